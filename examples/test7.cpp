@@ -24,8 +24,12 @@ int main(int argc, char *argv[]) {
 			pablo7a.adaptGlobalRefine();
 		}
 
-		/**<Instantation and copy pablo7a.*/
-		ParaTree pablo7b = pablo7a;
+		/**<Instantation of a second para_tree object equal to pablo7a (a para_tree can not be copied).*/
+		ParaTree pablo7b;
+		pablo7b.setBalance(idx,false);
+		for (iter=1; iter<6; iter++){
+			pablo7b.adaptGlobalRefine();
+		}
 
 		/**<Define a center point and a radius.*/
 		double xc, yc;
@@ -7,6 +7,8 @@
 #include "utils.hpp"
 #include "utils.tpp"
 
+#include <cmath>
+
 namespace utils {
 
 template bool add_to_ordered_vector<>(const long&, std::vector<long>&, std::less<long>);
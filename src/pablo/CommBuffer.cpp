@@ -49,6 +49,17 @@ CommBuffer::CommBuffer(const CommBuffer& other) {
 	m_comm = other.m_comm;
 }
 
+CommBuffer::CommBuffer(CommBuffer&& other) {
+
+	m_commBufferSize = other.m_commBufferSize;
+	m_commBuffer = other.m_commBuffer;
+	m_pos = other.m_pos;
+	m_comm = other.m_comm;
+	other.m_commBufferSize = 0;
+	other.m_commBuffer = NULL;
+	other.m_pos = 0;
+}
+
 CommBuffer::~CommBuffer() {
 		delete [] m_commBuffer;
 		m_commBuffer = NULL;
@@ -69,5 +80,22 @@ CommBuffer& CommBuffer::operator =(const CommBuffer& rhs) {
 	}
 	return *this;
 
+}
+
+CommBuffer& CommBuffer::operator =(CommBuffer&& rhs) {
+	if(this != &rhs)
+	{
+		delete [] m_commBuffer;
+
+		m_commBuffer = rhs.m_commBuffer;
+		m_commBufferSize = rhs.m_commBufferSize;
+		m_pos = rhs.m_pos;
+		m_comm = rhs.m_comm;
+		rhs.m_commBuffer = NULL;
+		rhs.m_commBufferSize = 0;
+		rhs.m_pos = 0;
+	}
+	return *this;
+
 }
 #endif
@@ -55,6 +55,7 @@ public:
 	CommBuffer(MPI_Comm comm_);
 	CommBuffer(uint32_t size, char value, MPI_Comm comm_);
 	CommBuffer(const CommBuffer& other);
+	CommBuffer(CommBuffer&& other);
 	~CommBuffer();
 
 	// =================================================================================== //
@@ -62,6 +63,7 @@ public:
 	// =================================================================================== //
 	//TODO routines write and read to write and read POD types in buffer
 	CommBuffer& operator=(const CommBuffer& rhs);
+	CommBuffer& operator=(CommBuffer&& rhs);
 
 	// =================================================================================== //
 	// TEMPLATE METHODS                                                                    //
@@ -0,0 +1,98 @@
+#ifndef CONNECTIVITYVIEW_HPP_
+#define CONNECTIVITYVIEW_HPP_
+
+// =================================================================================== //
+// INCLUDES                                                                            //
+// =================================================================================== //
+#include <stdint.h>
+#include <cstddef>
+
+// =================================================================================== //
+// CLASS DEFINITION                                                                    //
+// =================================================================================== //
+/*!
+ *  \ingroup        PABLO
+ *  @{
+ *
+ *	\brief Read-only view of a fixed-stride connectivity
+ *
+ *	The connectivity of the octants is stored in a single contiguous buffer with
+ *	a fixed number of nodes per octant (4/8 in 2D/3D), i.e. the nodes of the
+ *	i-th octant are data()[i*getStride() ... (i+1)*getStride()-1].
+ *	A view does not own the buffer: it is valid until the connectivity it refers
+ *	to is cleared or updated.
+ *
+ */
+class ConnectivityView{
+
+	// =================================================================================== //
+	// MEMBERS
+	// =================================================================================== //
+private:
+	const uint32_t*	m_data;		/**< First node index of the first octant */
+	uint32_t		m_size;		/**< Number of octants */
+	uint8_t			m_stride;	/**< Number of nodes per octant */
+
+	// =================================================================================== //
+	// CONSTRUCTORS
+	// =================================================================================== //
+public:
+	/*! Default constructor, it builds an empty view.
+	 */
+	ConnectivityView() : m_data(NULL), m_size(0), m_stride(0) {};
+
+	/*! Custom constructor.
+	 * \param[in] data Pointer to the first node index of the first octant.
+	 * \param[in] size Number of octants.
+	 * \param[in] stride Number of nodes per octant.
+	 */
+	ConnectivityView(const uint32_t* data, uint32_t size, uint8_t stride)
+		: m_data(data), m_size(size), m_stride(stride) {};
+
+	// =================================================================================== //
+	// METHODS
+	// =================================================================================== //
+
+	/*! Get the number of octants of the view.
+	 * \return Number of octants.
+	 */
+	uint32_t size() const {return m_size;};
+
+	/*! Check if the view is empty (connectivity not computed).
+	 * \return True if the view contains no octants.
+	 */
+	bool empty() const {return (m_size == 0);};
+
+	/*! Get the number of nodes per octant.
+	 * \return Number of nodes per octant (4/8 in 2D/3D).
+	 */
+	uint8_t getStride() const {return m_stride;};
+
+	/*! Get the contiguous buffer of the connectivity.
+	 * \return Pointer to the first node index of the first octant.
+	 */
+	const uint32_t* data() const {return m_data;};
+
+	/*! Get the connectivity of an octant.
+	 * \param[in] idx Local index of the octant.
+	 * \return Pointer to the getStride() node indices of the octant.
+	 */
+	const uint32_t* operator[](uint32_t idx) const {return m_data + size_t(idx)*m_stride;};
+
+	/*! Get the first node index of an octant.
+	 * \param[in] idx Local index of the octant.
+	 * \return Pointer to the first node index of the octant.
+	 */
+	const uint32_t* begin(uint32_t idx) const {return m_data + size_t(idx)*m_stride;};
+
+	/*! Get the past-the-end node index of an octant.
+	 * \param[in] idx Local index of the octant.
+	 * \return Pointer past the last node index of the octant.
+	 */
+	const uint32_t* end(uint32_t idx) const {return m_data + size_t(idx+1)*m_stride;};
+
+};
+
+/*  @} */
+
+#endif /* CONNECTIVITYVIEW_HPP_ */
@@ -0,0 +1,80 @@
+#ifndef DUMPBUFFER_HPP_
+#define DUMPBUFFER_HPP_
+
+// =================================================================================== //
+// INCLUDES                                                                            //
+// =================================================================================== //
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// =================================================================================== //
+// CLASS DEFINITION                                                                    //
+// =================================================================================== //
+/*!
+ *  \ingroup        PABLO
+ *  @{
+ *
+ *	\brief Bundle char container for restart files
+ *
+ *	The user data of the octants are written in (and read from) a restart file
+ *	through this container, with the same read/write interface of CommBuffer.
+ *	The POD data are stored as their raw bytes, so that the data of each octant
+ *	take exactly the fixed size declared by the user interface (the size of
+ *	data packed by MPI is not guaranteed to be the same).
+ *
+ */
+class DumpBuffer{
+
+	// =================================================================================== //
+	// FRIENDSHIPS
+	// =================================================================================== //
+
+	friend class ParaTree;
+
+	// =================================================================================== //
+	// MEMBERS
+	// =================================================================================== //
+private:
+	std::vector<char>	m_buffer;		/**<Raw bytes of the data*/
+	size_t				m_pos;			/**<Position of the next datum to be written or read*/
+
+	// =================================================================================== //
+	// CONSTRUCTORS
+	// =================================================================================== //
+public:
+	DumpBuffer(size_t size) : m_buffer(size, 0), m_pos(0){};
+
+	// =================================================================================== //
+	// TEMPLATE METHODS
+	// =================================================================================== //
+	/*! Write a POD datum of type T in the buffer (the buffer grows if needed).
+	 * \param[in] val The value that has to be written in the buffer.
+	 */
+	template<class T>
+	void write(T& val){
+		if (m_pos + sizeof(T) > m_buffer.size()){
+			m_buffer.resize(m_pos + sizeof(T));
+		}
+		memcpy(m_buffer.data() + m_pos, &val, sizeof(T));
+		m_pos += sizeof(T);
+	};
+
+	/*! Read a POD datum of type T from the buffer (nothing is read past the end of the buffer).
+	 * \param[out] val The value that has to be read from the buffer.
+	 */
+	template<class T>
+	void read(T& val){
+		if (m_pos + sizeof(T) > m_buffer.size()){
+			m_pos = m_buffer.size() + 1;
+			return;
+		}
+		memcpy(&val, m_buffer.data() + m_pos, sizeof(T));
+		m_pos += sizeof(T);
+	};
+};
+
+/*  @}  */
+
+#endif /* DUMPBUFFER_HPP_ */
@@ -143,7 +143,7 @@ Global::setGlobal(int8_t maxlevel, uint8_t dim){
 	m_nnodes				= 1<<dim;
 	m_nedges 				= (dim-2)*12;
 	m_nnodesPerFace 		= 1<<(dim-1);
-	m_octantBytes 			= uint8_t(sizeof(uint32_t)*3 + sizeof(uint8_t) + sizeof(int8_t) + (17)*sizeof(bool));
+	m_octantBytes 			= uint8_t(sizeof(uint32_t)*3 + sizeof(uint8_t) + sizeof(int8_t) + sizeof(uint32_t));
 	m_globalIndexBytes 		= uint8_t(sizeof(uint64_t));
 	m_markerBytes 			= sizeof(int8_t);
 	m_levelBytes 			= sizeof(uint8_t);
@@ -0,0 +1,158 @@
+#ifndef INTERSECTIONSTORE_HPP_
+#define INTERSECTIONSTORE_HPP_
+
+// =================================================================================== //
+// INCLUDES                                                                            //
+// =================================================================================== //
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+// =================================================================================== //
+// CLASS DEFINITION                                                                    //
+// =================================================================================== //
+/*!
+ *  \ingroup        PABLO
+ *  @{
+ *
+ *	\brief Structure of arrays of the intersections of a local tree
+ *
+ *	The intersections computed by ParaTree::computeIntersections are stored
+ *	field by field in contiguous arrays: the owners (two values per intersection,
+ *	the first is a local octant), the face of the finer owner, the flags packed in
+ *	a byte (see Flags) and the area, the center and the normal of each
+ *	intersection, one array per coordinate. The geometry is computed once, with
+ *	the same values of the ParaTree getters of an Intersection.
+ *	The i-th entry of the arrays refers to the i-th intersection of ParaTree::getIntersection.
+ *
+ */
+class IntersectionStore{
+
+	// =================================================================================== //
+	// FRIENDSHIPS
+	// =================================================================================== //
+
+	friend class ParaTree;
+
+	// =================================================================================== //
+	// TYPEDEFS
+	// =================================================================================== //
+public:
+	/*! Bits of the packed flags of an intersection.
+	 */
+	enum Flags {
+		FINER	= 1,	/**< The second owner is the finer one */
+		BOUND	= 2,	/**< Boundary intersection of the whole domain */
+		GHOST	= 4,	/**< The second owner is a ghost */
+		PBOUND	= 8		/**< Boundary intersection of a process domain */
+	};
+
+	// =================================================================================== //
+	// MEMBERS
+	// =================================================================================== //
+private:
+	std::vector<uint32_t>	m_owners;		/**< Owners of the intersections, two per intersection */
+	std::vector<uint8_t>	m_faces;		/**< Index of the face of the finer owner */
+	std::vector<uint8_t>	m_flags;		/**< Packed flags of the intersections */
+	std::vector<double>		m_areas;		/**< Areas of the intersections */
+	std::vector<double>		m_centers[3];	/**< Coordinates of the centers, one array per coordinate */
+	std::vector<double>		m_normals[3];	/**< Coordinates of the normals, one array per coordinate */
+
+	// =================================================================================== //
+	// METHODS
+	// =================================================================================== //
+
+	/*! Resize the arrays.
+	 * \param[in] n Number of intersections.
+	 */
+	void resize(uint32_t n){
+		m_owners.resize(2*size_t(n));
+		m_faces.resize(n);
+		m_flags.resize(n);
+		m_areas.resize(n);
+		for (int i = 0; i < 3; ++i){
+			m_centers[i].resize(n);
+			m_normals[i].resize(n);
+		}
+	};
+
+	/*! Clear the arrays and free their memory.
+	 */
+	void clear(){
+		std::vector<uint32_t>().swap(m_owners);
+		std::vector<uint8_t>().swap(m_faces);
+		std::vector<uint8_t>().swap(m_flags);
+		std::vector<double>().swap(m_areas);
+		for (int i = 0; i < 3; ++i){
+			std::vector<double>().swap(m_centers[i]);
+			std::vector<double>().swap(m_normals[i]);
+		}
+	};
+
+public:
+	/*! Get the number of intersections.
+	 * \return Number of intersections.
+	 */
+	uint32_t size() const {return uint32_t(m_faces.size());};
+
+	/*! Check if the store is empty (intersections not computed or store disabled).
+	 * \return True if the store contains no intersections.
+	 */
+	bool empty() const {return m_faces.empty();};
+
+	/*! Get the owners of the intersections.
+	 * \return Pointer to the owners, the owners of the i-th intersection at 2*i and 2*i+1.
+	 */
+	const uint32_t* getOwners() const {return m_owners.data();};
+
+	/*! Get the owner octant of an intersection with inner normal.
+	 * \param[in] i Index of the intersection.
+	 * \return Index of the in octant.
+	 */
+	uint32_t getIn(uint32_t i) const {return m_owners[2*size_t(i) + ((m_flags[i] & FINER) ? 0 : 1)];};
+
+	/*! Get the owner octant of an intersection with outer normal.
+	 * \param[in] i Index of the intersection.
+	 * \return Index of the out octant (the finer owner).
+	 */
+	uint32_t getOut(uint32_t i) const {return m_owners[2*size_t(i) + ((m_flags[i] & FINER) ? 1 : 0)];};
+
+	/*! Get the faces of the finer owners of the intersections.
+	 * \return Pointer to the face indices.
+	 */
+	const uint8_t* getFaces() const {return m_faces.data();};
+
+	/*! Get the packed flags of the intersections.
+	 * \return Pointer to the flags (see Flags).
+	 */
+	const uint8_t* getFlags() const {return m_flags.data();};
+
+	/*! Get if a flag of an intersection is set.
+	 * \param[in] i Index of the intersection.
+	 * \param[in] flag Target flag.
+	 * \return True if the flag is set.
+	 */
+	bool hasFlag(uint32_t i, Flags flag) const {return (m_flags[i] & flag) != 0;};
+
+	/*! Get the areas of the intersections.
+	 * \return Pointer to the areas.
+	 */
+	const double* getAreas() const {return m_areas.data();};
+
+	/*! Get the coordinates of the centers of the intersections.
+	 * \param[in] coord Index of the coordinate (0/1/2 for x/y/z).
+	 * \return Pointer to the coordinates.
+	 */
+	const double* getCenters(uint8_t coord) const {return m_centers[coord].data();};
+
+	/*! Get the coordinates of the normals of the intersections.
+	 * \param[in] coord Index of the coordinate (0/1/2 for x/y/z).
+	 * \return Pointer to the coordinates.
+	 */
+	const double* getNormals(uint8_t coord) const {return m_normals[coord].data();};
+
+};
+
+/*  @} */
+
+#endif /* INTERSECTIONSTORE_HPP_ */
@@ -2,7 +2,10 @@
 // INCLUDES                                                                            //
 // =================================================================================== //
 #include "LocalTree.hpp"
-#include <map>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // =================================================================================== //
 // NAME SPACES                                                                         //
@@ -29,11 +32,15 @@ LocalTree::LocalTree(int8_t maxlevel, uint8_t dim){
 	Octant octl(m_dim,m_global.m_maxLevel,m_global.m_maxLength-1,m_global.m_maxLength-1,(m_dim-2)*(m_global.m_maxLength-1), m_global.m_maxLevel);
 	m_octants.resize(1);
 	m_octants[0] = oct0;
+	updateMortons();
 	m_firstDesc = octf;
 	m_lastDesc = octl;
 	m_sizeGhosts = 0;
 	m_localMaxDepth = 0;
 	m_balanceCodim = 1;
+	m_neighCodim = 0;
+	m_neighCached = false;
+	m_intersectionsGhosts = 0;
 };
 
 /*!Default destructor.
@@ -112,7 +119,7 @@ LocalTree::getLevel(int32_t idx){
  */
 uint64_t
 LocalTree::computeMorton(int32_t idx){
-	return m_octants[idx].computeMorton();
+	return m_mortons[idx];
 };
 
 /** Get refinement/coarsening marker for idx-th ghost octant
@@ -130,7 +137,7 @@ LocalTree::getGhostLevel(int32_t idx){
  */
 uint64_t
 LocalTree::computeGhostMorton(int32_t idx){
-	return m_ghosts[idx].computeMorton();
+	return m_ghostsMortons[idx];
 };
 
 /** Get if balancing-blocked idx-th octant
@@ -244,7 +251,23 @@ LocalTree::extractGhostOctant(uint32_t idx) const{
 
 // =================================================================================== //
 
-/*! Refine local tree: refine one time octants with marker >0
+/** Release the memory of a vector only if its capacity is more than twice its size,
+ * so that the refine/coarse cycles of an adapt do not reallocate the vector every time.
+ * \param[in,out] v Vector to be shrunk.
+ */
+template<class T>
+static void
+shrinkOversized(vector<T> & v){
+	if (v.capacity() > 2*v.size()){
+		vector<T>(v).swap(v);
+	}
+}
+
+// =================================================================================== //
+
+/*! Refine local tree: refine one time octants with marker >0.
+ * The new size is computed first, then the octants are shifted and expanded in place
+ * starting from the back, so only the octants following the first refined one are moved.
  * \param[out] mapidx mapidx[i] = index in old octants vector of the new i-th octant (index of father if octant is new after refinement)
  * \return	true if refinement done
  */
@@ -268,7 +291,7 @@ LocalTree::refine(u32vector & mapidx){
 		else{
 			if (m_octants[idx].m_marker > 0){
 				m_octants[idx].m_marker = 0;
-				m_octants[idx].m_info[15] = false;
+				m_octants[idx].setInfo(15, false);
 			}
 		}
 	}
@@ -278,6 +301,7 @@ LocalTree::refine(u32vector & mapidx){
 //			u32vector((*mapidx)).swap((*mapidx));
 		}
 		m_octants.resize(m_octants.size()+offset);
+		m_mortons.resize(m_octants.size());
 		blockidx = last_child_index[0]-nchm1;
 		idx = m_octants.size();
 		ilastch = last_child_index.size()-1;
@@ -285,9 +309,10 @@ LocalTree::refine(u32vector & mapidx){
 		while (idx>blockidx){
 			idx--;
 			if(idx == last_child_index[ilastch]){
-				children = m_octants[idx-offset].buildChildren();
+				children = m_octants[idx-offset].buildChildren(m_dim);
 				for (ich=0; ich<m_global.m_nchildren; ich++){
 					m_octants[idx-ich] = (children[nchm1-ich]);
+					m_mortons[idx-ich] = children[nchm1-ich].computeMorton();
 					if(mapsize>0) mapidx[idx-ich]  = mapidx[idx-offset];
 				}
 				offset -= nchm1;
@@ -307,12 +332,12 @@ LocalTree::refine(u32vector & mapidx){
 			}
 			else {
 				m_octants[idx] = m_octants[idx-offset];
+				m_mortons[idx] = m_mortons[idx-offset];
 				if(mapsize>0) mapidx[idx]  = mapidx[idx-offset];
 			}
 		}
 	}
 
-	octvector(m_octants).swap(m_octants);
 	nocts = m_octants.size();
 	if(mapsize>0) {
 //		mapidx.resize(nocts);
@@ -328,7 +353,8 @@ LocalTree::refine(u32vector & mapidx){
 
 // =================================================================================== //
 /*! Coarse local tree: coarse one time family of octants with marker <0
- * (if at least one octant of family has marker>=0 set marker=0 for the entire family)
+ * (if at least one octant of family has marker>=0 set marker=0 for the entire family).
+ * The octants are compacted in place starting from the first coarsened family.
  * \param[out] mapidx mpaidx[i] = index in old octants vector of the new i-th octant (index of first child if octant is new after coarsening)
  * \return	true is coarsening done
  */
@@ -369,7 +395,7 @@ LocalTree::coarse(u32vector & mapidx){
 
 	// Set index for start and end check for ghosts
 	if (m_ghosts.size()){
-		while(idx2_gh < m_sizeGhosts && m_ghosts[idx2_gh].computeMorton() < m_lastDesc.computeMorton()){
+		while(idx2_gh < m_sizeGhosts && m_ghostsMortons[idx2_gh] < m_lastDesc.computeMorton()){
 			idx2_gh++;
 		}
 		idx2_gh = min((m_sizeGhosts-1), idx2_gh);
@@ -379,11 +405,11 @@ LocalTree::coarse(u32vector & mapidx){
 	for (idx=0; idx<nocts; idx++){
 		if(m_octants[idx].getMarker() < 0 && m_octants[idx].getLevel() > 0){
 			nbro = 0;
-			father = m_octants[idx].buildFather();
+			father = m_octants[idx].buildFather(m_dim);
 			// Check if family is to be refined
 			for (idx2=idx; idx2<idx+m_global.m_nchildren; idx2++){
 				if (idx2<nocts){
-					if(m_octants[idx2].getMarker() < 0 && m_octants[idx2].buildFather() == father){
+					if(m_octants[idx2].getMarker() < 0 && m_octants[idx2].buildFather(m_dim) == father){
 						nbro++;
 					}
 				}
@@ -400,14 +426,14 @@ LocalTree::coarse(u32vector & mapidx){
 	if (nidx!=0){
 		nblock = nocts - nidx*nchm1;
 		nidx = 0;
-		for (idx=0; idx<nblock; idx++){
+		for (idx=first_child_index[0]; idx<nblock; idx++){
 			if (idx+offset < nocts){
 				if (nidx < nfchild){
 					if (idx+offset == first_child_index[nidx]){
 						markerfather = -m_global.m_maxLevel;
-						father = m_octants[idx+offset].buildFather();
+						father = m_octants[idx+offset].buildFather(m_dim);
 						for (uint32_t iii=0; iii<17; iii++){
-							father.m_info[iii] = false;
+							father.setInfo(iii, false);
 						}
 						for(idx2=0; idx2<m_global.m_nchildren; idx2++){
 							if (idx2 < nocts){
@@ -415,35 +441,38 @@ LocalTree::coarse(u32vector & mapidx){
 									markerfather = m_octants[idx+offset+idx2].getMarker()+1;
 								}
 								for (uint32_t iii=0; iii<17; iii++){
-									father.m_info[iii] = father.m_info[iii] || m_octants[idx+offset+idx2].m_info[iii];
+									father.setInfo(iii, father.getInfo(iii) || m_octants[idx+offset+idx2].getInfo(iii));
 								}
 							}
 						}
-						father.m_info[13] = true;
-						father.m_info[15] = true;
+						father.setInfo(13, true);
+						father.setInfo(15, true);
 						father.setMarker(markerfather);
 						if (markerfather < 0 && mapsize == 0){
 							docoarse = true;
 						}
 						m_octants[idx] = father;
+						m_mortons[idx] = father.computeMorton();
 						if(mapsize > 0) mapidx[idx] = mapidx[idx+offset];
 						offset += nchm1;
 						nidx++;
 					}
 					else{
 						m_octants[idx] = m_octants[idx+offset];
+						m_mortons[idx] = m_mortons[idx+offset];
 						if(mapsize > 0) mapidx[idx] = mapidx[idx+offset];
 					}
 				}
 				else{
 					m_octants[idx] = m_octants[idx+offset];
+					m_mortons[idx] = m_mortons[idx+offset];
 					if(mapsize > 0) mapidx[idx] = mapidx[idx+offset];
 				}
 			}
 		}
 	}
 	m_octants.resize(nblock);
-	octvector(m_octants).swap(m_octants);
+	m_mortons.resize(nblock);
 	nocts = m_octants.size();
 	if(mapsize > 0){
 		mapidx.resize(nocts);
@@ -452,24 +481,24 @@ LocalTree::coarse(u32vector & mapidx){
 
 	// End on ghosts
 	if (m_ghosts.size() && nocts > 0){
-		if (m_ghosts[idx2_gh].buildFather() == m_octants[nocts-1].buildFather()){
-			father = m_ghosts[idx2_gh].buildFather();
+		if (m_ghosts[idx2_gh].buildFather(m_dim) == m_octants[nocts-1].buildFather(m_dim)){
+			father = m_ghosts[idx2_gh].buildFather(m_dim);
 //			for (uint32_t iii=0; iii<17; iii++){
-//				father.m_info[iii] = false;
+//				father.setInfo(iii, false);
 //			}
 			markerfather = m_ghosts[idx2_gh].getMarker()+1;
 			nbro = 0;
 			idx = idx2_gh;
 			marker = m_ghosts[idx].getMarker();
-			while(marker < 0 && m_ghosts[idx].buildFather() == father){
+			while(marker < 0 && m_ghosts[idx].buildFather(m_dim) == father){
 				nbro++;
 				if (markerfather < m_ghosts[idx].getMarker()+1){
 					markerfather = m_ghosts[idx].getMarker()+1;
 				}
 				for (uint32_t iii=0; iii<m_global.m_nfaces; iii++){
-					father.m_info[iii] = father.m_info[iii] || m_ghosts[idx].m_info[iii];
+					father.setInfo(iii, father.getInfo(iii) || m_ghosts[idx].getInfo(iii));
 				}
-				father.m_info[14] = father.m_info[14] || m_ghosts[idx].m_info[14];
+				father.setInfo(14, father.getInfo(14) || m_ghosts[idx].getInfo(14));
 				idx++;
 				if(idx == m_sizeGhosts){
 					break;
@@ -479,7 +508,7 @@ LocalTree::coarse(u32vector & mapidx){
 			nend = 0;
 			idx = nocts-1;
 			marker = m_octants[idx].getMarker();
-			while(marker < 0 && m_octants[idx].buildFather() == father && idx >= 0){
+			while(marker < 0 && m_octants[idx].buildFather(m_dim) == father && idx >= 0){
 				nbro++;
 				nend++;
 				if (markerfather < m_octants[idx].getMarker()+1){
@@ -504,18 +533,19 @@ LocalTree::coarse(u32vector & mapidx){
 		if (nend != 0){
 			for (idx=0; idx < nend; idx++){
 				for (uint32_t iii=0; iii<16; iii++){
-					father.m_info[iii] = father.m_info[iii] || m_octants[nocts-idx-1].m_info[iii];
+					father.setInfo(iii, father.getInfo(iii) || m_octants[nocts-idx-1].getInfo(iii));
 				}
 			}
-			father.m_info[13] = true;
-			father.m_info[15] = true;
+			father.setInfo(13, true);
+			father.setInfo(15, true);
 			if (markerfather < 0 && mapsize == 0){
 				docoarse = true;
 			}
 			father.setMarker(markerfather);
 			m_octants.resize(nocts-offset);
 			m_octants.push_back(father);
-			octvector(m_octants).swap(m_octants);
+			m_mortons.resize(nocts-offset);
+			m_mortons.push_back(father.computeMorton());
 			nocts = m_octants.size();
 			if(mapsize > 0){
 				mapidx.resize(nocts);
@@ -525,6 +555,9 @@ LocalTree::coarse(u32vector & mapidx){
 
 	}
 
+	shrinkOversized(m_octants);
+	shrinkOversized(m_mortons);
+
 	// Set final first and last desc
 	if(nocts>0){
 		setFirstDesc();
@@ -547,6 +580,7 @@ LocalTree::globalRefine(u32vector & mapidx){
 	bool 		dorefine = false;
 
 	nocts = m_octants.size();
+#pragma omp parallel for schedule(static) if (nocts > 4096)
 	for (idx=0; idx<nocts; idx++){
 		m_octants[idx].setMarker(1);
 	}
@@ -570,6 +604,7 @@ LocalTree::globalCoarse(u32vector & mapidx){
 	bool 		dorefine = false;
 
 	nocts = m_octants.size();
+#pragma omp parallel for schedule(static) if (nocts > 4096)
 	for (idx=0; idx<nocts; idx++){
 		m_octants[idx].setMarker(-1);
 	}
@@ -600,20 +635,25 @@ LocalTree::checkCoarse(uint64_t lastDescPre,
 
 	nocts = getNumOctants();
 	idx = 0;
-	Morton = m_octants[idx].computeMorton();
+	Morton = m_mortons[idx];
 
 	while(Morton <= lastDescPre && idx < nocts-1 && Morton != 0){
 		// To delete, the father is in proc before me
 		toDelete++;
 		idx++;
-		Morton = m_octants[idx].computeMorton();
+		Morton = m_mortons[idx];
 	}
-	if (nocts>toDelete){
+	if (toDelete == 0){
+		// Nothing to delete
+	}
+	else if (nocts>toDelete){
 		for(idx=0; idx<nocts-toDelete; idx++){
 			m_octants[idx] = m_octants[idx+toDelete];
+			m_mortons[idx] = m_mortons[idx+toDelete];
 			if (mapsize>0) mapidx[idx] = mapidx[idx+toDelete];
 		}
 		m_octants.resize(nocts-toDelete);
+		m_mortons.resize(nocts-toDelete);
 		//octvector(octants).swap(octants);
 		if (mapsize>0){
 			mapidx.resize(nocts-toDelete);
@@ -622,6 +662,7 @@ LocalTree::checkCoarse(uint64_t lastDescPre,
 	}
 	else{
 		m_octants.clear();
+		m_mortons.clear();
 		mapidx.clear();
 	}
 	nocts = getNumOctants();
@@ -639,13 +680,15 @@ LocalTree::updateLocalMaxDepth(){
 
 	uint32_t noctants = getNumOctants();
 	uint32_t i;
+	int localMaxDepth = 0;
 
-	m_localMaxDepth = 0;
+#pragma omp parallel for schedule(static) reduction(max:localMaxDepth) if (noctants > 4096)
 	for(i = 0; i < noctants; i++){
-		if(m_octants[i].getLevel() > m_localMaxDepth){
-			m_localMaxDepth = m_octants[i].getLevel();
+		if(int(m_octants[i].getLevel()) > localMaxDepth){
+			localMaxDepth = m_octants[i].getLevel();
 		}
 	}
+	m_localMaxDepth = localMaxDepth;
 };
 
 // =================================================================================== //
@@ -685,10 +728,10 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 	}
 
 	// Check if octants face is a process boundary
-	if (oct->m_info[6+iface] == false){
+	if (oct->getInfo(6+iface) == false){
 
 		// Check if octants face is a boundary
-		if (oct->m_info[iface] == false){
+		if (oct->getInfo(iface) == false){
 
 			//Build Morton number of virtual neigh of same size
 			Octant samesizeoct(m_dim, oct->m_level, int32_t(oct->m_x)+int32_t(cxyz[0]*size), int32_t(oct->m_y)+int32_t(cxyz[1]*size), int32_t(oct->m_z)+int32_t(cxyz[2]*size), m_global.m_maxLevel);
@@ -696,26 +739,8 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 			// Search morton in octants
 			// If a even face morton is lower than morton of oct, if odd higher
 			// ---> can i search only before or after idx in octants
-			Mortontry = oct->computeMorton();
-			int32_t jump = (Mortontry > Morton) ? int32_t(idx/2+1) : int32_t((noctants -idx)/2+1);
-			idxtry = uint32_t(idx + ((Mortontry < Morton) - (Mortontry > Morton))*jump);
-			if (idxtry > noctants-1) idxtry = noctants-1;
-			while(abs(jump) > 0){
-				Mortontry = m_octants[idxtry].computeMorton();
-				jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-				idxtry += jump;
-				if (idxtry > noctants-1){
-					if (jump > 0){
-						idxtry = noctants - 1;
-						jump = 0;
-					}
-					else if (jump < 0){
-						idxtry = 0;
-						jump = 0;
-					}
-				}
-			}
-			Mortontry = m_octants[idxtry].computeMorton();
+			idxtry = findLowerMorton(Morton);
+			Mortontry = m_mortons[idxtry];
 			if(Mortontry == Morton && m_octants[idxtry].m_level == oct->m_level){
 				//Found neighbour of same size
 				isghost.push_back(false);
@@ -729,19 +754,19 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 						idxtry++;
 						if(idxtry > noctants-1){
 							idxtry = noctants-1;
-							Mortontry = m_octants[idxtry].computeMorton();
+							Mortontry = m_mortons[idxtry];
 							break;
 						}
-						Mortontry = m_octants[idxtry].computeMorton();
+						Mortontry = m_mortons[idxtry];
 					}
 					while(Mortontry > Morton){
 						idxtry--;
 						if(idxtry > noctants-1){
 							idxtry = 0;
-							Mortontry = m_octants[idxtry].computeMorton();
+							Mortontry = m_mortons[idxtry];
 							break;
 						}
-						Mortontry = m_octants[idxtry].computeMorton();
+						Mortontry = m_mortons[idxtry];
 					}
 				}
 				if(Mortontry == Morton && m_octants[idxtry].m_level == oct->m_level){
@@ -751,9 +776,9 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 					return;
 				}
 				// Compute Last discendent of virtual octant of same size
-				Octant last_desc = samesizeoct.buildLastDesc();
+				Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 				uint64_t Mortonlast = last_desc.computeMorton();
-				Mortontry = m_octants[idxtry].computeMorton();
+				Mortontry = m_mortons[idxtry];
 				//				int32_t Dx, Dy, Dz;
 				//				int32_t Dxstar, Dystar, Dzstar;
 				int32_t Dx[3] = {0,0,0};
@@ -814,7 +839,7 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 					if(idxtry>noctants-1){
 						break;
 					}
-					Mortontry = m_octants[idxtry].computeMorton();
+					Mortontry = m_mortons[idxtry];
 					coordtry = m_octants[idxtry].getCoord();
 				}
 				return;
@@ -829,14 +854,12 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 	//--------------------------------------------------------------- //
 	else{
 		// Check if octants face is a boundary
-		if (oct->m_info[iface] == false){
+		if (oct->getInfo(iface) == false){
 
 			// IF OCTANT FACE IS A PROCESS BOUNDARY SEARCH ALSO IN GHOSTS
 			if (m_ghosts.size()>0){
 
 				// Search in ghosts
-				uint32_t idxghost = uint32_t(m_sizeGhosts/2);
-				Octant* octghost = &m_ghosts[idxghost];
 
 				//Build Morton number of virtual neigh of same size
 				//Octant samesizeoct(oct->m_level, oct->m_x+cx*size, oct->m_y+cy*size, oct->m_z+cz*size);
@@ -845,28 +868,8 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 				// Search morton in octants
 				// If a even face morton is lower than morton of oct, if odd higher
 				// ---> can i search only before or after idx in octants
-				Mortontry = octghost->computeMorton();
-				int32_t jump = (Mortontry > Morton) ? int32_t(idxghost/2+1) : int32_t((m_sizeGhosts -idxghost)/2+1);
-				idxtry = uint32_t(idxghost +((Mortontry<Morton)-(Mortontry>Morton))*jump);
-				if (idxtry > m_ghosts.size()-1) idxtry = m_ghosts.size()-1;
-				while(abs(jump) > 0){
-					Mortontry = m_ghosts[idxtry].computeMorton();
-					jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-					idxtry += jump;
-					if (idxtry > m_ghosts.size()-1){
-						if (jump > 0){
-							idxtry = m_ghosts.size() - 1;
-							Mortontry = m_ghosts[idxtry].computeMorton();
-							jump = 0;
-						}
-						else if (jump < 0){
-							idxtry = 0;
-							Mortontry = m_ghosts[idxtry].computeMorton();
-							jump = 0;
-						}
-					}
-				}
-				Mortontry = m_ghosts[idxtry].computeMorton();
+				idxtry = findGhostLowerMorton(Morton);
+				Mortontry = m_ghostsMortons[idxtry];
 				if(Mortontry == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 					//Found neighbour of same size
 					isghost.push_back(true);
@@ -880,32 +883,32 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 							idxtry++;
 							if(idxtry > m_ghosts.size()-1){
 								idxtry = m_ghosts.size()-1;
-								Mortontry = m_ghosts[idxtry].computeMorton();
+								Mortontry = m_ghostsMortons[idxtry];
 								break;
 							}
-							Mortontry = m_ghosts[idxtry].computeMorton();
+							Mortontry = m_ghostsMortons[idxtry];
 						}
-						while(m_ghosts[idxtry].computeMorton() > Morton){
+						while(m_ghostsMortons[idxtry] > Morton){
 							idxtry--;
 							if(idxtry > m_ghosts.size()-1){
 								idxtry = 0;
-								Mortontry = m_ghosts[idxtry].computeMorton();
+								Mortontry = m_ghostsMortons[idxtry];
 								break;
 							}
-							Mortontry = m_ghosts[idxtry].computeMorton();
+							Mortontry = m_ghostsMortons[idxtry];
 						}
 					}
 					if(idxtry < m_sizeGhosts){
-						if(m_ghosts[idxtry].computeMorton() == Morton && m_ghosts[idxtry].m_level == oct->m_level){
+						if(m_ghostsMortons[idxtry] == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 							//Found neighbour of same size
 							isghost.push_back(true);
 							neighbours.push_back(idxtry);
 							return;
 						}
 						// Compute Last discendent of virtual octant of same size
-						Octant last_desc = samesizeoct.buildLastDesc();
+						Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 						uint64_t Mortonlast = last_desc.computeMorton();
-						Mortontry = m_ghosts[idxtry].computeMorton();
+						Mortontry = m_ghostsMortons[idxtry];
 						//						int32_t Dx, Dy, Dz;
 						//						int32_t Dxstar, Dystar, Dzstar;
 						int32_t Dx[3] = {0,0,0};
@@ -966,7 +969,7 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 							if(idxtry>m_sizeGhosts-1){
 								break;
 							}
-							Mortontry = m_ghosts[idxtry].computeMorton();
+							Mortontry = m_ghostsMortons[idxtry];
 							coordtry = m_ghosts[idxtry].getCoord();
 						}
 					}
@@ -975,13 +978,13 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 				uint32_t lengthneigh = 0;
 				uint32_t sizeneigh = neighbours.size();
 				for (idxtry=0; idxtry<sizeneigh; idxtry++){
-					lengthneigh += m_ghosts[neighbours[idxtry]].getArea();
+					lengthneigh += m_ghosts[neighbours[idxtry]].getArea(m_dim);
 				}
-				if (lengthneigh < oct->getArea()){
+				if (lengthneigh < oct->getArea(m_dim)){
 					// Search in octants
 
 					// Check if octants face is a boundary
-					if (oct->m_info[iface] == false){
+					if (oct->getInfo(iface) == false){
 
 						//Build Morton number of virtual neigh of same size
 						Octant samesizeoct(m_dim, oct->m_level, int32_t(oct->m_x)+int32_t(cxyz[0]*size), int32_t(oct->m_y)+int32_t(cxyz[1]*size), int32_t(oct->m_z)+int32_t(cxyz[2]*size), m_global.m_maxLevel);
@@ -989,26 +992,8 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 						// Search morton in octants
 						// If a even face morton is lower than morton of oct, if odd higher
 						// ---> can i search only before or after idx in octants
-						Mortontry = oct->computeMorton();
-						int32_t jump = (Mortontry > Morton) ? int32_t(idx/2+1) : int32_t((noctants -idx)/2+1);
-						idxtry = uint32_t(idx + ((Mortontry < Morton) - (Mortontry > Morton))*jump);
-						if (idxtry > noctants-1) idxtry = noctants-1;
-						while(abs(jump) > 0){
-							Mortontry = m_octants[idxtry].computeMorton();
-							jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-							idxtry += jump;
-							if (idxtry > noctants-1){
-								if (jump > 0){
-									idxtry = noctants - 1;
-									jump = 0;
-								}
-								else if (jump < 0){
-									idxtry = 0;
-									jump = 0;
-								}
-							}
-						}
-						Mortontry = m_octants[idxtry].computeMorton();
+						idxtry = findLowerMorton(Morton);
+						Mortontry = m_mortons[idxtry];
 						if(Mortontry == Morton && m_octants[idxtry].m_level == oct->m_level){
 							//Found neighbour of same size
 							isghost.push_back(false);
@@ -1022,19 +1007,19 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 									idxtry++;
 									if(idxtry > noctants-1){
 										idxtry = noctants-1;
-										Mortontry = m_octants[idxtry].computeMorton();
+										Mortontry = m_mortons[idxtry];
 										break;
 									}
-									Mortontry = m_octants[idxtry].computeMorton();
+									Mortontry = m_mortons[idxtry];
 								}
 								while(Mortontry > Morton){
 									idxtry--;
 									if(idxtry > noctants-1){
 										idxtry = 0;
-										Mortontry = m_octants[idxtry].computeMorton();
+										Mortontry = m_mortons[idxtry];
 										break;
 									}
-									Mortontry = m_octants[idxtry].computeMorton();
+									Mortontry = m_mortons[idxtry];
 								}
 							}
 							if(Mortontry == Morton && m_octants[idxtry].m_level == oct->m_level){
@@ -1044,9 +1029,9 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 								return;
 							}
 							// Compute Last discendent of virtual octant of same size
-							Octant last_desc = samesizeoct.buildLastDesc();
+							Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 							uint64_t Mortonlast = last_desc.computeMorton();
-							Mortontry = m_octants[idxtry].computeMorton();
+							Mortontry = m_mortons[idxtry];
 							//				int32_t Dx, Dy, Dz;
 							//				int32_t Dxstar, Dystar, Dzstar;
 							int32_t Dx[3] = {0,0,0};
@@ -1107,7 +1092,7 @@ LocalTree::findNeighbours(uint32_t idx, uint8_t iface, u32vector & neighbours, v
 								if(idxtry>noctants-1){
 									break;
 								}
-								Mortontry = m_octants[idxtry].computeMorton();
+								Mortontry = m_mortons[idxtry];
 								coordtry = m_octants[idxtry].getCoord();
 							}
 							return;
@@ -1160,10 +1145,10 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 	}
 
 	// Check if octants face is a process boundary
-	if (oct->m_info[6+iface] == false){
+	if (oct->getInfo(6+iface) == false){
 
 		// Check if octants face is a boundary
-		if (oct->m_info[iface] == false){
+		if (oct->getInfo(iface) == false){
 
 			//Build Morton number of virtual neigh of same size
 			//			Octant samesizeoct(oct->m_level, int32_t(oct->m_x)+int32_t(cx*size), int32_t(oct->m_y)+int32_t(cy*size), int32_t(oct->m_z)+int32_t(cz*size));
@@ -1172,25 +1157,8 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 			// Search morton in octants
 			// If a even face morton is lower than morton of oct, if odd higher
 			// ---> can i search only before or after idx in octants
-			int32_t jump = int32_t((noctants)/2+1);
-			idxtry = uint32_t(jump);
-			Mortontry = oct->computeMorton();
-			while(abs(jump) > 0){
-				Mortontry = m_octants[idxtry].computeMorton();
-				jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-				idxtry += jump;
-				if (idxtry > noctants-1){
-					if (jump > 0){
-						idxtry = noctants - 1;
-						jump = 0;
-					}
-					else if (jump < 0){
-						idxtry = 0;
-						jump = 0;
-					}
-				}
-			}
-			Mortontry = m_octants[idxtry].computeMorton();
+			idxtry = findLowerMorton(Morton);
+			Mortontry = m_mortons[idxtry];
 			if(Mortontry == Morton && m_octants[idxtry].m_level == oct->m_level){
 				//Found neighbour of same size
 				isghost.push_back(false);
@@ -1204,19 +1172,19 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 						idxtry++;
 						if(idxtry > noctants-1){
 							idxtry = noctants-1;
-							Mortontry = m_octants[idxtry].computeMorton();
+							Mortontry = m_mortons[idxtry];
 							break;
 						}
-						Mortontry = m_octants[idxtry].computeMorton();
+						Mortontry = m_mortons[idxtry];
 					}
 					while(Mortontry > Morton){
 						idxtry--;
 						if(idxtry > noctants-1){
 							idxtry = 0;
-							Mortontry = m_octants[idxtry].computeMorton();
+							Mortontry = m_mortons[idxtry];
 							break;
 						}
-						Mortontry = m_octants[idxtry].computeMorton();
+						Mortontry = m_mortons[idxtry];
 					}
 				}
 				if(Mortontry == Morton && m_octants[idxtry].m_level == oct->m_level){
@@ -1226,9 +1194,9 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 					return;
 				}
 				// Compute Last discendent of virtual octant of same size
-				Octant last_desc = samesizeoct.buildLastDesc();
+				Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 				uint64_t Mortonlast = last_desc.computeMorton();
-				Mortontry = m_octants[idxtry].computeMorton();
+				Mortontry = m_mortons[idxtry];
 				//				int32_t Dx, Dy, Dz;
 				//				int32_t Dxstar, Dystar, Dzstar;
 				int32_t Dx[3] = {0,0,0};
@@ -1289,7 +1257,7 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 					if(idxtry>noctants-1){
 						break;
 					}
-					Mortontry = m_octants[idxtry].computeMorton();
+					Mortontry = m_mortons[idxtry];
 					coordtry = m_octants[idxtry].getCoord();
 				}
 				return;
@@ -1304,14 +1272,12 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 	//--------------------------------------------------------------- //
 	else{
 		// Check if octants face is a boundary
-		if (oct->m_info[iface] == false){
+		if (oct->getInfo(iface) == false){
 
 			// IF OCTANT FACE IS A PROCESS BOUNDARY SEARCH ALSO IN GHOSTS
 			if (m_ghosts.size()>0){
 
 				// Search in ghosts
-				uint32_t idxghost = uint32_t(m_sizeGhosts/2);
-				Octant* octghost = &m_ghosts[idxghost];
 
 				//Build Morton number of virtual neigh of same size
 				//Octant samesizeoct(oct->m_level, oct->m_x+cx*size, oct->m_y+cy*size, oct->m_z+cz*size);
@@ -1320,28 +1286,8 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 				// Search morton in octants
 				// If a even face morton is lower than morton of oct, if odd higher
 				// ---> can i search only before or after idx in octants
-				Mortontry = octghost->computeMorton();
-				int32_t jump = (Mortontry > Morton) ? int32_t(idxghost/2+1) : int32_t((m_sizeGhosts -idxghost)/2+1);
-				idxtry = uint32_t(idxghost +((Mortontry<Morton)-(Mortontry>Morton))*jump);
-				if (idxtry > m_ghosts.size()-1) idxtry = m_ghosts.size()-1;
-				while(abs(jump) > 0){
-					Mortontry = m_ghosts[idxtry].computeMorton();
-					jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-					idxtry += jump;
-					if (idxtry > m_ghosts.size()-1){
-						if (jump > 0){
-							idxtry = m_ghosts.size() - 1;
-							Mortontry = m_ghosts[idxtry].computeMorton();
-							jump = 0;
-						}
-						else if (jump < 0){
-							idxtry = 0;
-							Mortontry = m_ghosts[idxtry].computeMorton();
-							jump = 0;
-						}
-					}
-				}
-				Mortontry = m_ghosts[idxtry].computeMorton();
+				idxtry = findGhostLowerMorton(Morton);
+				Mortontry = m_ghostsMortons[idxtry];
 				if(Mortontry == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 					//Found neighbour of same size
 					isghost.push_back(true);
@@ -1355,32 +1301,32 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 							idxtry++;
 							if(idxtry > m_ghosts.size()-1){
 								idxtry = m_ghosts.size()-1;
-								Mortontry = m_ghosts[idxtry].computeMorton();
+								Mortontry = m_ghostsMortons[idxtry];
 								break;
 							}
-							Mortontry = m_ghosts[idxtry].computeMorton();
+							Mortontry = m_ghostsMortons[idxtry];
 						}
-						while(m_ghosts[idxtry].computeMorton() > Morton){
+						while(m_ghostsMortons[idxtry] > Morton){
 							idxtry--;
 							if(idxtry > m_ghosts.size()-1){
 								idxtry = 0;
-								Mortontry = m_ghosts[idxtry].computeMorton();
+								Mortontry = m_ghostsMortons[idxtry];
 								break;
 							}
-							Mortontry = m_ghosts[idxtry].computeMorton();
+							Mortontry = m_ghostsMortons[idxtry];
 						}
 					}
 					if(idxtry < m_sizeGhosts){
-						if(m_ghosts[idxtry].computeMorton() == Morton && m_ghosts[idxtry].m_level == oct->m_level){
+						if(m_ghostsMortons[idxtry] == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 							//Found neighbour of same size
 							isghost.push_back(true);
 							neighbours.push_back(idxtry);
 							return;
 						}
 						// Compute Last discendent of virtual octant of same size
-						Octant last_desc = samesizeoct.buildLastDesc();
+						Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 						uint64_t Mortonlast = last_desc.computeMorton();
-						Mortontry = m_ghosts[idxtry].computeMorton();
+						Mortontry = m_ghostsMortons[idxtry];
 						//						int32_t Dx, Dy, Dz;
 						//						int32_t Dxstar, Dystar, Dzstar;
 						int32_t Dx[3] = {0,0,0};
@@ -1441,7 +1387,7 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 							if(idxtry>m_sizeGhosts-1){
 								break;
 							}
-							Mortontry = m_ghosts[idxtry].computeMorton();
+							Mortontry = m_ghostsMortons[idxtry];
 							coordtry = m_ghosts[idxtry].getCoord();
 						}
 					}
@@ -1450,13 +1396,13 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 				uint32_t lengthneigh = 0;
 				uint32_t sizeneigh = neighbours.size();
 				for (idxtry=0; idxtry<sizeneigh; idxtry++){
-					lengthneigh += m_ghosts[neighbours[idxtry]].getArea();
+					lengthneigh += m_ghosts[neighbours[idxtry]].getArea(m_dim);
 				}
-				if (lengthneigh < oct->getArea()){
+				if (lengthneigh < oct->getArea(m_dim)){
 					// Search in octants
 
 					// Check if octants face is a boundary
-					if (oct->m_info[iface] == false){
+					if (oct->getInfo(iface) == false){
 
 						//Build Morton number of virtual neigh of same size
 						//Octant samesizeoct(oct->m_level, oct->m_x+cx*size, oct->m_y+cy*size, oct->m_z+cz*size);
@@ -1465,24 +1411,8 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 						// Search morton in octants
 						// If a even face morton is lower than morton of oct, if odd higher
 						// ---> can i search only before or after idx in octants
-						int32_t jump = (int32_t((noctants)/2+1));
-						idxtry = uint32_t(jump);
-						while(abs(jump) > 0){
-							Mortontry = m_octants[idxtry].computeMorton();
-							jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-							idxtry += jump;
-							if (idxtry > noctants-1){
-								if (jump > 0){
-									idxtry = noctants - 1;
-									jump = 0;
-								}
-								else if (jump < 0){
-									idxtry = 0;
-									jump = 0;
-								}
-							}
-						}
-						Mortontry = m_octants[idxtry].computeMorton();
+						idxtry = findLowerMorton(Morton);
+						Mortontry = m_mortons[idxtry];
 						if(Mortontry == Morton && m_octants[idxtry].m_level == oct->m_level){
 							//Found neighbour of same size
 							isghost.push_back(false);
@@ -1496,19 +1426,19 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 									idxtry++;
 									if(idxtry > noctants-1){
 										idxtry = noctants-1;
-										Mortontry = m_octants[idxtry].computeMorton();
+										Mortontry = m_mortons[idxtry];
 										break;
 									}
-									Mortontry = m_octants[idxtry].computeMorton();
+									Mortontry = m_mortons[idxtry];
 								}
 								while(Mortontry > Morton){
 									idxtry--;
 									if(idxtry > noctants-1){
 										idxtry = 0;
-										Mortontry = m_octants[idxtry].computeMorton();
+										Mortontry = m_mortons[idxtry];
 										break;
 									}
-									Mortontry = m_octants[idxtry].computeMorton();
+									Mortontry = m_mortons[idxtry];
 								}
 							}
 							if(Mortontry == Morton && m_octants[idxtry].m_level == oct->m_level){
@@ -1518,9 +1448,9 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 								return;
 							}
 							// Compute Last discendent of virtual octant of same size
-							Octant last_desc = samesizeoct.buildLastDesc();
+							Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 							uint64_t Mortonlast = last_desc.computeMorton();
-							Mortontry = m_octants[idxtry].computeMorton();
+							Mortontry = m_mortons[idxtry];
 							//				int32_t Dx, Dy, Dz;
 							//				int32_t Dxstar, Dystar, Dzstar;
 							int32_t Dx[3] = {0,0,0};
@@ -1581,7 +1511,7 @@ LocalTree::findNeighbours(Octant* oct, uint8_t iface, u32vector & neighbours, ve
 								if(idxtry>noctants-1){
 									break;
 								}
-								Mortontry = m_octants[idxtry].computeMorton();
+								Mortontry = m_mortons[idxtry];
 								coordtry = m_octants[idxtry].getCoord();
 							}
 							return;
@@ -1632,7 +1562,7 @@ LocalTree::findGhostNeighbours(uint32_t const idx, uint8_t iface, u32vector & ne
 	}
 
 	// Check if octants face is a process boundary
-	if (oct->m_info[6+iface] == true){
+	if (oct->getInfo(6+iface) == true){
 
 		//Build Morton number of virtual neigh of same size
 		//Octant samesizeoct(oct->m_level, int32_t(oct->m_x)+int32_t(cx*size), int32_t(oct->m_y)+int32_t(cy*size), int32_t(oct->m_z)+int32_t(cz*size));
@@ -1641,28 +1571,8 @@ LocalTree::findGhostNeighbours(uint32_t const idx, uint8_t iface, u32vector & ne
 		// Search morton in octants
 		// If a even face morton is lower than morton of oct, if odd higher
 		// ---> can i search only before or after idx in octants
-		int32_t jump = getNumOctants()/2;
-		idxtry = uint32_t(getNumOctants()/2);
-		Mortontry = m_octants[idxtry].computeMorton();
-		jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-		while(abs(jump) > 0){
-			Mortontry = m_octants[idxtry].computeMorton();
-			jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-			idxtry += jump;
-			if (idxtry > noctants-1){
-				if (jump > 0){
-					idxtry = noctants - 1;
-					Mortontry = m_octants[idxtry].computeMorton();
-					jump = 0;
-				}
-				else if (jump < 0){
-					idxtry = 0;
-					Mortontry = m_octants[idxtry].computeMorton();
-					jump = 0;
-				}
-			}
-		}
-		Mortontry = m_octants[idxtry].computeMorton();
+		idxtry = findLowerMorton(Morton);
+		Mortontry = m_mortons[idxtry];
 		if(Mortontry == Morton && m_octants[idxtry].m_level == oct->m_level){
 			//Found neighbour of same size
 			neighbours.push_back(idxtry);
@@ -1675,19 +1585,19 @@ LocalTree::findGhostNeighbours(uint32_t const idx, uint8_t iface, u32vector & ne
 					idxtry++;
 					if(idxtry > noctants-1){
 						idxtry = noctants-1;
-						Mortontry = m_octants[idxtry].computeMorton();
+						Mortontry = m_mortons[idxtry];
 						break;
 					}
-					Mortontry = m_octants[idxtry].computeMorton();
+					Mortontry = m_mortons[idxtry];
 				}
 				while(Mortontry > Morton){
 					idxtry--;
 					if(idxtry > noctants-1){
 						idxtry = 0;
-						Mortontry = m_octants[idxtry].computeMorton();
+						Mortontry = m_mortons[idxtry];
 						break;
 					}
-					Mortontry = m_octants[idxtry].computeMorton();
+					Mortontry = m_mortons[idxtry];
 				}
 			}
 			if(Mortontry == Morton && m_octants[idxtry].m_level == oct->m_level){
@@ -1696,9 +1606,9 @@ LocalTree::findGhostNeighbours(uint32_t const idx, uint8_t iface, u32vector & ne
 				return;
 			}
 			// Compute Last discendent of virtual octant of same size
-			Octant last_desc = samesizeoct.buildLastDesc();
+			Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 			uint64_t Mortonlast = last_desc.computeMorton();
-			Mortontry = m_octants[idxtry].computeMorton();
+			Mortontry = m_mortons[idxtry];
 			//			int32_t Dx, Dy, Dz;
 			//			int32_t Dxstar, Dystar, Dzstar;
 			int32_t Dx[3] = {0,0,0};
@@ -1757,7 +1667,7 @@ LocalTree::findGhostNeighbours(uint32_t const idx, uint8_t iface, u32vector & ne
 				if(idxtry>noctants-1){
 					break;
 				}
-				Mortontry = m_octants[idxtry].computeMorton();
+				Mortontry = m_mortons[idxtry];
 				coordtry = m_octants[idxtry].getCoord();
 			}
 			return;
@@ -1775,8 +1685,9 @@ LocalTree::findGhostNeighbours(uint32_t const idx, uint8_t iface, u32vector & ne
 
 /*! Pre-processing for 2:1 balancing of local tree. Check if there are broken families over processes.
  * \param[in] internal Set to true if the interior octants have to be checked.
+ * \return True if some marker is modified.
  */
-void
+bool
  LocalTree::preBalance21(bool internal){
 
 	Octant 			father, lastdesc;
@@ -1806,12 +1717,12 @@ void
 
 	// Set index for start and end check for ghosts
 	if (m_ghosts.size()){
-		while(idx2_gh < m_sizeGhosts && m_ghosts[idx2_gh].computeMorton() <= m_lastDesc.computeMorton()){
+		while(idx2_gh < m_sizeGhosts && m_ghostsMortons[idx2_gh] <= m_lastDesc.computeMorton()){
 			idx2_gh++;
 		}
 		idx2_gh = min((m_sizeGhosts-1), idx2_gh);
 
-		while(idx1_gh < m_sizeGhosts && m_ghosts[idx1_gh].computeMorton() <= m_octants[0].computeMorton()){
+		while(idx1_gh < m_sizeGhosts && m_ghostsMortons[idx1_gh] <= m_mortons[0]){
 			idx1_gh++;
 		}
 		idx1_gh-=1;
@@ -1821,12 +1732,12 @@ void
 
 	// End on ghosts
 	if (m_ghosts.size() && nocts > 0){
-		if (m_ghosts[idx1_gh].buildFather()==m_octants[0].buildFather()){
-			father = m_ghosts[idx1_gh].buildFather();
+		if (m_ghosts[idx1_gh].buildFather(m_dim)==m_octants[0].buildFather(m_dim)){
+			father = m_ghosts[idx1_gh].buildFather(m_dim);
 			nbro = 0;
 			idx = idx1_gh;
 			marker = m_ghosts[idx].getMarker();
-			while(marker < 0 && m_ghosts[idx].buildFather() == father){
+			while(marker < 0 && m_ghosts[idx].buildFather(m_dim) == father){
 				nbro++;
 				if (idx==0)
 					break;
@@ -1834,7 +1745,7 @@ void
 				marker = m_ghosts[idx].getMarker();
 			}
 			idx = 0;
-			while(idx<nocts && m_octants[idx].buildFather() == father){
+			while(idx<nocts && m_octants[idx].buildFather(m_dim) == father){
 				if(m_octants[idx].getMarker()<0)
 					nbro++;
 				idx++;
@@ -1845,19 +1756,19 @@ void
 				for(uint32_t ii=0; ii<idx; ii++){
 					if (m_octants[ii].getMarker()<0){
 						m_octants[ii].setMarker(0);
-						m_octants[ii].m_info[15]=true;
+						m_octants[ii].setInfo(15, true);
 						Bdone=true;
 					}
 				}
 			}
 		}
 
-		if (m_ghosts[idx2_gh].buildFather()==m_octants[nocts-1].buildFather()){
-			father = m_ghosts[idx2_gh].buildFather();
+		if (m_ghosts[idx2_gh].buildFather(m_dim)==m_octants[nocts-1].buildFather(m_dim)){
+			father = m_ghosts[idx2_gh].buildFather(m_dim);
 			nbro = 0;
 			idx = idx2_gh;
 			marker = m_ghosts[idx].getMarker();
-			while(marker < 0 && m_ghosts[idx].buildFather() == father){
+			while(marker < 0 && m_ghosts[idx].buildFather(m_dim) == father){
 
 				//Add ghost index to structure for mapper in case of coarsening a broken family
 				m_lastGhostBros.push_back(idx);
@@ -1870,7 +1781,7 @@ void
 				marker = m_ghosts[idx].getMarker();
 			}
 			idx = nocts-1;
-			while(m_octants[idx].buildFather() == father ){
+			while(m_octants[idx].buildFather(m_dim) == father ){
 				if (m_octants[idx].getMarker()<0)
 					nbro++;
 				if (idx==0)
@@ -1882,7 +1793,7 @@ void
 				for(uint32_t ii=idx+1; ii<nocts; ii++){
 					if (m_octants[ii].getMarker()<0){
 						m_octants[ii].setMarker(0);
-						m_octants[ii].m_info[15]=true;
+						m_octants[ii].setInfo(15, true);
 						Bdone=true;
 					}
 				}
@@ -1894,13 +1805,13 @@ void
 
 	// Check first internal octants
 	if (internal){
-		father = m_octants[0].buildFather();
-		lastdesc = father.buildLastDesc();
+		father = m_octants[0].buildFather(m_dim);
+		lastdesc = father.buildLastDesc(m_dim);
 		mortonld = lastdesc.computeMorton();
 		nbro = 0;
 		for (idx=0; idx<m_global.m_nchildren; idx++){
 			// Check if family is complete or to be checked in the internal loop (some brother refined)
-			if (m_octants[idx].computeMorton() <= mortonld){
+			if (m_mortons[idx] <= mortonld){
 				nbro++;
 			}
 		}
@@ -1911,11 +1822,11 @@ void
 		for (idx=idx0; idx<nocts; idx++){
 			if(m_octants[idx].getMarker() < 0 && m_octants[idx].getLevel() > 0){
 				nbro = 0;
-				father = m_octants[idx].buildFather();
+				father = m_octants[idx].buildFather(m_dim);
 				// Check if family is to be coarsened
 				for (idx2=idx; idx2<idx+m_global.m_nchildren; idx2++){
 					if (idx2<nocts){
-						if(m_octants[idx2].getMarker() < 0 && m_octants[idx2].buildFather() == father){
+						if(m_octants[idx2].getMarker() < 0 && m_octants[idx2].buildFather(m_dim) == father){
 							nbro++;
 						}
 					}
@@ -1926,13 +1837,14 @@ void
 				else{
 					if (idx<=last_idx){
 						m_octants[idx].setMarker(0);
-						m_octants[idx].m_info[15]=true;
+						m_octants[idx].setInfo(15, true);
 						Bdone=true;
 					}
 				}
 			}
 		}
 	}
+	return Bdone;
 };
 
 // =================================================================================== //
@@ -1969,12 +1881,12 @@ LocalTree::preBalance21(u32vector& newmodified){
 
 	// Set index for start and end check for ghosts
 	if (m_ghosts.size()){
-		while(idx2_gh < m_sizeGhosts && m_ghosts[idx2_gh].computeMorton() <= m_lastDesc.computeMorton()){
+		while(idx2_gh < m_sizeGhosts && m_ghostsMortons[idx2_gh] <= m_lastDesc.computeMorton()){
 			idx2_gh++;
 		}
 		idx2_gh = min((m_sizeGhosts-1), idx2_gh);
 
-		while(idx1_gh < m_sizeGhosts && m_ghosts[idx1_gh].computeMorton() <= m_octants[0].computeMorton()){
+		while(idx1_gh < m_sizeGhosts && m_ghostsMortons[idx1_gh] <= m_mortons[0]){
 			idx1_gh++;
 		}
 		idx1_gh-=1;
@@ -1984,12 +1896,12 @@ LocalTree::preBalance21(u32vector& newmodified){
 
 	// End on ghosts
 	if (m_ghosts.size() && nocts > 0){
-		if (m_ghosts[idx1_gh].buildFather()==m_octants[0].buildFather()){
-			father = m_ghosts[idx1_gh].buildFather();
+		if (m_ghosts[idx1_gh].buildFather(m_dim)==m_octants[0].buildFather(m_dim)){
+			father = m_ghosts[idx1_gh].buildFather(m_dim);
 			nbro = 0;
 			idx = idx1_gh;
 			marker = m_ghosts[idx].getMarker();
-			while(marker < 0 && m_ghosts[idx].buildFather() == father){
+			while(marker < 0 && m_ghosts[idx].buildFather(m_dim) == father){
 
 				//Add ghost index to structure for mapper in case of coarsening a broken family
 				m_lastGhostBros.push_back(idx);
@@ -2001,7 +1913,7 @@ LocalTree::preBalance21(u32vector& newmodified){
 				marker = m_ghosts[idx].getMarker();
 			}
 			idx = 0;
-			while(idx<nocts && m_octants[idx].buildFather() == father){
+			while(idx<nocts && m_octants[idx].buildFather(m_dim) == father){
 				if (m_octants[idx].getMarker()<0)
 					nbro++;
 				idx++;
@@ -2012,7 +1924,7 @@ LocalTree::preBalance21(u32vector& newmodified){
 				for(uint32_t ii=0; ii<idx; ii++){
 					if (m_octants[ii].getMarker()<0){
 						m_octants[ii].setMarker(0);
-						m_octants[ii].m_info[15]=true;
+						m_octants[ii].setInfo(15, true);
 						Bdone=true;
 						newmodified.push_back(ii);
 					}
@@ -2022,12 +1934,12 @@ LocalTree::preBalance21(u32vector& newmodified){
 			}
 		}
 
-		if (m_ghosts[idx2_gh].buildFather()==m_octants[nocts-1].buildFather()){
-			father = m_ghosts[idx2_gh].buildFather();
+		if (m_ghosts[idx2_gh].buildFather(m_dim)==m_octants[nocts-1].buildFather(m_dim)){
+			father = m_ghosts[idx2_gh].buildFather(m_dim);
 			nbro = 0;
 			idx = idx2_gh;
 			marker = m_ghosts[idx].getMarker();
-			while(marker < 0 && m_ghosts[idx].buildFather() == father){
+			while(marker < 0 && m_ghosts[idx].buildFather(m_dim) == father){
 				nbro++;
 				idx++;
 				if(idx == m_sizeGhosts){
@@ -2036,7 +1948,7 @@ LocalTree::preBalance21(u32vector& newmodified){
 				marker = m_ghosts[idx].getMarker();
 			}
 			idx = nocts-1;
-			while(m_octants[idx].buildFather() == father){
+			while(m_octants[idx].buildFather(m_dim) == father){
 				if (m_octants[idx].getMarker()<0)
 					nbro++;
 				idx--;
@@ -2048,7 +1960,7 @@ LocalTree::preBalance21(u32vector& newmodified){
 				for(uint32_t ii=idx+1; ii<nocts; ii++){
 					if (m_octants[ii].getMarker()<0){
 						m_octants[ii].setMarker(0);
-						m_octants[ii].m_info[15]=true;
+						m_octants[ii].setInfo(15, true);
 						Bdone=true;
 						newmodified.push_back(ii);
 					}
@@ -2058,14 +1970,14 @@ LocalTree::preBalance21(u32vector& newmodified){
 	}
 
 	// Check first internal octants
-	father = m_octants[0].buildFather();
-	lastdesc = father.buildLastDesc();
+	father = m_octants[0].buildFather(m_dim);
+	lastdesc = father.buildLastDesc(m_dim);
 	mortonld = lastdesc.computeMorton();
 	nbro = 0;
 	for (idx=0; idx<m_global.m_nchildren; idx++){
 		// Check if family is complete or to be checked in the internal loop (some brother refined)
 		if (idx<nocts){
-			if (m_octants[idx].computeMorton() <= mortonld){
+			if (m_mortons[idx] <= mortonld){
 				nbro++;
 			}
 		}
@@ -2077,11 +1989,11 @@ LocalTree::preBalance21(u32vector& newmodified){
 	for (idx=idx0; idx<nocts; idx++){
 		if(m_octants[idx].getMarker() < 0 && m_octants[idx].getLevel() > 0){
 			nbro = 0;
-			father = m_octants[idx].buildFather();
+			father = m_octants[idx].buildFather(m_dim);
 			// Check if family is to be coarsened
 			for (idx2=idx; idx2<idx+m_global.m_nchildren; idx2++){
 				if (idx2<nocts){
-					if(m_octants[idx2].getMarker() < 0 && m_octants[idx2].buildFather() == father){
+					if(m_octants[idx2].getMarker() < 0 && m_octants[idx2].buildFather(m_dim) == father){
 						nbro++;
 					}
 				}
@@ -2092,7 +2004,7 @@ LocalTree::preBalance21(u32vector& newmodified){
 			else{
 				if (idx<=last_idx){
 					m_octants[idx].setMarker(0);
-					m_octants[idx].m_info[15]=true;
+					m_octants[idx].setInfo(15, true);
 					Bdone=true;
 					newmodified.push_back(idx);
 				}
@@ -2103,491 +2015,243 @@ LocalTree::preBalance21(u32vector& newmodified){
 
 // =================================================================================== //
 
-/*! 2:1 balancing on level a local tree already adapted (balance only the octants with info[15] = false) (refinement wins!)
- * \param[in] doInterior Set to false if the interior octants are already balanced.
- * \return True if balanced done with some markers modification.
+/*! Check the 2:1 balance of an octant (or ghost octant) with respect to its neighbours
+ * and collect the new target levels (level+marker) needed to fix it. The octants
+ * are not modified, so that several sources can be checked concurrently.
+ * \param[in] idx Local index of the source octant (index in ghosts if isGhostSource).
+ * \param[in] isGhostSource True if the source is a ghost octant: only the local
+ * neighbours through the process boundaries are checked and refined.
+ * \param[in] checkGhosts If true the faces not on the domain boundary are checked and
+ * the source is refined to balance its ghost neighbours, otherwise only the faces
+ * not on a process boundary and the local neighbours are checked.
+ * \param[in,out] neigh Work vector for the neighbours.
+ * \param[in,out] isghost Work vector for the identity of the neighbours.
+ * \param[out] proposals Pairs (local index, target level) appended for each octant
+ * whose marker has to be increased.
  */
-bool
-LocalTree::localBalance(bool doInterior){
+void
+LocalTree::checkBalance(uint32_t idx, bool isGhostSource, bool checkGhosts, u32vector & neigh,
+		vector<bool> & isghost, vector<pair<uint32_t, int8_t> > & proposals){
 
-	uint32_t			sizeneigh, modsize;
-	u32vector		 	neigh;
-	u32vector		 	modified, newmodified;
-	uint32_t 			i, idx;
-	uint8_t				iface, iedge, inode;
-	int8_t				targetmarker;
-	vector<bool> 		isghost;
-	bool				Bdone = false;
+	uint32_t			sizeneigh, i;
+	uint8_t				ientity, nentities, iface, codim;
+	int8_t				targetmarker, neighmarker;
 	bool				Bedge = ((m_balanceCodim>1) && (m_dim==3));
 	bool				Bnode = (m_balanceCodim==m_dim);
 
-	octvector::iterator 	obegin, oend, it;
-	u32vector::iterator 	ibegin, iend, iit;
+	const Octant & source = (isGhostSource ? m_ghosts[idx] : m_octants[idx]);
+	targetmarker = min(m_global.m_maxLevel, int8_t(source.getLevel() + source.getMarker()));
+
+	// Faces, edges (if balanced through edges in 3D) and nodes (if balanced through nodes)
+	nentities = m_global.m_nfaces + m_global.m_nedges + m_global.m_nnodes;
+	for (ientity=0; ientity<nentities; ientity++){
+		if (ientity < m_global.m_nfaces){
+			iface = ientity;
+			codim = 1;
+			if (isGhostSource){
+				if (!source.getPbound(iface)) continue;
+			}
+			else if (checkGhosts){
+				if (source.getBound(iface)) continue;
+			}
+			else{
+				if (source.getPbound(iface)) continue;
+			}
+		}
+		else if (ientity < m_global.m_nfaces + m_global.m_nedges){
+			if (!Bedge) continue;
+			iface = ientity - m_global.m_nfaces;
+			codim = 2;
+		}
+		else{
+			if (!Bnode) continue;
+			iface = ientity - m_global.m_nfaces - m_global.m_nedges;
+			codim = m_dim;
+		}
 
-	//If interior octants have to be balanced
-	if(doInterior){
-		// First loop on the octants
-		obegin = m_octants.begin();
-		oend = m_octants.end();
-		idx = 0;
-		for (it=obegin; it!=oend; it++){
-			if (!it->getNotBalance() && it->getMarker() != 0){
-				targetmarker = min(m_global.m_maxLevel, int8_t(m_octants[idx].getLevel() + m_octants[idx].getMarker()));
-
-				//Balance through faces
-				for (iface=0; iface<m_global.m_nfaces; iface++){
-					if(!it->getBound(iface)){
-						findNeighbours(idx, iface, neigh, isghost);
-						sizeneigh = neigh.size();
-						for(i=0; i<sizeneigh; i++){
-							if (!isghost[i]){
-								{
-									if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) > (targetmarker + 1) ){
-										m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-										m_octants[idx].m_info[15] = true;
-										modified.push_back(idx);
-										Bdone = true;
-									}
-									else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-										m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-										m_octants[neigh[i]].m_info[15] = true;
-										modified.push_back(neigh[i]);
-										Bdone = true;
-									}
-								};
-							}
-							else{
-								{
-									if((m_ghosts[neigh[i]].getLevel() + m_ghosts[neigh[i]].getMarker()) > (targetmarker + 1) ){
-										m_octants[idx].setMarker(m_ghosts[neigh[i]].getLevel()+m_ghosts[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-										m_octants[idx].m_info[15] = true;
-										modified.push_back(idx);
-										Bdone = true;
-									}
-								};
-							}
-						}
-					}
-				}
+		if (isGhostSource){
+			if (codim == 1){
+				findGhostNeighbours(idx, iface, neigh);
+			}
+			else if (codim == m_dim){
+				findGhostNodeNeighbours(idx, iface, neigh);
+			}
+			else{
+				findGhostEdgeNeighbours(idx, iface, neigh);
+			}
+			isghost.assign(neigh.size(), false);
+		}
+		else if (!findCachedNeighbours(idx, iface, codim, neigh, isghost)){
+			if (codim == 1){
+				findNeighbours(idx, iface, neigh, isghost);
+			}
+			else if (codim == m_dim){
+				findNodeNeighbours(idx, iface, neigh, isghost);
+			}
+			else{
+				findEdgeNeighbours(idx, iface, neigh, isghost);
+			}
+		}
 
-				if (Bedge){
-					//Balance through edges
-					for (iedge=0; iedge<m_global.m_nedges; iedge++){
-						//if(!it->getBound(m_global.m_edgeFace[iedge][0]) && !it->getBound(m_global.m_edgeFace[iedge][1])){
-							findEdgeNeighbours(idx, iedge, neigh, isghost);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if (!isghost[i]){
-									{
-										if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) > (targetmarker + 1) ){
-											m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-											m_octants[idx].m_info[15] = true;
-											modified.push_back(idx);
-											Bdone = true;
-										}
-										else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-											m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-											m_octants[neigh[i]].m_info[15] = true;
-											modified.push_back(neigh[i]);
-											Bdone = true;
-										}
-									};
-								}
-								else{
-									if((m_ghosts[neigh[i]].getLevel() + m_ghosts[neigh[i]].getMarker()) > (targetmarker + 1) ){
-										m_octants[idx].setMarker(m_ghosts[neigh[i]].getLevel()+m_ghosts[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-										m_octants[idx].m_info[15] = true;
-										modified.push_back(idx);
-										Bdone = true;
-									}
-								}
-							}
-						//}
-					}
+		sizeneigh = neigh.size();
+		for(i=0; i<sizeneigh; i++){
+			if (!isghost[i]){
+				const Octant & neighbour = m_octants[neigh[i]];
+				neighmarker = neighbour.getLevel() + neighbour.getMarker();
+				if (!isGhostSource && neighmarker > (targetmarker + 1)){
+					proposals.push_back(pair<uint32_t, int8_t>(idx, neighmarker - 1));
 				}
-
-				if (Bnode){
-					//Balance through nodes
-					for (inode=0; inode<m_global.m_nnodes; inode++){
-						//if(!it->getBound(m_global.m_nodeFace[inode][0]) && !it->getBound(m_global.m_nodeFace[inode][1]) && !it->getBound(m_global.m_nodeFace[inode][m_dim-1])){
-							findNodeNeighbours(idx, inode, neigh, isghost);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if (!isghost[i]){
-									{
-										if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) > (targetmarker + 1) ){
-											m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-											m_octants[idx].m_info[15] = true;
-											modified.push_back(idx);
-											Bdone = true;
-										}
-										else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-											m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-											m_octants[neigh[i]].m_info[15] = true;
-											modified.push_back(neigh[i]);
-											Bdone = true;
-										}
-									};
-								}
-								else{
-									if((m_ghosts[neigh[i]].getLevel() + m_ghosts[neigh[i]].getMarker()) > (targetmarker + 1) ){
-										m_octants[idx].setMarker(m_ghosts[neigh[i]].getLevel()+m_ghosts[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-										m_octants[idx].m_info[15] = true;
-										modified.push_back(idx);
-										Bdone = true;
-									}
-								}
-							}
-						//}
-					}
+				else if (neighmarker < (targetmarker - 1)){
+					proposals.push_back(pair<uint32_t, int8_t>(neigh[i], targetmarker - 1));
 				}
-
 			}
-			idx++;
-		}
-		// Loop on ghost octants (influence over interior borders)
-		obegin = m_ghosts.begin();
-		oend = m_ghosts.end();
-		idx = 0;
-		for (it=obegin; it!=oend; it++){
-			if (!it->getNotBalance() && it->getMarker() != 0){
-				targetmarker = min(m_global.m_maxLevel, int8_t(it->getLevel()+it->getMarker()));
-
-				//Balance through faces
-				for (iface=0; iface<m_global.m_nfaces; iface++){
-					if(it->getPbound(iface) == true){
-						neigh.clear();
-						findGhostNeighbours(idx, iface, neigh);
-						sizeneigh = neigh.size();
-						for(i=0; i<sizeneigh; i++){
-							if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-								m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-								m_octants[neigh[i]].m_info[15] = true;
-								modified.push_back(neigh[i]);
-								Bdone = true;
-							}
-						}
-					}
-				}
-
-				if (Bedge){
-					//Balance through edges
-					for (iedge=0; iedge<m_global.m_nedges; iedge++){
-						//if(it->getPbound(m_global.m_edgeFace[iedge][0]) == true || it->getPbound(m_global.m_edgeFace[iedge][1]) == true){
-							neigh.clear();
-							findGhostEdgeNeighbours(idx, iedge, neigh);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-									m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-									m_octants[neigh[i]].m_info[15] = true;
-									modified.push_back(neigh[i]);
-									Bdone = true;
-								}
-							}
-						//}
-					}
+			else if (checkGhosts){
+				const Octant & neighbour = m_ghosts[neigh[i]];
+				neighmarker = neighbour.getLevel() + neighbour.getMarker();
+				if (neighmarker > (targetmarker + 1)){
+					proposals.push_back(pair<uint32_t, int8_t>(idx, neighmarker - 1));
 				}
+			}
+		}
+	}
+};
 
-				if (Bnode){
-					//Balance through nodes
-					for (inode=0; inode<m_global.m_nnodes; inode++){
-						//if(it->getPbound(m_global.m_nodeFace[inode][0]) == true || it->getPbound(m_global.m_nodeFace[inode][1]) == true || it->getPbound(m_global.m_nodeFace[inode][m_dim-1]) == true){
-							neigh.clear();
-							findGhostNodeNeighbours(idx, inode, neigh);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-									m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-									m_octants[neigh[i]].m_info[15] = true;
-									modified.push_back(neigh[i]);
-									Bdone = true;
-								}
-							}
-						//}
-					}
-				}
+/*! Balancing sweep: check the 2:1 balance of a set of local and ghost source octants
+ * and increase the markers of the unbalanced local octants.
+ * The sources are checked concurrently (if OpenMP is enabled) against the markers
+ * at the beginning of the sweep; the target levels proposed by the threads are then
+ * merged keeping the finest one for each octant, so the result does not depend on
+ * the number of threads.
+ * \param[in] sources Local indices of the source octants.
+ * \param[in] ghostSources Indices of the source ghost octants.
+ * \param[in] checkGhosts If true the sources are checked also against their ghost
+ * neighbours (see checkBalance).
+ * \param[out] modified Sorted local indices of the octants whose marker is increased.
+ * \return True if some marker is modified.
+ */
+bool
+LocalTree::balanceSweep(const u32vector & sources, const u32vector & ghostSources, bool checkGhosts, u32vector & modified){
+
+	typedef vector<pair<uint32_t, int8_t> > proposalvector;
+
+	uint32_t 				nsources = sources.size();
+	uint32_t 				nall = nsources + ghostSources.size();
+	int 					nthreads = 1;
+#ifdef _OPENMP
+	nthreads = omp_get_max_threads();
+#endif
+
+	vector<proposalvector> 	threadProposals(nthreads);
+#pragma omp parallel if (nall > 256)
+	{
+		int ithread = 0;
+#ifdef _OPENMP
+		ithread = omp_get_thread_num();
+#endif
+		proposalvector & proposals = threadProposals[ithread];
+		u32vector 		neigh;
+		vector<bool> 	isghost;
+
+#pragma omp for schedule(dynamic, 64)
+		for (uint32_t k = 0; k < nall; k++){
+			if (k < nsources){
+				checkBalance(sources[k], false, checkGhosts, neigh, isghost, proposals);
+			}
+			else{
+				checkBalance(ghostSources[k-nsources], true, checkGhosts, neigh, isghost, proposals);
+			}
+		}
+	}
 
+	// Merge the proposals keeping the finest target level
+	modified.clear();
+	for (int ithread = 0; ithread < nthreads; ithread++){
+		proposalvector & proposals = threadProposals[ithread];
+		for (size_t k = 0; k < proposals.size(); k++){
+			Octant & octant = m_octants[proposals[k].first];
+			int8_t targetmarker = proposals[k].second;
+			if (targetmarker > min(m_global.m_maxLevel, int8_t(octant.getLevel() + octant.getMarker()))){
+				octant.setMarker(targetmarker - octant.getLevel());
+				octant.setInfo(15, true);
+				modified.push_back(proposals[k].first);
 			}
-			idx++;
 		}
+		proposalvector().swap(proposals);
+	}
+	sort(modified.begin(), modified.end());
+	modified.erase(unique(modified.begin(), modified.end()), modified.end());
 
-		// While loop for iterative balancing
-		u32vector().swap(newmodified);
-		modsize = modified.size();
-		while(modsize!=0){
-			ibegin = modified.begin();
-			iend = modified.end();
-			for (iit=ibegin; iit!=iend; iit++){
-				idx = *iit;
-				if (!m_octants[idx].getNotBalance()){
-					targetmarker = min(m_global.m_maxLevel, int8_t(m_octants[idx].getLevel()+m_octants[idx].getMarker()));
-
-					//Balance through faces
-					for (iface=0; iface<m_global.m_nfaces; iface++){
-						if(!m_octants[idx].getPbound(iface)){
-							findNeighbours(idx, iface, neigh, isghost);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if (!isghost[i]){
-									{
-										if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-											m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-											m_octants[idx].m_info[15] = true;
-											newmodified.push_back(idx);
-											Bdone = true;
-										}
-										else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-											m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-											m_octants[neigh[i]].m_info[15] = true;
-											newmodified.push_back(neigh[i]);
-											Bdone = true;
-										}
-									};
-								}
-							}
-						}
-					}
+	return (modified.size() > 0);
+};
 
-					if (Bedge){
-						//Balance through edges
-						for (iedge=0; iedge<m_global.m_nedges; iedge++){
-							//if(!m_octants[idx].getPbound(m_global.m_edgeFace[iedge][0]) || !m_octants[idx].getPbound(m_global.m_edgeFace[iedge][1])){
-								findEdgeNeighbours(idx, iedge, neigh, isghost);
-								sizeneigh = neigh.size();
-								for(i=0; i<sizeneigh; i++){
-									if (!isghost[i]){
-										{
-											if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-												m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-												m_octants[idx].m_info[15] = true;
-												newmodified.push_back(idx);
-												Bdone = true;
-											}
-											else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-												m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-												m_octants[neigh[i]].m_info[15] = true;
-												newmodified.push_back(neigh[i]);
-												Bdone = true;
-											}
-										};
-									}
-								}
-							//}
-						}
-					}
+/*! Iterative 2:1 balancing of the octants modified by a first balancing sweep:
+ * the neighbours of the modified octants are balanced until no marker changes.
+ * \param[in,out] modified Local indices of the octants modified by the first sweep (empty on exit).
+ * \return True if some marker is modified.
+ */
+bool
+LocalTree::balanceModified(u32vector & modified){
 
-					if (Bnode){
-						//Balance through nodes
-						for (inode=0; inode<m_global.m_nnodes; inode++){
-							//if(!m_octants[idx].getPbound(m_global.m_nodeFace[inode][0]) || !m_octants[idx].getPbound(m_global.m_nodeFace[inode][1]) || !m_octants[idx].getPbound(m_global.m_nodeFace[inode][m_dim-1])){
-								findNodeNeighbours(idx, inode, neigh, isghost);
-								sizeneigh = neigh.size();
-								for(i=0; i<sizeneigh; i++){
-									if (!isghost[i]){
-										{
-											if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-												m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-												m_octants[idx].m_info[15] = true;
-												newmodified.push_back(idx);
-												Bdone = true;
-											}
-											else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-												m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-												m_octants[neigh[i]].m_info[15] = true;
-												newmodified.push_back(neigh[i]);
-												Bdone = true;
-											}
-										};
-									}
-								}
-							//}
-						}
-					}
+	u32vector 	sources, newmodified;
+	bool		Bdone = false;
 
-				}
+	while(modified.size() != 0){
+		sources.clear();
+		for (size_t k = 0; k < modified.size(); k++){
+			if (!m_octants[modified[k]].getNotBalance()){
+				sources.push_back(modified[k]);
 			}
-			preBalance21(newmodified);
-			u32vector().swap(modified);
-			swap(modified,newmodified);
-			modsize = modified.size();
-			u32vector().swap(newmodified);
-		}// end while
-
+		}
+		Bdone |= balanceSweep(sources, u32vector(), false, newmodified);
+		preBalance21(newmodified);
+		sort(newmodified.begin(), newmodified.end());
+		newmodified.erase(unique(newmodified.begin(), newmodified.end()), newmodified.end());
+		swap(modified, newmodified);
 	}
-	else{
+	u32vector().swap(newmodified);
 
-		// Loop on ghost octants (influence over interior borders)
-		obegin = m_ghosts.begin();
-		oend = m_ghosts.end();
-		idx = 0;
-		for (it=obegin; it!=oend; it++){
-			if (!it->getNotBalance() && it->m_info[15]){
-				targetmarker = min(m_global.m_maxLevel, int8_t(it->getLevel()+it->getMarker()));
-
-				//Balance through faces
-				for (iface=0; iface<m_global.m_nfaces; iface++){
-					if(it->getPbound(iface) == true){
-						neigh.clear();
-						findGhostNeighbours(idx, iface, neigh);
-						sizeneigh = neigh.size();
-						for(i=0; i<sizeneigh; i++){
-							if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-								m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-								m_octants[neigh[i]].m_info[15] = true;
-								modified.push_back(neigh[i]);
-								Bdone = true;
-							}
-						}
-					}
-				}
+	return Bdone;
+};
 
-				if (Bedge){
-					//Balance through edges
-					for (iedge=0; iedge<m_global.m_nedges; iedge++){
-						//if(it->getPbound(m_global.m_edgeFace[iedge][0]) == true || it->getPbound(m_global.m_edgeFace[iedge][1]) == true){
-							neigh.clear();
-							findGhostEdgeNeighbours(idx, iedge, neigh);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-									m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-									m_octants[neigh[i]].m_info[15] = true;
-									modified.push_back(neigh[i]);
-									Bdone = true;
-								}
-							}
-						//}
-					}
-				}
+/*! 2:1 balancing on level a local tree already adapted (balance only the octants with info[15] = false) (refinement wins!)
+ * \param[in] doInterior Set to false if the interior octants are already balanced.
+ * \return True if balanced done with some markers modification.
+ */
+bool
+LocalTree::localBalance(bool doInterior){
 
-				if (Bnode){
-					//Balance through nodes
-					for (inode=0; inode<m_global.m_nnodes; inode++){
-						//if(it->getPbound(m_global.m_nodeFace[inode][0]) == true || it->getPbound(m_global.m_nodeFace[inode][1]) == true || it->getPbound(m_global.m_nodeFace[inode][m_dim-1]) == true){
-							neigh.clear();
-							findGhostNodeNeighbours(idx, inode, neigh);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-									m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-									m_octants[neigh[i]].m_info[15] = true;
-									modified.push_back(neigh[i]);
-									Bdone = true;
-								}
-							}
-						//}
-					}
-				}
+	u32vector		 	sources, ghostSources, modified;
+	uint32_t 			idx;
+	bool				Bdone = false;
 
+	//If interior octants have to be balanced
+	if(doInterior){
+		// Sources: octants with a marker, and ghost octants with a marker (influence over interior borders)
+		for (idx=0; idx<m_octants.size(); idx++){
+			if (!m_octants[idx].getNotBalance() && m_octants[idx].getMarker() != 0){
+				sources.push_back(idx);
 			}
-			idx++;
 		}
+		for (idx=0; idx<m_ghosts.size(); idx++){
+			if (!m_ghosts[idx].getNotBalance() && m_ghosts[idx].getMarker() != 0){
+				ghostSources.push_back(idx);
+			}
+		}
+	}
+	else{
+		// Sources: ghost octants modified by the balance of their process (influence over interior borders)
+		for (idx=0; idx<m_ghosts.size(); idx++){
+			if (!m_ghosts[idx].getNotBalance() && m_ghosts[idx].getInfo(15)){
+				ghostSources.push_back(idx);
+			}
+		}
+	}
 
-		// While loop for iterative balancing
-		u32vector().swap(newmodified);
-		modsize = modified.size();
-		while(modsize!=0){
-			ibegin = modified.begin();
-			iend = modified.end();
-			for (iit=ibegin; iit!=iend; iit++){
-				idx = *iit;
-				if (!m_octants[idx].getNotBalance()){
-					targetmarker = min(m_global.m_maxLevel, int8_t(m_octants[idx].getLevel()+m_octants[idx].getMarker()));
-
-					//Balance through faces
-					for (iface=0; iface<m_global.m_nfaces; iface++){
-						if(!m_octants[idx].getPbound(iface)){
-							findNeighbours(idx, iface, neigh, isghost);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if (!isghost[i]){
-									{
-										if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-											m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-											m_octants[idx].m_info[15] = true;
-											newmodified.push_back(idx);
-											Bdone = true;
-										}
-										else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-											m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-											m_octants[neigh[i]].m_info[15] = true;
-											newmodified.push_back(neigh[i]);
-											Bdone = true;
-										}
-									};
-								}
-							}
-						}
-					}
-
-					if (Bedge){
-						//Balance through edges
-						for (iedge=0; iedge<m_global.m_nedges; iedge++){
-							//if(!m_octants[idx].getPbound(m_global.m_edgeFace[iedge][0]) || !m_octants[idx].getPbound(m_global.m_edgeFace[iedge][1])){
-								findEdgeNeighbours(idx, iedge, neigh, isghost);
-								sizeneigh = neigh.size();
-								for(i=0; i<sizeneigh; i++){
-									if (!isghost[i]){
-										{
-											if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-												m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-												m_octants[idx].m_info[15] = true;
-												newmodified.push_back(idx);
-												Bdone = true;
-											}
-											else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-												m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-												m_octants[neigh[i]].m_info[15] = true;
-												newmodified.push_back(neigh[i]);
-												Bdone = true;
-											}
-										};
-									}
-								}
-							//}
-						}
-					}
+	Bdone = balanceSweep(sources, ghostSources, true, modified);
 
-					if (Bnode){
-						//Balance through nodes
-						for (inode=0; inode<m_global.m_nnodes; inode++){
-							//if(!m_octants[idx].getPbound(m_global.m_nodeFace[inode][0]) || !m_octants[idx].getPbound(m_global.m_nodeFace[inode][1]) || !m_octants[idx].getPbound(m_global.m_nodeFace[inode][m_dim-1])){
-								findNodeNeighbours(idx, inode, neigh, isghost);
-								sizeneigh = neigh.size();
-								for(i=0; i<sizeneigh; i++){
-									if (!isghost[i]){
-										{
-											if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-												m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-												m_octants[idx].m_info[15] = true;
-												newmodified.push_back(idx);
-												Bdone = true;
-											}
-											else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-												m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-												m_octants[neigh[i]].m_info[15] = true;
-												newmodified.push_back(neigh[i]);
-												Bdone = true;
-											}
-										};
-									}
-								}
-							//}
-						}
-					}
+	// Iterative balancing
+	Bdone |= balanceModified(modified);
 
-				}
-			}
-			preBalance21(newmodified);
-			u32vector().swap(modified);
-			swap(modified,newmodified);
-			modsize = modified.size();
-			u32vector().swap(newmodified);
-		}// end while
-		obegin = oend = m_octants.end();
-		ibegin = iend = modified.end();
-	}
 	return Bdone;
 	// Pay attention : info[15] may be true after local balance for some octants
 };
@@ -2600,489 +2264,64 @@ LocalTree::localBalance(bool doInterior){
  */
 bool
 LocalTree::localBalanceAll(bool doInterior){
-	// Local variables
-	uint32_t			sizeneigh, modsize;
-	u32vector		 	neigh;
-	u32vector		 	modified, newmodified;
-	uint32_t 			i, idx;
-	uint8_t				iface, iedge, inode;
-	int8_t				targetmarker;
-	vector<bool> 		isghost;
-	bool				Bdone = false;
-	bool				Bedge = ((m_balanceCodim>1) && (m_dim==3));
-	bool				Bnode = (m_balanceCodim==m_dim);
-
-	octvector::iterator 	obegin, oend, it;
-	u32vector::iterator 	ibegin, iend, iit;
 
+	u32vector		 	sources, ghostSources, modified;
+	uint32_t 			idx;
+	bool				Bdone = false;
 
 	//If interior octants have to be balanced
 	if(doInterior){
-		// First loop on the octants
-		obegin = m_octants.begin();
-		oend = m_octants.end();
-		idx = 0;
-		for (it=obegin; it!=oend; it++){
-			if ((!it->getNotBalance()) && ((it->m_info[15]) || (it->getMarker()!=0) || ((it->getIsNewC()) || (it->getIsNewR())))){
-				targetmarker = min(m_global.m_maxLevel, int8_t(m_octants[idx].getLevel() + m_octants[idx].getMarker()));
-
-				//Balance through faces
-				for (iface=0; iface<m_global.m_nfaces; iface++){
-					if(!it->getBound(iface)){
-						findNeighbours(idx, iface, neigh, isghost);
-						sizeneigh = neigh.size();
-						for(i=0; i<sizeneigh; i++){
-							if (!isghost[i]){
-								{
-									if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) > (targetmarker + 1) ){
-										m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-										m_octants[idx].m_info[15] = true;
-										modified.push_back(idx);
-										Bdone = true;
-									}
-									else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-										m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-										m_octants[neigh[i]].m_info[15] = true;
-										modified.push_back(neigh[i]);
-										Bdone = true;
-									}
-								};
-							}
-							else{
-								{
-									if((m_ghosts[neigh[i]].getLevel() + m_ghosts[neigh[i]].getMarker()) > (targetmarker + 1) ){
-										m_octants[idx].setMarker(m_ghosts[neigh[i]].getLevel()+m_ghosts[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-										m_octants[idx].m_info[15] = true;
-										modified.push_back(idx);
-										Bdone = true;
-									}
-								};
+		// Sources: octants with a marker or new/modified octants, and new or modified ghost octants
+		for (idx=0; idx<m_octants.size(); idx++){
+			const Octant & octant = m_octants[idx];
+			if (!octant.getNotBalance() && (octant.getInfo(15) || octant.getMarker() != 0 || octant.getIsNewC() || octant.getIsNewR())){
+				sources.push_back(idx);
+			}
+		}
+	}
+	// Ghost octants new or modified (influence over interior borders)
+	for (idx=0; idx<m_ghosts.size(); idx++){
+		const Octant & ghost = m_ghosts[idx];
+		if (!ghost.getNotBalance() && (ghost.getInfo(15) || ghost.getIsNewC() || ghost.getIsNewR())){
+			ghostSources.push_back(idx);
+		}
+	}
 
-							}
-						}
-					}
-				}
+	Bdone = balanceSweep(sources, ghostSources, true, modified);
 
-				if (Bedge){
-					//Balance through edges
-					for (iedge=0; iedge<m_global.m_nedges; iedge++){
-						//if(!it->getBound(m_global.m_edgeFace[iedge][0]) && !it->getBound(m_global.m_edgeFace[iedge][1])){
-							findEdgeNeighbours(idx, iedge, neigh, isghost);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if (!isghost[i]){
-									{
-										if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) > (targetmarker + 1) ){
-											m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-											m_octants[idx].m_info[15] = true;
-											modified.push_back(idx);
-											Bdone = true;
-										}
-										else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-											m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-											m_octants[neigh[i]].m_info[15] = true;
-											modified.push_back(neigh[i]);
-											Bdone = true;
-										}
-									};
-								}
-								else{
-									if((m_ghosts[neigh[i]].getLevel() + m_ghosts[neigh[i]].getMarker()) > (targetmarker + 1) ){
-										m_octants[idx].setMarker(m_ghosts[neigh[i]].getLevel()+m_ghosts[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-										m_octants[idx].m_info[15] = true;
-										modified.push_back(idx);
-										Bdone = true;
-									}
-								}
-							}
-						//}
-					}
-				}
+	// Iterative balancing
+	Bdone |= balanceModified(modified);
 
-				if (Bnode){
-					//Balance through nodes
-					for (inode=0; inode<m_global.m_nnodes; inode++){
-						//if(!it->getBound(m_global.m_nodeFace[inode][0]) && !it->getBound(m_global.m_nodeFace[inode][1]) && !it->getBound(m_global.m_nodeFace[inode][m_dim-1])){
-							findNodeNeighbours(idx, inode, neigh, isghost);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if (!isghost[i]){
-									{
-										if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) > (targetmarker + 1) ){
-											m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-											m_octants[idx].m_info[15] = true;
-											modified.push_back(idx);
-											Bdone = true;
-										}
-										else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-											m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-											m_octants[neigh[i]].m_info[15] = true;
-											modified.push_back(neigh[i]);
-											Bdone = true;
-										}
-									};
-								}
-								else{
-									if((m_ghosts[neigh[i]].getLevel() + m_ghosts[neigh[i]].getMarker()) > (targetmarker + 1) ){
-										m_octants[idx].setMarker(m_ghosts[neigh[i]].getLevel()+m_ghosts[neigh[i]].getMarker()-1-m_octants[idx].getLevel());
-										m_octants[idx].m_info[15] = true;
-										modified.push_back(idx);
-										Bdone = true;
-									}
-								}
-							}
-						//}
-					}
-				}
+	return Bdone;
+	// Pay attention : info[15] may be true after local balance for some octants
+};
 
-			}
-			idx++;
-		}
-		// Loop on ghost octants (influence over interior borders)
-		obegin = m_ghosts.begin();
-		oend = m_ghosts.end();
-		idx = 0;
-		for (it=obegin; it!=oend; it++){
-			if (!it->getNotBalance() && (it->m_info[15] || (it->getIsNewC() || it->getIsNewR()))){
-				targetmarker = min(m_global.m_maxLevel, int8_t(it->getLevel()+it->getMarker()));
-
-				//Balance through faces
-				for (iface=0; iface<m_global.m_nfaces; iface++){
-					if(it->getPbound(iface) == true){
-						neigh.clear();
-						findGhostNeighbours(idx, iface, neigh);
-						sizeneigh = neigh.size();
-						for(i=0; i<sizeneigh; i++){
-							if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-								m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-								m_octants[neigh[i]].m_info[15] = true;
-								modified.push_back(neigh[i]);
-								Bdone = true;
-							}
-						}
-					}
-				}
+// =================================================================================== //
 
-				if (Bedge){
-					//Balance through edges
-					for (iedge=0; iedge<m_global.m_nedges; iedge++){
-						//if(it->getPbound(m_global.m_edgeFace[iedge][0]) == true || it->getPbound(m_global.m_edgeFace[iedge][1]) == true){
-							neigh.clear();
-							findGhostEdgeNeighbours(idx, iedge, neigh);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-									m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-									m_octants[neigh[i]].m_info[15] = true;
-									modified.push_back(neigh[i]);
-									Bdone = true;
-								}
-							}
-						//}
-					}
-				}
+/*! 2:1 balancing of the local octants adjacent to a set of ghost octants whose marker
+ * is changed (refinement wins!). Only the neighbours of the given ghosts and the octants
+ * modified in turn are visited, so the cost is proportional to the refinement front.
+ * \param[in] ghostSources Indices of the ghost octants whose marker is changed.
+ * \return True if balanced done with some markers modification.
+ */
+bool
+LocalTree::localBalanceGhosts(const u32vector & ghostSources){
 
-				if (Bnode){
-					//Balance through nodes
-					for (inode=0; inode<m_global.m_nnodes; inode++){
-						//if(it->getPbound(m_global.m_nodeFace[inode][0]) == true || it->getPbound(m_global.m_nodeFace[inode][1]) == true || it->getPbound(m_global.m_nodeFace[inode][m_dim-1]) == true){
-							neigh.clear();
-							findGhostNodeNeighbours(idx, inode, neigh);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-									m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-									m_octants[neigh[i]].m_info[15] = true;
-									modified.push_back(neigh[i]);
-									Bdone = true;
-								}
-							}
-						//}
-					}
-				}
+	u32vector		 	sources, modified;
+	bool				Bdone = false;
 
-			}
-			idx++;
+	for (size_t k=0; k<ghostSources.size(); k++){
+		if (!m_ghosts[ghostSources[k]].getNotBalance()){
+			sources.push_back(ghostSources[k]);
 		}
+	}
 
-		// While loop for iterative balancing
-		u32vector().swap(newmodified);
-		modsize = modified.size();
-		while(modsize!=0){
-			ibegin = modified.begin();
-			iend = modified.end();
-			for (iit=ibegin; iit!=iend; iit++){
-				idx = *iit;
-				if (!m_octants[idx].getNotBalance()){
-					targetmarker = min(m_global.m_maxLevel, int8_t(m_octants[idx].getLevel()+m_octants[idx].getMarker()));
-
-					//Balance through faces
-					for (iface=0; iface<m_global.m_nfaces; iface++){
-						if(!m_octants[idx].getPbound(iface)){
-							findNeighbours(idx, iface, neigh, isghost);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if (!isghost[i]){
-									{
-										if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-											m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-											m_octants[idx].m_info[15] = true;
-											newmodified.push_back(idx);
-											Bdone = true;
-										}
-										else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-											m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-											m_octants[neigh[i]].m_info[15] = true;
-											newmodified.push_back(neigh[i]);
-											Bdone = true;
-										}
-									};
-								}
-							}
-						}
-					}
+	Bdone = balanceSweep(u32vector(), sources, true, modified);
 
-					if (Bedge){
-						//Balance through edges
-						for (iedge=0; iedge<m_global.m_nedges; iedge++){
-							//if(!m_octants[idx].getPbound(m_global.m_edgeFace[iedge][0]) || !m_octants[idx].getPbound(m_global.m_edgeFace[iedge][1])){
-								findEdgeNeighbours(idx, iedge, neigh, isghost);
-								sizeneigh = neigh.size();
-								for(i=0; i<sizeneigh; i++){
-									if (!isghost[i]){
-										{
-											if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-												m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-												m_octants[idx].m_info[15] = true;
-												newmodified.push_back(idx);
-												Bdone = true;
-											}
-											else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-												m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-												m_octants[neigh[i]].m_info[15] = true;
-												newmodified.push_back(neigh[i]);
-												Bdone = true;
-											}
-										};
-									}
-								}
-							//}
-						}
-					}
-
-					if (Bnode){
-						//Balance through nodes
-						for (inode=0; inode<m_global.m_nnodes; inode++){
-							//if(!m_octants[idx].getPbound(m_global.m_nodeFace[inode][0]) || !m_octants[idx].getPbound(m_global.m_nodeFace[inode][1]) || !m_octants[idx].getPbound(m_global.m_nodeFace[inode][m_dim-1])){
-								findNodeNeighbours(idx, inode, neigh, isghost);
-								sizeneigh = neigh.size();
-								for(i=0; i<sizeneigh; i++){
-									if (!isghost[i]){
-										{
-											if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-												m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-												m_octants[idx].m_info[15] = true;
-												newmodified.push_back(idx);
-												Bdone = true;
-											}
-											else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-												m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-												m_octants[neigh[i]].m_info[15] = true;
-												newmodified.push_back(neigh[i]);
-												Bdone = true;
-											}
-										};
-									}
-								}
-							//}
-						}
-					}
-
-				}
-			}
-			preBalance21(newmodified);
-			u32vector().swap(modified);
-			swap(modified,newmodified);
-			modsize = modified.size();
-			u32vector().swap(newmodified);
-		}// end while
-
-	}
-	else{
-
-		// Loop on ghost octants (influence over interior borders)
-		obegin = m_ghosts.begin();
-		oend = m_ghosts.end();
-		idx = 0;
-		for (it=obegin; it!=oend; it++){
-			if (!it->getNotBalance() && (it->m_info[15] || (it->getIsNewC() || it->getIsNewR()))){
-				targetmarker = min(m_global.m_maxLevel, int8_t(it->getLevel()+it->getMarker()));
-
-				//Balance through faces
-				for (iface=0; iface<m_global.m_nfaces; iface++){
-					if(it->getPbound(iface) == true){
-						neigh.clear();
-						findGhostNeighbours(idx, iface, neigh);
-						sizeneigh = neigh.size();
-						for(i=0; i<sizeneigh; i++){
-							if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-								m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-								m_octants[neigh[i]].m_info[15] = true;
-								modified.push_back(neigh[i]);
-								Bdone = true;
-							}
-						}
-					}
-				}
-
-				if (Bedge){
-					//Balance through edges
-					for (iedge=0; iedge<m_global.m_nedges; iedge++){
-						//if(it->getPbound(m_global.m_edgeFace[iedge][0]) == true || it->getPbound(m_global.m_edgeFace[iedge][1]) == true){
-							neigh.clear();
-							findGhostEdgeNeighbours(idx, iedge, neigh);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-									m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-									m_octants[neigh[i]].m_info[15] = true;
-									modified.push_back(neigh[i]);
-									Bdone = true;
-								}
-							}
-						//}
-					}
-				}
-
-				if (Bnode){
-					//Balance through nodes
-					for (inode=0; inode<m_global.m_nnodes; inode++){
-						//if(it->getPbound(m_global.m_nodeFace[inode][0]) == true || it->getPbound(m_global.m_nodeFace[inode][1]) == true || it->getPbound(m_global.m_nodeFace[inode][m_dim-1]) == true){
-							neigh.clear();
-							findGhostNodeNeighbours(idx, inode, neigh);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-									m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-									m_octants[neigh[i]].m_info[15] = true;
-									modified.push_back(neigh[i]);
-									Bdone = true;
-								}
-							}
-						//}
-					}
-				}
-
-			}
-			idx++;
-		}
-
-		// While loop for iterative balancing
-		u32vector().swap(newmodified);
-		modsize = modified.size();
-		while(modsize!=0){
-			ibegin = modified.begin();
-			iend = modified.end();
-			for (iit=ibegin; iit!=iend; iit++){
-				idx = *iit;
-				if (!m_octants[idx].getNotBalance()){
-					targetmarker = min(m_global.m_maxLevel, int8_t(m_octants[idx].getLevel()+m_octants[idx].getMarker()));
-
-					//Balance through faces
-					for (iface=0; iface<m_global.m_nfaces; iface++){
-						if(!m_octants[idx].getPbound(iface)){
-							findNeighbours(idx, iface, neigh, isghost);
-							sizeneigh = neigh.size();
-							for(i=0; i<sizeneigh; i++){
-								if (!isghost[i]){
-									{
-										if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-											m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-											m_octants[idx].m_info[15] = true;
-											newmodified.push_back(idx);
-											Bdone = true;
-										}
-										else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-											m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-											m_octants[neigh[i]].m_info[15] = true;
-											newmodified.push_back(neigh[i]);
-											Bdone = true;
-										}
-									};
-								}
-							}
-						}
-					}
-
-					if (Bedge){
-						//Balance through edges
-						for (iedge=0; iedge<m_global.m_nedges; iedge++){
-							//if(!m_octants[idx].getPbound(m_global.m_edgeFace[iedge][0]) || !m_octants[idx].getPbound(m_global.m_edgeFace[iedge][1])){
-								findEdgeNeighbours(idx, iedge, neigh, isghost);
-								sizeneigh = neigh.size();
-								for(i=0; i<sizeneigh; i++){
-									if (!isghost[i]){
-										{
-											if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-												m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-												m_octants[idx].m_info[15] = true;
-												newmodified.push_back(idx);
-												Bdone = true;
-											}
-											else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-												m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-												m_octants[neigh[i]].m_info[15] = true;
-												newmodified.push_back(neigh[i]);
-												Bdone = true;
-											}
-										};
-									}
-								}
-							//}
-						}
-					}
-
-					if (Bnode){
-						//Balance through nodes
-						for (inode=0; inode<m_global.m_nnodes; inode++){
-							//if(!m_octants[idx].getPbound(m_global.m_nodeFace[inode][0]) || !m_octants[idx].getPbound(m_global.m_nodeFace[inode][1]) || !m_octants[idx].getPbound(m_global.m_nodeFace[inode][m_dim-1])){
-								findNodeNeighbours(idx, inode, neigh, isghost);
-								sizeneigh = neigh.size();
-								for(i=0; i<sizeneigh; i++){
-									if (!isghost[i]){
-										{
-											if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) >  (targetmarker + 1)){
-												m_octants[idx].setMarker(m_octants[neigh[i]].getLevel()+m_octants[neigh[i]].getMarker()-m_octants[idx].getLevel()-1);
-												m_octants[idx].m_info[15] = true;
-												newmodified.push_back(idx);
-												Bdone = true;
-											}
-											else if((m_octants[neigh[i]].getLevel() + m_octants[neigh[i]].getMarker()) < (targetmarker - 1)){
-												m_octants[neigh[i]].setMarker(targetmarker-m_octants[neigh[i]].getLevel()-1);
-												m_octants[neigh[i]].m_info[15] = true;
-												newmodified.push_back(neigh[i]);
-												Bdone = true;
-											}
-										};
-									}
-								}
-							//}
-						}
-					}
+	// Iterative balancing
+	Bdone |= balanceModified(modified);
 
-				}
-			}
-			preBalance21(newmodified);
-			u32vector().swap(modified);
-			swap(modified,newmodified);
-			modsize = modified.size();
-			u32vector().swap(newmodified);
-		}// end while
-		obegin = oend = m_octants.end();
-		ibegin = iend = modified.end();
-	}
 	return Bdone;
-	// Pay attention : info[15] may be true after local balance for some octants
 };
 
 // =================================================================================== //
@@ -3126,7 +2365,7 @@ LocalTree::findEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neighbour
 	iface2 = m_global.m_edgeFace[iedge][1];
 
 	// Check if octants edge is a boundary
-	if (oct->m_info[iface1] == false && oct->m_info[iface2] == false){
+	if (oct->getInfo(iface1) == false && oct->getInfo(iface2) == false){
 
 		//Build Morton number of virtual neigh of same size
 		Octant samesizeoct(m_dim, oct->m_level, oct->m_x+cx*size, oct->m_y+cy*size, oct->m_z+cz*size, m_global.m_maxLevel);
@@ -3136,31 +2375,12 @@ LocalTree::findEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neighbour
 
 		if (m_ghosts.size()>0){
 			// Search in ghosts
-			uint32_t idxghost = uint32_t(m_sizeGhosts/2);
-			Octant* octghost = &m_ghosts[idxghost];
 
 			// Search morton in octants
 			// If a even face morton is lower than morton of oct, if odd higher
 			// ---> can i search only before or after idx in octants
-			int32_t jump = int32_t(idxghost/2);
-			idxtry = uint32_t(((octghost->computeMorton()<Morton)-(octghost->computeMorton()>Morton))*jump);
-			if (idxtry > m_ghosts.size()-1) idxtry = m_ghosts.size()-1;
-			while(abs(jump) > 0){
-				Mortontry = m_ghosts[idxtry].computeMorton();
-				jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-				idxtry += jump;
-				if (idxtry > m_ghosts.size()-1){
-					if (jump > 0){
-						idxtry = m_ghosts.size() - 1;
-						jump = 0;
-					}
-					else if (jump < 0){
-						idxtry = 0;
-						jump = 0;
-					}
-				}
-			}
-			if(m_ghosts[idxtry].computeMorton() == Morton && m_ghosts[idxtry].m_level == oct->m_level){
+			idxtry = findGhostLowerMorton(Morton);
+			if(m_ghostsMortons[idxtry] == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 				//Found neighbour of same size
 				isghost.push_back(true);
 				neighbours.push_back(idxtry);
@@ -3169,14 +2389,14 @@ LocalTree::findEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neighbour
 			else{
 				// Step until the mortontry lower than morton (one idx of distance)
 				{
-					while(m_ghosts[idxtry].computeMorton() < Morton){
+					while(m_ghostsMortons[idxtry] < Morton){
 						idxtry++;
 						if(idxtry > m_ghosts.size()-1){
 							idxtry = m_ghosts.size()-1;
 							break;
 						}
 					}
-					while(m_ghosts[idxtry].computeMorton() > Morton){
+					while(m_ghostsMortons[idxtry] > Morton){
 						idxtry--;
 						if(idxtry > m_ghosts.size()-1){
 							idxtry = 0;
@@ -3185,16 +2405,16 @@ LocalTree::findEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neighbour
 					}
 				}
 				if(idxtry < m_sizeGhosts){
-					if(m_ghosts[idxtry].computeMorton() == Morton && m_ghosts[idxtry].m_level == oct->m_level){
+					if(m_ghostsMortons[idxtry] == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 						//Found neighbour of same size
 						isghost.push_back(true);
 						neighbours.push_back(idxtry);
 						return;
 					}
 					// Compute Last discendent of virtual octant of same size
-					Octant last_desc = samesizeoct.buildLastDesc();
+					Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 					uint64_t Mortonlast = last_desc.computeMorton();
-					Mortontry = m_ghosts[idxtry].computeMorton();
+					Mortontry = m_ghostsMortons[idxtry];
 					while(Mortontry < Mortonlast && idxtry < m_ghosts.size()){
 						Dx = int32_t(abs(cx))*(-int32_t(oct->m_x) + int32_t(m_ghosts[idxtry].m_x));
 						Dy = int32_t(abs(cy))*(-int32_t(oct->m_y) + int32_t(m_ghosts[idxtry].m_y));
@@ -3237,7 +2457,7 @@ LocalTree::findEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neighbour
 						if(idxtry>m_sizeGhosts-1){
 							break;
 						}
-						Mortontry = m_ghosts[idxtry].computeMorton();
+						Mortontry = m_ghostsMortons[idxtry];
 					}
 				}
 			}
@@ -3249,27 +2469,8 @@ LocalTree::findEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neighbour
 		// Search morton in octants
 		// If a even face morton is lower than morton of oct, if odd higher
 		// ---> can i search only before or after idx in octants
-		Mortontry = oct->computeMorton();
-		int32_t jump = (Mortontry > Morton) ? int32_t(idx/2+1) : int32_t((noctants -idx)/2+1);
-		idxtry = uint32_t(idx +((Mortontry<Morton)-(Mortontry>Morton))*jump);
-		if (idxtry > noctants-1)
-			idxtry = noctants-1;
-		while(abs(jump) > 0){
-			Mortontry = m_octants[idxtry].computeMorton();
-			jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-			idxtry += jump;
-			if (idxtry > m_octants.size()-1){
-				if (jump > 0){
-					idxtry = m_octants.size() - 1;
-					jump = 0;
-				}
-				else if (jump < 0){
-					idxtry = 0;
-					jump = 0;
-				}
-			}
-		}
-		if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+		idxtry = findLowerMorton(Morton);
+		if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 			//Found neighbour of same size
 			isghost.push_back(false);
 			neighbours.push_back(idxtry);
@@ -3278,14 +2479,14 @@ LocalTree::findEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neighbour
 		else{
 			// Step until the mortontry lower than morton (one idx of distance)
 			{
-				while(m_octants[idxtry].computeMorton() < Morton){
+				while(m_mortons[idxtry] < Morton){
 					idxtry++;
 					if(idxtry > noctants-1){
 						idxtry = noctants-1;
 						break;
 					}
 				}
-				while(m_octants[idxtry].computeMorton() > Morton){
+				while(m_mortons[idxtry] > Morton){
 					idxtry--;
 					if(idxtry > noctants-1){
 						idxtry = 0;
@@ -3294,16 +2495,16 @@ LocalTree::findEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neighbour
 				}
 			}
 			if (idxtry < noctants){
-				if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+				if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 					//Found neighbour of same size
 					isghost.push_back(false);
 					neighbours.push_back(idxtry);
 					return;
 				}
 				// Compute Last discendent of virtual octant of same size
-				Octant last_desc = samesizeoct.buildLastDesc();
+				Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 				uint64_t Mortonlast = last_desc.computeMorton();
-				Mortontry = m_octants[idxtry].computeMorton();
+				Mortontry = m_mortons[idxtry];
 				while(Mortontry < Mortonlast && idxtry <= noctants-1){
 					Dx = int32_t(abs(cx))*(-int32_t(oct->m_x) + int32_t(m_octants[idxtry].m_x));
 					Dy = int32_t(abs(cy))*(-int32_t(oct->m_y) + int32_t(m_octants[idxtry].m_y));
@@ -3346,7 +2547,7 @@ LocalTree::findEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neighbour
 					if(idxtry>noctants-1){
 						break;
 					}
-					Mortontry = m_octants[idxtry].computeMorton();
+					Mortontry = m_mortons[idxtry];
 				}
 			}
 		}
@@ -3398,7 +2599,7 @@ LocalTree::findEdgeNeighbours(Octant* oct, uint8_t iedge, u32vector & neighbours
 	iface2 = m_global.m_edgeFace[iedge][1];
 
 	// Check if octants edge is a boundary
-	if (oct->m_info[iface1] == false && oct->m_info[iface2] == false){
+	if (oct->getInfo(iface1) == false && oct->getInfo(iface2) == false){
 
 		//Build Morton number of virtual neigh of same size
 		Octant samesizeoct(m_dim, oct->m_level, oct->m_x+cx*size, oct->m_y+cy*size, oct->m_z+cz*size, m_global.m_maxLevel);
@@ -3408,31 +2609,12 @@ LocalTree::findEdgeNeighbours(Octant* oct, uint8_t iedge, u32vector & neighbours
 
 		if (m_ghosts.size()>0){
 			// Search in ghosts
-			uint32_t idxghost = uint32_t(m_sizeGhosts/2);
-			Octant* octghost = &m_ghosts[idxghost];
 
 			// Search morton in octants
 			// If a even face morton is lower than morton of oct, if odd higher
 			// ---> can i search only before or after idx in octants
-			Mortontry = octghost->computeMorton();
-			int32_t jump = int32_t(idxghost/2+1);
-			idxtry = uint32_t(idxghost +((Mortontry<Morton)-(Mortontry>Morton))*jump);
-			while(abs(jump) > 0){
-				Mortontry = m_ghosts[idxtry].computeMorton();
-				jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-				idxtry += jump;
-				if (idxtry > m_ghosts.size()-1){
-					if (jump > 0){
-						idxtry = m_ghosts.size() - 1;
-						jump = 0;
-					}
-					else if (jump < 0){
-						idxtry = 0;
-						jump = 0;
-					}
-				}
-			}
-			if(m_ghosts[idxtry].computeMorton() == Morton && m_ghosts[idxtry].m_level == oct->m_level){
+			idxtry = findGhostLowerMorton(Morton);
+			if(m_ghostsMortons[idxtry] == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 				//Found neighbour of same size
 				isghost.push_back(true);
 				neighbours.push_back(idxtry);
@@ -3441,14 +2623,14 @@ LocalTree::findEdgeNeighbours(Octant* oct, uint8_t iedge, u32vector & neighbours
 			else{
 				// Step until the mortontry lower than morton (one idx of distance)
 				{
-					while(m_ghosts[idxtry].computeMorton() < Morton){
+					while(m_ghostsMortons[idxtry] < Morton){
 						idxtry++;
 						if(idxtry > m_ghosts.size()-1){
 							idxtry = m_ghosts.size()-1;
 							break;
 						}
 					}
-					while(m_ghosts[idxtry].computeMorton() > Morton){
+					while(m_ghostsMortons[idxtry] > Morton){
 						idxtry--;
 						if(idxtry > m_ghosts.size()-1){
 							idxtry = 0;
@@ -3457,16 +2639,16 @@ LocalTree::findEdgeNeighbours(Octant* oct, uint8_t iedge, u32vector & neighbours
 					}
 				}
 				if(idxtry < m_sizeGhosts){
-					if(m_ghosts[idxtry].computeMorton() == Morton && m_ghosts[idxtry].m_level == oct->m_level){
+					if(m_ghostsMortons[idxtry] == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 						//Found neighbour of same size
 						isghost.push_back(true);
 						neighbours.push_back(idxtry);
 						return;
 					}
 					// Compute Last discendent of virtual octant of same size
-					Octant last_desc = samesizeoct.buildLastDesc();
+					Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 					uint64_t Mortonlast = last_desc.computeMorton();
-					Mortontry = m_ghosts[idxtry].computeMorton();
+					Mortontry = m_ghostsMortons[idxtry];
 					while(Mortontry < Mortonlast && idxtry < m_ghosts.size()){
 						Dx = int32_t(abs(cx))*(-int32_t(oct->m_x) + int32_t(m_ghosts[idxtry].m_x));
 						Dy = int32_t(abs(cy))*(-int32_t(oct->m_y) + int32_t(m_ghosts[idxtry].m_y));
@@ -3509,7 +2691,7 @@ LocalTree::findEdgeNeighbours(Octant* oct, uint8_t iedge, u32vector & neighbours
 						if(idxtry>m_sizeGhosts-1){
 							break;
 						}
-						Mortontry = m_ghosts[idxtry].computeMorton();
+						Mortontry = m_ghostsMortons[idxtry];
 					}
 				}
 			}
@@ -3521,26 +2703,8 @@ LocalTree::findEdgeNeighbours(Octant* oct, uint8_t iedge, u32vector & neighbours
 		// Search morton in octants
 		// If a even face morton is lower than morton of oct, if odd higher
 		// ---> can i search only before or after idx in octants
-		int32_t jump = int32_t((noctants)/2+1);
-		idxtry = uint32_t(jump);
-		if (idxtry > noctants-1)
-			idxtry = noctants-1;
-		while(abs(jump) > 0){
-			Mortontry = m_octants[idxtry].computeMorton();
-			jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-			idxtry += jump;
-			if (idxtry > m_octants.size()-1){
-				if (jump > 0){
-					idxtry = m_octants.size() - 1;
-					jump = 0;
-				}
-				else if (jump < 0){
-					idxtry = 0;
-					jump = 0;
-				}
-			}
-		}
-		if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+		idxtry = findLowerMorton(Morton);
+		if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 			//Found neighbour of same size
 			isghost.push_back(false);
 			neighbours.push_back(idxtry);
@@ -3549,14 +2713,14 @@ LocalTree::findEdgeNeighbours(Octant* oct, uint8_t iedge, u32vector & neighbours
 		else{
 			// Step until the mortontry lower than morton (one idx of distance)
 			{
-				while(m_octants[idxtry].computeMorton() < Morton){
+				while(m_mortons[idxtry] < Morton){
 					idxtry++;
 					if(idxtry > noctants-1){
 						idxtry = noctants-1;
 						break;
 					}
 				}
-				while(m_octants[idxtry].computeMorton() > Morton){
+				while(m_mortons[idxtry] > Morton){
 					idxtry--;
 					if(idxtry > noctants-1){
 						idxtry = 0;
@@ -3565,16 +2729,16 @@ LocalTree::findEdgeNeighbours(Octant* oct, uint8_t iedge, u32vector & neighbours
 				}
 			}
 			if (idxtry < noctants){
-				if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+				if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 					//Found neighbour of same size
 					isghost.push_back(false);
 					neighbours.push_back(idxtry);
 					return;
 				}
 				// Compute Last discendent of virtual octant of same size
-				Octant last_desc = samesizeoct.buildLastDesc();
+				Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 				uint64_t Mortonlast = last_desc.computeMorton();
-				Mortontry = m_octants[idxtry].computeMorton();
+				Mortontry = m_mortons[idxtry];
 				while(Mortontry < Mortonlast && idxtry <= noctants-1){
 					Dx = int32_t(abs(cx))*(-int32_t(oct->m_x) + int32_t(m_octants[idxtry].m_x));
 					Dy = int32_t(abs(cy))*(-int32_t(oct->m_y) + int32_t(m_octants[idxtry].m_y));
@@ -3617,7 +2781,7 @@ LocalTree::findEdgeNeighbours(Octant* oct, uint8_t iedge, u32vector & neighbours
 					if(idxtry>noctants-1){
 						break;
 					}
-					Mortontry = m_octants[idxtry].computeMorton();
+					Mortontry = m_mortons[idxtry];
 				}
 			}
 		}
@@ -3668,7 +2832,7 @@ LocalTree::findGhostEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neig
 	iface2 = m_global.m_edgeFace[iedge][1];
 
 	// Check if octants edge is a pboundary edge
-	if (oct->m_info[iface1+6] == true || oct->m_info[iface2+6] == true){
+	if (oct->getInfo(iface1+6) == true || oct->getInfo(iface2+6) == true){
 
 		//Build Morton number of virtual neigh of same size
 		Octant samesizeoct(m_dim, oct->m_level, oct->m_x+cx*size, oct->m_y+cy*size, oct->m_z+cz*size, m_global.m_maxLevel);
@@ -3678,24 +2842,8 @@ LocalTree::findGhostEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neig
 		// Search morton in octants
 		// If a even face morton is lower than morton of oct, if odd higher
 		// ---> can i search only before or after idx in octants
-		int32_t jump = getNumOctants()/2;
-		idxtry = uint32_t(getNumOctants()/2);
-		while(abs(jump) > 0){
-			Mortontry = m_octants[idxtry].computeMorton();
-			jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-			idxtry += jump;
-			if (idxtry > m_octants.size()-1){
-				if (jump > 0){
-					idxtry = m_octants.size() - 1;
-					jump = 0;
-				}
-				else if (jump < 0){
-					idxtry = 0;
-					jump = 0;
-				}
-			}
-		}
-		if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+		idxtry = findLowerMorton(Morton);
+		if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 			//Found neighbour of same size
 			neighbours.push_back(idxtry);
 			return;
@@ -3703,14 +2851,14 @@ LocalTree::findGhostEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neig
 		else{
 			// Step until the mortontry lower than morton (one idx of distance)
 			{
-				while(m_octants[idxtry].computeMorton() < Morton){
+				while(m_mortons[idxtry] < Morton){
 					idxtry++;
 					if(idxtry > noctants-1){
 						idxtry = noctants-1;
 						break;
 					}
 				}
-				while(m_octants[idxtry].computeMorton() > Morton){
+				while(m_mortons[idxtry] > Morton){
 					idxtry--;
 					if(idxtry > noctants-1){
 						idxtry = 0;
@@ -3719,15 +2867,15 @@ LocalTree::findGhostEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neig
 				}
 			}
 			if (idxtry < noctants){
-				if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+				if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 					//Found neighbour of same size
 					neighbours.push_back(idxtry);
 					return;
 				}
 				// Compute Last discendent of virtual octant of same size
-				Octant last_desc = samesizeoct.buildLastDesc();
+				Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 				uint64_t Mortonlast = last_desc.computeMorton();
-				Mortontry = m_octants[idxtry].computeMorton();
+				Mortontry = m_mortons[idxtry];
 				while(Mortontry < Mortonlast && idxtry <= noctants-1){
 					Dx = int32_t(abs(cx))*(-int32_t(oct->m_x) + int32_t(m_octants[idxtry].m_x));
 					Dy = int32_t(abs(cy))*(-int32_t(oct->m_y) + int32_t(m_octants[idxtry].m_y));
@@ -3767,7 +2915,7 @@ LocalTree::findGhostEdgeNeighbours(uint32_t idx, uint8_t iedge, u32vector & neig
 					if(idxtry>noctants-1){
 						break;
 					}
-					Mortontry = m_octants[idxtry].computeMorton();
+					Mortontry = m_mortons[idxtry];
 				}
 			}
 		}
@@ -3827,7 +2975,7 @@ LocalTree::findNodeNeighbours(Octant* oct, uint8_t inode, u32vector & neighbours
 	iface3 = m_global.m_nodeFace[inode][m_dim-1];
 
 	// Check if octants node is a boundary
-	if (oct->m_info[iface1] == false && oct->m_info[iface2] == false && oct->m_info[iface3] == false){
+	if (oct->getInfo(iface1) == false && oct->getInfo(iface2) == false && oct->getInfo(iface3) == false){
 
 		//Build Morton number of virtual neigh of same size
 		Octant samesizeoct(m_dim, oct->m_level, oct->m_x+cxyz[0]*size, oct->m_y+cxyz[1]*size, oct->m_z+cxyz[2]*size, m_global.m_maxLevel);
@@ -3837,33 +2985,12 @@ LocalTree::findNodeNeighbours(Octant* oct, uint8_t inode, u32vector & neighbours
 
 		if (m_ghosts.size()>0){
 			// Search in ghosts
-			uint32_t idxghost = uint32_t(m_sizeGhosts/2);
-			Octant* octghost = &m_ghosts[idxghost];
 
 			// Search morton in octants
 			// If a even face morton is lower than morton of oct, if odd higher
 			// ---> can i search only before or after idx in octants
-			Mortontry = octghost->computeMorton();
-			int32_t jump = (Mortontry > Morton) ? int32_t(idxghost/2+1) : int32_t((m_sizeGhosts -idxghost)/2+1);
-			idxtry = uint32_t(idxghost +((Mortontry<Morton)-(Mortontry>Morton))*jump);
-			if (idxtry > m_sizeGhosts-1)
-				idxtry = m_sizeGhosts-1;
-			while(abs(jump) > 0){
-				Mortontry = m_ghosts[idxtry].computeMorton();
-				jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-				idxtry += jump;
-				if (idxtry > m_ghosts.size()-1){
-					if (jump > 0){
-						idxtry = m_ghosts.size() - 1;
-						jump = 0;
-					}
-					else if (jump < 0){
-						idxtry = 0;
-						jump = 0;
-					}
-				}
-			}
-			if(m_ghosts[idxtry].computeMorton() == Morton && m_ghosts[idxtry].m_level == oct->m_level){
+			idxtry = findGhostLowerMorton(Morton);
+			if(m_ghostsMortons[idxtry] == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 				//Found neighbour of same size
 				isghost.push_back(true);
 				neighbours.push_back(idxtry);
@@ -3872,14 +2999,14 @@ LocalTree::findNodeNeighbours(Octant* oct, uint8_t inode, u32vector & neighbours
 			else{
 				// Step until the mortontry lower than morton (one idx of distance)
 				{
-					while(m_ghosts[idxtry].computeMorton() < Morton){
+					while(m_ghostsMortons[idxtry] < Morton){
 						idxtry++;
 						if(idxtry > m_ghosts.size()-1){
 							idxtry = m_ghosts.size()-1;
 							break;
 						}
 					}
-					while(m_ghosts[idxtry].computeMorton() > Morton){
+					while(m_ghostsMortons[idxtry] > Morton){
 						idxtry--;
 						if(idxtry > m_ghosts.size()-1){
 							idxtry = 0;
@@ -3888,16 +3015,16 @@ LocalTree::findNodeNeighbours(Octant* oct, uint8_t inode, u32vector & neighbours
 					}
 				}
 				if(idxtry < m_sizeGhosts){
-					if(m_ghosts[idxtry].computeMorton() == Morton && m_ghosts[idxtry].m_level == oct->m_level){
+					if(m_ghostsMortons[idxtry] == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 						//Found neighbour of same size
 						isghost.push_back(true);
 						neighbours.push_back(idxtry);
 						return;
 					}
 					// Compute Last discendent of virtual octant of same size
-					Octant last_desc = samesizeoct.buildLastDesc();
+					Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 					uint64_t Mortonlast = last_desc.computeMorton();
-					Mortontry = m_ghosts[idxtry].computeMorton();
+					Mortontry = m_ghostsMortons[idxtry];
 					int32_t Dx[3] = {0,0,0};
 					int32_t Dxstar[3] = {0,0,0};
 					u32array3 coord = oct->getCoord();
@@ -3926,7 +3053,7 @@ LocalTree::findNodeNeighbours(Octant* oct, uint8_t inode, u32vector & neighbours
 						if(idxtry>m_sizeGhosts-1){
 							break;
 						}
-						Mortontry = m_ghosts[idxtry].computeMorton();
+						Mortontry = m_ghostsMortons[idxtry];
 					}
 				}
 			}
@@ -3938,26 +3065,8 @@ LocalTree::findNodeNeighbours(Octant* oct, uint8_t inode, u32vector & neighbours
 		// Search morton in octants
 		// If a even face morton is lower than morton of oct, if odd higher
 		// ---> can i search only before or after idx in octants
-		int32_t jump = (int32_t((noctants)/2+1));
-		idxtry = uint32_t(jump);
-		if (idxtry > noctants-1)
-			idxtry = noctants-1;
-		while(abs(jump) > 0){
-			Mortontry = m_octants[idxtry].computeMorton();
-			jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-			idxtry += jump;
-			if (idxtry > m_octants.size()-1){
-				if (jump > 0){
-					idxtry = m_octants.size() - 1;
-					jump = 0;
-				}
-				else if (jump < 0){
-					idxtry = 0;
-					jump = 0;
-				}
-			}
-		}
-		if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+		idxtry = findLowerMorton(Morton);
+		if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 			//Found neighbour of same size
 			isghost.push_back(false);
 			neighbours.push_back(idxtry);
@@ -3966,14 +3075,14 @@ LocalTree::findNodeNeighbours(Octant* oct, uint8_t inode, u32vector & neighbours
 		else{
 			// Step until the mortontry lower than morton (one idx of distance)
 			{
-				while(m_octants[idxtry].computeMorton() < Morton){
+				while(m_mortons[idxtry] < Morton){
 					idxtry++;
 					if(idxtry > noctants-1){
 						idxtry = noctants-1;
 						break;
 					}
 				}
-				while(m_octants[idxtry].computeMorton() > Morton){
+				while(m_mortons[idxtry] > Morton){
 					idxtry--;
 					if(idxtry > noctants-1){
 						idxtry = 0;
@@ -3982,16 +3091,16 @@ LocalTree::findNodeNeighbours(Octant* oct, uint8_t inode, u32vector & neighbours
 				}
 			}
 			if (idxtry < noctants){
-				if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+				if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 					//Found neighbour of same size
 					isghost.push_back(false);
 					neighbours.push_back(idxtry);
 					return;
 				}
 				// Compute Last discendent of virtual octant of same size
-				Octant last_desc = samesizeoct.buildLastDesc();
+				Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 				uint64_t Mortonlast = last_desc.computeMorton();
-				Mortontry = m_octants[idxtry].computeMorton();
+				Mortontry = m_mortons[idxtry];
 				int32_t Dx[3] = {0,0,0};
 				int32_t Dxstar[3] = {0,0,0};
 				u32array3 coord = oct->getCoord();
@@ -4020,7 +3129,7 @@ LocalTree::findNodeNeighbours(Octant* oct, uint8_t inode, u32vector & neighbours
 					if(idxtry>noctants-1){
 						break;
 					}
-					Mortontry = m_octants[idxtry].computeMorton();
+					Mortontry = m_mortons[idxtry];
 				}
 			}
 		}
@@ -4081,7 +3190,7 @@ LocalTree::findNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neighbour
 	iface3 = m_global.m_nodeFace[inode][m_dim-1];
 
 	// Check if octants node is a boundary
-	if (oct->m_info[iface1] == false && oct->m_info[iface2] == false && oct->m_info[iface3] == false){
+	if (oct->getInfo(iface1) == false && oct->getInfo(iface2) == false && oct->getInfo(iface3) == false){
 
 		//Build Morton number of virtual neigh of same size
 		Octant samesizeoct(m_dim, oct->m_level, oct->m_x+cxyz[0]*size, oct->m_y+cxyz[1]*size, oct->m_z+cxyz[2]*size, m_global.m_maxLevel);
@@ -4091,33 +3200,12 @@ LocalTree::findNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neighbour
 
 		if (m_ghosts.size()>0){
 			// Search in ghosts
-			uint32_t idxghost = uint32_t(m_sizeGhosts/2);
-			Octant* octghost = &m_ghosts[idxghost];
 
 			// Search morton in octants
 			// If a even face morton is lower than morton of oct, if odd higher
 			// ---> can i search only before or after idx in octants
-			Mortontry = octghost->computeMorton();
-			int32_t jump = (Mortontry > Morton) ? int32_t(idxghost/2+1) : int32_t((m_sizeGhosts -idxghost)/2+1);
-			idxtry = uint32_t(idxghost +((Mortontry<Morton)-(Mortontry>Morton))*jump);
-			if (idxtry > m_sizeGhosts-1)
-				idxtry = m_sizeGhosts-1;
-			while(abs(jump) > 0){
-				Mortontry = m_ghosts[idxtry].computeMorton();
-				jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-				idxtry += jump;
-				if (idxtry > m_ghosts.size()-1){
-					if (jump > 0){
-						idxtry = m_ghosts.size() - 1;
-						jump = 0;
-					}
-					else if (jump < 0){
-						idxtry = 0;
-						jump = 0;
-					}
-				}
-			}
-			if(m_ghosts[idxtry].computeMorton() == Morton && m_ghosts[idxtry].m_level == oct->m_level){
+			idxtry = findGhostLowerMorton(Morton);
+			if(m_ghostsMortons[idxtry] == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 				//Found neighbour of same size
 				isghost.push_back(true);
 				neighbours.push_back(idxtry);
@@ -4126,14 +3214,14 @@ LocalTree::findNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neighbour
 			else{
 				// Step until the mortontry lower than morton (one idx of distance)
 				{
-					while(m_ghosts[idxtry].computeMorton() < Morton){
+					while(m_ghostsMortons[idxtry] < Morton){
 						idxtry++;
 						if(idxtry > m_ghosts.size()-1){
 							idxtry = m_ghosts.size()-1;
 							break;
 						}
 					}
-					while(m_ghosts[idxtry].computeMorton() > Morton){
+					while(m_ghostsMortons[idxtry] > Morton){
 						idxtry--;
 						if(idxtry > m_ghosts.size()-1){
 							idxtry = 0;
@@ -4142,16 +3230,16 @@ LocalTree::findNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neighbour
 					}
 				}
 				if(idxtry < m_sizeGhosts){
-					if(m_ghosts[idxtry].computeMorton() == Morton && m_ghosts[idxtry].m_level == oct->m_level){
+					if(m_ghostsMortons[idxtry] == Morton && m_ghosts[idxtry].m_level == oct->m_level){
 						//Found neighbour of same size
 						isghost.push_back(true);
 						neighbours.push_back(idxtry);
 						return;
 					}
 					// Compute Last discendent of virtual octant of same size
-					Octant last_desc = samesizeoct.buildLastDesc();
+					Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 					uint64_t Mortonlast = last_desc.computeMorton();
-					Mortontry = m_ghosts[idxtry].computeMorton();
+					Mortontry = m_ghostsMortons[idxtry];
 					int32_t Dx[3] = {0,0,0};
 					int32_t Dxstar[3] = {0,0,0};
 					u32array3 coord = oct->getCoord();
@@ -4180,7 +3268,7 @@ LocalTree::findNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neighbour
 						if(idxtry>m_sizeGhosts-1){
 							break;
 						}
-						Mortontry = m_ghosts[idxtry].computeMorton();
+						Mortontry = m_ghostsMortons[idxtry];
 					}
 				}
 			}
@@ -4192,26 +3280,8 @@ LocalTree::findNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neighbour
 		// Search morton in octants
 		// If a even face morton is lower than morton of oct, if odd higher
 		// ---> can i search only before or after idx in octants
-		int32_t jump = (int32_t((noctants)/2+1));
-		idxtry = uint32_t(jump);
-		if (idxtry > noctants-1)
-			idxtry = noctants-1;
-		while(abs(jump) > 0){
-			Mortontry = m_octants[idxtry].computeMorton();
-			jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-			idxtry += jump;
-			if (idxtry > m_octants.size()-1){
-				if (jump > 0){
-					idxtry = m_octants.size() - 1;
-					jump = 0;
-				}
-				else if (jump < 0){
-					idxtry = 0;
-					jump = 0;
-				}
-			}
-		}
-		if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+		idxtry = findLowerMorton(Morton);
+		if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 			//Found neighbour of same size
 			isghost.push_back(false);
 			neighbours.push_back(idxtry);
@@ -4220,14 +3290,14 @@ LocalTree::findNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neighbour
 		else{
 			// Step until the mortontry lower than morton (one idx of distance)
 			{
-				while(m_octants[idxtry].computeMorton() < Morton){
+				while(m_mortons[idxtry] < Morton){
 					idxtry++;
 					if(idxtry > noctants-1){
 						idxtry = noctants-1;
 						break;
 					}
 				}
-				while(m_octants[idxtry].computeMorton() > Morton){
+				while(m_mortons[idxtry] > Morton){
 					idxtry--;
 					if(idxtry > noctants-1){
 						idxtry = 0;
@@ -4236,16 +3306,16 @@ LocalTree::findNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neighbour
 				}
 			}
 			if (idxtry < noctants){
-				if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+				if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 					//Found neighbour of same size
 					isghost.push_back(false);
 					neighbours.push_back(idxtry);
 					return;
 				}
 				// Compute Last discendent of virtual octant of same size
-				Octant last_desc = samesizeoct.buildLastDesc();
+				Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 				uint64_t Mortonlast = last_desc.computeMorton();
-				Mortontry = m_octants[idxtry].computeMorton();
+				Mortontry = m_mortons[idxtry];
 				int32_t Dx[3] = {0,0,0};
 				int32_t Dxstar[3] = {0,0,0};
 				u32array3 coord = oct->getCoord();
@@ -4274,7 +3344,7 @@ LocalTree::findNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neighbour
 					if(idxtry>noctants-1){
 						break;
 					}
-					Mortontry = m_octants[idxtry].computeMorton();
+					Mortontry = m_mortons[idxtry];
 				}
 			}
 		}
@@ -4332,21 +3402,15 @@ LocalTree::findGhostNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neig
 	iface3 = m_global.m_nodeFace[inode][m_dim-1];
 
 	//		// Check if octants node is a boundary
-	//		if (oct->m_info[iface1] == false && oct->m_info[iface2] == false && oct->m_info[iface3] == false){
+	//		if (oct->getInfo(iface1) == false && oct->getInfo(iface2) == false && oct->getInfo(iface3) == false){
 	// Check if octants node is a pboundary node
-	if (oct->m_info[iface1+6] == true || oct->m_info[iface2+6] == true || oct->m_info[iface3+6] == true){
+	if (oct->getInfo(iface1+6) == true || oct->getInfo(iface2+6) == true || oct->getInfo(iface3+6) == true){
 
 		//Build Morton number of virtual neigh of same size
 		Octant samesizeoct(m_dim, oct->m_level, oct->m_x+cxyz[0]*size, oct->m_y+cxyz[1]*size, oct->m_z+cxyz[2]*size, m_global.m_maxLevel);
 		Morton = samesizeoct.computeMorton(); //mortonEncode_magicbits(oct->m_x-size,oct->m_y,oct->m_z);
-		int32_t jump = noctants/2;
-		idxtry = jump;
-		while(abs(jump) > 0){
-			Mortontry = m_octants[idxtry].computeMorton();
-			jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-			idxtry += jump;
-		}
-		if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+		idxtry = findLowerMorton(Morton);
+		if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 			//Found neighbour of same size
 			neighbours.push_back(idxtry);
 			return;
@@ -4354,14 +3418,14 @@ LocalTree::findGhostNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neig
 		else{
 			// Step until the mortontry lower than morton (one idx of distance)
 			{
-				while(m_octants[idxtry].computeMorton() < Morton){
+				while(m_mortons[idxtry] < Morton){
 					idxtry++;
 					if(idxtry > noctants-1){
 						idxtry = noctants-1;
 						break;
 					}
 				}
-				while(m_octants[idxtry].computeMorton() > Morton){
+				while(m_mortons[idxtry] > Morton){
 					idxtry--;
 					if(idxtry > noctants-1){
 						idxtry = 0;
@@ -4370,15 +3434,15 @@ LocalTree::findGhostNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neig
 				}
 			}
 			if (idxtry < noctants){
-				if(m_octants[idxtry].computeMorton() == Morton && m_octants[idxtry].m_level == oct->m_level){
+				if(m_mortons[idxtry] == Morton && m_octants[idxtry].m_level == oct->m_level){
 					//Found neighbour of same size
 					neighbours.push_back(idxtry);
 					return;
 				}
 				// Compute Last discendent of virtual octant of same size
-				Octant last_desc = samesizeoct.buildLastDesc();
+				Octant last_desc = samesizeoct.buildLastDesc(m_dim);
 				uint64_t Mortonlast = last_desc.computeMorton();
-				Mortontry = m_octants[idxtry].computeMorton();
+				Mortontry = m_mortons[idxtry];
 				int32_t Dx[3] = {0,0,0};
 				int32_t Dxstar[3] = {0,0,0};
 				u32array3 coord = oct->getCoord();
@@ -4402,7 +3466,7 @@ LocalTree::findGhostNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neig
 						neighbours.push_back(idxtry);
 					}
 					idxtry++;
-					Mortontry = m_octants[idxtry].computeMorton();
+					Mortontry = m_mortons[idxtry];
 				}
 			}
 		}
@@ -4416,28 +3480,242 @@ LocalTree::findGhostNodeNeighbours(uint32_t idx, uint8_t inode, u32vector & neig
 
 // =================================================================================== //
 
-/*! Compute and store in m_intersections the intersections of the local tree.
+/*! Finds neighbours of idx-th octant through the ientity-th entity, where the entities
+ * of an octant are ordered as in the neighbour cache (faces, edges and nodes).
+ * \param[in] idx Local index of the target local octant.
+ * \param[in] ientity Index of the entity in the ordering of the neighbour cache.
+ * \param[out] neighbours Vector with the local indices of the neighbours (size = 0 if boundary entity).
+ * \param[out] isghost Vector with the information about the identity of each neighbour (is the i-th neighours a ghost octant?).
  */
 void
-LocalTree::computeIntersections() {
+LocalTree::findEntityNeighbours(uint32_t idx, uint8_t ientity, u32vector & neighbours, vector<bool> & isghost){
+
+	if (ientity < m_global.m_nfaces){
+		findNeighbours(idx, ientity, neighbours, isghost);
+	}
+	else if (ientity < m_global.m_nfaces + m_global.m_nedges){
+		findEdgeNeighbours(idx, ientity - m_global.m_nfaces, neighbours, isghost);
+	}
+	else{
+		findNodeNeighbours(idx, ientity - m_global.m_nfaces - m_global.m_nedges, neighbours, isghost);
+	}
+};
+
+// =================================================================================== //
+// NEIGHBOUR CACHE METHODS
+// =================================================================================== //
+
+/*! Get the number of entities of an octant stored in the neighbour cache.
+ * \return Number of entities (faces, edges and nodes) cached for each octant.
+ */
+uint8_t
+LocalTree::getNumNeighEntities() const{
+	uint8_t nentities = 0;
+	if (m_neighCodim >= 1){
+		nentities += m_global.m_nfaces;
+	}
+	if (m_neighCodim >= 2){
+		nentities += m_global.m_nedges;
+	}
+	if (m_neighCodim >= m_dim){
+		nentities += m_global.m_nnodes;
+	}
+	return nentities;
+};
+
+/*! Get the index in the neighbour cache ordering of a face/edge/node of an octant.
+ * \param[in] iface Local index of the face/edge/node.
+ * \param[in] codim Codimension of the iface-th entity (1=face, 2=edge in 3D, dim=node).
+ * \param[out] ientity Index of the entity in the ordering of the neighbour cache.
+ * \return True if the entity is stored in the neighbour cache.
+ */
+bool
+LocalTree::getNeighEntity(uint8_t iface, uint8_t codim, uint8_t & ientity) const{
+	if (codim == 0 || codim > m_neighCodim){
+		return false;
+	}
+	if (codim == 1){
+		ientity = iface;
+	}
+	else if (codim == m_dim){
+		ientity = m_global.m_nfaces + m_global.m_nedges + iface;
+	}
+	else{
+		ientity = m_global.m_nfaces + iface;
+	}
+	return true;
+};
+
+/*! Get the neighbours of idx-th octant through a face/edge/node from the neighbour cache.
+ * \param[in] idx Local index of the target local octant.
+ * \param[in] iface Local index of the face/edge/node.
+ * \param[in] codim Codimension of the iface-th entity (1=face, 2=edge in 3D, dim=node).
+ * \param[out] neighbours Vector with the local indices of the neighbours (size = 0 if boundary entity).
+ * \param[out] isghost Vector with the information about the identity of each neighbour (is the i-th neighours a ghost octant?).
+ * \return True if the neighbours have been found in the cache, false if the cache is
+ * not up to date or the entity is not cached (neighbours and isghost are untouched).
+ */
+bool
+LocalTree::findCachedNeighbours(uint32_t idx, uint8_t iface, uint8_t codim, u32vector & neighbours, vector<bool> & isghost){
+
+	uint8_t ientity;
+	if (!m_neighCached || !getNeighEntity(iface, codim, ientity)){
+		return false;
+	}
+
+	uint64_t pos = uint64_t(idx)*getNumNeighEntities() + ientity;
+	uint64_t begin = m_neighOffsets[pos];
+	uint64_t end = m_neighOffsets[pos+1];
+	neighbours.assign(m_neighIdx.begin() + begin, m_neighIdx.begin() + end);
+	isghost.assign(m_neighIsGhost.begin() + begin, m_neighIsGhost.begin() + end);
+	return true;
+};
+
+/*! Compute the neighbour cache of the local octants, i.e. the neighbours of each
+ * face (and of each edge and node, depending on m_neighCodim) stored in CSR format.
+ */
+void
+LocalTree::computeNeighbourCache(){
+
+	u32vector 			neighbours;
+	vector<bool> 		isghost;
+	uint32_t 			noctants = getNumOctants();
+	uint8_t 			nentities = getNumNeighEntities();
+	uint64_t 			pos;
+
+	clearNeighbourCache();
+	if (nentities == 0){
+		return;
+	}
+
+	m_neighOffsets.resize(uint64_t(noctants)*nentities + 1);
+	m_neighIdx.reserve(uint64_t(noctants)*nentities);
+	m_neighIsGhost.reserve(uint64_t(noctants)*nentities);
+
+	pos = 0;
+	m_neighOffsets[pos] = 0;
+	for (uint32_t idx = 0; idx < noctants; idx++){
+		for (uint8_t ientity = 0; ientity < nentities; ientity++){
+			findEntityNeighbours(idx, ientity, neighbours, isghost);
+			m_neighIdx.insert(m_neighIdx.end(), neighbours.begin(), neighbours.end());
+			m_neighIsGhost.insert(m_neighIsGhost.end(), isghost.begin(), isghost.end());
+			m_neighOffsets[++pos] = m_neighIdx.size();
+		}
+	}
+
+	m_neighCached = true;
+};
+
+/*! Update the neighbour cache after an adapt tracked by a mapper.
+ * The entries of the octants untouched by the adapt whose neighbours are local
+ * octants untouched by the adapt are remapped from the previous cache, the other
+ * entries (new octants, ghost neighbours, boundaries) are searched again.
+ * If the previous cache is not available the cache is computed from scratch.
+ * \param[in] mapidx Mapper from new octants to old octants (as built by adapt with mapper).
+ */
+void
+LocalTree::updateNeighbourCache(const u32vector & mapidx){
+
+	u32vector 			neighbours;
+	vector<bool> 		isghost;
+	uint32_t 			noctants = getNumOctants();
+	uint8_t 			nentities = getNumNeighEntities();
+
+	if (!m_neighCached || nentities == 0 || mapidx.size() != noctants){
+		computeNeighbourCache();
+		return;
+	}
+
+	// Map from old to new index of the octants untouched by the adapt
+	// (=noctants if the old octant has been refined/coarsened)
+	uint32_t noldoctants = uint32_t((m_neighOffsets.size() - 1)/nentities);
+	u32vector oldToNew(noldoctants, noctants);
+	for (uint32_t idx = 0; idx < noctants; idx++){
+		if (!m_octants[idx].getInfo(12) && !m_octants[idx].getInfo(13)){
+			oldToNew[mapidx[idx]] = idx;
+		}
+	}
+
+	u64vector 			neighOffsets(uint64_t(noctants)*nentities + 1);
+	u32vector 			neighIdx;
+	vector<bool> 		neighIsGhost;
+	uint64_t 			pos = 0;
+
+	neighIdx.reserve(m_neighIdx.size());
+	neighIsGhost.reserve(m_neighIsGhost.size());
+
+	neighOffsets[pos] = 0;
+	for (uint32_t idx = 0; idx < noctants; idx++){
+		bool unchanged = (!m_octants[idx].getInfo(12) && !m_octants[idx].getInfo(13));
+		uint64_t oldpos = unchanged ? uint64_t(mapidx[idx])*nentities : 0;
+		for (uint8_t ientity = 0; ientity < nentities; ientity++){
+			bool reuse = unchanged;
+			uint64_t begin = 0, end = 0;
+			if (reuse){
+				begin = m_neighOffsets[oldpos + ientity];
+				end = m_neighOffsets[oldpos + ientity + 1];
+				reuse = (end > begin);
+				for (uint64_t k = begin; k < end && reuse; k++){
+					reuse = (!m_neighIsGhost[k] && oldToNew[m_neighIdx[k]] != noctants);
+				}
+			}
+			if (reuse){
+				for (uint64_t k = begin; k < end; k++){
+					neighIdx.push_back(oldToNew[m_neighIdx[k]]);
+					neighIsGhost.push_back(false);
+				}
+			}
+			else{
+				findEntityNeighbours(idx, ientity, neighbours, isghost);
+				neighIdx.insert(neighIdx.end(), neighbours.begin(), neighbours.end());
+				neighIsGhost.insert(neighIsGhost.end(), isghost.begin(), isghost.end());
+			}
+			neighOffsets[++pos] = neighIdx.size();
+		}
+	}
+
+	m_neighOffsets.swap(neighOffsets);
+	m_neighIdx.swap(neighIdx);
+	m_neighIsGhost.swap(neighIsGhost);
+	m_neighCached = true;
+};
+
+/*! Clear the neighbour cache of the local tree (the maximum cached codimension is retained).
+ */
+void
+LocalTree::clearNeighbourCache(){
+	u64vector().swap(m_neighOffsets);
+	u32vector().swap(m_neighIdx);
+	vector<bool>().swap(m_neighIsGhost);
+	m_neighCached = false;
+};
+
+// =================================================================================== //
+
+/*! Compute the intersections of a Morton-contiguous range of elements of the local tree.
+ * Ghosts and octants are numbered in a single sequence (the ghosts first), so that
+ * the intersections of the range [begin, end) are appended in the same order as
+ * in a serial loop over ghosts and octants.
+ * \param[in] begin First element of the range (ghosts are [0, nghosts)).
+ * \param[in] end Past-the-end element of the range (octants are [nghosts, nghosts+noctants)).
+ * \param[out] intersections Vector where the intersections of the range are appended.
+ * \param[out] counts If not NULL, counts[ielem] is set to the number of intersections
+ * appended for the element ielem of the range.
+ */
+void
+LocalTree::computeIntersections(uint32_t begin, uint32_t end, intervector & intersections, uint32_t* counts) {
 
-		octvector::iterator 	it, obegin, oend;
 		Intersection 			intersection;
 		u32vector 				neighbours;
 		vector<bool>			isghost;
-		uint32_t 				counter, idx;
+		uint32_t 				idx, ielem;
 		uint32_t 				i, nsize;
 		uint8_t 				iface, iface2;
 
-		m_intersections.clear();
-		m_intersections.reserve(2*3*m_octants.size());
-
-		counter = idx = 0;
-
 		// Loop on ghosts
-		obegin = m_ghosts.begin();
-		oend = m_ghosts.end();
-		for (it = obegin; it != oend; it++){
+		for (ielem = begin; ielem < end && ielem < m_sizeGhosts; ielem++){
+			idx = ielem;
+			size_t nprevious = intersections.size();
 			for (iface = 0; iface < m_dim; iface++){
 				iface2 = iface*2;
 				findGhostNeighbours(idx, iface2, neighbours);
@@ -4452,50 +3730,35 @@ LocalTree::computeIntersections() {
 					intersection.m_isghost = true;
 					intersection.m_bound = false;
 					intersection.m_pbound = true;
-					m_intersections.push_back(intersection);
-					counter++;
+					intersections.push_back(intersection);
 				}
 			}
-			idx++;
+			if (counts) counts[ielem] = uint32_t(intersections.size() - nprevious);
 		}
 
 		// Loop on octants
-		idx=0;
-		obegin = m_octants.begin();
-		oend = m_octants.end();
-		for (it = obegin; it != oend; it++){
+		for (; ielem < end; ielem++){
+			idx = ielem - m_sizeGhosts;
+			const Octant & octant = m_octants[idx];
+			size_t nprevious = intersections.size();
 			for (iface = 0; iface < m_dim; iface++){
 				iface2 = iface*2;
-				findNeighbours(idx, iface2, neighbours, isghost);
+				if (!findCachedNeighbours(idx, iface2, 1, neighbours, isghost)){
+					findNeighbours(idx, iface2, neighbours, isghost);
+				}
 				nsize = neighbours.size();
 				if (nsize) {
 					for (i = 0; i < nsize; i++){
-						if (isghost[i]){
-							intersection.m_dim = m_dim;
-							intersection.m_owners[0] = idx;
-							intersection.m_owners[1] = neighbours[i];
-							intersection.m_finer = (nsize>1);
-							intersection.m_iface = iface2 + (nsize>1);
-							intersection.m_isnew = false;
-							intersection.m_isghost = true;
-							intersection.m_bound = false;
-							intersection.m_pbound = true;
-							m_intersections.push_back(intersection);
-							counter++;
-						}
-						else{
-							intersection.m_dim = m_dim;
-							intersection.m_owners[0] = idx;
-							intersection.m_owners[1] = neighbours[i];
-							intersection.m_finer = (nsize>1);
-							intersection.m_iface = iface2 + (nsize>1);
-							intersection.m_isnew = false;
-							intersection.m_isghost = false;
-							intersection.m_bound = false;
-							intersection.m_pbound = false;
-							m_intersections.push_back(intersection);
-							counter++;
-						}
+						intersection.m_dim = m_dim;
+						intersection.m_owners[0] = idx;
+						intersection.m_owners[1] = neighbours[i];
+						intersection.m_finer = (nsize>1);
+						intersection.m_iface = iface2 + (nsize>1);
+						intersection.m_isnew = false;
+						intersection.m_isghost = isghost[i];
+						intersection.m_bound = false;
+						intersection.m_pbound = isghost[i];
+						intersections.push_back(intersection);
 					}
 				}
 				else{
@@ -4508,10 +3771,9 @@ LocalTree::computeIntersections() {
 					intersection.m_isghost = false;
 					intersection.m_bound = true;
 					intersection.m_pbound = false;
-					m_intersections.push_back(intersection);
-					counter++;
+					intersections.push_back(intersection);
 				}
-				if (it->m_info[iface2+1]){
+				if (octant.getInfo(iface2+1)){
 					intersection.m_dim = m_dim;
 					intersection.m_owners[0] = idx;
 					intersection.m_owners[1] = idx;
@@ -4521,56 +3783,158 @@ LocalTree::computeIntersections() {
 					intersection.m_isghost = false;
 					intersection.m_bound = true;
 					intersection.m_pbound = false;
-					m_intersections.push_back(intersection);
-					counter++;
+					intersections.push_back(intersection);
 				}
 			}
-			idx++;
+			if (counts) counts[ielem] = uint32_t(intersections.size() - nprevious);
 		}
-		intervector(m_intersections).swap(m_intersections);
 	}
 
-// =================================================================================== //
-/*! Find an input Morton in octants and return the local idx
- * \param[in] Morton Morton index to be found.
- * \return Local index of the target octant (=nocts if target Morton not found).
-*/
-uint32_t
-LocalTree::findMorton(uint64_t Morton){
+/*! Compute and store in m_intersections the intersections of the local tree.
+ * Ghosts and octants are split in Morton-contiguous chunks whose intersections are
+ * computed concurrently (if OpenMP is enabled); the chunks are then gathered at
+ * the offsets given by the prefix sum of their sizes, so the ordering of
+ * m_intersections does not depend on the number of threads.
+ */
+void
+LocalTree::computeIntersections() {
+		buildIntersections(u32vector(), u32vector());
+	}
 
-	uint32_t 		nocts = m_octants.size();
-	uint32_t 		idx = nocts/2;
-	uint64_t 		Mortontry = m_octants[idx].computeMorton();
-	int32_t 		jump = nocts/2;
+/*! Update the intersections after an adapt tracked by a mapper.
+ * The intersections of the octants untouched by the adapt whose neighbours are local
+ * octants untouched by the adapt (or the boundary of the domain) are remapped from the
+ * previous intersections, the other ones (ghosts, new octants and octants next to them
+ * or to ghosts) are computed again. The result is the same of computeIntersections.
+ * If the previous intersections are not available they are computed from scratch.
+ * \param[in] mapidx Mapper from new octants to old octants (as built by adapt with mapper).
+ */
+void
+LocalTree::updateIntersections(const u32vector & mapidx) {
 
-	while(abs(jump)>0){
-		if (Mortontry == Morton){
-			return idx;
-		}
-		Mortontry = m_octants[idx].computeMorton();
-		jump = ((Mortontry<Morton)-(Mortontry>Morton))*abs(jump)/2;
-		idx += jump;
-		if (idx > nocts){
-			return nocts-1;
+		uint32_t 			noctants = getNumOctants();
+
+		if (m_intersectionsOffsets.empty() || mapidx.size() != noctants){
+			computeIntersections();
+			return;
 		}
-	}
-	if (Mortontry<Morton){
-		for (uint32_t idx2=idx; idx2<nocts; idx2++){
-			Mortontry = m_octants[idx2].computeMorton();
-			if (Mortontry == Morton){
-				return idx2;
+
+		// Map from old to new index of the octants untouched by the adapt
+		// (=noctants if the old octant has been refined/coarsened)
+		uint32_t noldoctants = uint32_t(m_intersectionsOffsets.size() - 1) - m_intersectionsGhosts;
+		u32vector oldToNew(noldoctants, noctants);
+		for (uint32_t idx = 0; idx < noctants; idx++){
+			if (!m_octants[idx].getInfo(12) && !m_octants[idx].getInfo(13)){
+				oldToNew[mapidx[idx]] = idx;
 			}
 		}
+
+		buildIntersections(mapidx, oldToNew);
 	}
-	else{
-		for(uint32_t idx2=0; idx2<idx+1; idx2++){
-			Mortontry = m_octants[idx2].computeMorton();
-			if (Mortontry == Morton){
-				return idx2;
+
+/*! Build m_intersections and the offsets of the intersections of each element,
+ * reusing the previous intersections of the octants untouched by an adapt if a mapper is given.
+ * \param[in] mapidx Mapper from new octants to old octants (empty to compute all the intersections).
+ * \param[in] oldToNew Map from old to new index of the octants untouched by the adapt (=number of octants if changed).
+ */
+void
+LocalTree::buildIntersections(const u32vector & mapidx, const u32vector & oldToNew) {
+
+		const uint32_t 			minChunkSize = 1024;
+		uint32_t 				noctants = getNumOctants();
+		uint32_t 				nelements = m_sizeGhosts + noctants;
+		int 					nthreads = 1;
+#ifdef _OPENMP
+		nthreads = omp_get_max_threads();
+#endif
+
+		// Chunks of at least minChunkSize elements, some per thread to balance the load
+		uint32_t nchunks = min(uint32_t(nthreads)*4, max(uint32_t(1), nelements/minChunkSize));
+		uint32_t chunkSize = (nelements + nchunks - 1)/nchunks;
+
+		vector<intervector> chunkIntersections(nchunks);
+		u64vector counts(nelements+1, 0);
+		u32vector elementCounts(nelements, 0);
+#pragma omp parallel for schedule(dynamic, 1) if (nchunks > 1)
+		for (uint32_t ichunk = 0; ichunk < nchunks; ichunk++){
+			uint32_t begin = min(nelements, ichunk*chunkSize);
+			uint32_t end = min(nelements, begin + chunkSize);
+			intervector & intersections = chunkIntersections[ichunk];
+			intersections.reserve(2*m_dim*(end - begin));
+
+			// Runs of elements whose intersections are computed, between the reused ones
+			uint32_t runBegin = begin;
+			for (uint32_t ielem = max(begin, m_sizeGhosts); ielem < end && !mapidx.empty(); ielem++){
+				uint32_t idx = ielem - m_sizeGhosts;
+				if (m_octants[idx].getInfo(12) || m_octants[idx].getInfo(13)){
+					continue;
+				}
+				uint64_t oldelem = uint64_t(m_intersectionsGhosts) + mapidx[idx];
+				uint64_t oldbegin = m_intersectionsOffsets[oldelem];
+				uint64_t oldend = m_intersectionsOffsets[oldelem + 1];
+				bool reuse = (oldend > oldbegin);
+				for (uint64_t k = oldbegin; k < oldend && reuse; k++){
+					const Intersection & old = m_intersections[k];
+					reuse = (!old.m_isghost && (old.m_bound ? m_octants[idx].getInfo(old.m_iface) : oldToNew[old.m_owners[1]] != noctants));
+				}
+				if (!reuse){
+					continue;
+				}
+
+				computeIntersections(runBegin, ielem, intersections, elementCounts.data());
+				for (uint64_t k = oldbegin; k < oldend; k++){
+					Intersection intersection = m_intersections[k];
+					intersection.m_owners[0] = idx;
+					intersection.m_owners[1] = intersection.m_bound ? idx : oldToNew[intersection.m_owners[1]];
+					intersections.push_back(intersection);
+				}
+				elementCounts[ielem] = uint32_t(oldend - oldbegin);
+				runBegin = ielem + 1;
 			}
+			computeIntersections(runBegin, end, intersections, elementCounts.data());
+		}
+
+		// Prefix sum of the chunk sizes and of the element sizes
+		u64vector offsets(nchunks+1, 0);
+		for (uint32_t ichunk = 0; ichunk < nchunks; ichunk++){
+			offsets[ichunk+1] = offsets[ichunk] + chunkIntersections[ichunk].size();
+		}
+		for (uint32_t ielem = 0; ielem < nelements; ielem++){
+			counts[ielem+1] = counts[ielem] + elementCounts[ielem];
 		}
+
+		intervector(offsets[nchunks]).swap(m_intersections);
+#pragma omp parallel for schedule(static) if (nchunks > 1)
+		for (uint32_t ichunk = 0; ichunk < nchunks; ichunk++){
+			copy(chunkIntersections[ichunk].begin(), chunkIntersections[ichunk].end(), m_intersections.begin() + offsets[ichunk]);
+			intervector().swap(chunkIntersections[ichunk]);
+		}
+		m_intersectionsOffsets.swap(counts);
+		m_intersectionsGhosts = m_sizeGhosts;
+	}
+
+/*! Clear the intersections of the local tree and free their memory.
+ */
+void
+LocalTree::clearIntersections() {
+		intervector().swap(m_intersections);
+		u64vector().swap(m_intersectionsOffsets);
+		m_intersectionsGhosts = 0;
+	}
+
+// =================================================================================== //
+/*! Find an input Morton in octants and return the local idx
+ * \param[in] Morton Morton index to be found.
+ * \return Local index of the target octant (=nocts if target Morton not found).
+*/
+uint32_t
+LocalTree::findMorton(uint64_t Morton){
+
+	u64vector::const_iterator it = lower_bound(m_mortons.begin(), m_mortons.end(), Morton);
+	if (it != m_mortons.end() && *it == Morton){
+		return uint32_t(it - m_mortons.begin());
 	}
-	return nocts-1;
+	return m_octants.size();
 };
 
 // =================================================================================== //
@@ -4580,104 +3944,219 @@ LocalTree::findMorton(uint64_t Morton){
 */
 uint32_t
 LocalTree::findGhostMorton(uint64_t Morton){
-	uint32_t 		nocts = m_ghosts.size();
-	uint32_t 		idx = nocts/2;
-	uint64_t 		Mortontry = m_ghosts[idx].computeMorton();
-	int32_t 		jump = nocts/2;
-
-	while(abs(jump)>0){
-		if (Mortontry == Morton){
-			return idx;
-		}
-		Mortontry = m_ghosts[idx].computeMorton();
-		jump = (Mortontry<Morton)*jump/4;
-		idx += jump;
-		if (idx > nocts){
-			return nocts;
-		}
+
+	u64vector::const_iterator it = lower_bound(m_ghostsMortons.begin(), m_ghostsMortons.end(), Morton);
+	if (it != m_ghostsMortons.end() && *it == Morton){
+		return uint32_t(it - m_ghostsMortons.begin());
 	}
-	if (Mortontry<Morton){
-		for (uint32_t idx2=idx; idx2<nocts; idx2++){
-			Mortontry = m_ghosts[idx2].computeMorton();
-			if (Mortontry == Morton){
-				return idx2;
-			}
-		}
+	return m_ghosts.size();
+};
+
+// =================================================================================== //
+/*! Find the last octant with Morton index lower than or equal to an input Morton.
+ * \param[in] Morton Target Morton index.
+ * \return Local index of the last octant with Morton <= target Morton (=0 if all the octants follow the target Morton).
+*/
+uint32_t
+LocalTree::findLowerMorton(uint64_t Morton) const{
+
+	u64vector::const_iterator it = upper_bound(m_mortons.begin(), m_mortons.end(), Morton);
+	if (it == m_mortons.begin()){
+		return 0;
 	}
-	else{
-		for(uint32_t idx2=0; idx2<idx; idx2++){
-			Mortontry = m_ghosts[idx2].computeMorton();
-			if (Mortontry == Morton){
-				return idx2;
-			}
-		}
+	return uint32_t(it - m_mortons.begin()) - 1;
+};
+
+// =================================================================================== //
+/*! Find the last ghost octant with Morton index lower than or equal to an input Morton.
+ * \param[in] Morton Target Morton index.
+ * \return Index of the last ghost octant with Morton <= target Morton (=0 if all the ghosts follow the target Morton).
+*/
+uint32_t
+LocalTree::findGhostLowerMorton(uint64_t Morton) const{
+
+	u64vector::const_iterator it = upper_bound(m_ghostsMortons.begin(), m_ghostsMortons.end(), Morton);
+	if (it == m_ghostsMortons.begin()){
+		return 0;
 	}
-	return nocts;
+	return uint32_t(it - m_ghostsMortons.begin()) - 1;
 };
 
 // =================================================================================== //
+/*! Compute the Morton indices of the local octants from scratch.
+ * To be called every time the vector of octants is rebuilt outside refine/coarse
+ * (e.g. after a load balance).
+ */
+void
+LocalTree::updateMortons(){
+
+	uint32_t noctants = m_octants.size();
+	m_mortons.resize(noctants);
+	u64vector(m_mortons).swap(m_mortons);
+#pragma omp parallel for schedule(static) if (noctants > 4096)
+	for (uint32_t idx = 0; idx < noctants; idx++){
+		m_mortons[idx] = m_octants[idx].computeMorton();
+	}
+};
 
-/** Compute the connectivity of octants and store the coordinates of nodes.
+// =================================================================================== //
+/*! Move a range of local octants (and their Morton indices) inside the vector of octants
+ * and resize it, as done by a load balance for the octants that stay on the process.
+ * The octants are shifted in place (nothing is moved if the range does not change
+ * position) and the vectors are shrunk only if they end up oversized.
+ * The octants outside the moved range are not preserved.
+ * \param[in] first Index of the first octant to move.
+ * \param[in] last Index past the last octant to move.
+ * \param[in] dest New index of the first octant of the range.
+ * \param[in] newSize New number of local octants (at least dest + last - first).
  */
 void
-LocalTree::computeConnectivity(){
+LocalTree::moveOctants(uint32_t first, uint32_t last, uint32_t dest, uint32_t newSize){
 
-	map<uint64_t, vector<uint32_t> > 			mapnodes;
-	map<uint64_t, vector<uint32_t> >::iterator 	iter, iterend;
-	uint32_t 									i, k, counter;
-	uint64_t 									morton;
-	uint32_t 									noctants = getNumOctants();
-	u32arr3vector								octnodes;
-	uint8_t 									j;
+	if (dest < first){
+		copy(m_octants.begin() + first, m_octants.begin() + last, m_octants.begin() + dest);
+		copy(m_mortons.begin() + first, m_mortons.begin() + last, m_mortons.begin() + dest);
+	}
+	else if (dest > first){
+		m_octants.resize(newSize);
+		m_mortons.resize(newSize);
+		copy_backward(m_octants.begin() + first, m_octants.begin() + last, m_octants.begin() + dest + (last - first));
+		copy_backward(m_mortons.begin() + first, m_mortons.begin() + last, m_mortons.begin() + dest + (last - first));
+	}
+	m_octants.resize(newSize);
+	m_mortons.resize(newSize);
 
-	clearConnectivity();
-	octnodes.reserve(m_global.m_nnodes);
+	shrinkOversized(m_octants);
+	shrinkOversized(m_mortons);
+};
 
-	if (m_nodes.size() == 0){
-		m_connectivity.resize(noctants);
-		for (i = 0; i < noctants; i++){
-			m_octants[i].getNodes(octnodes);
-			for (j = 0; j < m_global.m_nnodes; j++){
-				morton = keyXYZ(octnodes[j][0], octnodes[j][1], octnodes[j][2], m_global.m_maxLevel);
-				if (mapnodes[morton].size()==0){
-					mapnodes[morton].reserve(16);
-					for (k = 0; k < 3; k++){
-						mapnodes[morton].push_back(octnodes[j][k]);
-					}
-				}
-				mapnodes[morton].push_back(i);
-			}
-			u32arr3vector().swap(octnodes);
+// =================================================================================== //
+/*! Compute the Morton indices of the ghost octants from scratch.
+ * To be called every time the vector of ghosts is rebuilt.
+ */
+void
+LocalTree::updateGhostsMortons(){
+
+	uint32_t nghosts = m_ghosts.size();
+	m_ghostsMortons.resize(nghosts);
+	u64vector(m_ghostsMortons).swap(m_ghostsMortons);
+#pragma omp parallel for schedule(static) if (nghosts > 4096)
+	for (uint32_t idx = 0; idx < nghosts; idx++){
+		m_ghostsMortons[idx] = m_ghosts[idx].computeMorton();
+	}
+};
+
+// =================================================================================== //
+
+/** Sort a vector of keys (and the attached values) by a least significant digit
+ * radix sort on 8 bit digits. The passes on digits shared by all the keys are skipped.
+ * \param[in,out] keys Keys to be sorted.
+ * \param[in,out] values Values attached to the keys, permuted as the keys.
+ * \param[in] nbits Number of significant bits of the keys.
+ */
+static void
+radixSort(u64vector & keys, u32vector & values, uint8_t nbits){
+
+	size_t nkeys = keys.size();
+	u64vector keysTmp(nkeys);
+	u32vector valuesTmp(nkeys);
+	size_t count[256];
+
+	for (uint8_t shift = 0; shift < nbits; shift += 8){
+		fill(count, count + 256, 0);
+		for (size_t i = 0; i < nkeys; i++){
+			count[(keys[i] >> shift) & 0xff]++;
 		}
-		iter	= mapnodes.begin();
-		iterend	= mapnodes.end();
-		counter = 0;
-		uint32_t numnodes = mapnodes.size();
-		m_nodes.resize(numnodes);
-		while (iter != iterend){
-			u32vector nodecasting(iter->second.begin(), iter->second.begin()+3);
-			for (k=0; k<3; k++){
-				m_nodes[counter][k] = nodecasting[k];
-			}
-			u32array3(m_nodes[counter]).swap(m_nodes[counter]);
+		if (count[(keys[0] >> shift) & 0xff] == nkeys){
+			continue;
+		}
+		size_t offset = 0;
+		for (int d = 0; d < 256; d++){
+			size_t c = count[d];
+			count[d] = offset;
+			offset += c;
+		}
+		for (size_t i = 0; i < nkeys; i++){
+			size_t pos = count[(keys[i] >> shift) & 0xff]++;
+			keysTmp[pos] = keys[i];
+			valuesTmp[pos] = values[i];
+		}
+		keys.swap(keysTmp);
+		values.swap(valuesTmp);
+	}
+};
 
-			for(u32vector::iterator iter2 = iter->second.begin()+3; iter2 != iter->second.end(); iter2++){
-				if (m_connectivity[(*iter2)].size()==0){
-					m_connectivity[(*iter2)].reserve(8);
-				}
-				m_connectivity[(*iter2)].push_back(counter);
-			}
-			mapnodes.erase(iter++);
-			counter++;
+/** Compute the nodes of a set of octants and the fixed-stride connectivity
+ * (nnodes entries per octant) as indices in the vector of nodes.
+ * The Morton numbers of all the octant corners are sorted in a flat array and
+ * equal keys are merged, so that the nodes are numbered in Morton order.
+ * \param[in] octants Octants.
+ * \param[in] noctants Number of octants.
+ * \param[out] nodes Logical coordinates of the nodes.
+ * \param[out] connectivity connectivity[i*nnodes+j] = index of the j-th node of the i-th octant.
+ */
+void
+LocalTree::computeNodes(const octvector & octants, uint32_t noctants,
+		u32arr3vector & nodes, u32vector & connectivity){
+
+	uint8_t 	nnodes = m_global.m_nnodes;
+	uint64_t 	ncorners = uint64_t(noctants) * nnodes;
+	u64vector 	keys(ncorners);
+	u32vector 	corners(ncorners);
+
+	nodes.clear();
+	connectivity.resize(ncorners);
+	if (ncorners == 0){
+		return;
+	}
+
+#pragma omp parallel for schedule(static) if (noctants > 4096)
+	for (uint32_t i = 0; i < noctants; i++){
+		const Octant & octant = octants[i];
+		uint32_t size = octant.getSize();
+		for (uint8_t j = 0; j < nnodes; j++){
+			uint64_t k = uint64_t(i) * nnodes + j;
+			keys[k] = mortonEncode(octant.m_x + (j%2)*size,
+					octant.m_y + ((j%4)/2)*size, octant.m_z + (j/4)*size);
+			corners[k] = k;
 		}
-		u32arr3vector(m_nodes).swap(m_nodes);
+	}
 
-		u32vector2D(m_connectivity).swap(m_connectivity);
+	// Node coordinates lie in [0, maxLength], i.e. maxLevel+1 bits per direction
+	radixSort(keys, corners, 3*(m_global.m_maxLevel + 1));
 
+	uint32_t nnumbered = 0;
+	for (uint64_t k = 0; k < ncorners; k++){
+		if (k == 0 || keys[k] != keys[k-1]){
+			nnumbered++;
+		}
 	}
+	nodes.resize(nnumbered);
 
-	map<uint64_t, vector<uint32_t> >().swap(mapnodes);
-	iter = mapnodes.end();
+	uint32_t inode = 0;
+	for (uint64_t k = 0; k < ncorners; k++){
+		if (k > 0 && keys[k] != keys[k-1]){
+			inode++;
+		}
+		if (k == 0 || keys[k] != keys[k-1]){
+			uint32_t x, y, z;
+			mortonDecode(keys[k], x, y, z);
+			nodes[inode][0] = x;
+			nodes[inode][1] = y;
+			nodes[inode][2] = z;
+		}
+		connectivity[corners[k]] = inode;
+	}
+};
+
+/** Compute the connectivity of octants and store the coordinates of nodes.
+ */
+void
+LocalTree::computeConnectivity(){
+
+	if (m_nodes.size() == 0){
+		computeNodes(m_octants, getNumOctants(), m_nodes, m_connectivity);
+	}
 
 };
 
@@ -4686,7 +4165,8 @@ LocalTree::computeConnectivity(){
 void
 LocalTree::clearConnectivity(){
 	u32arr3vector().swap(m_nodes);
-	u32vector2D().swap(m_connectivity);
+	u32vector().swap(m_connectivity);
+	u32vector2D().swap(m_nestedConnectivity);
 };
 
 /*! Updates nodes vector and connectivity of octants of local tree
@@ -4702,57 +4182,9 @@ LocalTree::updateConnectivity(){
 void
 LocalTree::computeGhostsConnectivity(){
 
-	map<uint64_t, vector<uint32_t> > 			mapnodes;
-	map<uint64_t, vector<uint32_t> >::iterator 	iter, iterend;
-	uint32_t 									i, k, counter;
-	uint64_t 									morton;
-	uint32_t 									noctants = m_sizeGhosts;
-	u32arr3vector								octnodes;
-	uint8_t 									j;
-
-	octnodes.reserve(m_global.m_nnodes);
 	if (m_ghostsNodes.size() == 0){
-		m_ghostsConnectivity.resize(noctants);
-		for (i = 0; i < noctants; i++){
-			m_ghosts[i].getNodes(octnodes);
-			for (j = 0; j < m_global.m_nnodes; j++){
-				morton = keyXYZ(octnodes[j][0], octnodes[j][1], octnodes[j][2], m_global.m_maxLevel);
-				if (mapnodes[morton].size()==0){
-					mapnodes[morton].reserve(16);
-					for (k = 0; k < 3; k++){
-						mapnodes[morton].push_back(octnodes[j][k]);
-					}
-				}
-				mapnodes[morton].push_back(i);
-			}
-			u32arr3vector().swap(octnodes);
-		}
-		iter	= mapnodes.begin();
-		iterend	= mapnodes.end();
-		uint32_t numnodes = mapnodes.size();
-		m_ghostsNodes.resize(numnodes);
-		counter = 0;
-		while (iter != iterend){
-			vector<uint32_t> nodecasting(iter->second.begin(), iter->second.begin()+3);
-			for (k=0; k<3; k++){
-				m_ghostsNodes[counter][k] = nodecasting[k];
-			}
-			u32array3(m_ghostsNodes[counter]).swap(m_ghostsNodes[counter]);
-			for(vector<uint32_t>::iterator iter2 = iter->second.begin()+3; iter2 != iter->second.end(); iter2++){
-				if (m_ghostsConnectivity[(*iter2)].size()==0){
-					m_ghostsConnectivity[(*iter2)].reserve(8);
-				}
-				m_ghostsConnectivity[(*iter2)].push_back(counter);
-			}
-			mapnodes.erase(iter++);
-			counter++;
-		}
-		u32arr3vector(m_ghostsNodes).swap(m_ghostsNodes);
-
-		u32vector2D(m_ghostsConnectivity).swap(m_ghostsConnectivity);
-
+		computeNodes(m_ghosts, m_sizeGhosts, m_ghostsNodes, m_ghostsConnectivity);
 	}
-	iter = mapnodes.end();
 
 };
 
@@ -4761,7 +4193,8 @@ LocalTree::computeGhostsConnectivity(){
 void
 LocalTree::clearGhostsConnectivity(){
 	u32arr3vector().swap(m_ghostsNodes);
-	u32vector2D().swap(m_ghostsConnectivity);
+	u32vector().swap(m_ghostsConnectivity);
+	u32vector2D().swap(m_nestedGhostsConnectivity);
 };
 
 /*! Update ghosts nodes vector and connectivity of ghosts octants of local tree
@@ -4772,6 +4205,66 @@ LocalTree::updateGhostsConnectivity(){
 	computeGhostsConnectivity();
 };
 
+/*! Get a view of the fixed-stride connectivity of the octants of local tree
+ * \return View of the connectivity (empty if the connectivity is not computed).
+ */
+ConnectivityView
+LocalTree::getConnectivityView() const{
+	if (m_connectivity.empty()){
+		return ConnectivityView();
+	}
+	return ConnectivityView(m_connectivity.data(), m_connectivity.size()/m_global.m_nnodes, m_global.m_nnodes);
+};
+
+/*! Get a view of the fixed-stride connectivity of the ghost octants of local tree
+ * \return View of the ghosts connectivity (empty if the connectivity is not computed).
+ */
+ConnectivityView
+LocalTree::getGhostsConnectivityView() const{
+	if (m_ghostsConnectivity.empty()){
+		return ConnectivityView();
+	}
+	return ConnectivityView(m_ghostsConnectivity.data(), m_ghostsConnectivity.size()/m_global.m_nnodes, m_global.m_nnodes);
+};
+
+/*! Get the connectivity of the octants of local tree as a vector per octant.
+ * The nested copy is built at the first call after a connectivity update and it
+ * doubles the memory used by the connectivity; prefer getConnectivityView.
+ * \return Constant reference to the nested connectivity.
+ */
+const u32vector2D &
+LocalTree::getNestedConnectivity(){
+	uint8_t nnodes = m_global.m_nnodes;
+	uint32_t noctants = m_connectivity.size()/nnodes;
+	if (m_nestedConnectivity.size() != noctants){
+		m_nestedConnectivity.resize(noctants);
+		for (uint32_t i = 0; i < noctants; i++){
+			m_nestedConnectivity[i].assign(m_connectivity.begin() + uint64_t(i)*nnodes,
+					m_connectivity.begin() + uint64_t(i+1)*nnodes);
+		}
+	}
+	return m_nestedConnectivity;
+};
+
+/*! Get the connectivity of the ghost octants of local tree as a vector per ghost.
+ * The nested copy is built at the first call after a connectivity update and it
+ * doubles the memory used by the connectivity; prefer getGhostsConnectivityView.
+ * \return Constant reference to the nested ghosts connectivity.
+ */
+const u32vector2D &
+LocalTree::getNestedGhostsConnectivity(){
+	uint8_t nnodes = m_global.m_nnodes;
+	uint32_t nghosts = m_ghostsConnectivity.size()/nnodes;
+	if (m_nestedGhostsConnectivity.size() != nghosts){
+		m_nestedGhostsConnectivity.resize(nghosts);
+		for (uint32_t i = 0; i < nghosts; i++){
+			m_nestedGhostsConnectivity[i].assign(m_ghostsConnectivity.begin() + uint64_t(i)*nnodes,
+					m_ghostsConnectivity.begin() + uint64_t(i+1)*nnodes);
+		}
+	}
+	return m_nestedGhostsConnectivity;
+};
+
 // =================================================================================== //
 
 
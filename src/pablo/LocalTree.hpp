@@ -7,6 +7,7 @@
 #include "Global.hpp"
 #include "Octant.hpp"
 #include "Intersection.hpp"
+#include "ConnectivityView.hpp"
 
 // =================================================================================== //
 // TYPEDEFS
@@ -71,7 +72,11 @@ public:
 private:
 	octvector				m_octants;				/**< Local vector of octants ordered with Morton Number */
 	octvector				m_ghosts;				/**< Local vector of ghost octants ordered with Morton Number */
+	u64vector				m_mortons;				/**< Morton numbers of the local octants (m_mortons[i] = Morton of m_octants[i]) */
+	u64vector				m_ghostsMortons;		/**< Morton numbers of the ghost octants (m_ghostsMortons[i] = Morton of m_ghosts[i]) */
 	intervector				m_intersections;		/**< Local vector of intersections */
+	u64vector				m_intersectionsOffsets;	/**< Offsets of the intersections computed for each element, ghosts first (size = nelements+1, empty if not computed) */
+	uint32_t				m_intersectionsGhosts;	/**< Number of ghosts when the intersections have been computed */
 	u64vector 				m_globalIdxGhosts;		/**< Global index of the ghost octants (size = size_ghosts) */
 	Octant 					m_firstDesc;			/**< First (Morton order) most refined octant possible in local partition */
 	Octant			 		m_lastDesc;				/**< Last (Morton order) most refined octant possible in local partition */
@@ -81,12 +86,20 @@ private:
 	 	 	 	 	 	 	 	 	 	 	 	 	 	 2 = 2:1 balance through edges and faces;
 	 	 	 	 	 	 	 	 	 	 	 	 	 	 3 = 2:1 balance through nodes, edges and faces)*/
 	u32vector 				m_lastGhostBros;		/**<Index of ghost brothers in case of broken family coarsened*/
-	u32vector2D				m_connectivity;			/**<Local vector of connectivity (node1, node2, ...) ordered with Morton-order.
-	 	 	 	 	 	 	 	 	 	 	 	 	 	 The nodes are stored as index of vector nodes*/
-	u32vector2D				m_ghostsConnectivity;	/**<Local vector of ghosts connectivity (node1, node2, ...) ordered with Morton-order.
-	 	 	 	 	 	 	 	 	 	 	 	 	 	 The nodes are stored as index of vector nodes*/
+	u32vector				m_connectivity;			/**<Local connectivity of the octants ordered with Morton-order, with a fixed stride of nnodes
+	 	 	 	 	 	 	 	 	 	 	 	 	 	 entries per octant (m_connectivity[i*nnodes+j] = index in m_nodes of the j-th node of octant i)*/
+	u32vector				m_ghostsConnectivity;	/**<Local connectivity of the ghosts ordered with Morton-order, with a fixed stride of nnodes
+	 	 	 	 	 	 	 	 	 	 	 	 	 	 entries per ghost (m_ghostsConnectivity[i*nnodes+j] = index in m_ghostsNodes of the j-th node of ghost i)*/
+	u32vector2D				m_nestedConnectivity;	/**<Copy of m_connectivity as a vector per octant, built on demand by the compatibility accessors*/
+	u32vector2D				m_nestedGhostsConnectivity;	/**<Copy of m_ghostsConnectivity as a vector per ghost, built on demand by the compatibility accessors*/
 	u32arr3vector			m_nodes;				/**<Local vector of nodes (x,y,z) ordered with Morton Number*/
 	u32arr3vector			m_ghostsNodes;			/**<Local vector of ghosts nodes (x,y,z) ordered with Morton Number*/
+	u64vector				m_neighOffsets;			/**<Offsets of the cached neighbours of each octant entity (CSR, size = noctants*nentities+1).
+	 	 	 	 	 	 	 	 	 	 	 	 	 	 The entities of an octant are ordered as faces, edges (3D only) and nodes*/
+	u32vector				m_neighIdx;				/**<Cached neighbours of the octants entities, as indices in octants or ghosts structure*/
+	std::vector<bool>		m_neighIsGhost;			/**<Cached ghost flags of the neighbours stored in m_neighIdx*/
+	uint8_t					m_neighCodim;			/**<Maximum codimension of the entities in the neighbour cache (0 = neighbour cache disabled)*/
+	bool					m_neighCached;			/**<True if the neighbour cache is consistent with the current local tree*/
 
 	uint8_t					m_dim;					/**<Space dimension. Only 2D or 3D space accepted*/
 	Global					m_global;				/**<Global variables*/
@@ -162,24 +175,55 @@ private:
 								u32vector & neighbours, std::vector<bool> & isghost);
 	void 		findGhostNodeNeighbours(uint32_t idx, uint8_t inode,
 								u32vector & neighbours);
+	void 		findEntityNeighbours(uint32_t idx, uint8_t ientity,
+								u32vector & neighbours, std::vector<bool> & isghost);
+
+	uint8_t 	getNumNeighEntities() const;
+	bool 		getNeighEntity(uint8_t iface, uint8_t codim, uint8_t & ientity) const;
+	bool 		findCachedNeighbours(uint32_t idx, uint8_t iface, uint8_t codim,
+								u32vector & neighbours, std::vector<bool> & isghost);
+	void 		computeNeighbourCache();
+	void 		updateNeighbourCache(const u32vector & mapidx);
+	void 		clearNeighbourCache();
 
 
-	void 		preBalance21(bool internal);
+	bool 		preBalance21(bool internal);
 	void 		preBalance21(u32vector& newmodified);
 	bool 		localBalance(bool doInterior);
 	bool 		localBalanceAll(bool doInterior);
+	bool 		localBalanceGhosts(const u32vector & ghostSources);
+	void 		checkBalance(uint32_t idx, bool isGhostSource, bool checkGhosts, u32vector & neigh,
+								std::vector<bool> & isghost, std::vector<std::pair<uint32_t, int8_t> > & proposals);
+	bool 		balanceSweep(const u32vector & sources, const u32vector & ghostSources, bool checkGhosts,
+								u32vector & modified);
+	bool 		balanceModified(u32vector & modified);
 
 	void 		computeIntersections();
+	void 		computeIntersections(uint32_t begin, uint32_t end, intervector & intersections, uint32_t* counts = NULL);
+	void 		updateIntersections(const u32vector & mapidx);
+	void 		buildIntersections(const u32vector & mapidx, const u32vector & oldToNew);
+	void 		clearIntersections();
 
 	uint32_t 	findMorton(uint64_t Morton);
 	uint32_t 	findGhostMorton(uint64_t Morton);
-
+	uint32_t 	findLowerMorton(uint64_t Morton) const;
+	uint32_t 	findGhostLowerMorton(uint64_t Morton) const;
+	void 		updateMortons();
+	void 		moveOctants(uint32_t first, uint32_t last, uint32_t dest, uint32_t newSize);
+	void 		updateGhostsMortons();
+
+	void 		computeNodes(const octvector & octants, uint32_t noctants,
+								u32arr3vector & nodes, u32vector & connectivity);
 	void 		computeConnectivity();
 	void 		clearConnectivity();
 	void 		updateConnectivity();
 	void 		computeGhostsConnectivity();
 	void 		clearGhostsConnectivity();
 	void 		updateGhostsConnectivity();
+	ConnectivityView			getConnectivityView() const;
+	ConnectivityView			getGhostsConnectivityView() const;
+	const u32vector2D &			getNestedConnectivity();
+	const u32vector2D &			getNestedGhostsConnectivity();
 
 	// =================================================================================== //
 
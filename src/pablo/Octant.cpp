@@ -3,6 +3,7 @@
 // =================================================================================== //
 #include "Octant.hpp"
 #include <algorithm>
+#include <math.h>
 
 // =================================================================================== //
 // NAME SPACES                                                                         //
@@ -21,6 +22,8 @@ constexpr int Octant::sm_CoeffFaceCenter[6][3];
 constexpr int Octant::sm_CoeffEdgeCenter[12][3];
 int8_t Octant::sm_maxLevel;
 
+static_assert(sizeof(Octant) == 16, "Octant has to fit in 16 bytes (coordinates, info flags, level and marker)");
+
 // =================================================================================== //
 // CONSTRUCTORS AND OPERATORS
 // =================================================================================== //
@@ -29,14 +32,16 @@ int8_t Octant::sm_maxLevel;
  * It builds a 2D zero-level octant with origin in (0,0,0).
  */
 Octant::Octant(){
-	m_dim = 2;
-	sm_maxLevel = 20;
+	// sm_maxLevel is shared by all the octants and octants are built concurrently
+	// by the multi-threaded kernels: write it only if it changes
+	if (sm_maxLevel != 20) sm_maxLevel = 20;
 	m_x = m_y = m_z = 0;
 	m_level = 0;
 	m_marker = 0;
-	//default constructor of bitset is zero value -> set boundary condition true for faces
+	m_info = 0;
+	//info flags are zero -> set boundary condition -> set boundary condition true for faces
 	for (uint8_t i=0; i<4; i++){
-		m_info[i] = true;
+		setInfo(i, true);
 	}
 };
 
@@ -46,15 +51,15 @@ Octant::Octant(){
  * \param[in] maxlevel Maximum refinement level of the octree.
  */
 Octant::Octant(uint8_t dim_, int8_t maxlevel){
-	m_dim = dim_;
-	sm_maxLevel = maxlevel;
+	if (sm_maxLevel != maxlevel) sm_maxLevel = maxlevel;
 	m_x = m_y = m_z = 0;
 	m_level = 0;
 	m_marker = 0;
-	uint8_t nf = m_dim*2;
-	//default constructor of bitset is zero value -> set boundary condition true for faces
+	m_info = 0;
+	uint8_t nf = dim_*2;
+	//info flags are zero -> set boundary condition -> set boundary condition true for faces
 	for (uint8_t i=0; i<nf; i++){
-		m_info[i] = true;
+		setInfo(i, true);
 	}
 };
 
@@ -66,18 +71,18 @@ Octant::Octant(uint8_t dim_, int8_t maxlevel){
  * \param[in] x_,y_,z_ Coordinates of the origin of the octant (default values for z=0).
  */
 Octant::Octant(uint8_t dim_, uint8_t level_, int32_t x_, int32_t y_, int32_t z_, int8_t maxlevel){
-	m_dim = dim_;
-	sm_maxLevel = maxlevel;
+	if (sm_maxLevel != maxlevel) sm_maxLevel = maxlevel;
 	m_x = x_;
 	m_y = y_;
-	m_z = (m_dim-2)*z_;
+	m_z = (dim_-2)*z_;
 	m_level = level_;
 	m_marker = 0;
-	//default constructor of bitset is zero value -> set boundary condition true for faces
+	m_info = 0;
+	//info flags are zero -> set boundary condition -> set boundary condition true for faces
 	if (m_level==0){
-		uint8_t nf = m_dim*2;
+		uint8_t nf = dim_*2;
 		for (uint8_t i=0; i<nf; i++){
-			m_info[i] = true;
+			setInfo(i, true);
 		}
 	}
 };
@@ -91,18 +96,18 @@ Octant::Octant(uint8_t dim_, uint8_t level_, int32_t x_, int32_t y_, int32_t z_,
  * \param[in] x_,y_,z_ Coordinates of the origin of the octant (default values for z=0).
  */
 Octant::Octant(bool bound, uint8_t dim_, uint8_t level_, int32_t x_, int32_t y_, int32_t z_, int8_t maxlevel){
-	m_dim = dim_;
-	sm_maxLevel = maxlevel;
+	if (sm_maxLevel != maxlevel) sm_maxLevel = maxlevel;
 	m_x = x_;
 	m_y = y_;
-	m_z = (m_dim-2)*z_;
+	m_z = (dim_-2)*z_;
 	m_level = level_;
 	m_marker = 0;
-	//default constructor of bitset is zero value -> set boundary condition bound for faces
+	m_info = 0;
+	//info flags are zero -> set boundary condition -> set boundary condition bound for faces
 	if (m_level==0){
-		uint8_t nf = m_dim*2;
+		uint8_t nf = dim_*2;
 		for (uint8_t i=0; i<nf; i++){
-			m_info[i] = bound;
+			setInfo(i, bound);
 		}
 	}
 };
@@ -110,7 +115,6 @@ Octant::Octant(bool bound, uint8_t dim_, uint8_t level_, int32_t x_, int32_t y_,
 /*! Copy constructor of an octant.
  */
 Octant::Octant(const Octant &octant){
-	m_dim = octant.m_dim;
 	m_x = octant.m_x;
 	m_y = octant.m_y;
 	m_z = octant.m_z;
@@ -123,7 +127,6 @@ Octant::Octant(const Octant &octant){
  */
 bool Octant::operator ==(const Octant & oct2){
 	bool check = true;
-	check = check && (m_dim == oct2.m_dim);
 	check = check && (m_x == oct2.m_x);
 	check = check && (m_y == oct2.m_y);
 	check = check && (m_z == oct2.m_z);
@@ -139,12 +142,6 @@ bool Octant::operator ==(const Octant & oct2){
 // BASIC GET/SET METHODS
 // =================================================================================== //
 
-/*! Get the dimension of an octant, 2 or 3 if 2D or 3D octant.
- * \return Dimension of octant.
- */
-uint32_t
-Octant::getDim() const{return m_dim;};
-
 /*! Get the coordinates of an octant, i.e. the coordinates of its node 0.
  * \return Coordinates of node 0.
  */
@@ -205,15 +202,16 @@ Octant::getMarker() const{return m_marker;};
  */
 bool
 Octant::getBound(uint8_t face) const{
-	return m_info[face];
+	return getInfo(face);
 };
 
 /*! Get the bound flag on an octant.
+ * In 2D the flags of the faces 4 and 5 are never set.
  * \return true if the octant is a boundary octant.
  */
 bool
 Octant::getBound() const{
-	return m_info[0]||m_info[1]||m_info[2]||m_info[3]||((m_dim-2)*(m_info[4]||m_info[5]));
+	return (m_info & 0x3f) != 0;
 };
 
 /*! Set the boundary flag to true on an octant face.
@@ -221,7 +219,7 @@ Octant::getBound() const{
  */
 void
 Octant::setBound(uint8_t face) {
-	m_info[face] = true;
+	setInfo(face, true);
 };
 
 /*! Get the pbound flag on an octant face.
@@ -230,47 +228,47 @@ Octant::setBound(uint8_t face) {
  */
 bool
 Octant::getPbound(uint8_t face) const{
-	return m_info[6+face];
+	return getInfo(6+face);
 };
 
-/*! Get the pbound flag on an octant face.
- * \param[in] iface local index of the face.
- * \return true if the iface face is a process boundary face.
+/*! Get the pbound flag on an octant.
+ * In 2D the flags of the faces 4 and 5 are never set.
+ * \return true if the octant is a process boundary octant.
  */
 bool
 Octant::getPbound() const{
-	return m_info[6]||m_info[7]||m_info[8]||m_info[9]||((m_dim-2)*(m_info[10]||m_info[11]));
+	return (m_info & 0xfc0) != 0;
 };
 
 /*! Get if the octant is new after a refinement.
  * \return true if the the octant is new after a refinement.
  */
 bool
-Octant::getIsNewR() const{return m_info[12];};
+Octant::getIsNewR() const{return getInfo(12);};
 
 /*! Get if the octant is new after a coarsening.
  * \return true if the the octant is new after a coarsening.
  */
 bool
-Octant::getIsNewC() const{return m_info[13];};
+Octant::getIsNewC() const{return getInfo(13);};
 
 /*! Get if the octant is a scary ghost octant.
  * \return true if the octant is a ghost octant.
  */
 bool
-Octant::getIsGhost() const{return m_info[16];};
+Octant::getIsGhost() const{return getInfo(16);};
 
 /*! Get if the octant is a balancing-blocked octant.
  * \return false if the octant has to be balanced.
  */
 bool
-Octant::getNotBalance() const{return m_info[14];};
+Octant::getNotBalance() const{return getInfo(14);};
 
 /*! Get if the octant has to be balanced.
  * \return true if the octant has to be balanced.
  */
 bool
-Octant::getBalance() const{return (!m_info[14]);};
+Octant::getBalance() const{return (!getInfo(14));};
 
 /*! Set the refinement marker of an octant.
  * \param[in] marker Refinement marker of octant (n=n refinement in adapt, -n=n coarsening in adapt, default=0).
@@ -285,7 +283,7 @@ Octant::setMarker(int8_t marker){
  */
 void
 Octant::setBalance(bool balance){
-	m_info[14] = balance;
+	setInfo(14, balance);
 };
 
 /*! Set the level of an octant.
@@ -301,7 +299,7 @@ Octant::setLevel(uint8_t level){
  */
 void
 Octant::setPbound(uint8_t face, bool flag){
-	m_info[6+face] = flag;
+	setInfo(6+face, flag);
 };
 
 // =================================================================================== //
@@ -318,20 +316,22 @@ Octant::getSize() const{
 };
 
 /*! Get the area of an octant in logical domain .
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \return Area of octant.
  */
 uint64_t
-Octant::getArea() const{
-	uint64_t area = uint64_t(pow(double(getSize()),double(m_dim-1)));
+Octant::getArea(uint8_t dim) const{
+	uint64_t area = uint64_t(pow(double(getSize()),double(dim-1)));
 	return area;
 };
 
 /*! Get the volume of an octant in logical domain.
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \return Volume of octant.
  */
 uint64_t
-Octant::getVolume() const{
-	uint64_t volume = uint64_t(pow(double(getSize()),double(m_dim)));
+Octant::getVolume(uint8_t dim) const{
+	uint64_t volume = uint64_t(pow(double(getSize()),double(dim)));
 	return volume;
 };
 
@@ -355,16 +355,17 @@ Octant::getCenter() const{
 // =================================================================================== //
 
 /*! Get the coordinates of the center of a face of an octant in logical domain.
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \param[in] iface Local index of the face
  * \return Array[3] with the coordinates of the center of the octant face.
  */
 darray3
-Octant::getFaceCenter(uint8_t iface) const{
+Octant::getFaceCenter(uint8_t dim, uint8_t iface) const{
 	double	dh_2;
 	darray3 center;
 
 	dh_2 = double(getSize())/2.0;
-	uint8_t nf = m_dim*2;
+	uint8_t nf = dim*2;
 	if (iface < nf){
 		center[0] = (double)m_x + (double)sm_CoeffFaceCenter[iface][0] * dh_2;
 		center[1] = (double)m_y + (double)sm_CoeffFaceCenter[iface][1] * dh_2;
@@ -394,13 +395,14 @@ Octant::getEdgeCenter(uint8_t iedge) const{
 // =================================================================================== //
 
 /*! Get the coordinates of the nodes of an octant in logical domain.
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \param[out] nodes Vector of arrays [nnodes][3] with the coordinates of the nodes of octant.
  */
 void
-Octant::getNodes(u32arr3vector & nodes) const{
+Octant::getNodes(uint8_t dim, u32arr3vector & nodes) const{
 	uint8_t		i, cx, cy, cz;
 	uint32_t	dh;
-	uint8_t nn = 1<<m_dim;
+	uint8_t nn = 1<<dim;
 
 	dh = getSize();
 	nodes.resize(nn);
@@ -416,13 +418,14 @@ Octant::getNodes(u32arr3vector & nodes) const{
 };
 
 /*! Get the coordinates of the nodes of an octant in logical domain.
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \return Vector of arrays [nnodes][3] with the coordinates of the nodes of octant.
  */
 u32arr3vector
-Octant::getNodes() const{
+Octant::getNodes(uint8_t dim) const{
 	uint8_t		i, cx, cy, cz;
 	uint32_t	dh;
-	uint8_t nn = 1<<m_dim;
+	uint8_t nn = 1<<dim;
 	u32arr3vector nodes;
 
 	dh = getSize();
@@ -436,6 +439,7 @@ Octant::getNodes() const{
 		nodes[i][1] = m_y + cy*dh;
 		nodes[i][2] = m_z + cz*dh;
 	}
+	return nodes;
 };
 
 /*! Get the coordinates of a nodes of an octant in logical domain.
@@ -492,7 +496,7 @@ void		Octant::getNormal(uint8_t & iface, i8array3 & normal, int8_t (&normals)[6]
  */
 uint64_t	Octant::computeMorton() const{
 	uint64_t morton = 0;
-	morton = mortonEncode_magicbits(this->m_x,this->m_y,this->m_z);
+	morton = mortonEncode(this->m_x,this->m_y,this->m_z);
 	return morton;
 };
 
@@ -502,7 +506,7 @@ uint64_t	Octant::computeMorton() const{
  */
 uint64_t	Octant::computeMorton(){
 	uint64_t morton = 0;
-	morton = mortonEncode_magicbits(this->m_x,this->m_y,this->m_z);
+	morton = mortonEncode(this->m_x,this->m_y,this->m_z);
 	return morton;
 };
 
@@ -511,45 +515,48 @@ uint64_t	Octant::computeMorton(){
 // =================================================================================== //
 
 /** Build the last descendant octant of this octant.
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \return Last descendant octant.
  */
-Octant	Octant::buildLastDesc(){
+Octant	Octant::buildLastDesc(uint8_t dim){
 	uint32_t delta[3] = {0,0,0};
-	for (int i=0; i<m_dim; i++){
+	for (int i=0; i<dim; i++){
 		delta[i] = (uint32_t)(1 << (sm_maxLevel - m_level)) - 1;
 	}
 
-	Octant last_desc(m_dim, m_x+delta[0], m_y+delta[1], m_z+delta[2], sm_maxLevel);
+	Octant last_desc(dim, m_x+delta[0], m_y+delta[1], m_z+delta[2], sm_maxLevel);
 	return last_desc;
 };
 
 // =================================================================================== //
 
 /** Build the father octant of this octant.
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \return Father octant.
  */
-Octant	Octant::buildFather(){
+Octant	Octant::buildFather(uint8_t dim){
 	uint32_t delta[3];
 	uint32_t xx[3];
 	xx[0] = m_x;
 	xx[1] = m_y;
 	xx[2] = m_z;
 	delta[2] = 0;
-	for (int i=0; i<m_dim; i++){
+	for (int i=0; i<dim; i++){
 		delta[i] = xx[i]%(uint32_t(1 << (sm_maxLevel - max(0,(m_level-1)))));
 	}
-	Octant father(m_dim, max(0,m_level-1), m_x-delta[0], m_y-delta[1], m_z-delta[2], sm_maxLevel);
+	Octant father(dim, max(0,m_level-1), m_x-delta[0], m_y-delta[1], m_z-delta[2], sm_maxLevel);
 	return father;
 };
 
 // =================================================================================== //
 
 /** Builds children of octant.
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  *   \return Ordered (by Z-index) vector of children[nchildren] (info update)
  */
-vector< Octant >	Octant::buildChildren(){
+vector< Octant >	Octant::buildChildren(uint8_t dim){
 	uint8_t xf,yf,zf;
-	int nchildren = 1<<m_dim;
+	int nchildren = 1<<dim;
 
 	if (this->m_level < sm_maxLevel){
 		vector< Octant > children(nchildren);
@@ -560,12 +567,15 @@ vector< Octant >	Octant::buildChildren(){
 				Octant oct(*this);
 				oct.setMarker(max(0,oct.m_marker-1));
 				oct.setLevel(oct.m_level+1);
-				oct.m_info[12]=true;
+				oct.setInfo(12, true);
 				// Update interior face bound and pbound
 				xf=1; yf=3; zf=5;
-				oct.m_info[xf] = oct.m_info[xf+6] = false;
-				oct.m_info[yf] = oct.m_info[yf+6] = false;
-				oct.m_info[zf] = oct.m_info[zf+6] = false;
+				oct.setInfo(xf, false);
+				oct.setInfo(xf+6, false);
+				oct.setInfo(yf, false);
+				oct.setInfo(yf+6, false);
+				oct.setInfo(zf, false);
+				oct.setInfo(zf+6, false);
 				children[0] = oct;
 			}
 			break;
@@ -574,14 +584,17 @@ vector< Octant >	Octant::buildChildren(){
 				Octant oct(*this);
 				oct.setMarker(max(0,oct.m_marker-1));
 				oct.setLevel(oct.m_level+1);
-				oct.m_info[12]=true;
+				oct.setInfo(12, true);
 				uint32_t dh = oct.getSize();
 				oct.m_x += dh;
 				// Update interior face bound and pbound
 				xf=0; yf=3; zf=5;
-				oct.m_info[xf] = oct.m_info[xf+6] = false;
-				oct.m_info[yf] = oct.m_info[yf+6] = false;
-				oct.m_info[zf] = oct.m_info[zf+6] = false;
+				oct.setInfo(xf, false);
+				oct.setInfo(xf+6, false);
+				oct.setInfo(yf, false);
+				oct.setInfo(yf+6, false);
+				oct.setInfo(zf, false);
+				oct.setInfo(zf+6, false);
 				children[1] = oct;
 			}
 			break;
@@ -590,14 +603,17 @@ vector< Octant >	Octant::buildChildren(){
 				Octant oct(*this);
 				oct.setMarker(max(0,oct.m_marker-1));
 				oct.setLevel(oct.m_level+1);
-				oct.m_info[12]=true;
+				oct.setInfo(12, true);
 				uint32_t dh = oct.getSize();
 				oct.m_y += dh;
 				// Update interior face bound and pbound
 				xf=1; yf=2; zf=5;
-				oct.m_info[xf] = oct.m_info[xf+6] = false;
-				oct.m_info[yf] = oct.m_info[yf+6] = false;
-				oct.m_info[zf] = oct.m_info[zf+6] = false;
+				oct.setInfo(xf, false);
+				oct.setInfo(xf+6, false);
+				oct.setInfo(yf, false);
+				oct.setInfo(yf+6, false);
+				oct.setInfo(zf, false);
+				oct.setInfo(zf+6, false);
 				children[2] = oct;
 			}
 			break;
@@ -606,15 +622,18 @@ vector< Octant >	Octant::buildChildren(){
 				Octant oct(*this);
 				oct.setMarker(max(0,oct.m_marker-1));
 				oct.setLevel(oct.m_level+1);
-				oct.m_info[12]=true;
+				oct.setInfo(12, true);
 				uint32_t dh = oct.getSize();
 				oct.m_x += dh;
 				oct.m_y += dh;
 				// Update interior face bound and pbound
 				xf=0; yf=2; zf=5;
-				oct.m_info[xf] = oct.m_info[xf+6] = false;
-				oct.m_info[yf] = oct.m_info[yf+6] = false;
-				oct.m_info[zf] = oct.m_info[zf+6] = false;
+				oct.setInfo(xf, false);
+				oct.setInfo(xf+6, false);
+				oct.setInfo(yf, false);
+				oct.setInfo(yf+6, false);
+				oct.setInfo(zf, false);
+				oct.setInfo(zf+6, false);
 				children[3] = oct;
 			}
 			break;
@@ -623,14 +642,17 @@ vector< Octant >	Octant::buildChildren(){
 				Octant oct(*this);
 				oct.setMarker(max(0,oct.m_marker-1));
 				oct.setLevel(oct.m_level+1);
-				oct.m_info[12]=true;
+				oct.setInfo(12, true);
 				uint32_t dh = oct.getSize();
 				oct.m_z += dh;
 				// Update interior face bound and pbound
 				xf=1; yf=3; zf=4;
-				oct.m_info[xf] = oct.m_info[xf+6] = false;
-				oct.m_info[yf] = oct.m_info[yf+6] = false;
-				oct.m_info[zf] = oct.m_info[zf+6] = false;
+				oct.setInfo(xf, false);
+				oct.setInfo(xf+6, false);
+				oct.setInfo(yf, false);
+				oct.setInfo(yf+6, false);
+				oct.setInfo(zf, false);
+				oct.setInfo(zf+6, false);
 				children[4] = oct;
 			}
 			break;
@@ -639,15 +661,18 @@ vector< Octant >	Octant::buildChildren(){
 				Octant oct(*this);
 				oct.setMarker(max(0,oct.m_marker-1));
 				oct.setLevel(oct.m_level+1);
-				oct.m_info[12]=true;
+				oct.setInfo(12, true);
 				uint32_t dh = oct.getSize();
 				oct.m_x += dh;
 				oct.m_z += dh;
 				// Update interior face bound and pbound
 				xf=0; yf=3; zf=4;
-				oct.m_info[xf] = oct.m_info[xf+6] = false;
-				oct.m_info[yf] = oct.m_info[yf+6] = false;
-				oct.m_info[zf] = oct.m_info[zf+6] = false;
+				oct.setInfo(xf, false);
+				oct.setInfo(xf+6, false);
+				oct.setInfo(yf, false);
+				oct.setInfo(yf+6, false);
+				oct.setInfo(zf, false);
+				oct.setInfo(zf+6, false);
 				children[5] = oct;
 			}
 			break;
@@ -656,15 +681,18 @@ vector< Octant >	Octant::buildChildren(){
 				Octant oct(*this);
 				oct.setMarker(max(0,oct.m_marker-1));
 				oct.setLevel(oct.m_level+1);
-				oct.m_info[12]=true;
+				oct.setInfo(12, true);
 				uint32_t dh = oct.getSize();
 				oct.m_y += dh;
 				oct.m_z += dh;
 				// Update interior face bound and pbound
 				xf=1; yf=2; zf=4;
-				oct.m_info[xf] = oct.m_info[xf+6] = false;
-				oct.m_info[yf] = oct.m_info[yf+6] = false;
-				oct.m_info[zf] = oct.m_info[zf+6] = false;
+				oct.setInfo(xf, false);
+				oct.setInfo(xf+6, false);
+				oct.setInfo(yf, false);
+				oct.setInfo(yf+6, false);
+				oct.setInfo(zf, false);
+				oct.setInfo(zf+6, false);
 				children[6] = oct;
 			}
 			break;
@@ -673,16 +701,19 @@ vector< Octant >	Octant::buildChildren(){
 				Octant oct(*this);
 				oct.setMarker(max(0,oct.m_marker-1));
 				oct.setLevel(oct.m_level+1);
-				oct.m_info[12]=true;
+				oct.setInfo(12, true);
 				uint32_t dh = oct.getSize();
 				oct.m_x += dh;
 				oct.m_y += dh;
 				oct.m_z += dh;
 				// Update interior face bound and pbound
 				xf=0; yf=2; zf=4;
-				oct.m_info[xf] = oct.m_info[xf+6] = false;
-				oct.m_info[yf] = oct.m_info[yf+6] = false;
-				oct.m_info[zf] = oct.m_info[zf+6] = false;
+				oct.setInfo(xf, false);
+				oct.setInfo(xf+6, false);
+				oct.setInfo(yf, false);
+				oct.setInfo(yf+6, false);
+				oct.setInfo(zf, false);
+				oct.setInfo(zf+6, false);
 				children[7] = oct;
 			}
 			break;
@@ -699,21 +730,22 @@ vector< Octant >	Octant::buildChildren(){
 /*! Computes Morton index (without level) of "n=sizehf" half-size
  * (or same size if level=maxlevel) possible neighbours of octant
  * throught face iface (sizehf=0 if boundary octant).
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \param[in] iface Local index of the face target.
  * \param[out] sizehf Number of possible neighbours.
  * \return Vector of neighbours morton numbers.
  */
-vector<uint64_t> Octant::computeHalfSizeMorton(uint8_t iface, uint32_t & sizehf){
+vector<uint64_t> Octant::computeHalfSizeMorton(uint8_t dim, uint8_t iface, uint32_t & sizehf){
 	uint32_t dh,dh2;
 	uint32_t nneigh;
 	uint32_t i,cx,cy,cz;
-	int nchildren = 1<<m_dim;
+	int nchildren = 1<<dim;
 
 	nneigh = (m_level < sm_maxLevel) ? nchildren/2 : 1;
 	dh = (m_level < sm_maxLevel) ? getSize()/2 : getSize();
 	dh2 = getSize();
 
-	if (m_info[iface]){
+	if (getInfo(iface)){
 		sizehf = 0;
 		vector<uint64_t> Morton(0);
 		return Morton;
@@ -725,8 +757,8 @@ vector<uint64_t> Octant::computeHalfSizeMorton(uint8_t iface, uint32_t & sizehf)
 		{
 			for (i=0; i<nneigh; i++){
 				cy = (i==1)||(i==3);
-				cz = (m_dim == 3) && ((i==2)||(i==3));
-				Morton[i] = mortonEncode_magicbits(this->m_x-dh,this->m_y+dh*cy,this->m_z+dh*cz);
+				cz = (dim == 3) && ((i==2)||(i==3));
+				Morton[i] = mortonEncode(this->m_x-dh,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -734,8 +766,8 @@ vector<uint64_t> Octant::computeHalfSizeMorton(uint8_t iface, uint32_t & sizehf)
 		{
 			for (i=0; i<nneigh; i++){
 				cy = (i==1)||(i==3);
-				cz = (m_dim == 3) && ((i==2)||(i==3));
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh2,this->m_y+dh*cy,this->m_z+dh*cz);
+				cz = (dim == 3) && ((i==2)||(i==3));
+				Morton[i] = mortonEncode(this->m_x+dh2,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -743,8 +775,8 @@ vector<uint64_t> Octant::computeHalfSizeMorton(uint8_t iface, uint32_t & sizehf)
 		{
 			for (i=0; i<nneigh; i++){
 				cx = (i==1)||(i==3);
-				cz = (m_dim == 3) && ((i==2)||(i==3));
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y-dh,this->m_z+dh*cz);
+				cz = (dim == 3) && ((i==2)||(i==3));
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y-dh,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -752,8 +784,8 @@ vector<uint64_t> Octant::computeHalfSizeMorton(uint8_t iface, uint32_t & sizehf)
 		{
 			for (i=0; i<nneigh; i++){
 				cx = (i==1)||(i==3);
-				cz = (m_dim == 3) && ((i==2)||(i==3));
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh2,this->m_z+dh*cz);
+				cz = (dim == 3) && ((i==2)||(i==3));
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh2,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -762,7 +794,7 @@ vector<uint64_t> Octant::computeHalfSizeMorton(uint8_t iface, uint32_t & sizehf)
 			for (i=0; i<nneigh; i++){
 				cx = (i==1)||(i==3);
 				cy = (i==2)||(i==3);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z-dh);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z-dh);
 			}
 		}
 		break;
@@ -771,7 +803,7 @@ vector<uint64_t> Octant::computeHalfSizeMorton(uint8_t iface, uint32_t & sizehf)
 			for (i=0; i<nneigh; i++){
 				cx = (i==1)||(i==3);
 				cy = (i==2)||(i==3);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2);
 			}
 		}
 		break;
@@ -786,22 +818,23 @@ vector<uint64_t> Octant::computeHalfSizeMorton(uint8_t iface, uint32_t & sizehf)
 /*! Computes Morton index (without level) of "n=sizem" min-size
  * (or same size if level=maxlevel) possible neighbours of octant
  * throught face iface (sizem=0 if boundary octant).
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \param[in] iface Local index of the face target.
  * \param[in] maxdepth Maximum refinement level currently reached in the octree.
  * \param[out] sizem Number of possible neighbours.
  * \return Vector of neighbours morton numbers.
  */
-vector<uint64_t> Octant::computeMinSizeMorton(uint8_t iface, const uint8_t & maxdepth, uint32_t & sizem){
+vector<uint64_t> Octant::computeMinSizeMorton(uint8_t dim, uint8_t iface, const uint8_t & maxdepth, uint32_t & sizem){
 	uint32_t dh,dh2;
 	uint32_t nneigh, nline;
 	uint32_t i,cx,cy,cz;
 
-	nneigh = (m_level < sm_maxLevel) ? uint32_t(1<<((m_dim-1)*(maxdepth-m_level))) : 1;
+	nneigh = (m_level < sm_maxLevel) ? uint32_t(1<<((dim-1)*(maxdepth-m_level))) : 1;
 	dh = (m_level < sm_maxLevel) ? uint32_t(1<<(sm_maxLevel - maxdepth)) : getSize();
 	dh2 = getSize();
 	nline = uint32_t(1<<(maxdepth-m_level));
 
-	if (m_info[iface]){
+	if (getInfo(iface)){
 		sizem = 0;
 		vector<uint64_t> Morton(0);
 		return Morton;
@@ -812,36 +845,36 @@ vector<uint64_t> Octant::computeMinSizeMorton(uint8_t iface, const uint8_t & max
 		case 0 :
 		{
 			for (i=0; i<nneigh; i++){
-				cz = (m_dim-2)*(i%nline);
-				cy = (m_dim==2)*(i%nline) + (m_dim-2)*(i/nline);
-				Morton[i] = mortonEncode_magicbits(this->m_x-dh,this->m_y+dh*cy,this->m_z+dh*cz);
+				cz = (dim-2)*(i%nline);
+				cy = (dim==2)*(i%nline) + (dim-2)*(i/nline);
+				Morton[i] = mortonEncode(this->m_x-dh,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
 		case 1 :
 		{
 			for (i=0; i<nneigh; i++){
-				cz = (m_dim-2)*(i%nline);
-				cy = (m_dim==2)*(i%nline) + (m_dim-2)*(i/nline);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh2,this->m_y+dh*cy,this->m_z+dh*cz);
+				cz = (dim-2)*(i%nline);
+				cy = (dim==2)*(i%nline) + (dim-2)*(i/nline);
+				Morton[i] = mortonEncode(this->m_x+dh2,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
 		case 2 :
 		{
 			for (i=0; i<nneigh; i++){
-				cz = (m_dim-2)*(i%nline);
-				cx = (m_dim==2)*(i%nline) + (m_dim-2)*(i/nline);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y-dh,this->m_z+dh*cz);
+				cz = (dim-2)*(i%nline);
+				cx = (dim==2)*(i%nline) + (dim-2)*(i/nline);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y-dh,this->m_z+dh*cz);
 			}
 		}
 		break;
 		case 3 :
 		{
 			for (i=0; i<nneigh; i++){
-				cz = (m_dim-2)*(i%nline);
-				cx = (m_dim==2)*(i%nline) + (m_dim-2)*(i/nline);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh2,this->m_z+dh*cz);
+				cz = (dim-2)*(i%nline);
+				cx = (dim==2)*(i%nline) + (dim-2)*(i/nline);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh2,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -850,7 +883,7 @@ vector<uint64_t> Octant::computeMinSizeMorton(uint8_t iface, const uint8_t & max
 			for (i=0; i<nneigh; i++){
 				cx = (i/nline);
 				cy = (i%nline);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z-dh);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z-dh);
 			}
 		}
 		break;
@@ -859,7 +892,7 @@ vector<uint64_t> Octant::computeMinSizeMorton(uint8_t iface, const uint8_t & max
 			for (i=0; i<nneigh; i++){
 				cx = (i/nline);
 				cy = (i%nline);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2);
 			}
 		}
 		break;
@@ -874,20 +907,21 @@ vector<uint64_t> Octant::computeMinSizeMorton(uint8_t iface, const uint8_t & max
 /*! Computes Morton index (without level) of possible (virtual) neighbours of octant
  * throught iface. Checks if balanced or not and uses half-size or min-size method
  * (sizeneigh=0 if boundary octant).
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \param[in] iface Local index of the face target.
  * \param[in] maxdepth Maximum refinement level currently reached in the octree.
  * \param[out] sizeneigh Number of possible neighbours.
  * \return Vector of neighbours morton numbers.
  */
-vector<uint64_t> Octant::computeVirtualMorton(uint8_t iface, const uint8_t & maxdepth, uint32_t & sizeneigh){
+vector<uint64_t> Octant::computeVirtualMorton(uint8_t dim, uint8_t iface, const uint8_t & maxdepth, uint32_t & sizeneigh){
 	vector<uint64_t> Morton;
 	if (getNotBalance()){
-		return computeMinSizeMorton(iface,
+		return computeMinSizeMorton(dim, iface,
 				maxdepth,
 				sizeneigh);
 	}
 	else{
-		return computeHalfSizeMorton(iface,
+		return computeHalfSizeMorton(dim, iface,
 				sizeneigh);
 	}
 };
@@ -912,7 +946,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 	iface1 = edgeface[iedge][0];
 	iface2 = edgeface[iedge][1];
 
-	if (m_info[iface1] || m_info[iface2]){
+	if (getInfo(iface1) || getInfo(iface2)){
 		sizehf = 0;
 		vector<uint64_t> Morton(0);
 		return Morton;
@@ -926,7 +960,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = -1;
 				cy = (i==1);
 				cz = -1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -936,7 +970,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = 1;
 				cy = (i==1);
 				cz = -1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -946,7 +980,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = (i==1);
 				cy = -1;
 				cz = -1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -956,7 +990,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = (i==1);
 				cy = 1;
 				cz = -1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -966,7 +1000,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = -1;
 				cy = -1;
 				cz = (i==1);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -976,7 +1010,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = 1;
 				cy = -1;
 				cz = (i==1);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -986,7 +1020,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = -1;
 				cy = 1;
 				cz = (i==1);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -996,7 +1030,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = 1;
 				cy = 1;
 				cz = (i==1);
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh2*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -1006,7 +1040,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = -1;
 				cy = (i==1);
 				cz = 1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
 			}
 		}
 		break;
@@ -1016,7 +1050,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = 1;
 				cy = (i==1);
 				cz = 1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
+				Morton[i] = mortonEncode(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
 			}
 		}
 		break;
@@ -1026,7 +1060,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = (i==1);
 				cy = -1;
 				cz = 1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
 			}
 		}
 		break;
@@ -1036,7 +1070,7 @@ vector<uint64_t> Octant::computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & siz
 				cx = (i==1);
 				cy = 1;
 				cz = 1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh2*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh2*cz);
 			}
 		}
 		break;
@@ -1071,7 +1105,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 	iface1 = edgeface[iedge][0];
 	iface2 = edgeface[iedge][1];
 
-	if (m_info[iface1] || m_info[iface2]){
+	if (getInfo(iface1) || getInfo(iface2)){
 		sizem = 0;
 		vector<uint64_t> Morton(0);
 		return Morton;
@@ -1085,7 +1119,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = -1;
 				cy = i;
 				cz = -1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -1095,7 +1129,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = 1;
 				cy = i;
 				cz = -1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -1105,7 +1139,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = i;
 				cy = -1;
 				cz = -1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -1115,7 +1149,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = i;
 				cy = 1;
 				cz = -1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -1125,7 +1159,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = -1;
 				cy = -1;
 				cz = i;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -1135,7 +1169,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = 1;
 				cy = -1;
 				cz = i;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -1145,7 +1179,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = -1;
 				cy = 1;
 				cz = i;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -1155,7 +1189,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = 1;
 				cy = 1;
 				cz = i;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
+				Morton[i] = mortonEncode(this->m_x+dh2*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
 			}
 		}
 		break;
@@ -1165,7 +1199,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = -1;
 				cy = i;
 				cz = 1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
 			}
 		}
 		break;
@@ -1175,7 +1209,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = 1;
 				cy = i;
 				cz = 1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
+				Morton[i] = mortonEncode(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
 			}
 		}
 		break;
@@ -1185,7 +1219,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = i;
 				cy = -1;
 				cz = 1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
 			}
 		}
 		break;
@@ -1195,7 +1229,7 @@ vector<uint64_t> 		Octant::computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t
 				cx = i;
 				cy = 1;
 				cz = 1;
-				Morton[i] = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh2*cz);
+				Morton[i] = mortonEncode(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh2*cz);
 			}
 		}
 		break;
@@ -1231,13 +1265,14 @@ vector<uint64_t>		Octant::computeEdgeVirtualMorton(uint8_t iedge, const uint8_t
 /*! Computes Morton index (without level) of "n=sizem" min-size
  * (or same size if level=maxlevel) possible neighbours of octant throught
  * node inode (sizem=0 if boundary octant)
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \param[in] inode Local index of the node target.
  * \param[in] maxdepth Maximum refinement level currently reached in the octree.
  * \param[out] sizem Number of possible neighbours (1 or 0).
  * \param[in] nodeface Local node-face connectivity.
  * \return Vector of neighbours morton numbers.
  */
-uint64_t 		Octant::computeNodeMinSizeMorton(uint8_t inode, const uint8_t & maxdepth,uint32_t & sizem, uint8_t (&nodeface)[8][3]){
+uint64_t 		Octant::computeNodeMinSizeMorton(uint8_t dim, uint8_t inode, const uint8_t & maxdepth,uint32_t & sizem, uint8_t (&nodeface)[8][3]){
 
 	uint32_t dh,dh2;
 	uint32_t nneigh;
@@ -1247,11 +1282,11 @@ uint64_t 		Octant::computeNodeMinSizeMorton(uint8_t inode, const uint8_t & maxde
 	nneigh = 1;
 	dh = (m_level < sm_maxLevel) ? uint32_t(1<<(sm_maxLevel - maxdepth)) : getSize();
 	dh2 = getSize();
-	for (int i=0; i<m_dim; i++){
+	for (int i=0; i<dim; i++){
 		iface[i] = nodeface[inode][i];
 	}
 
-	if (m_info[iface[0]] || m_info[iface[1]] || m_info[iface[m_dim-1]]){
+	if (getInfo(iface[0]) || getInfo(iface[1]) || getInfo(iface[dim-1])){
 		sizem = 0;
 		return this->computeMorton();
 	}
@@ -1262,32 +1297,32 @@ uint64_t 		Octant::computeNodeMinSizeMorton(uint8_t inode, const uint8_t & maxde
 		{
 			cx = -1;
 			cy = -1;
-			cz = -1*(m_dim-2);
-			Morton = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+			cz = -1*(dim-2);
+			Morton = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 		}
 		break;
 		case 1 :
 		{
 			cx = 1;
 			cy = -1;
-			cz = -1*(m_dim-2);
-			Morton = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh*cz);
+			cz = -1*(dim-2);
+			Morton = mortonEncode(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh*cz);
 		}
 		break;
 		case 2 :
 		{
 			cx = -1;
 			cy = 1;
-			cz = -1*(m_dim-2);
-			Morton = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
+			cz = -1*(dim-2);
+			Morton = mortonEncode(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
 		}
 		break;
 		case 3 :
 		{
 			cx = 1;
 			cy = 1;
-			cz = -1*(m_dim-2);
-			Morton = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
+			cz = -1*(dim-2);
+			Morton = mortonEncode(this->m_x+dh2*cx,this->m_y+dh2*cy,this->m_z+dh*cz);
 		}
 		break;
 		case 4 :
@@ -1295,7 +1330,7 @@ uint64_t 		Octant::computeNodeMinSizeMorton(uint8_t inode, const uint8_t & maxde
 			cx = -1;
 			cy = -1;
 			cz = 1;
-			Morton = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
+			Morton = mortonEncode(this->m_x+dh*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
 		}
 		break;
 		case 5 :
@@ -1303,7 +1338,7 @@ uint64_t 		Octant::computeNodeMinSizeMorton(uint8_t inode, const uint8_t & maxde
 			cx = 1;
 			cy = -1;
 			cz = 1;
-			Morton = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
+			Morton = mortonEncode(this->m_x+dh2*cx,this->m_y+dh*cy,this->m_z+dh2*cz);
 		}
 		break;
 		case 6 :
@@ -1311,7 +1346,7 @@ uint64_t 		Octant::computeNodeMinSizeMorton(uint8_t inode, const uint8_t & maxde
 			cx = -1;
 			cy = 1;
 			cz = 1;
-			Morton = mortonEncode_magicbits(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh2*cz);
+			Morton = mortonEncode(this->m_x+dh*cx,this->m_y+dh2*cy,this->m_z+dh2*cz);
 		}
 		break;
 		case 7 :
@@ -1319,7 +1354,7 @@ uint64_t 		Octant::computeNodeMinSizeMorton(uint8_t inode, const uint8_t & maxde
 			cx = 1;
 			cy = 1;
 			cz = 1;
-			Morton = mortonEncode_magicbits(this->m_x+dh2*cx,this->m_y+dh2*cy,this->m_z+dh2*cz);
+			Morton = mortonEncode(this->m_x+dh2*cx,this->m_y+dh2*cy,this->m_z+dh2*cz);
 		}
 		break;
 		}
@@ -1331,15 +1366,16 @@ uint64_t 		Octant::computeNodeMinSizeMorton(uint8_t inode, const uint8_t & maxde
 
 /*! Computes Morton index (without level) of possible (virtual) neighbours of octant
  * throught inode. Uses min-size method (sizeneigh=0 if boundary octant).
+ * \param[in] dim Dimension of the octree (2/3 for 2D/3D).
  * \param[in] inode Local index of the node target.
  * \param[in] maxdepth Maximum refinement level currently reached in the octree.
  * \param[out] sizeneigh Number of possible neighbours (1).
  * \param[in] nodeface Local node-face connectivity.
  * \return Vector of neighbours morton numbers.
  */
-uint64_t 		Octant::computeNodeVirtualMorton(uint8_t inode, const uint8_t & maxdepth, uint32_t & sizeneigh, uint8_t (&nodeface)[8][3]){
+uint64_t 		Octant::computeNodeVirtualMorton(uint8_t dim, uint8_t inode, const uint8_t & maxdepth, uint32_t & sizeneigh, uint8_t (&nodeface)[8][3]){
 
-	return computeNodeMinSizeMorton(inode, maxdepth,
+	return computeNodeMinSizeMorton(dim, inode, maxdepth,
 			sizeneigh, nodeface);
 
  };
@@ -2,7 +2,7 @@
 #define OCTANT_HPP_
 
 // INCLUDES                                                                            //
-#include "inlinedFunct.hpp"
+#include "mortonFunct.hpp"
 #include <vector>
 #include <bitset>
 #include <array>
@@ -68,15 +68,17 @@ private:
 	uint32_t		  	m_x;			/**< Coordinate x */
 	uint32_t		  	m_y;			/**< Coordinate y */
 	uint32_t		  	m_z;			/**< Coordinate z (2D case = 0)*/
-	uint8_t   			m_level;		/**< Refinement level (0=root) */
-	int8_t    			m_marker;		/**< Set for Refinement(m>0) or Coarsening(m<0) |m|-times */
-	std::bitset<17> 	m_info;			/**< -Info[0..#faces]: true if 0..#faces face is a boundary face [bound] \n
+	uint32_t			m_info : 17;	/**< -Info[0..#faces]: true if 0..#faces face is a boundary face [bound] \n
 										-Info[6..#faces+5]: true if 0..#faces face is a process boundary face [pbound] \n
 										-Info[12/13]: true if octant is new after refinement/coarsening \n
 										-Info[14]   : true if balancing is not required for this octant \n
 										-Info[15]   : Aux
 										-Info[16]   : true if octant is a scary ghost */
-	uint8_t				m_dim;			/**< Dimension of octant (2D/3D) */
+	uint32_t   			m_level : 7;	/**< Refinement level (0=root) */
+	int32_t    			m_marker : 8;	/**< Set for Refinement(m>0) or Coarsening(m<0) |m|-times */
+
+	// info flags, level and marker share a single 32 bit word, so that an octant
+	// takes 16 bytes; the dimension is a property of the tree (see LocalTree::m_dim).
 
 	//TODO add bitset for edge & node
 
@@ -106,6 +108,12 @@ private:
 	Octant(bool bound, uint8_t dim, uint8_t level, int32_t x, int32_t y, int32_t z = 0, int8_t maxlevel = 20);
 	bool operator ==(const Octant & oct2);
 
+	// =================================================================================== //
+	// INFO FLAGS
+	// =================================================================================== //
+	inline bool	getInfo(uint8_t i) const;
+	inline void	setInfo(uint8_t i, bool flag);
+
 	// =================================================================================== //
 	// METHODS
 	// =================================================================================== //
@@ -113,7 +121,6 @@ private:
 	// =================================================================================== //
 	// BASIC GET/SET METHODS
 	// =================================================================================== //
-	uint32_t	getDim() const;
 	u32array3	getCoordinates() const;
 	uint32_t	getX() const;
 	uint32_t	getY() const;
@@ -140,13 +147,13 @@ private:
 	// OTHER GET/SET METHODS
 	// =================================================================================== //
 	uint32_t		getSize() const;
-	uint64_t		getArea() const;
-	uint64_t		getVolume() const;
+	uint64_t		getArea(uint8_t dim) const;
+	uint64_t		getVolume(uint8_t dim) const;
 	darray3			getCenter() const;
-	darray3			getFaceCenter(uint8_t iface) const;
+	darray3			getFaceCenter(uint8_t dim, uint8_t iface) const;
 	darray3			getEdgeCenter(uint8_t iedge) const;
-	void			getNodes(u32arr3vector & nodes) const;
-	u32arr3vector	getNodes() const;
+	void			getNodes(uint8_t dim, u32arr3vector & nodes) const;
+	u32arr3vector	getNodes(uint8_t dim) const;
 	void			getNode(u32array3 & node, uint8_t inode) const;
 	u32array3		getNode(uint8_t inode) const;
 	void			getNormal(uint8_t & iface, i8array3 & normal, int8_t (&normals)[6][3]) const;
@@ -156,26 +163,47 @@ private:
 	// =================================================================================== //
 	// OTHER METHODS												    			   //
 	// =================================================================================== //
-	Octant					buildLastDesc();
-	Octant					buildFather();
-	std::vector< Octant >	buildChildren();
-	std::vector<uint64_t> 		computeHalfSizeMorton(uint8_t iface, uint32_t & sizehf);
-	std::vector<uint64_t>		computeMinSizeMorton(uint8_t iface, const uint8_t & maxdepth,
+	Octant					buildLastDesc(uint8_t dim);
+	Octant					buildFather(uint8_t dim);
+	std::vector< Octant >	buildChildren(uint8_t dim);
+	std::vector<uint64_t> 		computeHalfSizeMorton(uint8_t dim, uint8_t iface, uint32_t & sizehf);
+	std::vector<uint64_t>		computeMinSizeMorton(uint8_t dim, uint8_t iface, const uint8_t & maxdepth,
 			uint32_t & sizem);
-	std::vector<uint64_t> 		computeVirtualMorton(uint8_t iface, const uint8_t & maxdepth,
+	std::vector<uint64_t> 		computeVirtualMorton(uint8_t dim, uint8_t iface, const uint8_t & maxdepth,
 			uint32_t & sizeneigh);
 	std::vector<uint64_t> 		computeEdgeHalfSizeMorton(uint8_t iedge, uint32_t & sizehf, uint8_t (&edgeface)[12][2]);
 	std::vector<uint64_t> 		computeEdgeMinSizeMorton(uint8_t iedge, const uint8_t & maxdepth,
 			uint32_t & sizem, uint8_t (&edgeface)[12][2]);
 	std::vector<uint64_t>		computeEdgeVirtualMorton(uint8_t iedge, const uint8_t & maxdepth,
 			uint32_t & sizeneigh, uint8_t balance_codim, uint8_t (&edgeface)[12][2]);
-	uint64_t 		computeNodeMinSizeMorton(uint8_t inode, const uint8_t & maxdepth,
+	uint64_t 		computeNodeMinSizeMorton(uint8_t dim, uint8_t inode, const uint8_t & maxdepth,
 			uint32_t & sizehf, uint8_t (&nodeface)[8][3]);
-	uint64_t 		computeNodeVirtualMorton(uint8_t inode, const uint8_t & maxdepth,
+	uint64_t 		computeNodeVirtualMorton(uint8_t dim, uint8_t inode, const uint8_t & maxdepth,
 			uint32_t & sizeneigh, uint8_t (&nodeface)[8][3]);
 
 };
 
+// =================================================================================== //
+// INLINE METHODS
+// =================================================================================== //
+
+/*! Get an info flag of the octant.
+ * \param[in] i Index of the info flag (see Octant::m_info).
+ * \return Value of the flag.
+ */
+inline bool
+Octant::getInfo(uint8_t i) const{
+	return (m_info >> i) & 1u;
+};
+
+/*! Set an info flag of the octant.
+ * \param[in] i Index of the info flag (see Octant::m_info).
+ * \param[in] flag Value of the flag.
+ */
+inline void
+Octant::setInfo(uint8_t i, bool flag){
+	m_info = (m_info & ~(1u << i)) | (uint32_t(flag) << i);
+};
 
 /*  @} */
 
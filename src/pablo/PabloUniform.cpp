@@ -79,6 +79,8 @@ PabloUniform::getL(){
 void
 PabloUniform::setL(double L){
 	m_L = L;
+	updateGeometryCache();
+	updateIntersectionStore();
 };
 
 /*! Set the origin of the domain.
@@ -87,6 +89,8 @@ PabloUniform::setL(double L){
 void
 PabloUniform::setOrigin(darray3 origin){
 	m_origin = origin;
+	updateGeometryCache();
+	updateIntersectionStore();
 };
 
 /*! Get the size of an octant corresponding to a target level.
@@ -143,12 +147,12 @@ PabloUniform::getSize(uint32_t idx){
 
 double
 PabloUniform::getArea(uint32_t idx){
-	return m_L * m_L * ParaTree::getArea(idx);
+	return (ParaTree::getDim() == 3 ? m_L * m_L : m_L) * ParaTree::getArea(idx);
 };
 
 double
 PabloUniform::getVolume(uint32_t idx){
-	return m_L * m_L * m_L* ParaTree::getArea(idx);
+	return (ParaTree::getDim() == 3 ? m_L * m_L * m_L : m_L * m_L) * ParaTree::getVolume(idx);
 };
 
 void
@@ -168,6 +172,60 @@ PabloUniform::getCenter(uint32_t idx){
 	return center;
 };
 
+/*! Get the coordinates of the centers of a range of local octants in the physical
+ * domain (see ParaTree::getCenters). The geometry cache stores the physical values.
+ * \param[in] begin Local index of the first octant.
+ * \param[in] end Local index past the last octant.
+ * \param[out] x Coordinates x of the centers (end-begin values).
+ * \param[out] y Coordinates y of the centers (end-begin values).
+ * \param[out] z Coordinates z of the centers (end-begin values).
+ */
+void
+PabloUniform::getCenters(uint32_t begin, uint32_t end, double* x, double* y, double* z){
+	ParaTree::getCenters(begin, end, x, y, z);
+	if (ParaTree::getGeometryCache()) return;
+
+	int32_t n = int32_t(end) - int32_t(begin);
+	for (int32_t i = 0; i < n; ++i){
+		x[i] = m_origin[0] + m_L * x[i];
+		y[i] = m_origin[1] + m_L * y[i];
+		z[i] = m_origin[2] + m_L * z[i];
+	}
+};
+
+/*! Get the sizes of a range of local octants in the physical domain (see ParaTree::getSizes).
+ * \param[in] begin Local index of the first octant.
+ * \param[in] end Local index past the last octant.
+ * \param[out] sizes Sizes of the octants (end-begin values).
+ */
+void
+PabloUniform::getSizes(uint32_t begin, uint32_t end, double* sizes){
+	ParaTree::getSizes(begin, end, sizes);
+	if (ParaTree::getGeometryCache()) return;
+
+	int32_t n = int32_t(end) - int32_t(begin);
+	for (int32_t i = 0; i < n; ++i){
+		sizes[i] = m_L * sizes[i];
+	}
+};
+
+/*! Get the volumes of a range of local octants in the physical domain (see ParaTree::getVolumes).
+ * \param[in] begin Local index of the first octant.
+ * \param[in] end Local index past the last octant.
+ * \param[out] volumes Volumes of the octants (end-begin values).
+ */
+void
+PabloUniform::getVolumes(uint32_t begin, uint32_t end, double* volumes){
+	ParaTree::getVolumes(begin, end, volumes);
+	if (ParaTree::getGeometryCache()) return;
+
+	double scale = (ParaTree::getDim() == 3 ? m_L * m_L * m_L : m_L * m_L);
+	int32_t n = int32_t(end) - int32_t(begin);
+	for (int32_t i = 0; i < n; ++i){
+		volumes[i] = scale * volumes[i];
+	}
+};
+
 void
 PabloUniform::getFaceCenter(uint32_t idx, uint8_t iface, darray3& center){
 	darray3 center_ = ParaTree::getFaceCenter(idx, iface);
@@ -279,12 +337,12 @@ PabloUniform::getSize(Octant* oct){
 
 double
 PabloUniform::getArea(Octant* oct){
-	return m_L * m_L * ParaTree::getArea(oct);
+	return (ParaTree::getDim() == 3 ? m_L * m_L : m_L) * ParaTree::getArea(oct);
 };
 
 double
 PabloUniform::getVolume(Octant* oct){
-	return m_L * m_L * m_L* ParaTree::getArea(oct);
+	return (ParaTree::getDim() == 3 ? m_L * m_L * m_L : m_L * m_L) * ParaTree::getVolume(oct);
 };
 
 void
@@ -425,7 +483,7 @@ PabloUniform::getSize(Intersection* inter){
 
 double
 PabloUniform::getArea(Intersection* inter){
-	return m_L * m_L * ParaTree::getArea(inter);
+	return (ParaTree::getDim() == 3 ? m_L * m_L : m_L) * ParaTree::getArea(inter);
 };
 
 darray3
@@ -437,6 +495,22 @@ PabloUniform::getCenter(Intersection* inter){
 	return center;
 }
 
+darr3vector
+PabloUniform::getNodes(Intersection* inter){
+	darr3vector nodes = ParaTree::getNodes(inter);
+	for (size_t j=0; j<nodes.size(); j++){
+		for (int i=0; i<3; i++){
+			nodes[j][i] = m_origin[i] + m_L * nodes[j][i];
+		}
+	}
+	return nodes;
+}
+
+darray3
+PabloUniform::getNormal(Intersection* inter){
+	return ParaTree::getNormal(inter);
+}
+
 // =================================================================================== //
 // OTHER OCTANT BASED METHODS												    	   //
 // =================================================================================== //
@@ -454,3 +528,33 @@ uint32_t PabloUniform::getPointOwnerIdx(darray3 & point){
 	return ParaTree::getPointOwnerIdx(point);
 };
 
+/*! Get the octant owners of a set of input points (see ParaTree::getPointOwners).
+ * \param[in] points Physical coordinates of the target points.
+ * \param[out] idx Local indices of the octant owners of the points (max uint32_t
+ * representable if a point is outside of the domain or owned by another process).
+ */
+void
+PabloUniform::getPointOwners(const std::vector<darray3> & points, u32vector & idx){
+	std::vector<int> ranks;
+	getPointOwners(points, idx, ranks);
+};
+
+/*! Get the octant owners and the owner processes of a set of input points
+ * (see ParaTree::getPointOwners); the points are mapped in the logical domain
+ * as in getPointOwnerIdx.
+ * \param[in] points Physical coordinates of the target points.
+ * \param[out] idx Local indices of the octant owners of the points (max uint32_t
+ * representable if a point is outside of the domain or owned by another process).
+ * \param[out] ranks Ranks of the processes owning the points (-1 if a point is outside of the domain).
+ */
+void
+PabloUniform::getPointOwners(const std::vector<darray3> & points, u32vector & idx, std::vector<int> & ranks){
+	std::vector<darray3> logicalPoints(points.size());
+	for (size_t k=0; k<points.size(); k++){
+		for (int i=0; i<3; i++){
+			logicalPoints[k][i] = (points[k][i] - m_origin[i])/m_L;
+		}
+	}
+	ParaTree::getPointOwners(logicalPoints, idx, ranks);
+};
+
@@ -81,6 +81,9 @@ public:
 	double 		getVolume(uint32_t idx);
 	void 		getCenter(uint32_t idx, darray3& center);
 	darray3 	getCenter(uint32_t idx);
+	void 		getCenters(uint32_t begin, uint32_t end, double* x, double* y, double* z);
+	void 		getSizes(uint32_t begin, uint32_t end, double* sizes);
+	void 		getVolumes(uint32_t begin, uint32_t end, double* volumes);
 	darray3 	getFaceCenter(uint32_t idx, uint8_t iface);
 	void 		getFaceCenter(uint32_t idx, uint8_t iface, darray3& center);
 	darray3 	getNode(uint32_t idx, uint8_t inode);
@@ -132,6 +135,8 @@ public:
 	// =================================================================================== //
 	Octant* getPointOwner(darray3 & point);
 	uint32_t getPointOwnerIdx(darray3 & point);
+	void 		getPointOwners(const std::vector<darray3> & points, u32vector & idx);
+	void 		getPointOwners(const std::vector<darray3> & points, u32vector & idx, std::vector<int> & ranks);
 
 };
 
@@ -6,6 +6,11 @@
 #include <sstream>
 #include <iomanip>
 #include <fstream>
+#include <chrono>
+#include <limits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // =================================================================================== //
 // NAME SPACES                                                                         //
@@ -42,10 +47,20 @@ ParaTree::ParaTree(uint8_t dim, int8_t maxlevel, string logfile ) : m_dim(uint8_
 	m_serial = true;
 	m_errorFlag = 0;
 	m_maxDepth = 0;
+	m_balanceIterations = 0;
+	m_geometryCache = false;
+	m_storeIntersections = false;
+#if ENABLE_MPI==1
+	m_ghostsRequestsDataSize = 0;
+	m_loadBalanceTolerance = 0.0;
+	m_partitionFamilyDepth = 0;
+	m_sparseExchanges = 0;
+#endif
 	m_globalNumOctants = m_octree.getNumOctants();
 #if ENABLE_MPI==1
 	m_errorFlag = MPI_Comm_size(m_comm,&m_nproc);
 	m_errorFlag = MPI_Comm_rank(m_comm,&m_rank);
+	initSharedComm();
 #else
 	m_rank = 0;
 	m_nproc = 1;
@@ -69,6 +84,7 @@ ParaTree::ParaTree(uint8_t dim, int8_t maxlevel, string logfile ) : m_dim(uint8_
 	m_log.writeLog(" Number of proc		:	" + to_string(static_cast<unsigned long long>(m_nproc)));
 	m_log.writeLog(" Dimension		:	" + to_string(static_cast<unsigned long long>(m_dim)));
 	m_log.writeLog(" Max allowed level	:	" + to_string(static_cast<unsigned long long>(m_global.m_maxLevel)));
+	writeThreadsLog();
 	m_log.writeLog("---------------------------------------------");
 	m_log.writeLog(" ");
 #if ENABLE_MPI==1
@@ -105,6 +121,15 @@ ParaTree::ParaTree(u32vector2D & XYZ, u8vector & levels, uint8_t dim, int8_t max
 	uint32_t NumOctants = XYZ.size();
 	m_dim = dim;
 	m_global.setGlobal(maxlevel, m_dim);
+	m_balanceIterations = 0;
+	m_geometryCache = false;
+	m_storeIntersections = false;
+#if ENABLE_MPI==1
+	m_ghostsRequestsDataSize = 0;
+	m_loadBalanceTolerance = 0.0;
+	m_partitionFamilyDepth = 0;
+	m_sparseExchanges = 0;
+#endif
 	m_octree.m_octants.resize(NumOctants);
 	for (uint32_t i=0; i<NumOctants; i++){
 		lev = uint8_t(levels[i]);
@@ -139,10 +164,12 @@ ParaTree::ParaTree(u32vector2D & XYZ, u8vector & levels, uint8_t dim, int8_t max
         }
 		m_octree.m_octants[i] = oct;
 	}
+	m_octree.updateMortons();
 
 #if ENABLE_MPI==1
 	m_errorFlag = MPI_Comm_size(m_comm,&m_nproc);
 	m_errorFlag = MPI_Comm_rank(m_comm,&m_rank);
+	initSharedComm();
 	m_serial = true;
 	if (m_nproc > 1 ) m_serial = false;
 #else
@@ -173,6 +200,7 @@ ParaTree::ParaTree(u32vector2D & XYZ, u8vector & levels, uint8_t dim, int8_t max
 	m_log.writeLog(" Dimension		:	" + to_string(static_cast<unsigned long long>(m_dim)));
 	m_log.writeLog(" Max allowed level	:	" + to_string(static_cast<unsigned long long>(m_global.m_maxLevel)));
 	m_log.writeLog(" Number of octants	:	" + to_string(static_cast<unsigned long long>(m_globalNumOctants)));
+	writeThreadsLog();
 	m_log.writeLog("---------------------------------------------");
 	m_log.writeLog(" ");
 #if ENABLE_MPI==1
@@ -186,6 +214,10 @@ ParaTree::ParaTree(u32vector2D & XYZ, u8vector & levels, uint8_t dim, int8_t max
 /*! Default Destructor of ParaTree.
 */
 ParaTree::~ParaTree(){
+#if ENABLE_MPI==1
+	freeGhostsRequests();
+	freeSharedComm();
+#endif
 	m_log.writeLog("---------------------------------------------");
 	m_log.writeLog("--------------- R.I.P. PABLO ----------------");
 	m_log.writeLog("---------------------------------------------");
@@ -248,6 +280,19 @@ ParaTree::getNproc(){
 	return m_nproc;
 };
 
+/*! Get the number of threads used by the local process for the multi-threaded
+ * kernels of the octree (1 if OpenMP is not enabled).
+ * \return Number of threads of the local process.
+ */
+int
+ParaTree::getNumThreads(){
+#ifdef _OPENMP
+	return omp_get_max_threads();
+#else
+	return 1;
+#endif
+};
+
 #if ENABLE_MPI==1
 /*! Get thecommunicator used by octree between processes.
  * \return MPI Communicator.
@@ -576,7 +621,7 @@ ParaTree::getSize(uint32_t idx) {
  */
 double
 ParaTree::getArea(uint32_t idx) {
-	return m_trans.mapArea(m_octree.m_octants[idx].getArea());
+	return m_trans.mapArea(m_octree.m_octants[idx].getArea(m_dim));
 }
 
 /*! Get the volume of an octant.
@@ -585,7 +630,7 @@ ParaTree::getArea(uint32_t idx) {
  */
 double
 ParaTree::getVolume(uint32_t idx) {
-	return m_trans.mapVolume(m_octree.m_octants[idx].getVolume());
+	return m_trans.mapVolume(m_octree.m_octants[idx].getVolume(m_dim));
 }
 
 /*! Get the coordinates of the center of an octant.
@@ -610,6 +655,141 @@ ParaTree::getCenter(uint32_t idx) {
 	return center;
 }
 
+/*! Get the coordinates of the centers of a range of local octants, in separate
+ * arrays for each coordinate (the same values of getCenter). The octants are processed
+ * in a single loop, with the sizes of the octants taken from a table of the levels;
+ * if the geometry cache is enabled the values are copied from the cache.
+ * The bulk getters are virtual and fill the cache, so that an octree with a physical
+ * domain caches its physical geometry (see PabloUniform).
+ * \param[in] begin Local index of the first octant.
+ * \param[in] end Local index past the last octant.
+ * \param[out] x Coordinates x of the centers (end-begin values).
+ * \param[out] y Coordinates y of the centers (end-begin values).
+ * \param[out] z Coordinates z of the centers (end-begin values, set to 0 in 2D).
+ */
+void
+ParaTree::getCenters(uint32_t begin, uint32_t end, double* x, double* y, double* z){
+	if (m_geometryCache){
+		copy(m_cachedCenters[0].begin() + begin, m_cachedCenters[0].begin() + end, x);
+		copy(m_cachedCenters[1].begin() + begin, m_cachedCenters[1].begin() + end, y);
+		copy(m_cachedCenters[2].begin() + begin, m_cachedCenters[2].begin() + end, z);
+		return;
+	}
+
+	dvector halfSizes(m_global.m_maxLevel + 1);
+	for (int level = 0; level <= m_global.m_maxLevel; ++level){
+		halfSizes[level] = double(uint32_t(1) << (m_global.m_maxLevel - level))/2.0;
+	}
+
+	const Octant* octants = m_octree.m_octants.data();
+	double maxLength_1 = m_trans.m_maxLength_1;
+	bool is3D = (m_dim == 3);
+	int32_t n = int32_t(end) - int32_t(begin);
+#pragma omp parallel for schedule(static) if (n > 4096)
+	for (int32_t i = 0; i < n; ++i){
+		const Octant & octant = octants[begin + i];
+		double dh = halfSizes[octant.m_level];
+		x[i] = maxLength_1 * (double(octant.m_x) + dh);
+		y[i] = maxLength_1 * (double(octant.m_y) + dh);
+		z[i] = is3D ? maxLength_1 * (double(octant.m_z) + dh) : 0.0;
+	}
+};
+
+/*! Get the sizes of a range of local octants (the same values of getSize).
+ * \param[in] begin Local index of the first octant.
+ * \param[in] end Local index past the last octant.
+ * \param[out] sizes Sizes of the octants (end-begin values).
+ */
+void
+ParaTree::getSizes(uint32_t begin, uint32_t end, double* sizes){
+	if (m_geometryCache){
+		copy(m_cachedSizes.begin() + begin, m_cachedSizes.begin() + end, sizes);
+		return;
+	}
+
+	dvector levelSizes(m_global.m_maxLevel + 1);
+	for (int level = 0; level <= m_global.m_maxLevel; ++level){
+		levelSizes[level] = m_trans.mapSize(uint32_t(1) << (m_global.m_maxLevel - level));
+	}
+
+	const Octant* octants = m_octree.m_octants.data();
+	int32_t n = int32_t(end) - int32_t(begin);
+#pragma omp parallel for schedule(static) if (n > 4096)
+	for (int32_t i = 0; i < n; ++i){
+		sizes[i] = levelSizes[octants[begin + i].m_level];
+	}
+};
+
+/*! Get the volumes of a range of local octants (the same values of getVolume).
+ * \param[in] begin Local index of the first octant.
+ * \param[in] end Local index past the last octant.
+ * \param[out] volumes Volumes of the octants (end-begin values).
+ */
+void
+ParaTree::getVolumes(uint32_t begin, uint32_t end, double* volumes){
+	if (m_geometryCache){
+		copy(m_cachedVolumes.begin() + begin, m_cachedVolumes.begin() + end, volumes);
+		return;
+	}
+
+	dvector levelVolumes(m_global.m_maxLevel + 1);
+	for (int level = 0; level <= m_global.m_maxLevel; ++level){
+		levelVolumes[level] = m_trans.mapVolume(Octant(m_dim, level, 0, 0, 0, m_global.m_maxLevel).getVolume(m_dim));
+	}
+
+	const Octant* octants = m_octree.m_octants.data();
+	int32_t n = int32_t(end) - int32_t(begin);
+#pragma omp parallel for schedule(static) if (n > 4096)
+	for (int32_t i = 0; i < n; ++i){
+		volumes[i] = levelVolumes[octants[begin + i].m_level];
+	}
+};
+
+/*! Enable or disable the cache of the geometry of the local octants.
+ * If the cache is enabled the centers, sizes and volumes of the local octants are
+ * computed once and stored in separate arrays (see getCachedCenters, getCachedSizes and
+ * getCachedVolumes); the cache is recomputed by adapt and loadBalance.
+ * \param[in] cache True to enable the cache, false to disable it and free its memory.
+ */
+void
+ParaTree::setGeometryCache(bool cache){
+	m_geometryCache = cache;
+	updateGeometryCache();
+};
+
+/*! Get if the cache of the geometry of the local octants is enabled.
+ * \return True if the geometry cache is enabled.
+ */
+bool
+ParaTree::getGeometryCache() const{
+	return m_geometryCache;
+};
+
+/*! Get the cached coordinates of the centers of the local octants.
+ * \param[in] coord Index of the coordinate (0/1/2 for x/y/z).
+ * \return Constant reference to the coordinates of the centers (empty if the geometry cache is disabled).
+ */
+const dvector &
+ParaTree::getCachedCenters(uint8_t coord) const{
+	return m_cachedCenters[coord];
+};
+
+/*! Get the cached sizes of the local octants.
+ * \return Constant reference to the sizes (empty if the geometry cache is disabled).
+ */
+const dvector &
+ParaTree::getCachedSizes() const{
+	return m_cachedSizes;
+};
+
+/*! Get the cached volumes of the local octants.
+ * \return Constant reference to the volumes (empty if the geometry cache is disabled).
+ */
+const dvector &
+ParaTree::getCachedVolumes() const{
+	return m_cachedVolumes;
+};
+
 /*! Get the coordinates of the center of a face of an octant.
  * \param[in] idx Local index of target octant.
  * \param[in] iface Index of the target face.
@@ -618,7 +798,7 @@ ParaTree::getCenter(uint32_t idx) {
 darray3
 ParaTree::getFaceCenter(uint32_t idx, uint8_t iface) {
 	darray3 center;
-	darray3 center_ = m_octree.m_octants[idx].getFaceCenter(iface);
+	darray3 center_ = m_octree.m_octants[idx].getFaceCenter(m_dim, iface);
 	m_trans.mapCenter(center_, center);
 	return center;
 }
@@ -630,7 +810,7 @@ ParaTree::getFaceCenter(uint32_t idx, uint8_t iface) {
  */
 void
 ParaTree::getFaceCenter(uint32_t idx, uint8_t iface, darray3& center) {
-	darray3 center_ = m_octree.m_octants[idx].getFaceCenter(iface);
+	darray3 center_ = m_octree.m_octants[idx].getFaceCenter(m_dim, iface);
 	m_trans.mapCenter(center_, center);
 }
 
@@ -665,7 +845,7 @@ ParaTree::getNode(uint32_t idx, uint8_t inode, darray3& node) {
 void
 ParaTree::getNodes(uint32_t idx, darr3vector & nodes) {
 	u32arr3vector nodes_;
-	m_octree.m_octants[idx].getNodes(nodes_);
+	m_octree.m_octants[idx].getNodes(m_dim, nodes_);
 	m_trans.mapNodes(nodes_, nodes);
 }
 
@@ -677,7 +857,7 @@ darr3vector
 ParaTree::getNodes(uint32_t idx){
 	darr3vector nodes;
 	u32arr3vector nodes_;
-	m_octree.m_octants[idx].getNodes(nodes_);
+	m_octree.m_octants[idx].getNodes(m_dim, nodes_);
 	m_trans.mapNodes(nodes_, nodes);
 	return nodes;
 }
@@ -788,7 +968,7 @@ ParaTree::getPbound(uint32_t idx){
  */
 bool
 ParaTree::getIsGhost(uint32_t idx){
-	return (findOwner(m_octree.m_octants[idx].computeMorton()) != m_rank);
+	return (findOwner(m_octree.m_mortons[idx]) != m_rank);
 };
 
 /*! Get if the octant is new after refinement.
@@ -923,7 +1103,7 @@ ParaTree::getSize(Octant* oct) {
  */
 double
 ParaTree::getArea(Octant* oct) {
-	return m_trans.mapArea(oct->getArea());
+	return m_trans.mapArea(oct->getArea(m_dim));
 }
 
 /*! Get the volume of an octant.
@@ -932,7 +1112,7 @@ ParaTree::getArea(Octant* oct) {
  */
 double
 ParaTree::getVolume(Octant* oct) {
-	return m_trans.mapVolume(oct->getVolume());
+	return m_trans.mapVolume(oct->getVolume(m_dim));
 }
 
 /*! Get the coordinates of the center of an octant.
@@ -965,7 +1145,7 @@ ParaTree::getCenter(Octant* oct) {
 darray3
 ParaTree::getFaceCenter(Octant* oct, uint8_t iface) {
 	darray3 center;
-	darray3 center_ = oct->getFaceCenter(iface);
+	darray3 center_ = oct->getFaceCenter(m_dim, iface);
 	m_trans.mapCenter(center_, center);
 	return center;
 }
@@ -977,7 +1157,7 @@ ParaTree::getFaceCenter(Octant* oct, uint8_t iface) {
  */
 void
 ParaTree::getFaceCenter(Octant* oct, uint8_t iface, darray3& center) {
-	darray3 center_ = oct->getFaceCenter(iface);
+	darray3 center_ = oct->getFaceCenter(m_dim, iface);
 	m_trans.mapCenter(center_, center);
 }
 
@@ -1012,7 +1192,7 @@ ParaTree::getNode(Octant* oct, uint8_t inode, darray3& node) {
 void
 ParaTree::getNodes(Octant* oct, darr3vector & nodes) {
 	u32arr3vector nodes_;
-	oct->getNodes(nodes_);
+	oct->getNodes(m_dim, nodes_);
 	m_trans.mapNodes(nodes_, nodes);
 }
 
@@ -1024,7 +1204,7 @@ darr3vector
 ParaTree::getNodes(Octant* oct){
 	darr3vector nodes;
 	u32arr3vector nodes_;
-	oct->getNodes(nodes_);
+	oct->getNodes(m_dim, nodes_);
 	m_trans.mapNodes(nodes_, nodes);
 	return nodes;
 }
@@ -1311,7 +1491,7 @@ Octant & ParaTree::getLastDesc() const{
  */
 uint64_t
 ParaTree::getLastDescMorton(uint32_t idx) {
-	return m_octree.m_octants[idx].buildLastDesc().computeMorton();
+	return m_octree.m_octants[idx].buildLastDesc(m_dim).computeMorton();
 };
 
 /*!Get the begin position for the iterator of the local internal octants.
@@ -1354,6 +1534,82 @@ ParaTree::setBalanceCodimension(uint8_t b21codim){
 	m_octree.setBalanceCodim(b21codim);
 };
 
+/*! Get the memory used by the local tree of the process, i.e. octants, ghosts,
+ * Morton numbers, intersections, connectivity and neighbour cache.
+ * The allocated capacity of the containers is counted.
+ * \return Memory footprint of the local tree in bytes.
+ */
+uint64_t
+ParaTree::getMemoryFootprint(){
+	vector<pair<string, uint64_t> > footprint;
+	computeMemoryFootprint(footprint);
+
+	uint64_t bytes = 0;
+	for (size_t i = 0; i < footprint.size(); i++){
+		bytes += footprint[i].second;
+	}
+	return bytes;
+};
+
+/*! Write on the log file the memory footprint of the octree, item by item,
+ * together with the size of an octant and the bytes per octant.
+ * In parallel the footprint is summed over the processes, so the method has
+ * to be called by all the processes of the communicator.
+ */
+void
+ParaTree::writeMemoryFootprint(){
+	vector<pair<string, uint64_t> > footprint;
+	computeMemoryFootprint(footprint);
+
+	int nitems = footprint.size();
+	u64vector bytes(nitems + 1, 0);
+	for (int i = 0; i < nitems; i++){
+		bytes[i] = footprint[i].second;
+		bytes[nitems] += footprint[i].second;
+	}
+#if ENABLE_MPI==1
+	if (!m_serial){
+		u64vector localBytes(bytes);
+		m_errorFlag = MPI_Allreduce(localBytes.data(), bytes.data(), nitems + 1, MPI_UINT64_T, MPI_SUM, m_comm);
+	}
+#endif
+
+	double perOctant = 0.0;
+	if (m_globalNumOctants > 0){
+		perOctant = double(bytes[nitems]) / double(m_globalNumOctants);
+	}
+
+	m_log.writeLog("---------------------------------------------");
+	m_log.writeLog(" MEMORY FOOTPRINT");
+	m_log.writeLog(" ");
+	m_log.writeLog(" Size of an octant	:	" + to_string(static_cast<unsigned long long>(sizeof(Octant))) + " B");
+	m_log.writeLog(" Number of octants	:	" + to_string(static_cast<unsigned long long>(m_globalNumOctants)));
+	for (int i = 0; i < nitems; i++){
+		m_log.writeLog(" " + footprint[i].first + "	:	" + to_string(static_cast<unsigned long long>(bytes[i])) + " B");
+	}
+	m_log.writeLog(" Total			:	" + to_string(static_cast<unsigned long long>(bytes[nitems])) + " B");
+	m_log.writeLog(" Bytes per octant	:	" + to_string(perOctant));
+	m_log.writeLog("---------------------------------------------");
+};
+
+/*! Get the number of iterations of the last 2:1 balance, the first sweep over
+ * all the local octants included.
+ * \return Number of iterations of the last 2:1 balance.
+ */
+uint32_t
+ParaTree::getBalanceIterations() const{
+	return m_balanceIterations;
+};
+
+/*! Get the wall-clock time spent by the process in each iteration of the last
+ * 2:1 balance (the first element is the sweep over all the local octants).
+ * \return Time in seconds of each iteration of the last 2:1 balance.
+ */
+const dvector &
+ParaTree::getBalanceTimes() const{
+	return m_balanceTimes;
+};
+
 // =================================================================================== //
 // INTERSECTION GET/SET METHODS
 // =================================================================================== //
@@ -1485,12 +1741,12 @@ ParaTree::getSize(Intersection* inter) {
  */
 double
 ParaTree::getArea(Intersection* inter) {
-	uint32_t Area;
+	uint64_t Area;
 	if(inter->m_finer && inter->m_isghost)
-		Area = m_octree.extractGhostOctant(inter->m_owners[1]).getArea();
+		Area = m_octree.extractGhostOctant(inter->m_owners[1]).getArea(m_dim);
 	else
-		Area = m_octree.extractOctant(inter->m_owners[inter->m_finer]).getArea();
-	return m_trans.mapSize(Area);
+		Area = m_octree.extractOctant(inter->m_owners[inter->m_finer]).getArea(m_dim);
+	return m_trans.mapArea(Area);
 }
 
 /*! Get the coordinates of the center of an intersection.
@@ -1527,7 +1783,7 @@ ParaTree::getNodes(Intersection* inter){
 		oct = m_octree.extractOctant(inter->m_owners[inter->m_finer]);
 	uint8_t iface = inter->m_iface;
 	u32arr3vector nodes_all;
-	oct.getNodes(nodes_all);
+	oct.getNodes(m_dim, nodes_all);
 	u32arr3vector nodes_(m_global.m_nnodesPerFace);
 	for (int i=0; i<m_global.m_nnodesPerFace; i++){
 		for (int j=0; j<3; j++){
@@ -1664,7 +1920,11 @@ ParaTree::setLastDesc(){
 void
 ParaTree::findNeighbours(uint32_t idx, uint8_t iface, uint8_t codim, u32vector & neighbours, vector<bool> & isghost){
 
-	bool	Fedge = ((codim>1) && (m_dim==3));
+	if (m_octree.findCachedNeighbours(idx, iface, codim, neighbours, isghost)){
+		return;
+	}
+
+	bool	Fedge = ((codim==2) && (m_dim==3));
 	bool	Fnode = (codim == m_dim);
 
 	if (codim == 1){
@@ -1694,7 +1954,14 @@ ParaTree::findNeighbours(uint32_t idx, uint8_t iface, uint8_t codim, u32vector &
 void
 ParaTree::findNeighbours(Octant* oct, uint8_t iface, uint8_t codim, u32vector & neighbours, vector<bool> & isghost){
 
-	bool	Fedge = ((codim>1) && (m_dim==3));
+	if (m_octree.m_neighCached && !oct->getIsGhost() && getNumOctants() > 0
+			&& oct >= &m_octree.m_octants.front() && oct <= &m_octree.m_octants.back()){
+		if (m_octree.findCachedNeighbours(uint32_t(oct - &m_octree.m_octants.front()), iface, codim, neighbours, isghost)){
+			return;
+		}
+	}
+
+	bool	Fedge = ((codim==2) && (m_dim==3));
 	bool	Fnode = (codim == m_dim);
 
 	if (codim == 1){
@@ -1724,7 +1991,7 @@ ParaTree::findNeighbours(Octant* oct, uint8_t iface, uint8_t codim, u32vector &
 void
 ParaTree::findGhostNeighbours(uint32_t idx, uint8_t iface, uint8_t codim, u32vector & neighbours){
 
-	bool	Fedge = ((codim>1) && (m_dim==3));
+	bool	Fedge = ((codim==2) && (m_dim==3));
 	bool	Fnode = (codim == m_dim);
 
 	if (codim == 1){
@@ -1741,16 +2008,44 @@ ParaTree::findGhostNeighbours(uint32_t idx, uint8_t iface, uint8_t codim, u32vec
 	}
 };
 
+/** Enable/disable the neighbour cache of the local octants.
+ * When the cache is enabled the neighbours of each face (and optionally of each edge
+ * and node) of the local octants are computed once and stored in a CSR table;
+ * findNeighbours by index then reads the table instead of searching the octants.
+ * The cache is updated automatically by adapt (incrementally if a mapper is
+ * tracked) and rebuilt by loadBalance.
+ * \param[in] cache True to enable the cache, false to disable it and free its memory.
+ * \param[in] codim Maximum codimension of the cached entities (1=faces, 2=faces and edges in 3D, dim=faces, edges and nodes).
+ */
+void
+ParaTree::setNeighbourCache(bool cache, uint8_t codim){
+	if (cache){
+		m_octree.m_neighCodim = max(uint8_t(1), min(codim, m_dim));
+		m_octree.computeNeighbourCache();
+	}
+	else{
+		m_octree.m_neighCodim = 0;
+		m_octree.clearNeighbourCache();
+	}
+};
+
+/** Get if the neighbour cache of the local octants is enabled.
+ * \return True if the neighbour cache is enabled.
+ */
+bool
+ParaTree::getNeighbourCache() const{
+	return (m_octree.m_neighCodim > 0);
+};
+
 /** Get the octant owner of an input point.
  * \param[in] point Coordinates of target point.
  * \return Pointer to octant owner of target point (=NULL if point is outside of the domain).
  */
 Octant*
 ParaTree::getPointOwner(dvector & point){
-	uint32_t noctants = m_octree.m_octants.size();
-	uint32_t idxtry = noctants/2;
+	uint32_t idxtry;
 	uint32_t x, y, z;
-	uint64_t morton, mortontry;
+	uint64_t morton;
 	int powner = 0;
 
 	x = m_trans.mapX(point[0]);
@@ -1762,7 +2057,7 @@ ParaTree::getPointOwner(dvector & point){
 	if (x == m_global.m_maxLength) x = x - 1;
 	if (y == m_global.m_maxLength) y = y - 1;
 	if (z == m_global.m_maxLength) z = z - 1;
-	morton = mortonEncode_magicbits(x,y,z);
+	morton = mortonEncode(x,y,z);
 
 	powner = 0;
 	if (!m_serial) powner = findOwner(morton);
@@ -1770,45 +2065,8 @@ ParaTree::getPointOwner(dvector & point){
 	if ((powner!=m_rank) && (!m_serial))
 		return NULL;
 
-	int32_t jump = idxtry;
-	while(abs(jump) > 0){
-		mortontry = m_octree.m_octants[idxtry].computeMorton();
-		jump = ((mortontry<morton)-(mortontry>morton))*abs(jump)/2;
-		idxtry += jump;
-		if (idxtry > noctants-1){
-			if (jump > 0){
-				idxtry = noctants - 1;
-				jump = 0;
-			}
-			else if (jump < 0){
-				idxtry = 0;
-				jump = 0;
-			}
-		}
-	}
-	if(m_octree.m_octants[idxtry].computeMorton() == morton){
-		return &m_octree.m_octants[idxtry];
-	}
-	else{
-		// Step until the mortontry lower than morton (one idx of distance)
-		{
-			while(m_octree.m_octants[idxtry].computeMorton() < morton){
-				idxtry++;
-				if(idxtry > noctants-1){
-					idxtry = noctants-1;
-					break;
-				}
-			}
-			while(m_octree.m_octants[idxtry].computeMorton() > morton){
-				idxtry--;
-				if(idxtry > noctants-1){
-					idxtry = 0;
-					break;
-				}
-			}
-		}
-		return &m_octree.m_octants[idxtry];
-	}
+	idxtry = m_octree.findLowerMorton(morton);
+	return &m_octree.m_octants[idxtry];
 
 };
 
@@ -1818,10 +2076,9 @@ ParaTree::getPointOwner(dvector & point){
  */
 uint32_t
 ParaTree::getPointOwnerIdx(dvector & point){
-	uint32_t noctants = m_octree.m_octants.size();
-	uint32_t idxtry = noctants/2;
+	uint32_t idxtry;
 	uint32_t x, y, z;
-	uint64_t morton, mortontry;
+	uint64_t morton;
 	int powner = 0;
 
 	x = m_trans.mapX(point[0]);
@@ -1836,7 +2093,7 @@ ParaTree::getPointOwnerIdx(dvector & point){
 	if (x == m_global.m_maxLength) x = x - 1;
 	if (y == m_global.m_maxLength) y = y - 1;
 	if (z == m_global.m_maxLength) z = z - 1;
-	morton = mortonEncode_magicbits(x,y,z);
+	morton = mortonEncode(x,y,z);
 
 
 	powner = 0;
@@ -1845,46 +2102,8 @@ ParaTree::getPointOwnerIdx(dvector & point){
 	if ((powner!=m_rank) && (!m_serial))
 		return -1;
 
-	int32_t jump = idxtry;
-	while(abs(jump) > 0){
-
-		mortontry = m_octree.m_octants[idxtry].computeMorton();
-		jump = ((mortontry<morton)-(mortontry>morton))*abs(jump)/2;
-		idxtry += jump;
-		if (idxtry > noctants-1){
-			if (jump > 0){
-				idxtry = noctants - 1;
-				jump = 0;
-			}
-			else if (jump < 0){
-				idxtry = 0;
-				jump = 0;
-			}
-		}
-	}
-	if(m_octree.m_octants[idxtry].computeMorton() == morton){
-		return idxtry;
-	}
-	else{
-		// Step until the mortontry lower than morton (one idx of distance)
-		{
-			while(m_octree.m_octants[idxtry].computeMorton() < morton){
-				idxtry++;
-				if(idxtry > noctants-1){
-					idxtry = noctants-1;
-					break;
-				}
-			}
-			while(m_octree.m_octants[idxtry].computeMorton() > morton){
-				idxtry--;
-				if(idxtry > noctants-1){
-					idxtry = 0;
-					break;
-				}
-			}
-		}
-		return idxtry;
-	}
+	idxtry = m_octree.findLowerMorton(morton);
+	return idxtry;
 };
 
 /** Get the octant owner of an input point.
@@ -1893,10 +2112,9 @@ ParaTree::getPointOwnerIdx(dvector & point){
  */
 Octant*
 ParaTree::getPointOwner(darray3 & point){
-	uint32_t noctants = m_octree.m_octants.size();
-	uint32_t idxtry = noctants/2;
+	uint32_t idxtry;
 	uint32_t x, y, z;
-	uint64_t morton, mortontry;
+	uint64_t morton;
 	int powner = 0;
 
 	x = m_trans.mapX(point[0]);
@@ -1908,7 +2126,7 @@ ParaTree::getPointOwner(darray3 & point){
 	if (x == m_global.m_maxLength) x = x - 1;
 	if (y == m_global.m_maxLength) y = y - 1;
 	if (z == m_global.m_maxLength) z = z - 1;
-	morton = mortonEncode_magicbits(x,y,z);
+	morton = mortonEncode(x,y,z);
 
 	powner = 0;
 	if (!m_serial) powner = findOwner(morton);
@@ -1916,45 +2134,8 @@ ParaTree::getPointOwner(darray3 & point){
 	if ((powner!=m_rank) && (!m_serial))
 		return NULL;
 
-	int32_t jump = idxtry;
-	while(abs(jump) > 0){
-		mortontry = m_octree.m_octants[idxtry].computeMorton();
-		jump = ((mortontry<morton)-(mortontry>morton))*abs(jump)/2;
-		idxtry += jump;
-		if (idxtry > noctants-1){
-			if (jump > 0){
-				idxtry = noctants - 1;
-				jump = 0;
-			}
-			else if (jump < 0){
-				idxtry = 0;
-				jump = 0;
-			}
-		}
-	}
-	if(m_octree.m_octants[idxtry].computeMorton() == morton){
-		return &m_octree.m_octants[idxtry];
-	}
-	else{
-		// Step until the mortontry lower than morton (one idx of distance)
-		{
-			while(m_octree.m_octants[idxtry].computeMorton() < morton){
-				idxtry++;
-				if(idxtry > noctants-1){
-					idxtry = noctants-1;
-					break;
-				}
-			}
-			while(m_octree.m_octants[idxtry].computeMorton() > morton){
-				idxtry--;
-				if(idxtry > noctants-1){
-					idxtry = 0;
-					break;
-				}
-			}
-		}
-		return &m_octree.m_octants[idxtry];
-	}
+	idxtry = m_octree.findLowerMorton(morton);
+	return &m_octree.m_octants[idxtry];
 
 };
 
@@ -1964,10 +2145,9 @@ ParaTree::getPointOwner(darray3 & point){
  */
 uint32_t
 ParaTree::getPointOwnerIdx(darray3 & point){
-	uint32_t noctants = m_octree.m_octants.size();
-	uint32_t idxtry = noctants/2;
+	uint32_t idxtry;
 	uint32_t x, y, z;
-	uint64_t morton, mortontry;
+	uint64_t morton;
 	int powner = 0;
 
 	x = m_trans.mapX(point[0]);
@@ -1982,7 +2162,7 @@ ParaTree::getPointOwnerIdx(darray3 & point){
 	if (x == m_global.m_maxLength) x = x - 1;
 	if (y == m_global.m_maxLength) y = y - 1;
 	if (z == m_global.m_maxLength) z = z - 1;
-	morton = mortonEncode_magicbits(x,y,z);
+	morton = mortonEncode(x,y,z);
 
 
 	powner = 0;
@@ -1991,47 +2171,172 @@ ParaTree::getPointOwnerIdx(darray3 & point){
 	if ((powner!=m_rank) && (!m_serial))
 		return -1;
 
-	int32_t jump = idxtry;
-	while(abs(jump) > 0){
+	idxtry = m_octree.findLowerMorton(morton);
+	return idxtry;
+};
 
-		mortontry = m_octree.m_octants[idxtry].computeMorton();
-		jump = ((mortontry<morton)-(mortontry>morton))*abs(jump)/2;
-		idxtry += jump;
-		if (idxtry > noctants-1){
-			if (jump > 0){
-				idxtry = noctants - 1;
-				jump = 0;
-			}
-			else if (jump < 0){
-				idxtry = 0;
-				jump = 0;
+/** Get the octant owners of a set of input points.
+ * The Morton indices of the points are computed and sorted, then the points are
+ * located with a merge of the sorted Morton indices with the ones of the octants
+ * (and with the partition of the octree for the points of the other processes).
+ * The sorted points are split in chunks located concurrently (if OpenMP is enabled).
+ * \param[in] points Coordinates of the target points.
+ * \param[out] idx Local indices of the octant owners of the points (max uint32_t
+ * representable if a point is outside of the domain or owned by another process).
+ */
+void
+ParaTree::getPointOwners(const std::vector<darray3> & points, u32vector & idx){
+	std::vector<int> ranks;
+	getPointOwners(points, idx, ranks);
+};
+
+/** Get the octant owners and the owner processes of a set of input points
+ * (see getPointOwners(const std::vector<darray3> &, u32vector &)); the points
+ * owned by other processes can be sent to their owners in a single exchange.
+ * The method is virtual: an octree with a physical domain maps the points in the
+ * logical domain before locating them (see PabloUniform).
+ * \param[in] points Coordinates of the target points.
+ * \param[out] idx Local indices of the octant owners of the points (max uint32_t
+ * representable if a point is outside of the domain or owned by another process).
+ * \param[out] ranks Ranks of the processes owning the points (-1 if a point is outside of the domain).
+ */
+void
+ParaTree::getPointOwners(const std::vector<darray3> & points, u32vector & idx, std::vector<int> & ranks){
+
+	const uint32_t	minChunkSize = 4096;
+	const uint64_t	outside = numeric_limits<uint64_t>::max();
+	uint32_t		npoints = points.size();
+	uint32_t		noctants = getNumOctants();
+
+	idx.assign(npoints, uint32_t(-1));
+	ranks.assign(npoints, -1);
+
+	// Morton indices of the points (outside for the points outside of the domain)
+	std::vector<std::pair<uint64_t, uint32_t> > keys(npoints);
+#pragma omp parallel for schedule(static) if (npoints > minChunkSize)
+	for (uint32_t i = 0; i < npoints; ++i){
+		const darray3 & point = points[i];
+		uint32_t x = m_trans.mapX(point[0]);
+		uint32_t y = m_trans.mapY(point[1]);
+		uint32_t z = m_trans.mapZ(point[2]);
+		keys[i].second = i;
+		if ((x > m_global.m_maxLength) || (y > m_global.m_maxLength) || (z > m_global.m_maxLength)
+				|| (point[0] < m_trans.m_origin[0]) || (point[1] < m_trans.m_origin[1]) || (point[2] < m_trans.m_origin[2])){
+			keys[i].first = outside;
+			continue;
+		}
+		if (x == m_global.m_maxLength) x = x - 1;
+		if (y == m_global.m_maxLength) y = y - 1;
+		if (z == m_global.m_maxLength) z = z - 1;
+		keys[i].first = mortonEncode(x,y,z);
+	}
+	sort(keys.begin(), keys.end());
+
+	// Merge of the sorted points with the octants and the partition, by chunks
+	uint32_t nchunks = max(uint32_t(1), npoints/minChunkSize);
+	uint32_t chunkSize = (npoints + nchunks - 1)/nchunks;
+#pragma omp parallel for schedule(static) if (nchunks > 1)
+	for (uint32_t ichunk = 0; ichunk < nchunks; ichunk++){
+		uint32_t begin = min(npoints, ichunk*chunkSize);
+		uint32_t end = min(npoints, begin + chunkSize);
+		if (begin == end || keys[begin].first == outside) continue;
+
+		uint32_t ioctant = m_octree.findLowerMorton(keys[begin].first);
+		int rank = m_rank;
+		if (!m_serial) rank = findOwner(keys[begin].first);
+		for (uint32_t k = begin; k < end && keys[k].first != outside; ++k){
+			uint64_t morton = keys[k].first;
+			if (!m_serial){
+				while (rank < m_nproc - 1 && m_partitionLastDesc[rank] < morton) ++rank;
 			}
+			ranks[keys[k].second] = rank;
+			if (rank != m_rank || noctants == 0) continue;
+			while (ioctant + 1 < noctants && m_octree.m_mortons[ioctant + 1] <= morton) ++ioctant;
+			idx[keys[k].second] = ioctant;
 		}
 	}
-	if(m_octree.m_octants[idxtry].computeMorton() == morton){
-		return idxtry;
+};
+
+#if ENABLE_MPI==1
+/** Exchange buffers of bytes with a sparse set of processes, not known in advance
+ * by the receivers. The buffers are sent with synchronous sends and received as
+ * they are probed; when all the local sends have been matched a non-blocking barrier
+ * is started, and the exchange ends when all the processes have joined the barrier.
+ * No collective communication of size proportional to the number of processes is used.
+ * Consecutive exchanges use different tags, so that the buffers of an exchange are
+ * never received by the previous one.
+ * The non-blocking barrier needs MPI-3: with an older MPI the number of buffers to be
+ * received is found with a reduction of the destinations over the processes.
+ * \param[in] sendBuffers Buffers to be sent, one per destination process.
+ * \param[out] recvBuffers Buffers received, one per source process.
+ */
+void
+ParaTree::exchangeSparse(const std::map<int, std::vector<char> > & sendBuffers, std::map<int, std::vector<char> > & recvBuffers){
+
+	// The tag is larger than the ranks used as tags by the other communications. It
+	// alternates between consecutive exchanges: a process can leave an exchange and
+	// send the buffers of the next one while another process is still probing, but it
+	// cannot start a third exchange before all the processes have left the first one
+	const int tag = m_nproc + int(m_sparseExchanges % 2);
+	++m_sparseExchanges;
+
+	recvBuffers.clear();
+	std::vector<MPI_Request> sendRequests;
+	sendRequests.reserve(sendBuffers.size());
+	for (std::map<int, std::vector<char> >::const_iterator sit = sendBuffers.begin(); sit != sendBuffers.end(); ++sit){
+		sendRequests.push_back(MPI_REQUEST_NULL);
+		m_errorFlag = MPI_Issend(const_cast<char*>(sit->second.data()), int(sit->second.size()), MPI_BYTE, sit->first, tag, m_comm, &sendRequests.back());
 	}
-	else{
-		// Step until the mortontry lower than morton (one idx of distance)
-		{
-			while(m_octree.m_octants[idxtry].computeMorton() < morton){
-				idxtry++;
-				if(idxtry > noctants-1){
-					idxtry = noctants-1;
-					break;
-				}
-			}
-			while(m_octree.m_octants[idxtry].computeMorton() > morton){
-				idxtry--;
-				if(idxtry > noctants-1){
-					idxtry = 0;
-					break;
-				}
+
+#if MPI_VERSION >= 3
+	MPI_Request barrierRequest = MPI_REQUEST_NULL;
+	bool barrierActive = false;
+	bool done = false;
+	while (!done){
+		int flag = 0;
+		MPI_Status status;
+		m_errorFlag = MPI_Iprobe(MPI_ANY_SOURCE, tag, m_comm, &flag, &status);
+		if (flag){
+			int count = 0;
+			MPI_Get_count(&status, MPI_BYTE, &count);
+			std::vector<char> & recvBuffer = recvBuffers[status.MPI_SOURCE];
+			recvBuffer.resize(count);
+			m_errorFlag = MPI_Recv(recvBuffer.data(), count, MPI_BYTE, status.MPI_SOURCE, tag, m_comm, MPI_STATUS_IGNORE);
+		}
+		if (!barrierActive){
+			int sent = 0;
+			m_errorFlag = MPI_Testall(int(sendRequests.size()), sendRequests.data(), &sent, MPI_STATUSES_IGNORE);
+			if (sent){
+				m_errorFlag = MPI_Ibarrier(m_comm, &barrierRequest);
+				barrierActive = true;
 			}
 		}
-		return idxtry;
+		else{
+			int finished = 0;
+			m_errorFlag = MPI_Test(&barrierRequest, &finished, MPI_STATUS_IGNORE);
+			done = (finished != 0);
+		}
+	}
+#else
+	std::vector<int> nbuffers(m_nproc, 0);
+	for (std::map<int, std::vector<char> >::const_iterator sit = sendBuffers.begin(); sit != sendBuffers.end(); ++sit){
+		nbuffers[sit->first] = 1;
+	}
+	m_errorFlag = MPI_Allreduce(MPI_IN_PLACE, nbuffers.data(), m_nproc, MPI_INT, MPI_SUM, m_comm);
+
+	for (int i = 0; i < nbuffers[m_rank]; ++i){
+		MPI_Status status;
+		m_errorFlag = MPI_Probe(MPI_ANY_SOURCE, tag, m_comm, &status);
+		int count = 0;
+		MPI_Get_count(&status, MPI_BYTE, &count);
+		std::vector<char> & recvBuffer = recvBuffers[status.MPI_SOURCE];
+		recvBuffer.resize(count);
+		m_errorFlag = MPI_Recv(recvBuffer.data(), count, MPI_BYTE, status.MPI_SOURCE, tag, m_comm, MPI_STATUS_IGNORE);
 	}
+	m_errorFlag = MPI_Waitall(int(sendRequests.size()), sendRequests.data(), MPI_STATUSES_IGNORE);
+#endif
 };
+#endif
 
 /** Get mapping info of an octant after an adapting with tracking changes.
  * \param[in] idx Index of new octant.
@@ -2106,9 +2411,9 @@ ParaTree::adaptGlobalRefine(bool mapper_flag) {
 	vector<Octant>::iterator iter, iterend = m_octree.m_octants.end();
 
 	for (iter = m_octree.m_octants.begin(); iter != iterend; iter++){
-		iter->m_info[12] = false;
-		iter->m_info[13] = false;
-		iter->m_info[15] = false;
+		iter->setInfo(12, false);
+		iter->setInfo(13, false);
+		iter->setInfo(15, false);
 	}
 
 	m_mapIdx.clear();
@@ -2181,8 +2486,18 @@ ParaTree::adaptGlobalRefine(bool mapper_flag) {
 		m_log.writeLog(" ");
 		m_log.writeLog("---------------------------------------------");
 	}
+	if (globalDone){
+		updateNeighbourCache(mapper_flag);
+		updateGeometryCache();
+		updateIntersections(mapper_flag);
+	}
 	return globalDone;
 #else
+	if (localDone){
+		updateNeighbourCache(mapper_flag);
+		updateGeometryCache();
+		updateIntersections(mapper_flag);
+	}
 	return localDone;
 #endif
 }
@@ -2199,9 +2514,9 @@ ParaTree::adaptGlobalCoarse(bool mapper_flag) {
 	vector<Octant>::iterator iter, iterend = m_octree.m_octants.end();
 
 	for (iter = m_octree.m_octants.begin(); iter != iterend; iter++){
-		iter->m_info[12] = false;
-		iter->m_info[13] = false;
-		iter->m_info[15] = false;
+		iter->setInfo(12, false);
+		iter->setInfo(13, false);
+		iter->setInfo(15, false);
 	}
 
 	m_mapIdx.clear();
@@ -2297,8 +2612,18 @@ ParaTree::adaptGlobalCoarse(bool mapper_flag) {
 		m_log.writeLog(" ");
 		m_log.writeLog("---------------------------------------------");
 	}
+	if (globalDone){
+		updateNeighbourCache(mapper_flag);
+		updateGeometryCache();
+		updateIntersections(mapper_flag);
+	}
 	return globalDone;
 #else
+	if (localDone){
+		updateNeighbourCache(mapper_flag);
+		updateGeometryCache();
+		updateIntersections(mapper_flag);
+	}
 	return localDone;
 #endif
 }
@@ -2318,27 +2643,8 @@ ParaTree::getMaxDepth() const{
  */
 int
 ParaTree::findOwner(const uint64_t & morton) {
-	int p = -1;
-	int length = m_nproc;
-	int beg = 0;
-	int end = m_nproc -1;
-	int seed = m_nproc/2;
-	while(beg != end){
-		if(morton <= m_partitionLastDesc[seed]){
-			end = seed;
-			if(morton > m_partitionLastDesc[seed-1])
-				beg = seed;
-		}
-		else{
-			beg = seed;
-			if(morton <= m_partitionLastDesc[seed+1])
-				beg = seed + 1;
-		}
-		length = end - beg;
-		seed = beg + length/2;
-	}
-	p = beg;
-	return p;
+	uint64_t* p = lower_bound(m_partitionLastDesc, m_partitionLastDesc + m_nproc, morton);
+	return min(int(p - m_partitionLastDesc), m_nproc - 1);
 }
 
 /** Compute the connectivity of octants and store the coordinates of nodes.
@@ -2368,26 +2674,42 @@ ParaTree::updateConnectivity() {
  */
 const u32vector2D &
 ParaTree::getConnectivity(){
-	return m_octree.m_connectivity;
+	return m_octree.getNestedConnectivity();
 }
 
 /** Get the local connectivity of an octant
  * \param[in] idx Local index of octant
- * \return Constant reference to the connectivity of the octant
- * (4/8 indices of nodes for 2D/3D case).
+ * \return Connectivity of the octant (4/8 indices of nodes for 2D/3D case), copied
+ * from the row of the octant in the flat connectivity (empty if the connectivity is not computed).
  */
-const u32vector &
+u32vector
 ParaTree::getConnectivity(uint32_t idx){
-	return m_octree.m_connectivity[idx];
+	ConnectivityView connectivity = m_octree.getConnectivityView();
+	if (idx >= connectivity.size()){
+		return u32vector();
+	}
+	return u32vector(connectivity.begin(idx), connectivity.end(idx));
 }
 
 /** Get the local connectivity of an octant
  * \param[in] oct Pointer to an octant
- * \return Constant reference to the connectivity of the octant (4/8 indices of nodes for 2D/3D case).
+ * \return Connectivity of the octant (4/8 indices of nodes for 2D/3D case), copied
+ * from the row of the octant in the flat connectivity (empty if the connectivity is not computed).
  */
-const u32vector &
+u32vector
 ParaTree::getConnectivity(Octant* oct){
-	return m_octree.m_connectivity[getIdx(oct)];
+	return getConnectivity(getIdx(oct));
+}
+
+/** Get a view of the connectivity of the octants.
+ * The connectivity is stored in a contiguous buffer with a fixed stride of
+ * 4/8 node indices per octant in 2D/3D: view[idx][j] is the index of the j-th
+ * node of the octant idx. The view is valid until the connectivity is cleared or updated.
+ * \return View of the connectivity (empty if the connectivity is not computed).
+ */
+ConnectivityView
+ParaTree::getConnectivityView(){
+	return m_octree.getConnectivityView();
 }
 
 /** Get the logical coordinates of the nodes
@@ -2443,27 +2765,42 @@ ParaTree::updateGhostsConnectivity() {
  */
 const u32vector2D &
 ParaTree::getGhostConnectivity(){
-	return m_octree.m_ghostsConnectivity;
+	return m_octree.getNestedGhostsConnectivity();
 }
 
 /** Get the local connectivity of a ghost octant
  * \param[in] idx Local index of ghost octant
- * \return Constant reference to the connectivity of the ghost octant
- * (4/8 indices of nodes for 2D/3D case).
+ * \return Connectivity of the ghost octant (4/8 indices of nodes for 2D/3D case), copied
+ * from the row of the ghost in the flat connectivity (empty if the connectivity is not computed).
  */
-const u32vector &
+u32vector
 ParaTree::getGhostConnectivity(uint32_t idx){
-	return m_octree.m_ghostsConnectivity[idx];
+	ConnectivityView connectivity = m_octree.getGhostsConnectivityView();
+	if (idx >= connectivity.size()){
+		return u32vector();
+	}
+	return u32vector(connectivity.begin(idx), connectivity.end(idx));
 }
 
 /** Get the local connectivity of a ghost octant
  * \param[in] oct Pointer to a ghost octant
- * \return Constant reference to the connectivity of the ghost octant
- * (4/8 indices of nodes for 2D/3D case).
+ * \return Connectivity of the ghost octant (4/8 indices of nodes for 2D/3D case), copied
+ * from the row of the ghost in the flat connectivity (empty if the connectivity is not computed).
  */
-const u32vector &
+u32vector
 ParaTree::getGhostConnectivity(Octant* oct){
-	return m_octree.m_ghostsConnectivity[getIdx(oct)];
+	return getGhostConnectivity(getIdx(oct));
+}
+
+/** Get a view of the connectivity of the ghost octants.
+ * The connectivity is stored in a contiguous buffer with a fixed stride of
+ * 4/8 node indices per ghost in 2D/3D: view[idx][j] is the index of the j-th
+ * node of the ghost idx. The view is valid until the connectivity is cleared or updated.
+ * \return View of the ghosts connectivity (empty if the connectivity is not computed).
+ */
+ConnectivityView
+ParaTree::getGhostConnectivityView(){
+	return m_octree.getGhostsConnectivityView();
 }
 
 /** Get the logical coordinates of the ghost nodes
@@ -2507,11 +2844,16 @@ ParaTree::loadBalance(dvector* weight){
 	m_log.writeLog("---------------------------------------------");
 	m_log.writeLog(" LOAD BALANCE ");
 
+	if (isLoadBalanced(weight)){
+		return;
+	}
+
 	uint32_t* partition = new uint32_t [m_nproc];
 	if (weight == NULL)
 		computePartition(partition);
 	else
 		computePartition(partition, weight);
+	snapPartitionToFamilies(partition);
 
 	weight = NULL;
 
@@ -2545,8 +2887,13 @@ ParaTree::loadBalance(uint8_t & level, dvector* weight){
 	m_log.writeLog("---------------------------------------------");
 	m_log.writeLog(" LOAD BALANCE ");
 
+	if (isLoadBalanced(weight)){
+		return;
+	}
+
 	uint32_t* partition = new uint32_t [m_nproc];
 	computePartition(partition, level, weight);
+	snapPartitionToFamilies(partition);
 
 	privateLoadBalance(partition);
 
@@ -2565,6 +2912,111 @@ ParaTree::loadBalance(uint8_t & level, dvector* weight){
 
 };
 
+/** Set the tolerance on the imbalance of the load of the processes under which
+ * a load balance does not migrate any octant. The imbalance is the ratio between
+ * the maximum and the mean load of the processes minus one (e.g. 0.02 means that
+ * the most loaded process has 2% more load than the mean).
+ * \param[in] tolerance Tolerance on the imbalance (0 = the octants are always migrated).
+ */
+void
+ParaTree::setLoadBalanceTolerance(double tolerance){
+	m_loadBalanceTolerance = max(tolerance, 0.0);
+};
+
+/** Get the tolerance on the imbalance of the load of the processes under which
+ * a load balance does not migrate any octant.
+ * \return Tolerance on the imbalance (0 = the octants are always migrated).
+ */
+double
+ParaTree::getLoadBalanceTolerance() const{
+	return m_loadBalanceTolerance;
+};
+
+/** Set the depth of the families of octants that a load balance (also with a level of
+ * compact families) never splits between two processes. A process can start only with
+ * an octant that is the first descendant of its ancestor depth levels above it, so that
+ * with depth >= 1 the families of siblings are always stored on the same process and
+ * the coarsening does not have to deal with families broken across the processes.
+ * \param[in] depth Depth of the families kept on the same process (0 = the cuts are not moved).
+ */
+void
+ParaTree::setPartitionFamilyDepth(uint8_t depth){
+	m_partitionFamilyDepth = depth;
+};
+
+/** Get the depth of the families of octants that a load balance never splits between
+ * two processes.
+ * \return Depth of the families kept on the same process (0 = the cuts are not moved).
+ */
+uint8_t
+ParaTree::getPartitionFamilyDepth() const{
+	return m_partitionFamilyDepth;
+};
+
+/** Allocate a buffer in a memory window shared between the processes of the same node,
+ * replacing the previous one (if any). The call is collective over the processes of the
+ * node. The buffers of the other processes of the node can be accessed directly, so that
+ * a communicate of data stored in the buffer (see allocateSharedData) does not send any
+ * message between processes of the same node. The buffer has to be allocated again
+ * when the octants change (adapt, loadBalance). With an MPI older than 3 the buffer is
+ * private to the local process and the ghosts are always sent.
+ * \param[in] size Size in bytes of the buffer of the local process.
+ * \return Pointer to the buffer of the local process.
+ */
+void*
+ParaTree::allocateSharedBuffer(size_t size){
+	freeSharedBuffer();
+
+	void* buffer = NULL;
+#if MPI_VERSION >= 3
+	m_errorFlag = MPI_Win_allocate_shared(MPI_Aint(size),1,MPI_INFO_NULL,m_sharedComm,&buffer,&m_sharedWin);
+	m_errorFlag = MPI_Win_lock_all(MPI_MODE_NOCHECK,m_sharedWin);
+
+	int nofSharedProcs;
+	m_errorFlag = MPI_Comm_size(m_sharedComm,&nofSharedProcs);
+	m_sharedBuffers.resize(nofSharedProcs);
+	for(int p = 0; p < nofSharedProcs; ++p){
+		MPI_Aint sharedSize;
+		int dispUnit;
+		m_errorFlag = MPI_Win_shared_query(m_sharedWin,p,&sharedSize,&dispUnit,&m_sharedBuffers[p]);
+	}
+#else
+	// Without shared memory windows the buffer is private and the ghosts are sent
+	m_errorFlag = MPI_Alloc_mem(MPI_Aint(size),MPI_INFO_NULL,&buffer);
+	m_sharedBuffers.assign(1,buffer);
+#endif
+	return buffer;
+};
+
+/** Free the buffer in the shared memory window (collective over the processes of the node).
+ */
+void
+ParaTree::freeSharedBuffer(){
+#if MPI_VERSION >= 3
+	if(m_sharedWin != MPI_WIN_NULL){
+		MPI_Win_unlock_all(m_sharedWin);
+		MPI_Win_free(&m_sharedWin);
+	}
+#else
+	if(!m_sharedBuffers.empty()){
+		MPI_Free_mem(m_sharedBuffers[0]);
+	}
+#endif
+	m_sharedBuffers.clear();
+};
+
+/** Check if an array is stored in the buffer of the local process in the shared memory window.
+ * \param[in] data Pointer to the first element of the array.
+ * \return True if the array starts at the buffer of the local process in the shared window.
+ */
+bool
+ParaTree::isSharedBuffer(const void* data) const{
+	if(m_sharedWin == MPI_WIN_NULL){
+		return false;
+	}
+	return (data == m_sharedBuffers[m_sharedRanks[m_rank]]);
+};
+
 /** Distribute Load-Balancing the octants of the whole tree over
  * the processes of the job following a given partition distribution.
  * Until loadBalance is not called for the first time the mesh is serial.
@@ -2584,14 +3036,7 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 		uint32_t stride = 0;
 		for(int i = 0; i < m_rank; ++i)
 			stride += partition[i];
-		LocalTree::octvector octantsCopy = m_octree.m_octants;
-		LocalTree::octvector::const_iterator first = octantsCopy.begin() + stride;
-		LocalTree::octvector::const_iterator last = first + partition[m_rank];
-		m_octree.m_octants.assign(first, last);
-		octvector(m_octree.m_octants).swap(m_octree.m_octants);
-
-		first = octantsCopy.end();
-		last = octantsCopy.end();
+		m_octree.moveOctants(stride, stride + partition[m_rank], 0, partition[m_rank]);
 
 		//Update and ghosts here
 		updateLoadBalance();
@@ -2609,6 +3054,7 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 
 		//empty ghosts
 		m_octree.m_ghosts.clear();
+		m_octree.m_ghostsMortons.clear();
 		m_octree.m_sizeGhosts = 0;
 		//compute new partition range globalidx
 		uint64_t* newPartitionRangeGlobalidx = new uint64_t[m_nproc];
@@ -2679,7 +3125,7 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 		uint32_t x,y,z;
 		uint8_t l;
 		int8_t m;
-		bool info[17];
+		uint32_t info;
 		int intBuffer = 0;
 		int contatore = 0;
 		//build send buffers from Head
@@ -2704,16 +3150,13 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 						z = octant.getZ();
 						l = octant.getLevel();
 						m = octant.getMarker();
-						for(int ii = 0; ii < 17; ++ii)
-							info[ii] = octant.m_info[ii];
+						info = octant.m_info;
 						m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
-						for(int j = 0; j < 17; ++j){
-							MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
-						}
+						m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 					}
 					if(nofElementsFromSuccessiveToPrevious == headSize)
 						break;
@@ -2736,16 +3179,13 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 						z = octant.getZ();
 						l = octant.getLevel();
 						m = octant.getMarker();
-						for(int i = 0; i < 17; ++i)
-							info[i] = octant.m_info[i];
+						info = octant.m_info;
 						m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
-						for(int j = 0; j < 17; ++j){
-							MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
-						}
+						m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 					}
 					lh -= nofElementsFromSuccessiveToPrevious;
 					globalLastHead -= nofElementsFromSuccessiveToPrevious;
@@ -2778,16 +3218,13 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 						z = octant.getZ();
 						l = octant.getLevel();
 						m = octant.getMarker();
-						for(int ii = 0; ii < 17; ++ii)
-							info[ii] = octant.m_info[ii];
+						info = octant.m_info;
 						m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
-						for(int j = 0; j < 17; ++j){
-							MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
-						}
+						m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 					}
 					if(nofElementsFromPreviousToSuccessive == tailSize)
 						break;
@@ -2810,16 +3247,13 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 						z = octant.getZ();
 						l = octant.getLevel();
 						m = octant.getMarker();
-						for(int ii = 0; ii < 17; ++ii)
-							info[ii] = octant.m_info[ii];
+						info = octant.m_info;
 						m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 						m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
-						for(int j = 0; j < 17; ++j){
-							MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
-						}
+						m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&pos,m_comm);
 					}
 					ft += nofElementsFromPreviousToSuccessive;
 					globalFirstTail += nofElementsFromPreviousToSuccessive;
@@ -2830,44 +3264,25 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 			}
 		}
 
-		//Build receiver sources
-		vector<Array> recvs(m_nproc);
-		recvs[m_rank] = Array((uint32_t)sendBuffers.size()+1,-1);
-		recvs[m_rank].m_array[0] = m_rank;
-		int counter = 1;
-		map<int,CommBuffer>::iterator sitend = sendBuffers.end();
-		for(map<int,CommBuffer>::iterator sit = sendBuffers.begin(); sit != sitend; ++sit){
-			recvs[m_rank].m_array[counter] = sit->first;
-			++counter;
-		}
-		int* nofRecvsPerProc = new int[m_nproc];
-		m_errorFlag = MPI_Allgather(&recvs[m_rank].m_arraySize,1,MPI_INT,nofRecvsPerProc,1,MPI_INT,m_comm);
-		int globalRecvsBuffSize = 0;
-		int* displays = new int[m_nproc];
-		for(int pp = 0; pp < m_nproc; ++pp){
-			displays[pp] = 0;
-			globalRecvsBuffSize += nofRecvsPerProc[pp];
-			for(int ppp = 0; ppp < pp; ++ppp){
-				displays[pp] += nofRecvsPerProc[ppp];
-			}
-		}
-		int* globalRecvsBuff = new int[globalRecvsBuffSize];
-		m_errorFlag = MPI_Allgatherv(recvs[m_rank].m_array,recvs[m_rank].m_arraySize,MPI_INT,globalRecvsBuff,nofRecvsPerProc,displays,MPI_INT,m_comm);
-
-		vector<set<int> > sendersPerProc(m_nproc);
-		for(int pin = 0; pin < m_nproc; ++pin){
-			for(int k = displays[pin]+1; k < displays[pin] + nofRecvsPerProc[pin]; ++k){
-				sendersPerProc[globalRecvsBuff[k]].insert(globalRecvsBuff[displays[pin]]);
-			}
+		//Find the processes exchanging octants with this one from the old and the new partition
+		//(buffers without octants are not sent)
+		set<int> senders, receivers;
+		findMigrationNeighbours(newPartitionRangeGlobalidx, senders, receivers);
+		map<int,CommBuffer>::iterator sit = sendBuffers.begin();
+		while(sit != sendBuffers.end()){
+			if(receivers.count(sit->first))
+				++sit;
+			else
+				sendBuffers.erase(sit++);
 		}
 
 		//Communicate Octants (size)
-		MPI_Request* req = new MPI_Request[sendBuffers.size()+sendersPerProc[m_rank].size()];
-		MPI_Status* stats = new MPI_Status[sendBuffers.size()+sendersPerProc[m_rank].size()];
+		MPI_Request* req = new MPI_Request[sendBuffers.size()+senders.size()];
+		MPI_Status* stats = new MPI_Status[sendBuffers.size()+senders.size()];
 		int nReq = 0;
 		map<int,int> recvBufferSizePerProc;
-		set<int>::iterator senditend = sendersPerProc[m_rank].end();
-		for(set<int>::iterator sendit = sendersPerProc[m_rank].begin(); sendit != senditend; ++sendit){
+		set<int>::iterator senditend = senders.end();
+		for(set<int>::iterator sendit = senders.begin(); sendit != senditend; ++sendit){
 			recvBufferSizePerProc[*sendit] = 0;
 			m_errorFlag = MPI_Irecv(&recvBufferSizePerProc[*sendit],1,MPI_UINT32_T,*sendit,m_rank,m_comm,&req[nReq]);
 			++nReq;
@@ -2895,7 +3310,7 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 				nofNewTail += nofNewPerProc;
 		}
 		nReq = 0;
-		for(set<int>::iterator sendit = sendersPerProc[m_rank].begin(); sendit != senditend; ++sendit){
+		for(set<int>::iterator sendit = senders.begin(); sendit != senditend; ++sendit){
 			//nofBytesOverProc += recvBuffers[sit->first].m_commBufferSize;
 			m_errorFlag = MPI_Irecv(recvBuffers[*sendit].m_commBuffer,recvBuffers[*sendit].m_commBufferSize,MPI_PACKED,*sendit,m_rank,m_comm,&req[nReq]);
 			++nReq;
@@ -2906,21 +3321,11 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 		}
 		MPI_Waitall(nReq,req,stats);
 
-		//MOVE RESIDENT TO BEGIN IN OCTANTS
+		//MOVE RESIDENTS IN RIGHT POSITION (in place, they are not moved if the head does not change size)
 		uint32_t resEnd = m_octree.getNumOctants() - tailOffset;
 		uint32_t nofResidents = resEnd - headOffset;
-		int octCounter = 0;
-		for(uint32_t i = headOffset; i < resEnd; ++i){
-			m_octree.m_octants[octCounter] = m_octree.m_octants[i];
-			++octCounter;
-		}
 		uint32_t newCounter = nofNewHead + nofNewTail + nofResidents;
-		m_octree.m_octants.resize(newCounter);
-		//MOVE RESIDENTS IN RIGHT POSITION
-		uint32_t resCounter = nofNewHead + nofResidents - 1;
-		for(uint32_t k = 0; k < nofResidents ; ++k){
-			m_octree.m_octants[resCounter - k] = m_octree.m_octants[nofResidents - k - 1];
-		}
+		m_octree.moveOctants(headOffset, resEnd, nofNewHead, newCounter);
 
 		//UNPACK BUFFERS AND BUILD NEW OCTANTS
 		newCounter = 0;
@@ -2941,25 +3346,24 @@ ParaTree::privateLoadBalance(uint32_t* partition){
 				m_octree.m_octants[newCounter] = Octant(m_dim,l,x,y,z,m_global.m_maxLevel);
 				m_errorFlag = MPI_Unpack(rbit->second.m_commBuffer,rbit->second.m_commBufferSize,&pos,&m,1,MPI_INT8_T,m_comm);
 				m_octree.m_octants[newCounter].setMarker(m);
-				for(int j = 0; j < 17; ++j){
-					m_errorFlag = MPI_Unpack(rbit->second.m_commBuffer,rbit->second.m_commBufferSize,&pos,&info[j],1,MPI::BOOL,m_comm);
-					m_octree.m_octants[newCounter].m_info[j] = info[j];
-				}
+				m_errorFlag = MPI_Unpack(rbit->second.m_commBuffer,rbit->second.m_commBufferSize,&pos,&info,1,MPI_UINT32_T,m_comm);
+				m_octree.m_octants[newCounter].m_info = info;
+				m_octree.m_mortons[newCounter] = m_octree.m_octants[newCounter].computeMorton();
 				++newCounter;
 			}
 		}
-		octvector(m_octree.m_octants).swap(m_octree.m_octants);
 
 		delete [] newPartitionRangeGlobalidx; newPartitionRangeGlobalidx = NULL;
-		delete [] nofRecvsPerProc; nofRecvsPerProc = NULL;
-		delete [] displays; displays = NULL;
 		delete [] req; req = NULL;
 		delete [] stats; stats = NULL;
-		delete [] globalRecvsBuff; globalRecvsBuff = NULL;
 		//Update and ghosts here
 		updateLoadBalance();
 		setPboundGhosts();
 	}
+
+	updateNeighbourCache(false);
+	updateGeometryCache();
+	updateIntersections(false);
 };
 
 #endif
@@ -2980,12 +3384,57 @@ ParaTree::levelToSize(uint8_t & level) {
 // =================================================================================== //
 
 /** Compute the intersection between octants (local, ghost, boundary).
+ * Once computed, the intersections are kept up to date by adapt with mapper
+ * (only the intersections next to the changed octants are computed again) and
+ * cleared by adapt without mapper and loadBalance; the intersections are computed
+ * only if they are not up to date.
  */
 void
 ParaTree::computeIntersections(){
+	if (!m_octree.m_intersectionsOffsets.empty()){
+		return;
+	}
 	m_octree.computeIntersections();
+	updateIntersectionStore();
 }
 
+/*! Clear the intersections of the local tree (and the intersection store) and free their memory.
+ */
+void
+ParaTree::clearIntersections(){
+	m_octree.clearIntersections();
+	updateIntersectionStore();
+}
+
+/*! Enable or disable the structure of arrays of the intersections.
+ * If the store is enabled computeIntersections also fills an IntersectionStore with
+ * the owners, faces, flags and the precomputed areas, centers and normals of the
+ * intersections (see getStoredIntersections).
+ * \param[in] store True to enable the store, false to disable it and free its memory.
+ */
+void
+ParaTree::setIntersectionStore(bool store){
+	m_storeIntersections = store;
+	updateIntersectionStore();
+};
+
+/*! Get if the structure of arrays of the intersections is enabled.
+ * \return True if the intersection store is enabled.
+ */
+bool
+ParaTree::getIntersectionStore() const{
+	return m_storeIntersections;
+};
+
+/*! Get the structure of arrays of the intersections computed by the last call to
+ * computeIntersections.
+ * \return Constant reference to the intersection store (empty if the store is disabled).
+ */
+const IntersectionStore &
+ParaTree::getStoredIntersections() const{
+	return m_intersectionStore;
+};
+
 // =================================================================================== //
 // OTHER PRIVATE METHODS												    			   //
 // =================================================================================== //
@@ -3012,9 +3461,9 @@ ParaTree::private_adapt_mapidx(bool mapflag) {
 	vector<Octant >::iterator iter, iterend = m_octree.m_octants.end();
 
 	for (iter = m_octree.m_octants.begin(); iter != iterend; iter++){
-		iter->m_info[12] = false;
-		iter->m_info[13] = false;
-		iter->m_info[15] = false;
+		iter->setInfo(12, false);
+		iter->setInfo(13, false);
+		iter->setInfo(15, false);
 	}
 
 	// m_mapIdx init
@@ -3119,12 +3568,40 @@ ParaTree::private_adapt_mapidx(bool mapflag) {
 		m_log.writeLog(" ");
 		m_log.writeLog("---------------------------------------------");
 	}
+	if (globalDone){
+		updateNeighbourCache(mapflag);
+		updateGeometryCache();
+		updateIntersections(mapflag);
+	}
 	return globalDone;
 #else
+	if (localDone){
+		updateNeighbourCache(mapflag);
+		updateGeometryCache();
+		updateIntersections(mapflag);
+	}
 	return localDone;
 #endif
 }
 
+/*! Write on the log the number of threads used by the local process.
+ * In a hybrid run the threads only execute the local kernels and all the MPI calls
+ * are made by the thread calling the methods of the octree, so that MPI has to be
+ * initialized at least with MPI_THREAD_FUNNELED: a warning is written otherwise.
+ */
+void
+ParaTree::writeThreadsLog(){
+	int nthreads = getNumThreads();
+	m_log.writeLog(" Threads per proc	:	" + to_string(static_cast<unsigned long long>(nthreads)));
+#if ENABLE_MPI==1
+	int provided = MPI_THREAD_SINGLE;
+	m_errorFlag = MPI_Query_thread(&provided);
+	if (nthreads > 1 && provided < MPI_THREAD_FUNNELED){
+		m_log.writeLog(" WARNING : MPI is not initialized with MPI_THREAD_FUNNELED, use MPI_Init_thread");
+	}
+#endif
+};
+
 /*!Update the local tree after an adapt.
  */
 void
@@ -3173,6 +3650,145 @@ ParaTree::updateAdapt(){
 #endif
 }
 
+/*! Update the neighbour cache of the local tree (if enabled) after a change
+ * of the octree structure.
+ * \param[in] mapper_flag True if the change has been tracked by the mapper m_mapIdx,
+ * so that the cache can be updated incrementally.
+ */
+void
+ParaTree::updateNeighbourCache(bool mapper_flag){
+	if (m_octree.m_neighCodim == 0){
+		return;
+	}
+	if (mapper_flag){
+		m_octree.updateNeighbourCache(m_mapIdx);
+	}
+	else{
+		m_octree.computeNeighbourCache();
+	}
+}
+
+/*! Recompute the cache of the geometry of the local octants, if enabled
+ * (free its memory if disabled).
+ */
+void
+ParaTree::updateGeometryCache(){
+	if (!m_geometryCache){
+		for (int i = 0; i < 3; ++i){
+			dvector().swap(m_cachedCenters[i]);
+		}
+		dvector().swap(m_cachedSizes);
+		dvector().swap(m_cachedVolumes);
+		return;
+	}
+
+	uint32_t nocts = getNumOctants();
+	for (int i = 0; i < 3; ++i){
+		m_cachedCenters[i].resize(nocts);
+	}
+	m_cachedSizes.resize(nocts);
+	m_cachedVolumes.resize(nocts);
+
+	// Fill the cache with the bulk getters, the cache is disabled while it is filled
+	m_geometryCache = false;
+	getCenters(0, nocts, m_cachedCenters[0].data(), m_cachedCenters[1].data(), m_cachedCenters[2].data());
+	getSizes(0, nocts, m_cachedSizes.data());
+	getVolumes(0, nocts, m_cachedVolumes.data());
+	m_geometryCache = true;
+};
+
+/*! Update the intersections of the local tree after a change of the octree, if they have
+ * been computed: they are updated incrementally if the change is tracked by a mapper,
+ * otherwise they are cleared (and computed again by the next computeIntersections).
+ * \param[in] mapper_flag True if the change is tracked by the mapper m_mapIdx.
+ */
+void
+ParaTree::updateIntersections(bool mapper_flag){
+	if (m_octree.m_intersectionsOffsets.empty()){
+		return;
+	}
+	if (mapper_flag){
+		m_octree.updateIntersections(m_mapIdx);
+	}
+	else{
+		m_octree.clearIntersections();
+	}
+	updateIntersectionStore();
+};
+
+/*! Fill the structure of arrays of the intersections, if enabled (free its memory if disabled).
+ * The geometry of each intersection is computed with the getters of an Intersection;
+ * they are virtual, so the store of an octree with a physical domain holds its physical
+ * geometry (see PabloUniform).
+ */
+void
+ParaTree::updateIntersectionStore(){
+	if (!m_storeIntersections){
+		m_intersectionStore.clear();
+		return;
+	}
+
+	int32_t nintersections = m_octree.m_intersections.size();
+	m_intersectionStore.resize(nintersections);
+#pragma omp parallel for schedule(static) if (nintersections > 4096)
+	for (int32_t i = 0; i < nintersections; ++i){
+		Intersection* inter = &m_octree.m_intersections[i];
+		m_intersectionStore.m_owners[2*size_t(i)] = inter->m_owners[0];
+		m_intersectionStore.m_owners[2*size_t(i)+1] = inter->m_owners[1];
+		m_intersectionStore.m_faces[i] = inter->m_iface;
+		m_intersectionStore.m_flags[i] = uint8_t((inter->m_finer ? IntersectionStore::FINER : 0) | (inter->m_bound ? IntersectionStore::BOUND : 0)
+				| (inter->m_isghost ? IntersectionStore::GHOST : 0) | (inter->m_pbound ? IntersectionStore::PBOUND : 0));
+		m_intersectionStore.m_areas[i] = getArea(inter);
+		darray3 center = getCenter(inter);
+		darray3 normal = getNormal(inter);
+		for (int j = 0; j < 3; ++j){
+			m_intersectionStore.m_centers[j][i] = center[j];
+			m_intersectionStore.m_normals[j][i] = normal[j];
+		}
+	}
+};
+
+/*! Compute the memory used by the containers of the local tree (allocated capacity).
+ * \param[out] footprint Name and bytes of each item of the local tree.
+ */
+void
+ParaTree::computeMemoryFootprint(vector<pair<string, uint64_t> > & footprint){
+	const LocalTree & tree = m_octree;
+
+	uint64_t connectivity = tree.m_connectivity.capacity() * sizeof(uint32_t);
+	connectivity += tree.m_nestedConnectivity.capacity() * sizeof(u32vector);
+	for (size_t i = 0; i < tree.m_nestedConnectivity.size(); i++){
+		connectivity += tree.m_nestedConnectivity[i].capacity() * sizeof(uint32_t);
+	}
+	connectivity += tree.m_nodes.capacity() * sizeof(u32array3);
+
+	uint64_t ghostsConnectivity = tree.m_ghostsConnectivity.capacity() * sizeof(uint32_t);
+	ghostsConnectivity += tree.m_nestedGhostsConnectivity.capacity() * sizeof(u32vector);
+	for (size_t i = 0; i < tree.m_nestedGhostsConnectivity.size(); i++){
+		ghostsConnectivity += tree.m_nestedGhostsConnectivity[i].capacity() * sizeof(uint32_t);
+	}
+	ghostsConnectivity += tree.m_ghostsNodes.capacity() * sizeof(u32array3);
+
+	uint64_t neighCache = tree.m_neighOffsets.capacity() * sizeof(uint64_t);
+	neighCache += tree.m_neighIdx.capacity() * sizeof(uint32_t);
+	neighCache += tree.m_neighIsGhost.capacity() / CHAR_BIT;
+
+	footprint.clear();
+	footprint.push_back(make_pair(string("Octants		"), uint64_t(tree.m_octants.capacity() * sizeof(Octant))));
+	footprint.push_back(make_pair(string("Ghosts		"), uint64_t(tree.m_ghosts.capacity() * sizeof(Octant) + tree.m_globalIdxGhosts.capacity() * sizeof(uint64_t))));
+	footprint.push_back(make_pair(string("Morton numbers	"), uint64_t((tree.m_mortons.capacity() + tree.m_ghostsMortons.capacity()) * sizeof(uint64_t))));
+	footprint.push_back(make_pair(string("Intersections	"), uint64_t(tree.m_intersections.capacity() * sizeof(Intersection) + tree.m_intersectionsOffsets.capacity() * sizeof(uint64_t))));
+	footprint.push_back(make_pair(string("Intersection store"), uint64_t(m_intersectionStore.m_owners.capacity() * sizeof(uint32_t)
+			+ (m_intersectionStore.m_faces.capacity() + m_intersectionStore.m_flags.capacity()) * sizeof(uint8_t)
+			+ (m_intersectionStore.m_areas.capacity() + 3*m_intersectionStore.m_centers[0].capacity() + 3*m_intersectionStore.m_normals[0].capacity()) * sizeof(double))));
+	footprint.push_back(make_pair(string("Connectivity	"), connectivity));
+	footprint.push_back(make_pair(string("Ghosts connectivity"), ghostsConnectivity));
+	footprint.push_back(make_pair(string("Neighbour cache	"), neighCache));
+	footprint.push_back(make_pair(string("Geometry cache	"), uint64_t((m_cachedCenters[0].capacity() + m_cachedCenters[1].capacity() + m_cachedCenters[2].capacity()
+			+ m_cachedSizes.capacity() + m_cachedVolumes.capacity()) * sizeof(double))));
+	footprint.push_back(make_pair(string("Mapper		"), uint64_t(m_mapIdx.capacity() * sizeof(uint32_t))));
+};
+
 #if ENABLE_MPI==1
 /*! Compute the partition of the octree over the processes (only compute the information about
  * how distribute the mesh). This is an uniform distribution method.
@@ -3198,235 +3814,233 @@ ParaTree::computePartition(uint32_t* partition){
 
 /*! Compute the partition of the octree over the processes (only compute the information about
  * how distribute the mesh). This is an weighted distribution method: each process will have the same weight.
+ * The octants are cut along the Morton curve: an octant is assigned to the process
+ * p = floor(P * c / W), where c is the weight of the octants preceding the center of the octant
+ * and W the global weight. The offset of the local weights is given by an exclusive scan and
+ * each process computes the cuts falling in its range of weights, then the cuts are sent to
+ * the processes starting at them (see gatherPartition): no process holds the weights of the
+ * other processes.
  * \param[out] partition Pointer to partition information array. partition[i] = number of octants
  * to be stored on the i-th process (i-th rank).
  * \param[in] weight Pointer to weight array. weight[i] = weight of i-th local octant.
  */
 void
 ParaTree::computePartition(uint32_t* partition, dvector* weight){
-	if(m_serial){
 
-		double division_result = 0;
-		double global_weight = 0.0;
-		for (int i=0; i<weight->size(); i++){
-			global_weight += (*weight)[i];
-		}
-		division_result = global_weight/(double)m_nproc;
-
-		//Estimate resulting weight distribution starting from proc 0 (sending tail)
-		//Estimate sending weight by each proc in initial conf (sending tail)
-		uint32_t i = 0, tot = 0;
-		int iproc = 0;
-		while (iproc < m_nproc-1){
-			double partial_weight = 0.0;
-			partition[iproc] = 0;
-			while(partial_weight < division_result){
-				partial_weight += (*weight)[i];
-				tot++;
-				partition[iproc]++;
-				i++;
-			}
-			iproc++;
+	uint32_t nocts = weight->size();
+
+	//Local and global weight, range of the local weights along the curve
+	double localWeight = 0.0;
+	for (uint32_t i = 0; i < nocts; i++){
+		localWeight += (*weight)[i];
+	}
+	double globalWeight = localWeight;
+	double weightOffset = 0.0;
+	double weightEnd = localWeight;
+	if (!m_serial){
+		m_errorFlag = MPI_Exscan(&localWeight,&weightOffset,1,MPI_DOUBLE,MPI_SUM,m_comm);
+		if (m_rank == 0) weightOffset = 0.0;
+		m_errorFlag = MPI_Allreduce(&localWeight,&globalWeight,1,MPI_DOUBLE,MPI_SUM,m_comm);
+
+		//The range ends at the offset of the next process (the same value on both processes)
+		int prev = (m_rank > 0) ? m_rank - 1 : MPI_PROC_NULL;
+		int next = (m_rank < m_nproc - 1) ? m_rank + 1 : MPI_PROC_NULL;
+		m_errorFlag = MPI_Sendrecv(&weightOffset,1,MPI_DOUBLE,prev,m_rank,&weightEnd,1,MPI_DOUBLE,next,m_rank+1,m_comm,MPI_STATUS_IGNORE);
+	}
+	if (!(globalWeight > 0.0)){
+		computePartition(partition);
+		return;
+	}
+
+	//Cuts in the range of the local weights: the cut before the process p is the number
+	//of octants assigned to the processes preceding p
+	uint64_t firstGlobalIdx = 0;
+	if (!m_serial && m_rank != 0){
+		firstGlobalIdx = m_partitionRangeGlobalIdx[m_rank-1] + 1;
+	}
+	int firstCut = 1;
+	int lastCut = m_nproc - 1;
+	if (!m_serial){
+		if (m_rank > 0) firstCut = int(double(m_nproc)*weightOffset/globalWeight) + 1;
+		if (m_rank < m_nproc - 1) lastCut = min(int(double(m_nproc)*weightEnd/globalWeight), m_nproc - 1);
+	}
+
+	std::vector<std::pair<int, uint64_t> > cuts;
+	double partialWeight = weightOffset;
+	uint32_t i = 0;
+	for (int p = firstCut; p <= lastCut; p++){
+		while (i < nocts && int(double(m_nproc)*(partialWeight + 0.5*(*weight)[i])/globalWeight) < p){
+			partialWeight += (*weight)[i];
+			i++;
 		}
-		partition[m_nproc-1] = weight->size() - tot;
+		cuts.push_back(std::make_pair(p, firstGlobalIdx + i));
 	}
-	else{
 
-		int weightSize = weight->size();
-		double* gweight;
-		double* lweight = new double[weightSize];
+	gatherPartition(cuts, partition);
+};
+
+/*! Build the partition of the octree over the processes from its cuts, each cut being
+ * known by a single process (all the cuts of a serial octree are known by every process).
+ * Each cut is sent to the process starting at it, then each process gets the cut of
+ * the next process and the numbers of octants of the processes are gathered.
+ * \param[in] cuts Cuts known by the local process, in increasing order: rank p > 0 of
+ * a process and global index of its first octant.
+ * \param[out] partition Pointer to partition information array. partition[i] = number of octants
+ * to be stored on the i-th process (i-th rank).
+ */
+void
+ParaTree::gatherPartition(const std::vector<std::pair<int, uint64_t> > & cuts, uint32_t* partition){
 
-		for (int i=0; i<weight->size(); i++){
-			lweight[i] = (*weight)[i];
+	if (m_serial){
+		uint64_t first = 0;
+		for (size_t k = 0; k < cuts.size(); k++){
+			partition[cuts[k].first-1] = uint32_t(cuts[k].second - first);
+			first = cuts[k].second;
 		}
+		partition[m_nproc-1] = uint32_t(m_globalNumOctants - first);
+		return;
+	}
+
+	// The tags are larger than the ranks and than the tags of exchangeSparse
+	const int cutTag = m_nproc + 2;
+	const int nextTag = m_nproc + 3;
+
+	std::vector<MPI_Request> requests(cuts.size(), MPI_REQUEST_NULL);
+	for (size_t k = 0; k < cuts.size(); k++){
+		m_errorFlag = MPI_Isend(const_cast<uint64_t*>(&cuts[k].second),1,MPI_UINT64_T,cuts[k].first,cutTag,m_comm,&requests[k]);
+	}
+	uint64_t first = 0;
+	uint64_t next = m_globalNumOctants;
+	if (m_rank > 0){
+		m_errorFlag = MPI_Recv(&first,1,MPI_UINT64_T,MPI_ANY_SOURCE,cutTag,m_comm,MPI_STATUS_IGNORE);
+	}
+	m_errorFlag = MPI_Waitall(int(requests.size()),requests.data(),MPI_STATUSES_IGNORE);
+
+	int prev = (m_rank > 0) ? m_rank - 1 : MPI_PROC_NULL;
+	int succ = (m_rank < m_nproc - 1) ? m_rank + 1 : MPI_PROC_NULL;
+	m_errorFlag = MPI_Sendrecv(&first,1,MPI_UINT64_T,prev,nextTag,&next,1,MPI_UINT64_T,succ,nextTag,m_comm,MPI_STATUS_IGNORE);
+
+	uint32_t nofOctants = uint32_t(next - first);
+	m_errorFlag = MPI_Allgather(&nofOctants,1,MPI_UINT32_T,partition,1,MPI_UINT32_T,m_comm);
+};
 
-		int *oldpartition = new int[m_nproc];
-		int *displays = new int[m_nproc];
-		MPI_Allgather(&weightSize,1,MPI_INT,oldpartition,1,MPI_INT,m_comm);
-		int globalNofOctant = 0;
-		for(int i = 0; i < m_nproc; ++i){
-			displays[i] = globalNofOctant;
-			globalNofOctant += oldpartition[i];
+/*! Compute the imbalance of the load of the processes, i.e. the ratio between the maximum
+ * and the mean load minus one.
+ * \param[in] weight Pointer to a vector of weights of the local octants (weight=NULL is uniform distribution).
+ * \return Imbalance of the load of the processes (0 = perfectly balanced).
+ */
+double
+ParaTree::computeLoadImbalance(dvector* weight){
+
+	double localLoad = 0.0;
+	if (weight == NULL){
+		localLoad = double(getNumOctants());
+	}
+	else{
+		for (uint32_t i = 0; i < weight->size(); i++){
+			localLoad += (*weight)[i];
 		}
-		gweight = new double[globalNofOctant];
-		MPI_Allgatherv(lweight,weightSize,MPI_DOUBLE,gweight,oldpartition,displays,MPI_DOUBLE,m_comm);
+	}
+	double maxLoad = localLoad, globalLoad = localLoad;
+	m_errorFlag = MPI_Allreduce(&localLoad,&maxLoad,1,MPI_DOUBLE,MPI_MAX,m_comm);
+	m_errorFlag = MPI_Allreduce(&localLoad,&globalLoad,1,MPI_DOUBLE,MPI_SUM,m_comm);
+	if (!(globalLoad > 0.0)){
+		return 0.0;
+	}
+	return maxLoad/(globalLoad/double(m_nproc)) - 1.0;
+};
+
+/*! Check if a load balance can be skipped because the imbalance of the load of the
+ * processes is under the tolerance (see setLoadBalanceTolerance). A serial octree
+ * is never considered balanced.
+ * \param[in] weight Pointer to a vector of weights of the local octants (weight=NULL is uniform distribution).
+ * \return True if the migration of the octants can be skipped.
+ */
+bool
+ParaTree::isLoadBalanced(dvector* weight){
+
+	if (m_serial || !(m_loadBalanceTolerance > 0.0)){
+		return false;
+	}
+	double imbalance = computeLoadImbalance(weight);
+	if (imbalance > m_loadBalanceTolerance){
+		return false;
+	}
+	m_log.writeLog(" ");
+	m_log.writeLog(" Load imbalance " + to_string(static_cast<long double>(imbalance)) + " under tolerance : no migration");
+	m_log.writeLog(" ");
+	m_log.writeLog("---------------------------------------------");
+	return true;
+};
+
+/*! Check if a cut between two processes can be placed before a local octant without
+ * splitting a family of octants (see setPartitionFamilyDepth): the octant has to be the
+ * first descendant of its ancestor m_partitionFamilyDepth levels above it.
+ * The check uses the Morton index of the octant only.
+ * \param[in] idx Local index of the octant.
+ * \return True if the octant can be the first octant of a process.
+ */
+bool
+ParaTree::isFamilyCut(uint32_t idx){
+
+	//Morton indices interleave three coordinates also in 2D (z = 0)
+	int ancestorLevel = max(int(m_octree.m_octants[idx].getLevel()) - int(m_partitionFamilyDepth), 0);
+	uint64_t familyMask = (uint64_t(1) << (3*(m_global.m_maxLevel - ancestorLevel))) - 1;
+	return ((m_octree.m_mortons[idx] & familyMask) == 0);
+};
+
+/*! Move the cuts of a partition of the octree over the processes so that the families
+ * of octants are not split between the processes (see setPartitionFamilyDepth).
+ * Each cut is moved by the process that owns the octant where the cut falls to the
+ * nearest octant that starts a family; a cut is left unchanged if no local octant starts
+ * a family. The moved cuts are sent only to the processes starting at them (see gatherPartition).
+ * \param[in,out] partition Pointer to partition information array. partition[i] = number of octants
+ * to be stored on the i-th process (i-th rank).
+ */
+void
+ParaTree::snapPartitionToFamilies(uint32_t* partition){
+
+	if (m_partitionFamilyDepth == 0 || m_nproc == 1){
+		return;
+	}
+
+	uint32_t nocts = m_octree.getNumOctants();
+	uint64_t firstGlobalIdx = 0;
+	if (!m_serial && m_rank != 0){
+		firstGlobalIdx = m_partitionRangeGlobalIdx[m_rank-1] + 1;
+	}
 
-		double division_result = 0;
-		double global_weight = 0.0;
-		for (int i=0; i<globalNofOctant; i++){
-			global_weight += gweight[i];
+	//Cuts falling on local octants (the cut at the end of the octree belongs to the last process)
+	std::vector<std::pair<int, uint64_t> > cuts;
+	uint64_t cut = 0;
+	for (int p = 1; p < m_nproc; p++){
+		cut += partition[p-1];
+		if (cut == m_globalNumOctants && (m_serial || m_rank == m_nproc - 1)){
+			cuts.push_back(std::make_pair(p, cut));
+			continue;
 		}
-		division_result = global_weight/(double)m_nproc;
-
-		//Estimate resulting weight distribution starting from proc 0 (sending tail)
-		//Estimate sending weight by each proc in initial conf (sending tail)
-		uint32_t i = 0, tot = 0;
-		int iproc = 0;
-		while (iproc < m_nproc-1){
-			double partial_weight = 0.0;
-			partition[iproc] = 0;
-			while(partial_weight < division_result && i < globalNofOctant){
-				partial_weight += gweight[i];
-				tot++;
-				partition[iproc]++;
-				i++;
-			}
-			global_weight = 0;
-			for(int j = i; j < globalNofOctant; ++j)
-				global_weight += gweight[j];
-			division_result = global_weight/double(m_nproc-(iproc+1));
-			iproc++;
+		if (cut < firstGlobalIdx || cut >= firstGlobalIdx + nocts){
+			continue;
 		}
-		partition[m_nproc-1] = globalNofOctant - tot;
-
-		delete [] oldpartition;
-		delete [] displays;
-		delete [] lweight;
-		delete [] gweight;
-
-//TODO CHECK OLD ALGORITHM
-//		double division_result = 0;
-//		double remind = 0;
-//		dvector local_weight(m_nproc,0.0);
-//		dvector temp_local_weight(m_nproc,0.0);
-//		dvector2D sending_weight(m_nproc, dvector(m_nproc,0.0));
-//		double* rbuff = new double[m_nproc];
-//		double global_weight = 0.0;
-//		for (int i=0; i<weight->size(); i++){
-//			local_weight[m_rank] += (*weight)[i];
-//		}
-//		m_errorFlag = MPI_Allgather(&local_weight[m_rank],1,MPI_DOUBLE,rbuff,1,MPI_DOUBLE,m_comm);
-//		for (int i=0; i<m_nproc; i++){
-//			local_weight[i] = rbuff[i];
-//			global_weight += rbuff[i];
-//		}
-//		delete [] rbuff; rbuff = NULL;
-//		division_result = global_weight/(double)m_nproc;
-//
-//		//Estimate resulting weight distribution starting from proc 0 (sending tail)
-//
-//		temp_local_weight = local_weight;
-//		//Estimate sending weight by each proc in initial conf (sending tail)
-//
-//		for (int iter = 0; iter < 1; iter++){
-//
-//			vector<double> delta(m_nproc);
-//			for (int i=0; i<m_nproc; i++){
-//				delta[i] = temp_local_weight[i] - division_result;
-//			}
-//
-//			for (int i=0; i<m_nproc-1; i++){
-//
-//				double post_weight = 0.0;
-//				for (int j=i+1; j<m_nproc; j++){
-//					post_weight += temp_local_weight[j];
-//				}
-//				if (temp_local_weight[i] > division_result){
-//
-//					delta[i] = temp_local_weight[i] - division_result;
-//					if (post_weight < division_result*(m_nproc-i-1)){
-//
-//						double post_delta =  division_result*(m_nproc-i-1) - post_weight;
-//						double delta_sending = min(local_weight[i], min(delta[i], post_delta));
-//						int jproc = i+1;
-//						double sending = 0;
-//						while (delta_sending > 0 && jproc<m_nproc){
-//							sending = min(division_result, delta_sending);
-//							sending = min(sending, (division_result-temp_local_weight[jproc]));
-//							sending = max(sending, 0.0);
-//							sending_weight[i][jproc] += sending;
-//							temp_local_weight[jproc] += sending;
-//							temp_local_weight[i] -= sending;
-//							delta_sending -= sending;
-//							delta[i] -= delta_sending;
-//							jproc++;
-//						}
-//					} //post
-//				}//weight>
-//			}//iproc
-//
-//			for (int i = m_nproc-1; i>0; i--){
-//
-//				double pre_weight = 0.0;
-//				for (int j=i-1; j>=0; j--){
-//					pre_weight += temp_local_weight[j];
-//				}
-//				if (temp_local_weight[i] > division_result){
-//
-//					delta[i] = temp_local_weight[i] - division_result;
-//					if (pre_weight < division_result*(i)){
-//
-//						double pre_delta =  division_result*(i) - pre_weight;
-//						double delta_sending = min(local_weight[i], min(temp_local_weight[i], min(delta[i], pre_delta)));
-//						int jproc = i-1;
-//						double sending = 0;
-//						while (delta_sending > 0 && jproc >=0){
-//							sending = min(division_result, delta_sending);
-//							sending = min(sending, (division_result-temp_local_weight[jproc]));
-//							sending = max(sending, 0.0);
-//							sending_weight[i][jproc] += sending;
-//							temp_local_weight[jproc] += sending;
-//							temp_local_weight[i] -= sending;
-//							delta_sending -= sending;
-//							delta[i] -= delta_sending;
-//							jproc--;
-//						}
-//					}//pre
-//				}//weight>
-//			}//iproc
-//		}//iter
-//
-//		//Update partition locally
-//		//to send
-//		u32vector sending_cell(m_nproc,0);
-//		int i = getNumOctants();;
-//		for (int jproc=m_nproc-1; jproc>m_rank; jproc--){
-//			double pack_weight = 0.0;
-//			while(pack_weight < sending_weight[m_rank][jproc] && i > 0){
-//				i--;
-//				pack_weight += (*weight)[i];
-//				sending_cell[jproc]++;
-//			}
-//		}
-//		partition[m_rank] = i;
-//		i = 0;
-//		for (int jproc=0; jproc<m_rank; jproc++){
-//			double pack_weight = 0.0;
-//			while(pack_weight < sending_weight[m_rank][jproc] && i <  getNumOctants()-1){
-//				i++;
-//				pack_weight += (*weight)[i];
-//				sending_cell[jproc]++;
-//			}
-//		}
-//		partition[m_rank] -= i;
-//
-//		//to receive
-//		u32vector rec_cell(m_nproc,0);
-//		MPI_Request* req = new MPI_Request[m_nproc*10];
-//		MPI_Status* stats = new MPI_Status[m_nproc*10];
-//		int nReq = 0;
-//		for (int iproc=0; iproc<m_nproc; iproc++){
-//			m_errorFlag = MPI_Irecv(&rec_cell[iproc],1,MPI_UINT32_T,iproc,m_rank,m_comm,&req[nReq]);
-//			++nReq;
-//		}
-//		for (int iproc=0; iproc<m_nproc; iproc++){
-//			m_errorFlag =  MPI_Isend(&sending_cell[iproc],1,MPI_UINT32_T,iproc,iproc,m_comm,&req[nReq]);
-//			++nReq;
-//		}
-//		MPI_Waitall(nReq,req,stats);
-//
-//		delete [] req; req = NULL;
-//		delete [] stats; stats = NULL;
-//
-//		i = 0;
-//		for (int jproc=0; jproc<m_nproc; jproc++){
-//			i+= rec_cell[jproc];
-//		}
-//		partition[m_rank] += i;
-//		uint32_t part = partition[m_rank];
-//		m_errorFlag = MPI_Allgather(&part,1,MPI_UINT32_T,partition,1,MPI_UINT32_T,m_comm);
-
+		uint32_t idx = uint32_t(cut - firstGlobalIdx);
+		uint32_t forw = idx, backw = idx;
+		while (forw < nocts && !isFamilyCut(forw)){
+			forw++;
+		}
+		while (backw > 0 && !isFamilyCut(backw)){
+			backw--;
+		}
+		bool foundBackw = isFamilyCut(backw);
+		if (forw < nocts && (!foundBackw || forw - idx < idx - backw)){
+			idx = forw;
+		}
+		else if (foundBackw){
+			idx = backw;
+		}
+		cuts.push_back(std::make_pair(p, firstGlobalIdx + idx));
 	}
+
+	gatherPartition(cuts, partition);
 };
 
 /*! Compute the partition of the octree over the processes (only compute the information about
@@ -3554,6 +4168,7 @@ ParaTree::computePartition(uint32_t* partition, uint8_t & level_, dvector* weigh
 }
 
 /*! Update the distributed octree after a LoadBalance over the processes.
+ * The Morton indices of the local octants are already updated by the migration.
  */
 void
 ParaTree::updateLoadBalance() {
@@ -3579,6 +4194,129 @@ ParaTree::updateLoadBalance() {
 	delete [] rbuff; rbuff = NULL;
 }
 
+/*! Build the buffers and the persistent requests to communicate user data of fixed size
+ * with the neighbour processes. They are reused by every communication of data of the
+ * same size until the ghosts change.
+ * \param[in] fixedDataSize Size in bytes of the data of each octant.
+ */
+void
+ParaTree::initGhostsRequests(size_t fixedDataSize) {
+	freeGhostsRequests();
+
+	m_ghostsRequests.reserve(m_ghostsPerProc.size() + m_bordersPerProc.size());
+	map<int,uint32_t>::iterator gitend = m_ghostsPerProc.end();
+	for(map<int,uint32_t>::iterator git = m_ghostsPerProc.begin(); git != gitend; ++git){
+		CommBuffer & recvBuffer = m_ghostsRecvBuffers[git->first];
+		recvBuffer = CommBuffer(fixedDataSize*git->second,'a',m_comm);
+		MPI_Request request;
+		m_errorFlag = MPI_Recv_init(recvBuffer.m_commBuffer,recvBuffer.m_commBufferSize,MPI_PACKED,git->first,m_rank,m_comm,&request);
+		m_ghostsRequests.push_back(request);
+	}
+	map<int,u32vector>::iterator bitend = m_bordersPerProc.end();
+	for(map<int,u32vector>::iterator bit = m_bordersPerProc.begin(); bit != bitend; ++bit){
+		CommBuffer & sendBuffer = m_ghostsSendBuffers[bit->first];
+		sendBuffer = CommBuffer(fixedDataSize*bit->second.size(),'a',m_comm);
+		MPI_Request request;
+		m_errorFlag = MPI_Send_init(sendBuffer.m_commBuffer,sendBuffer.m_commBufferSize,MPI_PACKED,bit->first,bit->first,m_comm,&request);
+		m_ghostsRequests.push_back(request);
+	}
+	m_ghostsRequestsDataSize = fixedDataSize;
+}
+
+/*! Free the persistent requests and the buffers of the communications of fixed size data.
+ */
+void
+ParaTree::freeGhostsRequests() {
+	int finalized = 0;
+	MPI_Finalized(&finalized);
+	if(!finalized){
+		for(size_t i = 0; i < m_ghostsRequests.size(); ++i){
+			MPI_Request_free(&m_ghostsRequests[i]);
+		}
+	}
+	m_ghostsRequests.clear();
+	m_ghostsSendBuffers.clear();
+	m_ghostsRecvBuffers.clear();
+	m_ghostsRequestsDataSize = 0;
+}
+
+/*! Build the communicator of the processes sharing the memory with the local one
+ * (i.e. running on the same node) and the rank of each process in it.
+ * Shared memory windows require MPI 3: with an older MPI no process shares the
+ * memory with the local one and the ghosts are always sent.
+ */
+void
+ParaTree::initSharedComm() {
+	m_sharedWin = MPI_WIN_NULL;
+#if MPI_VERSION < 3
+	m_sharedComm = MPI_COMM_NULL;
+	m_sharedRanks.assign(m_nproc,MPI_UNDEFINED);
+#else
+	m_errorFlag = MPI_Comm_split_type(m_comm,MPI_COMM_TYPE_SHARED,m_rank,MPI_INFO_NULL,&m_sharedComm);
+
+	MPI_Group group, sharedGroup;
+	m_errorFlag = MPI_Comm_group(m_comm,&group);
+	m_errorFlag = MPI_Comm_group(m_sharedComm,&sharedGroup);
+	vector<int> ranks(m_nproc);
+	for(int p = 0; p < m_nproc; ++p){
+		ranks[p] = p;
+	}
+	m_sharedRanks.resize(m_nproc);
+	m_errorFlag = MPI_Group_translate_ranks(group,m_nproc,ranks.data(),sharedGroup,m_sharedRanks.data());
+	MPI_Group_free(&group);
+	MPI_Group_free(&sharedGroup);
+#endif
+}
+
+/*! Free the shared memory window and the communicator of the processes of the node.
+ */
+void
+ParaTree::freeSharedComm() {
+	int finalized = 0;
+	MPI_Finalized(&finalized);
+	if(!finalized){
+		freeSharedBuffer();
+		if(m_sharedComm != MPI_COMM_NULL){
+			MPI_Comm_free(&m_sharedComm);
+		}
+	}
+	m_sharedRanks.clear();
+}
+
+/*! Find the processes exchanging octants with the local process during a load balance.
+ * Both the old and the new partitions are known by every process, so that the
+ * senders and the receivers are found without any communication: a process sends
+ * octants to another one if its old range of global indices overlaps the new range
+ * of the other process.
+ * \param[in] newPartitionRangeGlobalidx Global index of the last octant of each process in the new partition.
+ * \param[out] senders Processes sending octants to the local process.
+ * \param[out] receivers Processes receiving octants from the local process.
+ */
+void
+ParaTree::findMigrationNeighbours(const uint64_t* newPartitionRangeGlobalidx, set<int> & senders, set<int> & receivers) {
+	senders.clear();
+	receivers.clear();
+
+	//ranges are [begin,end) (unsigned wrap-around handles empty partitions)
+	uint64_t oldBegin = (m_rank == 0) ? 0 : m_partitionRangeGlobalIdx[m_rank-1] + 1;
+	uint64_t oldEnd = m_partitionRangeGlobalIdx[m_rank] + 1;
+	uint64_t newBegin = (m_rank == 0) ? 0 : newPartitionRangeGlobalidx[m_rank-1] + 1;
+	uint64_t newEnd = newPartitionRangeGlobalidx[m_rank] + 1;
+	for(int p = 0; p < m_nproc; ++p){
+		if(p == m_rank) continue;
+		uint64_t pOldBegin = (p == 0) ? 0 : m_partitionRangeGlobalIdx[p-1] + 1;
+		uint64_t pOldEnd = m_partitionRangeGlobalIdx[p] + 1;
+		uint64_t pNewBegin = (p == 0) ? 0 : newPartitionRangeGlobalidx[p-1] + 1;
+		uint64_t pNewEnd = newPartitionRangeGlobalidx[p] + 1;
+		if(max(pOldBegin, newBegin) < min(pOldEnd, newEnd)){
+			senders.insert(p);
+		}
+		if(max(oldBegin, pNewBegin) < min(oldEnd, pNewEnd)){
+			receivers.insert(p);
+		}
+	}
+}
+
 /*! Build the structure with the information about ghost octants, partition boundary octants
  *  and parameters for communicate between porcesses.
  */
@@ -3591,6 +4329,7 @@ ParaTree::setPboundGhosts() {
 	//this map contains the local octants as ghosts for neighbor processes
 
 	// NO PBORDERS !
+	freeGhostsRequests();
 	LocalTree::octvector::iterator end = m_octree.m_octants.end();
 	LocalTree::octvector::iterator begin = m_octree.m_octants.begin();
 	m_bordersPerProc.clear();
@@ -3601,11 +4340,12 @@ ParaTree::setPboundGhosts() {
 	int countint = 0;
 	for(LocalTree::octvector::iterator it = begin; it != end; ++it){
 		set<int> procs;
+		pbd = false;
 		//Virtual Face Neighbors
 		for(uint8_t i = 0; i < m_global.m_nfaces; ++i){
 			if(it->getBound(i) == false){
 				uint32_t virtualNeighborsSize = 0;
-				vector<uint64_t> virtualNeighbors = it->computeVirtualMorton(i,m_maxDepth,virtualNeighborsSize);
+				vector<uint64_t> virtualNeighbors = it->computeVirtualMorton(m_dim, i,m_maxDepth,virtualNeighborsSize);
 				uint32_t maxDelta = virtualNeighborsSize/2;
 				for(uint32_t j = 0; j <= maxDelta; ++j){
 					int pBegin = findOwner(virtualNeighbors[j]);
@@ -3645,7 +4385,7 @@ ParaTree::setPboundGhosts() {
 		for(uint8_t c = 0; c < m_global.m_nnodes; ++c){
 			if(!it->getBound(m_global.m_nodeFace[c][0]) && !it->getBound(m_global.m_nodeFace[c][1])){
 				uint32_t virtualCornerNeighborSize = 0;
-				uint64_t virtualCornerNeighbor = it ->computeNodeVirtualMorton(c,m_maxDepth,virtualCornerNeighborSize, m_global.m_nodeFace);
+				uint64_t virtualCornerNeighbor = it ->computeNodeVirtualMorton(m_dim, c,m_maxDepth,virtualCornerNeighborSize, m_global.m_nodeFace);
 				if(virtualCornerNeighborSize){
 					int proc = findOwner(virtualCornerNeighbor);
 					procs.insert(proc);
@@ -3694,7 +4434,7 @@ ParaTree::setPboundGhosts() {
 	uint32_t x,y,z;
 	uint8_t l;
 	int8_t m;
-	bool info[17];
+	uint32_t info;
 	map<int,CommBuffer> sendBuffers;
 	map<int,vector<uint32_t> >::iterator bitend = m_bordersPerProc.end();
 	uint32_t pbordersOversize = 0;
@@ -3716,16 +4456,13 @@ ParaTree::setPboundGhosts() {
 			l = octant.getLevel();
 			m = octant.getMarker();
 			global_index = getGlobalIdx(value[i]);
-			for(int i = 0; i < 17; ++i)
-				info[i] = octant.m_info[i];
+			info = octant.m_info;
 			m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[key].m_commBuffer,buffSize,&pos,m_comm);
 			m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[key].m_commBuffer,buffSize,&pos,m_comm);
 			m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[key].m_commBuffer,buffSize,&pos,m_comm);
 			m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[key].m_commBuffer,buffSize,&pos,m_comm);
 			m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[key].m_commBuffer,buffSize,&pos,m_comm);
-			for(int j = 0; j < 17; ++j){
-				MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[key].m_commBuffer,buffSize,&pos,m_comm);
-			}
+			m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[key].m_commBuffer,buffSize,&pos,m_comm);
 			m_errorFlag = MPI_Pack(&global_index,1,MPI_UINT64_T,sendBuffers[key].m_commBuffer,buffSize,&pos,m_comm);
 		}
 	}
@@ -3785,12 +4522,15 @@ ParaTree::setPboundGhosts() {
 	//UNPACK BUFFERS AND BUILD GHOSTS CONTAINER OF CLASS_LOCAL_TREE
 	//every entry in recvBuffers is visited, each buffers from neighbor processes is unpacked octant by octant.
 	//every ghost octant is built and put in the ghost vector
+	//the number of ghosts per neighbour process is stored as communication plan for the ghosts
 	uint32_t ghostCounter = 0;
+	m_ghostsPerProc.clear();
 	map<int,CommBuffer>::iterator rritend = recvBuffers.end();
 	for(map<int,CommBuffer>::iterator rrit = recvBuffers.begin(); rrit != rritend; ++rrit){
 		int pos = 0;
 		//			int nofGhostsPerProc = int(rrit->second.m_commBufferSize / (uint32_t) (m_global.m_octantBytes + m_global.m_globalIndexBytes));
 		int nofGhostsPerProc = int(rrit->second.m_commBufferSize / (uint32_t) (m_global.m_octantBytes + m_global.m_globalIndexBytes));
+		m_ghostsPerProc[rrit->first] = nofGhostsPerProc;
 		for(int i = 0; i < nofGhostsPerProc; ++i){
 			m_errorFlag = MPI_Unpack(rrit->second.m_commBuffer,rrit->second.m_commBufferSize,&pos,&x,1,MPI_UINT32_T,m_comm);
 			m_errorFlag = MPI_Unpack(rrit->second.m_commBuffer,rrit->second.m_commBufferSize,&pos,&y,1,MPI_UINT32_T,m_comm);
@@ -3799,15 +4539,14 @@ ParaTree::setPboundGhosts() {
 			m_octree.m_ghosts[ghostCounter] = Octant(m_dim,l,x,y,z,m_global.m_maxLevel);
 			m_errorFlag = MPI_Unpack(rrit->second.m_commBuffer,rrit->second.m_commBufferSize,&pos,&m,1,MPI_INT8_T,m_comm);
 			m_octree.m_ghosts[ghostCounter].setMarker(m);
-			for(int j = 0; j < 17; ++j){
-				m_errorFlag = MPI_Unpack(rrit->second.m_commBuffer,rrit->second.m_commBufferSize,&pos,&info[j],1,MPI::BOOL,m_comm);
-				m_octree.m_ghosts[ghostCounter].m_info[j] = info[j];
-			}
+			m_errorFlag = MPI_Unpack(rrit->second.m_commBuffer,rrit->second.m_commBufferSize,&pos,&info,1,MPI_UINT32_T,m_comm);
+			m_octree.m_ghosts[ghostCounter].m_info = info;
 			m_errorFlag = MPI_Unpack(rrit->second.m_commBuffer,rrit->second.m_commBufferSize,&pos,&global_index,1,MPI_UINT64_T,m_comm);
 			m_octree.m_globalIdxGhosts[ghostCounter] = global_index;
 			++ghostCounter;
 		}
 	}
+	m_octree.updateGhostsMortons();
 	recvBuffers.clear();
 	sendBuffers.clear();
 	recvBufferSizePerProc.clear();
@@ -3843,7 +4582,7 @@ ParaTree::commMarker() {
 			//the use of auxiliary variable can be avoided passing to MPI_Pack the members of octant but octant in that case cannot be const
 			const Octant & octant = m_octree.m_octants[value[i]];
 			marker = octant.getMarker();
-			mod	= octant.m_info[15];
+			mod	= octant.getInfo(15);
 			m_errorFlag = MPI_Pack(&marker,1,MPI_INT8_T,sendBuffers[key].m_commBuffer,buffSize,&pos,m_comm);
 			m_errorFlag = MPI_Pack(&mod,1,MPI::BOOL,sendBuffers[key].m_commBuffer,buffSize,&pos,m_comm);
 		}
@@ -3903,7 +4642,7 @@ ParaTree::commMarker() {
 			m_errorFlag = MPI_Unpack(rrit->second.m_commBuffer,rrit->second.m_commBufferSize,&pos,&marker,1,MPI_INT8_T,m_comm);
 			m_octree.m_ghosts[ghostCounter].setMarker(marker);
 			m_errorFlag = MPI_Unpack(rrit->second.m_commBuffer,rrit->second.m_commBufferSize,&pos,&mod,1,MPI::BOOL,m_comm);
-			m_octree.m_ghosts[ghostCounter].m_info[15] = mod;
+			m_octree.m_ghosts[ghostCounter].setInfo(15, mod);
 			++ghostCounter;
 		}
 	}
@@ -3914,6 +4653,97 @@ ParaTree::commMarker() {
 	delete [] stats; stats = NULL;
 
 }
+
+/*! Communicate the markers of the border octants changed since the previous call
+ * and update the ghost octants. Only the (position, marker, modified flag) of the
+ * changed border octants are sent to each neighbour process.
+ * \param[in,out] sentMarkers Marker and modified flag of the border octants sent to
+ * each process at the previous call (empty at the first call, i.e. all the markers are sent).
+ * \param[in] ghostOffsets Index of the first ghost octant owned by each neighbour process.
+ * \param[in,out] changedGhosts Indices of the ghost octants whose marker or modified flag
+ * is changed are appended to this vector.
+ * \return True if some ghost octant is changed.
+ */
+bool
+ParaTree::commChangedMarkers(map<int, vector<pair<int8_t, bool> > > & sentMarkers, const map<int, uint32_t> & ghostOffsets, u32vector & changedGhosts) {
+
+	int8_t marker;
+	bool mod;
+	uint32_t position;
+	uint32_t entryBytes = sizeof(uint32_t) + m_global.m_markerBytes + m_global.m_boolBytes;
+
+	//PACK POSITION, MARKER AND MODIFIED FLAG OF THE CHANGED BORDER OCTANTS
+	map<int,CommBuffer> sendBuffers;
+	map<int,u32vector>::iterator bitend = m_bordersPerProc.end();
+	for(map<int,u32vector>::iterator bit = m_bordersPerProc.begin(); bit != bitend; ++bit){
+		int key = bit->first;
+		const u32vector & value = bit->second;
+		vector<pair<int8_t, bool> > & sent = sentMarkers[key];
+		bool sendAll = (sent.size() != value.size());
+		sent.resize(value.size());
+		u32vector changed;
+		for(uint32_t i = 0; i < value.size(); ++i){
+			const Octant & octant = m_octree.m_octants[value[i]];
+			pair<int8_t, bool> state(octant.getMarker(), octant.getInfo(15));
+			if (sendAll || state != sent[i]){
+				sent[i] = state;
+				changed.push_back(i);
+			}
+		}
+		sendBuffers[key] = CommBuffer(changed.size()*entryBytes,'a',m_comm);
+		for(uint32_t i = 0; i < changed.size(); ++i){
+			position = changed[i];
+			marker = sent[position].first;
+			mod = sent[position].second;
+			sendBuffers[key].write(position);
+			sendBuffers[key].write(marker);
+			sendBuffers[key].write(mod);
+		}
+	}
+
+	//COMMUNICATE THE BUFFERS TO THE NEIGHBOUR PROCESSES
+	//the size of each message is found by probing, so that a single message per neighbour is sent
+	MPI_Request* req = new MPI_Request[sendBuffers.size()];
+	MPI_Status* stats = new MPI_Status[sendBuffers.size()];
+	int nReq = 0;
+	map<int,CommBuffer>::iterator sitend = sendBuffers.end();
+	for(map<int,CommBuffer>::iterator sit = sendBuffers.begin(); sit != sitend; ++sit){
+		m_errorFlag = MPI_Isend(sit->second.m_commBuffer,sit->second.m_commBufferSize,MPI_PACKED,sit->first,sit->first,m_comm,&req[nReq]);
+		++nReq;
+	}
+
+	//UNPACK THE BUFFERS AND UPDATE THE GHOST OCTANTS
+	bool changed = false;
+	for(map<int,CommBuffer>::iterator sit = sendBuffers.begin(); sit != sitend; ++sit){
+		MPI_Status status;
+		int recvSize;
+		m_errorFlag = MPI_Probe(sit->first,m_rank,m_comm,&status);
+		m_errorFlag = MPI_Get_count(&status,MPI_PACKED,&recvSize);
+		CommBuffer recvBuffer(recvSize,'a',m_comm);
+		m_errorFlag = MPI_Recv(recvBuffer.m_commBuffer,recvSize,MPI_PACKED,sit->first,m_rank,m_comm,&status);
+
+		int nofChanged = int(recvSize / entryBytes);
+		uint32_t ghostOffset = (nofChanged > 0) ? ghostOffsets.at(sit->first) : 0;
+		for(int i = 0; i < nofChanged; ++i){
+			recvBuffer.read(position);
+			recvBuffer.read(marker);
+			recvBuffer.read(mod);
+			Octant & ghost = m_octree.m_ghosts[ghostOffset + position];
+			if (ghost.getMarker() != marker || ghost.getInfo(15) != mod){
+				ghost.setMarker(marker);
+				ghost.setInfo(15, mod);
+				changedGhosts.push_back(ghostOffset + position);
+				changed = true;
+			}
+		}
+	}
+	MPI_Waitall(nReq,req,stats);
+
+	delete [] req; req = NULL;
+	delete [] stats; stats = NULL;
+
+	return changed;
+}
 #endif
 
 /*! Update the distributed octree over the processes after a coarsening procedure.
@@ -3966,15 +4796,36 @@ ParaTree::updateAfterCoarse(u32vector & mapidx){
 }
 
 /*!Balance 2:1 the octree.
+ * The balance is propagated as a ripple: after a first sweep over the local octants,
+ * each iteration exchanges only the markers of the border octants changed since the
+ * previous exchange and balances only the local octants adjacent to the changed
+ * ghosts. The global convergence check of each iteration is a non-blocking reduction
+ * overlapped with the following iteration.
+ * The number of iterations and the time spent in each iteration are available
+ * through getBalanceIterations and getBalanceTimes.
  * \param[in] first Is the first call of the 2:1 balance method?
  */
 void
 ParaTree::balance21(bool const first){
 #if ENABLE_MPI==1
-	bool globalDone = true, localDone = false;
+	bool globalDone = true, localDone = false, sendDone = false;
 	int  iteration  = 0;
+	map<int, vector<pair<int8_t, bool> > > sentMarkers;
+	map<int, uint32_t> ghostOffsets;
+	u32vector changedGhosts;
+	MPI_Request doneRequest;
+
+	m_balanceTimes.clear();
+	double startTime = MPI_Wtime();
+
+	// Index of the first ghost owned by each process (ghosts are ordered by owner)
+	uint32_t ghostOffset = 0;
+	for (map<int, uint32_t>::iterator it = m_ghostsPerProc.begin(); it != m_ghostsPerProc.end(); ++it){
+		ghostOffsets[it->first] = ghostOffset;
+		ghostOffset += it->second;
+	}
 
-	commMarker();
+	bool received = commChangedMarkers(sentMarkers, ghostOffsets, changedGhosts);
 	m_octree.preBalance21(true);
 
 	if (first){
@@ -3984,68 +4835,68 @@ ParaTree::balance21(bool const first){
 		m_log.writeLog(" Iterative procedure	");
 		m_log.writeLog(" ");
 		m_log.writeLog(" Iteration	:	" + to_string(static_cast<unsigned long long>(iteration)));
+	}
 
-		commMarker();
-
+	// First sweep on all the local octants, the changed ghosts are visited again by the ripple
+	received |= commChangedMarkers(sentMarkers, ghostOffsets, changedGhosts);
+	if (first){
 		localDone = m_octree.localBalance(true);
-		commMarker();
-		m_octree.preBalance21(false);
-		MPI_Barrier(m_comm);
-		m_errorFlag = MPI_Allreduce(&localDone,&globalDone,1,MPI::BOOL,MPI_LOR,m_comm);
+	}
+	else{
+		localDone = m_octree.localBalanceAll(true);
+	}
+	localDone |= m_octree.preBalance21(false);
+	localDone |= received;
+	m_balanceTimes.push_back(MPI_Wtime() - startTime);
+
+	// Ripple: the iteration is not converged while some process modifies a marker
+	// or receives a modified ghost marker
+	while(true){
+		startTime = MPI_Wtime();
+		// The send buffer of the reduction is not modified until the reduction is completed
+		sendDone = localDone;
+#if MPI_VERSION >= 3
+		m_errorFlag = MPI_Iallreduce(&sendDone,&globalDone,1,MPI::BOOL,MPI_LOR,m_comm,&doneRequest);
+#else
+		m_errorFlag = MPI_Allreduce(&sendDone,&globalDone,1,MPI::BOOL,MPI_LOR,m_comm);
+		doneRequest = MPI_REQUEST_NULL;
+#endif
 
-		while(globalDone){
-			iteration++;
+		// Next sweep, overlapped with the reduction. If the previous iteration is
+		// globally converged no marker is changed, so this sweep has nothing to do.
+		localDone = commChangedMarkers(sentMarkers, ghostOffsets, changedGhosts);
+		sort(changedGhosts.begin(), changedGhosts.end());
+		changedGhosts.erase(unique(changedGhosts.begin(), changedGhosts.end()), changedGhosts.end());
+		localDone |= m_octree.localBalanceGhosts(changedGhosts);
+		localDone |= m_octree.preBalance21(false);
+		changedGhosts.clear();
+
+		MPI_Wait(&doneRequest, MPI_STATUS_IGNORE);
+		if (!globalDone){
+			break;
+		}
+
+		iteration++;
+		m_balanceTimes.push_back(MPI_Wtime() - startTime);
+		if (first){
 			m_log.writeLog(" Iteration	:	" + to_string(static_cast<unsigned long long>(iteration)));
-			commMarker();
-			localDone = m_octree.localBalance(false);
-			commMarker();
-			m_octree.preBalance21(false);
-			m_errorFlag = MPI_Allreduce(&localDone,&globalDone,1,MPI::BOOL,MPI_LOR,m_comm);
 		}
+	}
+	m_balanceIterations = iteration + 1;
 
-		commMarker();
+	if (first){
 		m_log.writeLog(" Iteration	:	Finalizing ");
 		m_log.writeLog(" ");
-		//localDone = m_octree.localBalance(false);
-		//commMarker();
-		//m_octree.preBalance21(true);
-		//commMarker();
-
 		m_log.writeLog(" 2:1 Balancing reached ");
 		m_log.writeLog(" ");
 		m_log.writeLog("---------------------------------------------");
-
-	}
-	else{
-
-		commMarker();
-		MPI_Barrier(m_comm);
-		localDone = m_octree.localBalanceAll(true);
-		commMarker();
-		m_octree.preBalance21(false);
-		MPI_Barrier(m_comm);
-		m_errorFlag = MPI_Allreduce(&localDone,&globalDone,1,MPI::BOOL,MPI_LOR,m_comm);
-
-		while(globalDone){
-			iteration++;
-			commMarker();
-			localDone = m_octree.localBalanceAll(false);
-			commMarker();
-			m_octree.preBalance21(false);
-			m_errorFlag = MPI_Allreduce(&localDone,&globalDone,1,MPI::BOOL,MPI_LOR,m_comm);
-		}
-
-		commMarker();
-		//			localDone = m_octree.localBalance(false);
-		//			commMarker();
-		//			m_octree.preBalance21(false);
-		//			commMarker();
-
 	}
 #else
 	bool localDone = false;
 	int  iteration  = 0;
+	chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
 
+	m_balanceTimes.clear();
 	m_octree.preBalance21(true);
 
 	if (first){
@@ -4058,12 +4909,15 @@ ParaTree::balance21(bool const first){
 
 		localDone = m_octree.localBalance(true);
 		m_octree.preBalance21(false);
+		m_balanceTimes.push_back(chrono::duration<double>(chrono::steady_clock::now() - startTime).count());
 
 		while(localDone){
+			startTime = chrono::steady_clock::now();
 			iteration++;
 			m_log.writeLog(" Iteration	:	" + to_string(static_cast<unsigned long long>(iteration)));
 			localDone = m_octree.localBalance(false);
 			m_octree.preBalance21(false);
+			m_balanceTimes.push_back(chrono::duration<double>(chrono::steady_clock::now() - startTime).count());
 		}
 
 		m_log.writeLog(" Iteration	:	Finalizing ");
@@ -4080,17 +4934,21 @@ ParaTree::balance21(bool const first){
 
 		localDone = m_octree.localBalanceAll(true);
 		m_octree.preBalance21(false);
+		m_balanceTimes.push_back(chrono::duration<double>(chrono::steady_clock::now() - startTime).count());
 
 		while(localDone){
+			startTime = chrono::steady_clock::now();
 			iteration++;
 			localDone = m_octree.localBalanceAll(false);
 			m_octree.preBalance21(false);
+			m_balanceTimes.push_back(chrono::duration<double>(chrono::steady_clock::now() - startTime).count());
 		}
 
 		//			localDone = m_octree.localBalance(false);
 		//			m_octree.preBalance21(false);
 
 	}
+	m_balanceIterations = iteration + 1;
 
 #endif /* NOMPI */
 }
@@ -4125,13 +4983,13 @@ ParaTree::write(string filename) {
 	}
 	int nofNodes = m_octree.m_nodes.size();
 	int nofGhostNodes = m_octree.m_ghostsNodes.size();
-	int nofOctants = m_octree.m_connectivity.size();
-	int nofGhosts = m_octree.m_ghostsConnectivity.size();
+	int nofOctants = m_octree.m_connectivity.size() / m_global.m_nnodes;
+	int nofGhosts = m_octree.m_ghostsConnectivity.size() / m_global.m_nnodes;
 	int nofAll = nofGhosts + nofOctants;
 	out << "<?xml version=\"1.0\"?>" << endl
 			<< "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"BigEndian\">" << endl
 			<< "  <UnstructuredGrid>" << endl
-			<< "    <Piece NumberOfCells=\"" << m_octree.m_connectivity.size() + m_octree.m_ghostsConnectivity.size() << "\" NumberOfPoints=\"" << m_octree.m_nodes.size() + m_octree.m_ghostsNodes.size() << "\">" << endl;
+			<< "    <Piece NumberOfCells=\"" << nofAll << "\" NumberOfPoints=\"" << m_octree.m_nodes.size() + m_octree.m_ghostsNodes.size() << "\">" << endl;
 	out << "      <Points>" << endl
 			<< "        <DataArray type=\"Float64\" Name=\"Coordinates\" NumberOfComponents=\""<< 3 <<"\" format=\"ascii\">" << endl
 			<< "          " << std::fixed;
@@ -4176,7 +5034,7 @@ ParaTree::write(string filename) {
 					jj = 2;
 				}
 			}
-			out << m_octree.m_connectivity[i][jj] << " ";
+			out << m_octree.m_connectivity[i*m_global.m_nnodes+jj] << " ";
 		}
 		if((i+1)%3==0 && i!=nofOctants-1)
 			out << endl << "          ";
@@ -4197,7 +5055,7 @@ ParaTree::write(string filename) {
 					jj = 2;
 				}
 			}
-			out << m_octree.m_ghostsConnectivity[i][jj] + nofNodes << " ";
+			out << m_octree.m_ghostsConnectivity[i*m_global.m_nnodes+jj] + nofNodes << " ";
 		}
 		if((i+1)%3==0 && i!=nofGhosts-1)
 			out << endl << "          ";
@@ -4289,16 +5147,16 @@ ParaTree::writeTest(string filename, vector<double> data) {
 		return;
 	}
 	int nofNodes = m_octree.m_nodes.size();
-	int nofOctants = m_octree.m_connectivity.size();
+	int nofOctants = m_octree.m_connectivity.size() / m_global.m_nnodes;
 	int nofAll = nofOctants;
 	out << "<?xml version=\"1.0\"?>" << endl
 			<< "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\" byte_order=\"BigEndian\">" << endl
 			<< "  <UnstructuredGrid>" << endl
-			<< "    <Piece NumberOfCells=\"" << m_octree.m_connectivity.size() << "\" NumberOfPoints=\"" << m_octree.m_nodes.size() << "\">" << endl;
+			<< "    <Piece NumberOfCells=\"" << nofOctants << "\" NumberOfPoints=\"" << m_octree.m_nodes.size() << "\">" << endl;
 	out << "      <CellData Scalars=\"Data\">" << endl;
 	out << "      <DataArray type=\"Float64\" Name=\"Data\" NumberOfComponents=\"1\" format=\"ascii\">" << endl
 			<< "          " << std::fixed;
-	int ndata = m_octree.m_connectivity.size();
+	int ndata = nofOctants;
 	for(int i = 0; i < ndata; i++)
 	{
 		out << std::setprecision(6) << data[i] << " ";
@@ -4341,7 +5199,7 @@ ParaTree::writeTest(string filename, vector<double> data) {
 					jj = 2;
 				}
 			}
-			out << m_octree.m_connectivity[i][jj] << " ";
+			out << m_octree.m_connectivity[i*m_global.m_nnodes+jj] << " ";
 		}
 		if((i+1)%3==0 && i!=nofOctants-1)
 			out << endl << "          ";
@@ -4409,8 +5267,351 @@ ParaTree::writeTest(string filename, vector<double> data) {
 
 }
 
-// =============================================================================== //
+// =================================================================================== //
+// RESTART METHODS												    			       //
+// =================================================================================== //
 
+#if ENABLE_MPI==1
+/*! Layout of the restart files written by dump: a header (magic string, version,
+ * dimension, max level, global number of octants, size of the octant records and of
+ * the user data per octant) followed by one fixed size record per octant, in Morton
+ * order (Morton index, info flags, level and marker), and by the user data of the
+ * octants, if any. The values are stored with the native byte order.
+ */
+static const char		sm_dumpMagic[8] = {'P','A','B','L','O','D','M','P'};
+static const uint32_t	sm_dumpVersion = 1;
+static const uint32_t	sm_dumpHeaderSize = 32;
+static const uint32_t	sm_dumpRecordSize = 16;
+
+/*! Write the octree in a binary restart file, with collective MPI-IO writes at the
+ * offsets given by the global indices of the local octants (see restore).
+ * \param[in] filename Name of the restart file.
+ * \return True if the file has been written (false on any MPI-IO error, on all the processes).
+ */
+bool
+ParaTree::dump(const std::string & filename){
+	MPI_File file;
+	if (!openDump(filename, 0, file)){
+		return false;
+	}
+	return closeDump(true, file);
+};
+
+/*! Replace the octree with the one stored in a binary restart file written by dump.
+ * The file can be written by a different number of processes: the octants are
+ * read with collective MPI-IO reads and uniformly distributed over the processes.
+ * \param[in] filename Name of the restart file.
+ * \return True if the octree has been restored (false if the file cannot be read or
+ * it stores an octree of different dimension or max level).
+ */
+bool
+ParaTree::restore(const std::string & filename){
+	MPI_File file;
+	if (!openRestore(filename, 0, file)){
+		return false;
+	}
+	return closeDump(true, file);
+};
+
+/*! Get the range of global indices of the octants written by the local process
+ * in a restart file (all the octants are written by the first process if the octree is serial).
+ * \param[out] first Global index of the first octant written by the local process.
+ * \param[out] count Number of octants written by the local process.
+ */
+void
+ParaTree::getDumpRange(uint64_t & first, uint32_t & count){
+	first = 0;
+	count = getNumOctants();
+	if (m_serial){
+		if (m_rank != 0) count = 0;
+	}
+	else if (m_rank != 0){
+		first = m_partitionRangeGlobalIdx[m_rank-1] + 1;
+	}
+};
+
+/*! Get the offset in a restart file of the user data of the first octant written
+ * by the local process.
+ * \param[in] dataSize Size in bytes of the user data of each octant.
+ * \return Offset of the user data of the local process in the file.
+ */
+MPI_Offset
+ParaTree::getDumpDataOffset(uint32_t dataSize){
+	uint64_t first;
+	uint32_t count;
+	getDumpRange(first, count);
+	return MPI_Offset(sm_dumpHeaderSize) + MPI_Offset(m_globalNumOctants)*sm_dumpRecordSize + MPI_Offset(first)*dataSize;
+};
+
+/*! Collective write of fixed size records in a restart file. Each record is a
+ * contiguous block of bytes, so that the count of the MPI call is the number of
+ * records and not the number of bytes.
+ * \param[in] file Restart file.
+ * \param[in] offset Offset in the file of the first record.
+ * \param[in] data Records to be written.
+ * \param[in] count Number of records written by the local process.
+ * \param[in] recordSize Size in bytes of each record.
+ * \return True if all the records have been written by the local process.
+ */
+bool
+ParaTree::writeDumpRecords(MPI_File & file, MPI_Offset offset, const void* data, uint32_t count, uint32_t recordSize){
+	if (recordSize == 0){
+		return true;
+	}
+	MPI_Datatype recordType;
+	MPI_Type_contiguous(int(recordSize), MPI_BYTE, &recordType);
+	MPI_Type_commit(&recordType);
+	MPI_Status status;
+	m_errorFlag = MPI_File_write_at_all(file, offset, const_cast<void*>(data), int(count), recordType, &status);
+	bool done = (m_errorFlag == MPI_SUCCESS);
+	if (done){
+		int written = 0;
+		MPI_Get_count(&status, recordType, &written);
+		done = (written == int(count));
+	}
+	MPI_Type_free(&recordType);
+	return done;
+};
 
+/*! Collective read of fixed size records from a restart file (see writeDumpRecords).
+ * \param[in] file Restart file.
+ * \param[in] offset Offset in the file of the first record.
+ * \param[out] data Records read from the file.
+ * \param[in] count Number of records read by the local process.
+ * \param[in] recordSize Size in bytes of each record.
+ * \return True if all the records have been read by the local process
+ * (false also if the file ends before the last record).
+ */
+bool
+ParaTree::readDumpRecords(MPI_File & file, MPI_Offset offset, void* data, uint32_t count, uint32_t recordSize){
+	if (recordSize == 0){
+		return true;
+	}
+	MPI_Datatype recordType;
+	MPI_Type_contiguous(int(recordSize), MPI_BYTE, &recordType);
+	MPI_Type_commit(&recordType);
+	MPI_Status status;
+	m_errorFlag = MPI_File_read_at_all(file, offset, data, int(count), recordType, &status);
+	bool done = (m_errorFlag == MPI_SUCCESS);
+	if (done){
+		int read = 0;
+		MPI_Get_count(&status, recordType, &read);
+		done = (read == int(count));
+	}
+	MPI_Type_free(&recordType);
+	return done;
+};
+
+/*! Check on all the processes the outcome of the accesses to a restart file.
+ * The file is closed if any process failed.
+ * \param[in] done True if the local accesses to the file succeeded.
+ * \param[in] file Restart file.
+ * \return True if the accesses succeeded on all the processes.
+ */
+bool
+ParaTree::checkDumpAccess(bool done, MPI_File & file){
+	int localDone = done ? 1 : 0;
+	int globalDone = 0;
+	MPI_Allreduce(&localDone, &globalDone, 1, MPI_INT, MPI_MIN, m_comm);
+	if (globalDone == 0){
+		m_log.writeLog(" Error in the access to the restart file");
+		m_log.writeLog("---------------------------------------------");
+		MPI_File_close(&file);
+		return false;
+	}
+	return true;
+};
 
+/*! Check the outcome of the last accesses to a restart file and close it.
+ * \param[in] done True if the last local accesses to the file succeeded.
+ * \param[in] file Restart file.
+ * \return True if all the accesses and the closure succeeded on all the processes.
+ */
+bool
+ParaTree::closeDump(bool done, MPI_File & file){
+	if (!checkDumpAccess(done, file)){
+		return false;
+	}
+	int localDone = (MPI_File_close(&file) == MPI_SUCCESS) ? 1 : 0;
+	int globalDone = 0;
+	MPI_Allreduce(&localDone, &globalDone, 1, MPI_INT, MPI_MIN, m_comm);
+	if (globalDone == 0){
+		m_log.writeLog(" Error in the closure of the restart file");
+		return false;
+	}
+	return true;
+};
+
+/*! Open a restart file and write the header and the octants.
+ * \param[in] filename Name of the restart file.
+ * \param[in] dataSize Size in bytes of the user data of each octant written after the octants.
+ * \param[out] file Restart file, left open to write the user data.
+ * \return True if the file has been opened and the octants written (on all the processes;
+ * the file is closed otherwise).
+ */
+bool
+ParaTree::openDump(const std::string & filename, uint32_t dataSize, MPI_File & file){
+
+	m_log.writeLog("---------------------------------------------");
+	m_log.writeLog(" DUMP : " + filename);
 
+	m_errorFlag = MPI_File_open(m_comm, const_cast<char*>(filename.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file);
+	if (m_errorFlag != MPI_SUCCESS){
+		m_log.writeLog(" Unable to open the restart file");
+		m_log.writeLog("---------------------------------------------");
+		return false;
+	}
+	m_errorFlag = MPI_File_set_size(file, MPI_Offset(sm_dumpHeaderSize) + MPI_Offset(m_globalNumOctants)*(sm_dumpRecordSize + dataSize));
+	bool done = (m_errorFlag == MPI_SUCCESS);
+
+	//Header
+	char header[sm_dumpHeaderSize] = {};
+	uint8_t dim = m_dim;
+	int8_t maxLevel = m_global.m_maxLevel;
+	memcpy(header, sm_dumpMagic, 8);
+	memcpy(header + 8, &sm_dumpVersion, 4);
+	memcpy(header + 12, &dim, 1);
+	memcpy(header + 13, &maxLevel, 1);
+	memcpy(header + 16, &m_globalNumOctants, 8);
+	memcpy(header + 24, &sm_dumpRecordSize, 4);
+	memcpy(header + 28, &dataSize, 4);
+	done = writeDumpRecords(file, 0, header, (m_rank == 0) ? 1 : 0, sm_dumpHeaderSize) && done;
+
+	//Octants
+	uint64_t first;
+	uint32_t count;
+	getDumpRange(first, count);
+	vector<char> records(size_t(count)*sm_dumpRecordSize, 0);
+	for (uint32_t i = 0; i < count; ++i){
+		const Octant & octant = m_octree.m_octants[i];
+		char* record = records.data() + size_t(i)*sm_dumpRecordSize;
+		uint64_t morton = m_octree.m_mortons[i];
+		uint32_t info = octant.m_info;
+		uint8_t level = octant.getLevel();
+		int8_t marker = octant.getMarker();
+		memcpy(record, &morton, 8);
+		memcpy(record + 8, &info, 4);
+		memcpy(record + 12, &level, 1);
+		memcpy(record + 13, &marker, 1);
+	}
+	MPI_Offset offset = MPI_Offset(sm_dumpHeaderSize) + MPI_Offset(first)*sm_dumpRecordSize;
+	done = writeDumpRecords(file, offset, records.data(), count, sm_dumpRecordSize) && done;
+	if (!checkDumpAccess(done, file)){
+		return false;
+	}
+
+	m_log.writeLog(" Number of octants	:	" + to_string(static_cast<unsigned long long>(m_globalNumOctants)));
+	m_log.writeLog("---------------------------------------------");
+	return true;
+};
+
+/*! Open a restart file, read the header and the octants and replace the octree.
+ * The octants are uniformly distributed over the processes. The octree is left
+ * unchanged if the file cannot be read or it does not match the octree.
+ * \param[in] filename Name of the restart file.
+ * \param[in] dataSize Size in bytes of the user data of each octant expected in the file.
+ * \param[out] file Restart file, left open to read the user data.
+ * \return True if the file has been opened and the octants read (on all the processes;
+ * the file is closed otherwise).
+ */
+bool
+ParaTree::openRestore(const std::string & filename, uint32_t dataSize, MPI_File & file){
+
+	m_log.writeLog("---------------------------------------------");
+	m_log.writeLog(" RESTORE : " + filename);
+
+	m_errorFlag = MPI_File_open(m_comm, const_cast<char*>(filename.c_str()), MPI_MODE_RDONLY, MPI_INFO_NULL, &file);
+	if (m_errorFlag != MPI_SUCCESS){
+		m_log.writeLog(" Unable to open the restart file");
+		m_log.writeLog("---------------------------------------------");
+		return false;
+	}
+
+	//Header
+	char header[sm_dumpHeaderSize] = {};
+	bool done = readDumpRecords(file, 0, header, 1, sm_dumpHeaderSize);
+	uint32_t version, recordSize, fileDataSize;
+	uint8_t dim;
+	int8_t maxLevel;
+	uint64_t globalNumOctants;
+	memcpy(&version, header + 8, 4);
+	memcpy(&dim, header + 12, 1);
+	memcpy(&maxLevel, header + 13, 1);
+	memcpy(&globalNumOctants, header + 16, 8);
+	memcpy(&recordSize, header + 24, 4);
+	memcpy(&fileDataSize, header + 28, 4);
+	MPI_Offset fileSize = 0;
+	m_errorFlag = MPI_File_get_size(file, &fileSize);
+	done = done && (m_errorFlag == MPI_SUCCESS);
+	if (!checkDumpAccess(done, file)){
+		return false;
+	}
+	if (memcmp(header, sm_dumpMagic, 8) != 0 || version != sm_dumpVersion || recordSize != sm_dumpRecordSize
+			|| dim != m_dim || maxLevel != m_global.m_maxLevel || fileDataSize != dataSize){
+		m_log.writeLog(" The restart file does not match the octree (dimension, max level or user data)");
+		m_log.writeLog("---------------------------------------------");
+		MPI_File_close(&file);
+		return false;
+	}
+	if (globalNumOctants > uint64_t(fileSize - MPI_Offset(sm_dumpHeaderSize))/(sm_dumpRecordSize + dataSize)){
+		m_log.writeLog(" The restart file is truncated");
+		m_log.writeLog("---------------------------------------------");
+		MPI_File_close(&file);
+		return false;
+	}
+
+	//Uniform partition of the octants of the file
+	uint64_t first = (globalNumOctants/m_nproc)*m_rank + min(uint64_t(m_rank), globalNumOctants%m_nproc);
+	uint32_t count = uint32_t(globalNumOctants/m_nproc + ((uint64_t(m_rank) < globalNumOctants%m_nproc) ? 1 : 0));
+
+	//Octants
+	vector<char> records(size_t(count)*sm_dumpRecordSize);
+	MPI_Offset offset = MPI_Offset(sm_dumpHeaderSize) + MPI_Offset(first)*sm_dumpRecordSize;
+	done = readDumpRecords(file, offset, records.data(), count, sm_dumpRecordSize);
+	if (!checkDumpAccess(done, file)){
+		return false;
+	}
+
+	m_octree.m_octants.resize(count);
+	m_octree.m_mortons.resize(count);
+	for (uint32_t i = 0; i < count; ++i){
+		const char* record = records.data() + size_t(i)*sm_dumpRecordSize;
+		uint64_t morton;
+		uint32_t info, x, y, z;
+		uint8_t level;
+		int8_t marker;
+		memcpy(&morton, record, 8);
+		memcpy(&info, record + 8, 4);
+		memcpy(&level, record + 12, 1);
+		memcpy(&marker, record + 13, 1);
+		mortonDecode(morton, x, y, z);
+		m_octree.m_octants[i] = Octant(m_dim, level, x, y, z, m_global.m_maxLevel);
+		m_octree.m_octants[i].setMarker(marker);
+		m_octree.m_octants[i].m_info = info;
+		m_octree.m_mortons[i] = morton;
+	}
+	octvector(m_octree.m_octants).swap(m_octree.m_octants);
+	u64vector(m_octree.m_mortons).swap(m_octree.m_mortons);
+
+	//Update the distributed octree and build the ghosts
+	m_octree.m_ghosts.clear();
+	m_octree.m_ghostsMortons.clear();
+	m_octree.m_sizeGhosts = 0;
+	m_octree.clearConnectivity();
+	m_octree.clearGhostsConnectivity();
+	m_octree.clearIntersections();
+	m_intersectionStore.clear();
+	updateLoadBalance();
+	updateAdapt();
+	setPboundGhosts();
+	updateNeighbourCache(false);
+	updateGeometryCache();
+	updateIntersections(false);
+
+	m_log.writeLog(" Number of octants	:	" + to_string(static_cast<unsigned long long>(m_globalNumOctants)));
+	m_log.writeLog("---------------------------------------------");
+	return true;
+};
+#endif
+
+// =============================================================================== //
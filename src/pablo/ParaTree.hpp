@@ -7,6 +7,7 @@
 #if ENABLE_MPI==1
 #include <mpi.h>
 #include "CommBuffer.hpp"
+#include "DumpBuffer.hpp"
 #include "DataLBInterface.hpp"
 #include "DataCommInterface.hpp"
 #endif
@@ -14,12 +15,15 @@
 #include "Array.hpp"
 #include "Octant.hpp"
 #include "LocalTree.hpp"
+#include "IntersectionStore.hpp"
 #include "Map.hpp"
 #include "Log.hpp"
 #include <map>
 #include <set>
 #include <bitset>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 
 // =================================================================================== //
 // TYPEDEFS																			   //
@@ -50,6 +54,11 @@ typedef ptroctvector::iterator			octantIterator;
  *	index of the octants. By default it is a balanced partition over the number of octants for each
  *	process.
  *
+ *	A process can use several threads (OpenMP) for the loops over its local octants
+ *	(e.g. intersections, connectivity, balance, global refinement, packing of the ghosts data),
+ *	so that fewer and larger partitions can be used. The MPI calls are made only by the thread
+ *	calling the methods of ParaTree: MPI has to be initialized with MPI_THREAD_FUNNELED at least.
+ *
  *	Class ParaTree has a dimensional parameter int dim and it accepts only two
  *	 values: dim=2 and dim=3, for 2D and 3D respectively.
  */
@@ -72,6 +81,8 @@ private:
 	int 					m_rank;							/**<Local m_rank of process*/
 	LocalTree 				m_octree;						/**<Local tree in each processor*/
 	std::map<int,u32vector> m_bordersPerProc;				/**<Local indices of border octants per process*/
+	std::map<int,uint32_t> 	m_ghostsPerProc;				/**<Number of ghost octants received from each neighbour process
+															(communication plan of the ghosts, updated with the ghosts)*/
 	ptroctvector 			m_internals;					/**<Local pointers to internal octants*/
 	ptroctvector 			m_pborders;						/**<Local pointers to border of process octants*/
 
@@ -97,9 +108,41 @@ private:
 	//log member
 	Log 					m_log;							/**<Log object*/
 
+	//balance statistics
+	uint32_t 				m_balanceIterations;			/**<Number of iterations of the last 2:1 balance*/
+	dvector 				m_balanceTimes;					/**<Wall-clock time in seconds of each iteration of the last 2:1 balance*/
+
+	//geometry cache
+	bool 					m_geometryCache;				/**<True if the geometry of the local octants is cached (updated by adapt and loadBalance)*/
+	dvector 				m_cachedCenters[3];				/**<Coordinates of the centers of the local octants, one array per coordinate*/
+	dvector 				m_cachedSizes;					/**<Sizes of the local octants*/
+	dvector 				m_cachedVolumes;				/**<Volumes of the local octants*/
+
+	//intersection store
+	bool 					m_storeIntersections;			/**<True if computeIntersections fills the structure of arrays of the intersections*/
+	IntersectionStore 		m_intersectionStore;			/**<Structure of arrays of the intersections*/
+
 	//communicator
 #if ENABLE_MPI==1
 	MPI_Comm 				m_comm;							/**<MPI communicator*/
+	double 					m_loadBalanceTolerance;			/**<Imbalance of the load under which a load balance does not migrate octants*/
+	uint8_t 				m_partitionFamilyDepth;			/**<Depth of the families of octants never split between processes by a load balance*/
+	uint64_t 				m_sparseExchanges;				/**<Number of sparse exchanges done (consecutive exchanges use different tags)*/
+
+	//persistent ghosts communication members
+	std::map<int,CommBuffer> m_ghostsSendBuffers;			/**<Send buffers of the communications of fixed size data, one per neighbour process*/
+	std::map<int,CommBuffer> m_ghostsRecvBuffers;			/**<Receive buffers of the communications of fixed size data, one per neighbour process*/
+	std::vector<MPI_Request> m_ghostsRequests;				/**<Persistent requests of the communications of fixed size data (receives, then sends)*/
+	size_t					m_ghostsRequestsDataSize;		/**<Data size per octant of the persistent requests (0 if the requests are not built)*/
+	std::map<int,CommBuffer> m_ghostsVariableSendBuffers;	/**<Send buffers of a communication of variable size data in progress*/
+	std::map<int,CommBuffer> m_ghostsVariableRecvBuffers;	/**<Receive buffers of a communication of variable size data in progress*/
+	std::vector<MPI_Request> m_ghostsVariableRequests;		/**<Requests of a communication of variable size data in progress*/
+	std::vector<char>		m_ghostsPodBuffer;				/**<Send buffer of the communications of POD arrays, reused by all the calls*/
+	std::vector<MPI_Request> m_ghostsPodRequests;			/**<Requests of a communication of POD arrays in progress*/
+	MPI_Comm 				m_sharedComm;					/**<Communicator of the processes sharing the memory with the local one (same node)*/
+	std::vector<int> 		m_sharedRanks;					/**<Rank in m_sharedComm of each process (MPI_UNDEFINED if on another node)*/
+	MPI_Win 				m_sharedWin;					/**<Shared memory window storing the user data of the processes of the node*/
+	std::vector<void*> 		m_sharedBuffers;				/**<Data buffer of each process of the node in the shared window*/
 #endif
 
 	// =================================================================================== //
@@ -113,7 +156,11 @@ public:
 	ParaTree(uint8_t dim = 2, int8_t maxlevel = 20, std::string logfile="PABLO.log");
 	ParaTree(u32vector2D & XYZ, u8vector & levels, uint8_t dim = 2, int8_t maxlevel = 20, std::string logfile="PABLO.log");
 #endif
-	~ParaTree();
+	virtual ~ParaTree();
+	// The tree owns MPI resources (persistent requests, communicator and window
+	// of the shared memory), released by the destructor: it can not be copied.
+	ParaTree(const ParaTree & other) = delete;
+	ParaTree & operator=(const ParaTree & other) = delete;
 
 	// =================================================================================== //
 	// METHODS																			   //
@@ -128,6 +175,7 @@ public:
 	bool		getParallel();
 	int 		getRank();
 	int 		getNproc();
+	int 		getNumThreads();
 #if ENABLE_MPI==1
 	MPI_Comm	getComm();
 #endif
@@ -172,6 +220,14 @@ public:
 	double 		getVolume(uint32_t idx);
 	void 		getCenter(uint32_t idx, darray3& center);
 	darray3 	getCenter(uint32_t idx);
+	virtual void getCenters(uint32_t begin, uint32_t end, double* x, double* y, double* z);
+	virtual void getSizes(uint32_t begin, uint32_t end, double* sizes);
+	virtual void getVolumes(uint32_t begin, uint32_t end, double* volumes);
+	void 		setGeometryCache(bool cache);
+	bool 		getGeometryCache() const;
+	const dvector & getCachedCenters(uint8_t coord) const;
+	const dvector & getCachedSizes() const;
+	const dvector & getCachedVolumes() const;
 	darray3 	getFaceCenter(uint32_t idx, uint8_t iface);
 	void 		getFaceCenter(uint32_t idx, uint8_t iface, darray3& center);
 	darray3 	getNode(uint32_t idx, uint8_t inode);
@@ -252,6 +308,10 @@ public:
 	octantIterator	getPboundOctantsBegin();
 	octantIterator	getPboundOctantsEnd();
 	void 		setBalanceCodimension(uint8_t b21codim);
+	uint64_t 	getMemoryFootprint();
+	void 		writeMemoryFootprint();
+	uint32_t 	getBalanceIterations() const;
+	const dvector & getBalanceTimes() const;
 
 	// =================================================================================== //
 	// INTERSECTION GET/SET METHODS														   //
@@ -267,11 +327,11 @@ public:
 	u32vector 	getOwners(Intersection* inter);
 	uint32_t 	getIn(Intersection* inter);
 	uint32_t 	getOut(Intersection* inter);
-	double 		getSize(Intersection* inter);
-	double 		getArea(Intersection* inter);
-	darray3 	getCenter(Intersection* inter);
-	darr3vector getNodes(Intersection* inter);
-	darray3 	getNormal(Intersection* inter);
+	virtual double getSize(Intersection* inter);
+	virtual double getArea(Intersection* inter);
+	virtual darray3 getCenter(Intersection* inter);
+	virtual darr3vector getNodes(Intersection* inter);
+	virtual darray3 getNormal(Intersection* inter);
 
 	// =================================================================================== //
 	// OTHER GET/SET METHODS															   //
@@ -300,10 +360,14 @@ public:
 	void 		findNeighbours(uint32_t idx, uint8_t iface, uint8_t codim, u32vector & neighbours, bvector & isghost);
 	void 		findNeighbours(Octant* oct, uint8_t iface, uint8_t codim, u32vector & neighbours, bvector & isghost);
 	void 		findGhostNeighbours(uint32_t idx, uint8_t iface, uint8_t codim, u32vector & neighbours);
+	void 		setNeighbourCache(bool cache, uint8_t codim = 1);
+	bool 		getNeighbourCache() const;
 	Octant* getPointOwner(dvector & point);
 	uint32_t 	getPointOwnerIdx(dvector & point);
 	Octant* getPointOwner(darray3 & point);
 	uint32_t 	getPointOwnerIdx(darray3 & point);
+	void 		getPointOwners(const std::vector<darray3> & points, u32vector & idx);
+	virtual void getPointOwners(const std::vector<darray3> & points, u32vector & idx, std::vector<int> & ranks);
 	void 		getMapping(uint32_t & idx, u32vector & mapper, bvector & isghost);
 
 	// =================================================================================== //
@@ -318,8 +382,9 @@ public:
 	void 		clearConnectivity();
 	void 		updateConnectivity();
 	const u32vector2D & getConnectivity();
-	const u32vector & getConnectivity(uint32_t idx);
-	const u32vector & getConnectivity(Octant* oct);
+	u32vector 	getConnectivity(uint32_t idx);
+	u32vector 	getConnectivity(Octant* oct);
+	ConnectivityView getConnectivityView();
 	const u32arr3vector & getNodes();
 	const u32array3 & getNodeLogicalCoordinates(uint32_t inode);
 	darray3 	getNodeCoordinates(uint32_t inode);
@@ -327,14 +392,22 @@ public:
 	void 		clearGhostsConnectivity();
 	void 		updateGhostsConnectivity();
 	const u32vector2D & getGhostConnectivity();
-	const u32vector & getGhostConnectivity(uint32_t idx);
-	const u32vector & getGhostConnectivity(Octant* oct);
+	u32vector 	getGhostConnectivity(uint32_t idx);
+	u32vector 	getGhostConnectivity(Octant* oct);
+	ConnectivityView getGhostConnectivityView();
 	const u32arr3vector & getGhostNodes();
 	const u32array3 & getGhostNodeLogicalCoordinates(uint32_t inode);
 	darray3 	getGhostNodeCoordinates(uint32_t inode);
 #if ENABLE_MPI==1
 	void 		loadBalance(dvector* weight = NULL);
 	void 		loadBalance(uint8_t & level, dvector* weight = NULL);
+	void 		setLoadBalanceTolerance(double tolerance);
+	double 		getLoadBalanceTolerance() const;
+	void 		setPartitionFamilyDepth(uint8_t depth);
+	uint8_t 	getPartitionFamilyDepth() const;
+	void* 		allocateSharedBuffer(size_t size);
+	void 		freeSharedBuffer();
+	bool 		isSharedBuffer(const void* data) const;
 private:
 	void 		privateLoadBalance(uint32_t* partition);
 #endif
@@ -345,22 +418,46 @@ public:
 	// OTHER INTERSECTION BASED METHODS										     		   //
 	// =================================================================================== //
 	void 		computeIntersections();
+	void 		clearIntersections();
+	void 		setIntersectionStore(bool store);
+	bool 		getIntersectionStore() const;
+	const IntersectionStore & getStoredIntersections() const;
 
 	// =================================================================================== //
 	// OTHER PRIVATE METHODS												    		   //
 	// =================================================================================== //
+protected:
+	void 		updateGeometryCache();
+	void 		updateIntersectionStore();
 private:
 	Octant& extractOctant(uint32_t idx);
 	bool 		private_adapt();
 	bool 		private_adapt_mapidx(bool mapflag);
 	void 		updateAdapt();
+	void 		writeThreadsLog();
+	void 		updateNeighbourCache(bool mapper_flag);
+	void 		updateIntersections(bool mapper_flag);
+	void 		computeMemoryFootprint(std::vector<std::pair<std::string, uint64_t> > & footprint);
 #if ENABLE_MPI==1
 	void 		computePartition(uint32_t* partition);
 	void 		computePartition(uint32_t* partition, dvector* weight);
 	void 		computePartition(uint32_t* partition, uint8_t & level_, dvector* weight);
+	void 		gatherPartition(const std::vector<std::pair<int, uint64_t> > & cuts, uint32_t* partition);
+	double 		computeLoadImbalance(dvector* weight);
+	bool 		isLoadBalanced(dvector* weight);
+	bool 		isFamilyCut(uint32_t idx);
+	void 		snapPartitionToFamilies(uint32_t* partition);
+	void 		exchangeSparse(const std::map<int, std::vector<char> > & sendBuffers, std::map<int, std::vector<char> > & recvBuffers);
 	void 		updateLoadBalance();
 	void 		setPboundGhosts();
+	void 		initGhostsRequests(size_t fixedDataSize);
+	void 		freeGhostsRequests();
+	void 		initSharedComm();
+	void 		freeSharedComm();
+	void 		findMigrationNeighbours(const uint64_t* newPartitionRangeGlobalidx, std::set<int> & senders, std::set<int> & receivers);
 	void 		commMarker();
+	bool 		commChangedMarkers(std::map<int, std::vector<std::pair<int8_t, bool> > > & sentMarkers,
+							const std::map<int, uint32_t> & ghostOffsets, u32vector & changedGhosts);
 #endif
 	void 		updateAfterCoarse();
 	void 		updateAfterCoarse(u32vector & mapidx);
@@ -373,33 +470,153 @@ public:
 	void 		write(std::string filename);
 	void 		writeTest(std::string filename, dvector data);
 
+	// =================================================================================== //
+	// RESTART METHODS												    			       //
+	// =================================================================================== //
+#if ENABLE_MPI==1
+	bool 		dump(const std::string & filename);
+	bool 		restore(const std::string & filename);
+private:
+	void 		getDumpRange(uint64_t & first, uint32_t & count);
+	MPI_Offset 	getDumpDataOffset(uint32_t dataSize);
+	bool 		openDump(const std::string & filename, uint32_t dataSize, MPI_File & file);
+	bool 		openRestore(const std::string & filename, uint32_t dataSize, MPI_File & file);
+	bool 		writeDumpRecords(MPI_File & file, MPI_Offset offset, const void* data, uint32_t count, uint32_t recordSize);
+	bool 		readDumpRecords(MPI_File & file, MPI_Offset offset, void* data, uint32_t count, uint32_t recordSize);
+	bool 		checkDumpAccess(bool done, MPI_File & file);
+	bool 		closeDump(bool done, MPI_File & file);
+public:
+#endif
+
 	// =================================================================================== //
 	// TEMPLATE METHODS												    			       //
 	// =================================================================================== //
 #if ENABLE_MPI==1
 
+	/** Send a set of points with attached data to the processes owning them and locate
+	 * the points received in the local octants.
+	 * The owners are found from the partition of the octree (see getPointOwners) and the
+	 * points are exchanged only with the processes they are sent to (see exchangeSparse).
+	 * The points outside of the domain are discarded.
+	 * \param[in] points Coordinates of the points to be routed.
+	 * \param[in] data Data attached to the points (POD type, stride values per point).
+	 * \param[out] localPoints Coordinates of the points owned by the local process: the
+	 * local input points, in input order, followed by the points received, ordered by source process.
+	 * \param[out] localData Data attached to the points owned by the local process.
+	 * \param[out] localIdx Local indices of the octants owning the points of the local process.
+	 * \param[in] stride Number of values of data per point.
+	 */
+	template<class T>
+	void
+	routePoints(const std::vector<darray3> & points, const std::vector<T> & data, std::vector<darray3> & localPoints,
+			std::vector<T> & localData, u32vector & localIdx, size_t stride = 1){
+
+		u32vector idx;
+		std::vector<int> ranks;
+		getPointOwners(points, idx, ranks);
+
+		localPoints.clear();
+		localData.clear();
+		size_t recordSize = sizeof(darray3) + stride*sizeof(T);
+		std::map<int, std::vector<char> > sendBuffers, recvBuffers;
+		uint32_t npoints = points.size();
+		for (uint32_t i = 0; i < npoints; ++i){
+			if (ranks[i] < 0) continue;
+			if (ranks[i] == m_rank){
+				localPoints.push_back(points[i]);
+				localData.insert(localData.end(), data.begin() + i*stride, data.begin() + (i+1)*stride);
+				continue;
+			}
+			std::vector<char> & sendBuffer = sendBuffers[ranks[i]];
+			size_t pos = sendBuffer.size();
+			sendBuffer.resize(pos + recordSize);
+			memcpy(&sendBuffer[pos], points[i].data(), sizeof(darray3));
+			memcpy(&sendBuffer[pos + sizeof(darray3)], &data[i*stride], stride*sizeof(T));
+		}
+
+		if (!m_serial){
+			exchangeSparse(sendBuffers, recvBuffers);
+		}
+
+		for (std::map<int, std::vector<char> >::iterator rit = recvBuffers.begin(); rit != recvBuffers.end(); ++rit){
+			size_t nrecv = rit->second.size()/recordSize;
+			size_t pointOffset = localPoints.size();
+			size_t dataOffset = localData.size();
+			localPoints.resize(pointOffset + nrecv);
+			localData.resize(dataOffset + nrecv*stride);
+			for (size_t k = 0; k < nrecv; ++k){
+				const char* record = rit->second.data() + k*recordSize;
+				memcpy(localPoints[pointOffset + k].data(), record, sizeof(darray3));
+				memcpy(&localData[dataOffset + k*stride], record + sizeof(darray3), stride*sizeof(T));
+			}
+		}
+
+		getPointOwners(localPoints, localIdx);
+	}
+
 	/** Communicate data provided by the user between the processes.
+	 * The neighbour processes and the number of ghosts received from each of them are
+	 * taken from the communication plan built with the ghosts, so that no collective
+	 * communication is needed.
+	 * If the user data has a fixed size, the buffers and the persistent requests are
+	 * built at the first call and reused until the ghosts change; otherwise the
+	 * size of the buffers is exchanged before the data.
+	 * It is equivalent to communicateBegin followed by communicateEnd.
+	 * \param[in] userData User interface to communicate the data of the ghosts.
 	 */
 	template<class Impl>
 	void
 	communicate(DataCommInterface<Impl> & userData){
-		//BUILD SEND BUFFERS
-		std::map<int,CommBuffer> sendBuffers;
+		communicateBegin(userData);
+		communicateEnd(userData);
+	};
+
+	/** Start the communication of the data provided by the user between the processes.
+	 * The data of the border of process octants are written in the buffers and sent;
+	 * the data of the ghosts are available after communicateEnd. In between, the user
+	 * can work on the internal octants (see getInternalOctantsBegin), while the data of
+	 * the border of process octants (see getPboundOctantsBegin) must not be changed.
+	 * Only one communication at a time can be in progress.
+	 * \param[in] userData User interface to communicate the data of the ghosts.
+	 */
+	template<class Impl>
+	void
+	communicateBegin(DataCommInterface<Impl> & userData){
 		size_t fixedDataSize = userData.fixedSize();
 		std::map<int,u32vector >::iterator bitend = m_bordersPerProc.end();
 		std::map<int,u32vector >::iterator bitbegin = m_bordersPerProc.begin();
+		if(fixedDataSize != 0){
+			if(m_ghostsRequestsDataSize != fixedDataSize){
+				initGhostsRequests(fixedDataSize);
+			}
+
+			//WRITE SEND BUFFERS
+			for(std::map<int,u32vector >::iterator bit = bitbegin; bit != bitend; ++bit){
+				const u32vector & pborders = bit->second;
+				CommBuffer & sendBuffer = m_ghostsSendBuffers[bit->first];
+				sendBuffer.m_pos = 0;
+				size_t nofPbordersPerProc = pborders.size();
+				for(size_t j = 0; j < nofPbordersPerProc; ++j){
+					userData.gather(sendBuffer,pborders[j]);
+				}
+			}
+
+			//Start Communication of Buffers
+			if(!m_ghostsRequests.empty()){
+				m_errorFlag = MPI_Startall(int(m_ghostsRequests.size()),m_ghostsRequests.data());
+			}
+			return;
+		}
+
+		//BUILD SEND BUFFERS
+		std::map<int,CommBuffer> & sendBuffers = m_ghostsVariableSendBuffers;
 		for(std::map<int,u32vector >::iterator bit = bitbegin; bit != bitend; ++bit){
 			const int & key = bit->first;
 			const u32vector & pborders = bit->second;
 			size_t buffSize = 0;
 			size_t nofPbordersPerProc = pborders.size();
-			if(fixedDataSize != 0){
-				buffSize = fixedDataSize*nofPbordersPerProc;
-			}
-			else{
-				for(size_t i = 0; i < nofPbordersPerProc; ++i){
-					buffSize += userData.size(pborders[i]);
-				}
+			for(size_t i = 0; i < nofPbordersPerProc; ++i){
+				buffSize += userData.size(pborders[i]);
 			}
 			//enlarge buffer to store number of pborders from this proc
 			buffSize += sizeof(int);
@@ -415,8 +632,8 @@ public:
 		}
 
 		//Communicate Buffers Size
-		MPI_Request* req = new MPI_Request[sendBuffers.size()*2];
-		MPI_Status* stats = new MPI_Status[sendBuffers.size()*2];
+		std::vector<MPI_Request> & req = m_ghostsVariableRequests;
+		req.resize(sendBuffers.size()*2);
 		int nReq = 0;
 		std::map<int,int> recvBufferSizePerProc;
 		std::map<int,CommBuffer>::iterator sitend = sendBuffers.end();
@@ -430,10 +647,12 @@ public:
 			m_errorFlag =  MPI_Isend(&rsit->second.m_commBufferSize,1,MPI_UINT32_T,rsit->first,rsit->first,m_comm,&req[nReq]);
 			++nReq;
 		}
-		MPI_Waitall(nReq,req,stats);
+		if(nReq > 0){
+			MPI_Waitall(nReq,req.data(),MPI_STATUSES_IGNORE);
+		}
 
-		//Communicate Buffers
-		std::map<int,CommBuffer> recvBuffers;
+		//Start Communication of Buffers
+		std::map<int,CommBuffer> & recvBuffers = m_ghostsVariableRecvBuffers;
 		std::map<int,int>::iterator ritend = recvBufferSizePerProc.end();
 		for(std::map<int,int>::iterator rit = recvBufferSizePerProc.begin(); rit != ritend; ++rit){
 			recvBuffers[rit->first] = CommBuffer(rit->second,'a',m_comm);
@@ -447,12 +666,47 @@ public:
 			m_errorFlag =  MPI_Isend(rsit->second.m_commBuffer,rsit->second.m_commBufferSize,MPI_PACKED,rsit->first,rsit->first,m_comm,&req[nReq]);
 			++nReq;
 		}
-		MPI_Waitall(nReq,req,stats);
+
+	};
+
+	/** Complete the communication of the data provided by the user started by
+	 * communicateBegin and store the received data of the ghosts.
+	 * \param[in] userData User interface to communicate the data of the ghosts
+	 * (the same passed to communicateBegin).
+	 */
+	template<class Impl>
+	void
+	communicateEnd(DataCommInterface<Impl> & userData){
+		size_t fixedDataSize = userData.fixedSize();
+		if(fixedDataSize != 0){
+			//Wait Communication of Buffers
+			if(!m_ghostsRequests.empty()){
+				m_errorFlag = MPI_Waitall(int(m_ghostsRequests.size()),m_ghostsRequests.data(),MPI_STATUSES_IGNORE);
+			}
+
+			//READ RECEIVE BUFFERS
+			uint32_t ghostOffset = 0;
+			std::map<int,CommBuffer>::iterator rbitend = m_ghostsRecvBuffers.end();
+			for(std::map<int,CommBuffer>::iterator rbit = m_ghostsRecvBuffers.begin(); rbit != rbitend; ++rbit){
+				rbit->second.m_pos = 0;
+				uint32_t nofGhostFromThisProc = m_ghostsPerProc[rbit->first];
+				for(uint32_t k = 0; k < nofGhostFromThisProc; ++k){
+					userData.scatter(rbit->second, k+ghostOffset);
+				}
+				ghostOffset += nofGhostFromThisProc;
+			}
+			return;
+		}
+
+		//Wait Communication of Buffers
+		if(!m_ghostsVariableRequests.empty()){
+			m_errorFlag = MPI_Waitall(int(m_ghostsVariableRequests.size()),m_ghostsVariableRequests.data(),MPI_STATUSES_IGNORE);
+		}
 
 		//READ RECEIVE BUFFERS
 		int ghostOffset = 0;
-		std::map<int,CommBuffer>::iterator rbitend = recvBuffers.end();
-		std::map<int,CommBuffer>::iterator rbitbegin = recvBuffers.begin();
+		std::map<int,CommBuffer>::iterator rbitend = m_ghostsVariableRecvBuffers.end();
+		std::map<int,CommBuffer>::iterator rbitbegin = m_ghostsVariableRecvBuffers.begin();
 		for(std::map<int,CommBuffer>::iterator rbit = rbitbegin; rbit != rbitend; ++rbit){
 			int nofGhostFromThisProc = 0;
 			MPI_Unpack(rbit->second.m_commBuffer,rbit->second.m_commBufferSize,&rbit->second.m_pos,&nofGhostFromThisProc,1,MPI_INT,m_comm);
@@ -461,9 +715,164 @@ public:
 			}
 			ghostOffset += nofGhostFromThisProc;
 		}
-		delete [] req; req = NULL;
-		delete [] stats; stats = NULL;
+		m_ghostsVariableSendBuffers.clear();
+		m_ghostsVariableRecvBuffers.clear();
+		m_ghostsVariableRequests.clear();
+
+	};
+
+	/** Allocate the array of the data of the local octants in a memory window shared
+	 * between the processes of the same node (see allocateSharedBuffer). When the data
+	 * passed to communicate are stored in this array, the ghosts owned by processes of
+	 * the same node are read directly from their arrays, without any message.
+	 * \param[in] stride Number of values for each octant.
+	 * \return Pointer to the getNumOctants()*stride values of the local octants.
+	 */
+	template<class T>
+	T*
+	allocateSharedData(size_t stride = 1){
+		return static_cast<T*>(allocateSharedBuffer(size_t(getNumOctants())*stride*sizeof(T)));
+	};
+
+	/** Communicate the data of the ghosts stored by the user in contiguous arrays of
+	 * MPI-compatible POD values, with the same number of values for each octant.
+	 * The data of the border of process octants are copied in a single send buffer,
+	 * reused by all the calls, and the data of the ghosts are received directly in the
+	 * user array, without calling any gather/scatter for each octant.
+	 * If the data are stored in the array returned by allocateSharedData (on all the
+	 * processes), the ghosts owned by processes of the same node are copied directly from
+	 * their arrays and only the processes of the other nodes exchange messages.
+	 * It is equivalent to communicateBegin followed by communicateEnd.
+	 * \param[in] data Data of the local octants (stride values for each octant).
+	 * \param[out] ghostData Data of the ghost octants (stride values for each ghost),
+	 * it has to store getNumGhosts()*stride values.
+	 * \param[in] stride Number of values for each octant.
+	 */
+	template<class T>
+	void
+	communicate(const T* data, T* ghostData, size_t stride = 1){
+		communicateBegin(data, ghostData, stride);
+		communicateEnd(data, ghostData, stride);
+	};
 
+	/** Communicate the data of the ghosts stored by the user in vectors of
+	 * MPI-compatible POD values, with the same number of values for each octant.
+	 * \param[in] data Data of the local octants (stride values for each octant).
+	 * \param[out] ghostData Data of the ghost octants (stride values for each ghost),
+	 * it is resized to getNumGhosts()*stride values.
+	 * \param[in] stride Number of values for each octant.
+	 */
+	template<class T>
+	void
+	communicate(const std::vector<T> & data, std::vector<T> & ghostData, size_t stride = 1){
+		ghostData.resize(size_t(getNumGhosts())*stride);
+		communicate(data.data(), ghostData.data(), stride);
+	};
+
+	/** Start the communication of the data of the ghosts stored by the user in
+	 * contiguous arrays of MPI-compatible POD values (see communicate).
+	 * Neither the data of the border of process octants nor the ghost data can be
+	 * used until communicateEnd is called.
+	 * \param[in] data Data of the local octants (stride values for each octant).
+	 * \param[out] ghostData Data of the ghost octants (stride values for each ghost).
+	 * \param[in] stride Number of values for each octant.
+	 */
+	template<class T>
+	void
+	communicateBegin(const T* data, T* ghostData, size_t stride = 1){
+		MPI_Datatype datatype = convert<T>();
+		bool shared = isSharedBuffer(data);
+
+		//Receive the ghosts directly in the user array (ghosts are ordered by owner),
+		//the ghosts of the same node are read from the shared window by communicateEnd
+		m_ghostsPodRequests.resize(m_ghostsPerProc.size() + m_bordersPerProc.size());
+		int nReq = 0;
+		size_t ghostOffset = 0;
+		std::map<int,uint32_t>::iterator gitend = m_ghostsPerProc.end();
+		for(std::map<int,uint32_t>::iterator git = m_ghostsPerProc.begin(); git != gitend; ++git){
+			int count = int(git->second*stride);
+			if(!shared || m_sharedRanks[git->first] == MPI_UNDEFINED){
+				m_errorFlag = MPI_Irecv(ghostData + ghostOffset,count,datatype,git->first,m_rank,m_comm,&m_ghostsPodRequests[nReq]);
+				++nReq;
+			}
+			ghostOffset += size_t(count);
+		}
+
+		//Copy the border octants in the send buffer and send it
+		size_t nofValues = 0;
+		std::map<int,u32vector >::iterator bitend = m_bordersPerProc.end();
+		for(std::map<int,u32vector >::iterator bit = m_bordersPerProc.begin(); bit != bitend; ++bit){
+			nofValues += bit->second.size()*stride;
+		}
+		m_ghostsPodBuffer.resize(nofValues*sizeof(T));
+		T* sendData = reinterpret_cast<T*>(m_ghostsPodBuffer.data());
+		for(std::map<int,u32vector >::iterator bit = m_bordersPerProc.begin(); bit != bitend; ++bit){
+			if(shared && m_sharedRanks[bit->first] != MPI_UNDEFINED){
+				continue;
+			}
+			const u32vector & pborders = bit->second;
+			size_t nofPbordersPerProc = pborders.size();
+			T* sendBlock = sendData;
+#pragma omp parallel for schedule(static) if (nofPbordersPerProc*stride > 4096)
+			for(size_t j = 0; j < nofPbordersPerProc; ++j){
+				const T* octantData = data + size_t(pborders[j])*stride;
+				std::copy(octantData, octantData + stride, sendBlock + j*stride);
+			}
+			sendData += nofPbordersPerProc*stride;
+			m_errorFlag = MPI_Isend(sendBlock,int(nofPbordersPerProc*stride),datatype,bit->first,bit->first,m_comm,&m_ghostsPodRequests[nReq]);
+			++nReq;
+		}
+		m_ghostsPodRequests.resize(nReq);
+
+		//The data of the processes of the node are complete when all of them get here
+#if MPI_VERSION >= 3
+		if(shared){
+			m_errorFlag = MPI_Win_sync(m_sharedWin);
+			m_errorFlag = MPI_Barrier(m_sharedComm);
+			m_errorFlag = MPI_Win_sync(m_sharedWin);
+		}
+#endif
+	};
+
+	/** Complete the communication of the data of the ghosts stored by the user in
+	 * contiguous arrays of MPI-compatible POD values started by communicateBegin.
+	 * \param[in] data Data of the local octants (stride values for each octant).
+	 * \param[out] ghostData Data of the ghost octants (stride values for each ghost).
+	 * \param[in] stride Number of values for each octant.
+	 */
+	template<class T>
+	void
+	communicateEnd(const T* data, T* ghostData, size_t stride = 1){
+		if(!m_ghostsPodRequests.empty()){
+			m_errorFlag = MPI_Waitall(int(m_ghostsPodRequests.size()),m_ghostsPodRequests.data(),MPI_STATUSES_IGNORE);
+		}
+		m_ghostsPodRequests.clear();
+
+		if(!isSharedBuffer(data)){
+			return;
+		}
+
+		//Copy the ghosts of the processes of the node from their arrays (the local index
+		//of a ghost in its owner follows from its global index)
+		size_t ghostOffset = 0;
+		std::map<int,uint32_t>::iterator gitend = m_ghostsPerProc.end();
+		for(std::map<int,uint32_t>::iterator git = m_ghostsPerProc.begin(); git != gitend; ++git){
+			int sharedRank = m_sharedRanks[git->first];
+			if(sharedRank != MPI_UNDEFINED){
+				const T* ownerData = static_cast<const T*>(m_sharedBuffers[sharedRank]);
+				uint64_t ownerOffset = (git->first == 0) ? 0 : m_partitionRangeGlobalIdx[git->first-1] + 1;
+				uint32_t ghostBegin = uint32_t(ghostOffset/stride);
+#pragma omp parallel for schedule(static) if (git->second*stride > 4096)
+				for(uint32_t k = 0; k < git->second; ++k){
+					const T* octantData = ownerData + size_t(m_octree.m_globalIdxGhosts[ghostBegin + k] - ownerOffset)*stride;
+					std::copy(octantData, octantData + stride, ghostData + size_t(ghostBegin + k)*stride);
+				}
+			}
+			ghostOffset += size_t(git->second)*stride;
+		}
+
+		//The arrays of the node can be modified only when all the processes have read them
+		m_errorFlag = MPI_Barrier(m_sharedComm);
 	};
 
 	/** Distribute Load-Balancing the octants (with user defined weights) of the whole tree and data provided by the user
@@ -480,11 +889,16 @@ public:
 		m_log.writeLog("---------------------------------------------");
 		m_log.writeLog(" LOAD BALANCE ");
 
+		if (isLoadBalanced(weight)){
+			return;
+		}
+
 		uint32_t* partition = new uint32_t [m_nproc];
 		if (weight == NULL)
 			computePartition(partition);
 		else
 			computePartition(partition, weight);
+		snapPartitionToFamilies(partition);
 
 		weight = NULL;
 
@@ -499,14 +913,7 @@ public:
 			uint32_t stride = 0;
 			for(int i = 0; i < m_rank; ++i)
 				stride += partition[i];
-			LocalTree::octvector octantsCopy = m_octree.m_octants;
-			LocalTree::octvector::const_iterator first = octantsCopy.begin() + stride;
-			LocalTree::octvector::const_iterator last = first + partition[m_rank];
-			m_octree.m_octants.assign(first, last);
-			octvector(m_octree.m_octants).swap(m_octree.m_octants);
-
-			first = octantsCopy.end();
-			last = octantsCopy.end();
+			m_octree.moveOctants(stride, stride + partition[m_rank], 0, partition[m_rank]);
 
 			userData.assign(stride,partition[m_rank]);
 
@@ -525,6 +932,7 @@ public:
 
 			//empty ghosts
 			m_octree.m_ghosts.clear();
+			m_octree.m_ghostsMortons.clear();
 			m_octree.m_sizeGhosts = 0;
 			//compute new partition range globalidx
 			uint64_t* newPartitionRangeGlobalidx = new uint64_t[m_nproc];
@@ -595,7 +1003,7 @@ public:
 			uint32_t x,y,z;
 			uint8_t l;
 			int8_t m;
-			bool info[17];
+			uint32_t info;
 			int intBuffer = 0;
 			int contatore = 0;
 			//build send buffers from Head
@@ -634,17 +1042,13 @@ public:
 							z = octant.getZ();
 							l = octant.getLevel();
 							m = octant.getMarker();
-							for(int j = 0; j < 17; ++j)
-								info[j] = octant.m_info[j];
+							info = octant.m_info;
 							m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							for(int j = 0; j < 17; ++j){
-								MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-
-							}
+							m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							userData.gather(sendBuffers[p],i);
 						}
 						if(nofElementsFromSuccessiveToPrevious == headSize)
@@ -682,16 +1086,13 @@ public:
 							z = octant.getZ();
 							l = octant.getLevel();
 							m = octant.getMarker();
-							for(int j = 0; j < 17; ++j)
-								info[j] = octant.m_info[j];
+							info = octant.m_info;
 							m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							for(int j = 0; j < 17; ++j){
-								MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							}
+							m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							userData.gather(sendBuffers[p],i);
 						}
 						lh -= nofElementsFromSuccessiveToPrevious;
@@ -740,16 +1141,13 @@ public:
 							z = octant.getZ();
 							l = octant.getLevel();
 							m = octant.getMarker();
-							for(int j = 0; j < 17; ++j)
-								info[j] = octant.m_info[j];
+							info = octant.m_info;
 							m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							for(int j = 0; j < 17; ++j){
-								MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							}
+							m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							userData.gather(sendBuffers[p],i);
 						}
 						if(nofElementsFromPreviousToSuccessive == tailSize)
@@ -786,16 +1184,13 @@ public:
 							z = octant.getZ();
 							l = octant.getLevel();
 							m = octant.getMarker();
-							for(int j = 0; j < 17; ++j)
-								info[j] = octant.m_info[j];
+							info = octant.m_info;
 							m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							for(int j = 0; j < 17; ++j){
-								MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							}
+							m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							userData.gather(sendBuffers[p],i);
 						}
 						ft += nofElementsFromPreviousToSuccessive;
@@ -808,45 +1203,25 @@ public:
 			}
 //			cout << "second" << endl;
 
-			//Build receiver sources
-			std::vector<Array> recvs(m_nproc);
-			recvs[m_rank] = Array((uint32_t)sendBuffers.size()+1,-1);
-			recvs[m_rank].m_array[0] = m_rank;
-			int counter = 1;
-			std::map<int,CommBuffer>::iterator sitend = sendBuffers.end();
-			for(std::map<int,CommBuffer>::iterator sit = sendBuffers.begin(); sit != sitend; ++sit){
-				recvs[m_rank].m_array[counter] = sit->first;
-				++counter;
-			}
-			int* nofRecvsPerProc = new int[m_nproc];
-			m_errorFlag = MPI_Allgather(&recvs[m_rank].m_arraySize,1,MPI_INT,nofRecvsPerProc,1,MPI_INT,m_comm);
-			int globalRecvsBuffSize = 0;
-			int* displays = new int[m_nproc];
-			for(int pp = 0; pp < m_nproc; ++pp){
-				displays[pp] = 0;
-				globalRecvsBuffSize += nofRecvsPerProc[pp];
-				for(int ppp = 0; ppp < pp; ++ppp){
-					displays[pp] += nofRecvsPerProc[ppp];
-				}
-			}
-			//int globalRecvsBuff[globalRecvsBuffSize];
-			int* globalRecvsBuff = new int[globalRecvsBuffSize];
-			m_errorFlag = MPI_Allgatherv(recvs[m_rank].m_array,recvs[m_rank].m_arraySize,MPI_INT,globalRecvsBuff,nofRecvsPerProc,displays,MPI_INT,m_comm);
-
-			std::vector<std::set<int> > sendersPerProc(m_nproc);
-			for(int pin = 0; pin < m_nproc; ++pin){
-				for(int k = displays[pin]+1; k < displays[pin] + nofRecvsPerProc[pin]; ++k){
-					sendersPerProc[globalRecvsBuff[k]].insert(globalRecvsBuff[displays[pin]]);
-				}
+			//Find the processes exchanging octants with this one from the old and the new partition
+			//(buffers without octants are not sent)
+			std::set<int> senders, receivers;
+			findMigrationNeighbours(newPartitionRangeGlobalidx, senders, receivers);
+			std::map<int,CommBuffer>::iterator sit = sendBuffers.begin();
+			while(sit != sendBuffers.end()){
+				if(receivers.count(sit->first))
+					++sit;
+				else
+					sendBuffers.erase(sit++);
 			}
 
 			//Communicate Octants (size)
-			MPI_Request* req = new MPI_Request[sendBuffers.size()+sendersPerProc[m_rank].size()];
-			MPI_Status* stats = new MPI_Status[sendBuffers.size()+sendersPerProc[m_rank].size()];
+			MPI_Request* req = new MPI_Request[sendBuffers.size()+senders.size()];
+			MPI_Status* stats = new MPI_Status[sendBuffers.size()+senders.size()];
 			int nReq = 0;
 			std::map<int,int> recvBufferSizePerProc;
-			std::set<int>::iterator senditend = sendersPerProc[m_rank].end();
-			for(std::set<int>::iterator sendit = sendersPerProc[m_rank].begin(); sendit != senditend; ++sendit){
+			std::set<int>::iterator senditend = senders.end();
+			for(std::set<int>::iterator sendit = senders.begin(); sendit != senditend; ++sendit){
 				recvBufferSizePerProc[*sendit] = 0;
 				m_errorFlag = MPI_Irecv(&recvBufferSizePerProc[*sendit],1,MPI_UINT32_T,*sendit,m_rank,m_comm,&req[nReq]);
 				++nReq;
@@ -871,7 +1246,7 @@ public:
 			}
 
 			nReq = 0;
-			for(std::set<int>::iterator sendit = sendersPerProc[m_rank].begin(); sendit != senditend; ++sendit){
+			for(std::set<int>::iterator sendit = senders.begin(); sendit != senditend; ++sendit){
 				m_errorFlag = MPI_Irecv(recvBuffers[*sendit].m_commBuffer,recvBuffers[*sendit].m_commBufferSize,MPI_PACKED,*sendit,m_rank,m_comm,&req[nReq]);
 				++nReq;
 			}
@@ -894,23 +1269,24 @@ public:
 					nofNewTail += nofNewPerProc;
 			}
 
-			//MOVE RESIDENT TO BEGIN IN OCTANTS
+			//MOVE RESIDENTS IN RIGHT POSITION (in place, they are not moved if the head does not change size)
 			uint32_t resEnd = m_octree.getNumOctants() - tailOffset;
 			uint32_t nofResidents = resEnd - headOffset;
-			uint32_t octCounter = 0;
-			for(uint32_t i = headOffset; i < resEnd; ++i){
-				m_octree.m_octants[octCounter] = m_octree.m_octants[i];
-				userData.move(i,octCounter);
-				++octCounter;
-			}
 			uint32_t newCounter = nofNewHead + nofNewTail + nofResidents;
-			m_octree.m_octants.resize(newCounter);
-			userData.resize(newCounter);
-			//MOVE RESIDENTS IN RIGHT POSITION
-			uint32_t resCounter = nofNewHead + nofResidents - 1;
-			for(uint32_t k = 0; k < nofResidents ; ++k){
-				m_octree.m_octants[resCounter - k] = m_octree.m_octants[nofResidents - k - 1];
-				userData.move(nofResidents - k - 1,resCounter - k);
+			m_octree.moveOctants(headOffset, resEnd, nofNewHead, newCounter);
+			if(nofNewHead > headOffset){
+				userData.resize(newCounter);
+				for(uint32_t k = nofResidents; k > 0; --k){
+					userData.move(headOffset + k - 1, nofNewHead + k - 1);
+				}
+			}
+			else{
+				if(nofNewHead < headOffset){
+					for(uint32_t k = 0; k < nofResidents; ++k){
+						userData.move(headOffset + k, nofNewHead + k);
+					}
+				}
+				userData.resize(newCounter);
 			}
 
 			//UNPACK BUFFERS AND BUILD NEW OCTANTS
@@ -932,25 +1308,20 @@ public:
 					m_octree.m_octants[newCounter] = Octant(m_dim,l,x,y,z);
 					m_errorFlag = MPI_Unpack(rbit->second.m_commBuffer,rbit->second.m_commBufferSize,&rbit->second.m_pos,&m,1,MPI_INT8_T,m_comm);
 					m_octree.m_octants[newCounter].setMarker(m);
-					for(int j = 0; j < 17; ++j){
-						m_errorFlag = MPI_Unpack(rbit->second.m_commBuffer,rbit->second.m_commBufferSize,&rbit->second.m_pos,&info[j],1,MPI::BOOL,m_comm);
-						m_octree.m_octants[newCounter].m_info[j] = info[j];
-					}
+					m_errorFlag = MPI_Unpack(rbit->second.m_commBuffer,rbit->second.m_commBufferSize,&rbit->second.m_pos,&info,1,MPI_UINT32_T,m_comm);
+					m_octree.m_octants[newCounter].m_info = info;
+					m_octree.m_mortons[newCounter] = m_octree.m_octants[newCounter].computeMorton();
 					userData.scatter(rbit->second,newCounter);
 					++newCounter;
 				}
 			}
-			octvector(m_octree.m_octants).swap(m_octree.m_octants);
 //			cout << "third" << endl;
 
 			userData.shrink();
 
 			delete [] newPartitionRangeGlobalidx; newPartitionRangeGlobalidx = NULL;
-			delete [] nofRecvsPerProc; nofRecvsPerProc = NULL;
-			delete [] displays; displays = NULL;
 			delete [] req; req = NULL;
 			delete [] stats; stats = NULL;
-			delete [] globalRecvsBuff; globalRecvsBuff = NULL;
 
 			//Update and ghosts here
 	//		cout << "in update" << endl;
@@ -965,6 +1336,10 @@ public:
 		delete [] partition;
 		partition = NULL;
 
+		updateNeighbourCache(false);
+		updateGeometryCache();
+		updateIntersections(false);
+
 		//Write info of final partition on m_log
 		m_log.writeLog(" ");
 		m_log.writeLog(" Final Parallel partition : ");
@@ -994,8 +1369,13 @@ public:
 		m_log.writeLog("---------------------------------------------");
 		m_log.writeLog(" LOAD BALANCE ");
 
+		if (isLoadBalanced(weight)){
+			return;
+		}
+
 		uint32_t* partition = new uint32_t [m_nproc];
 		computePartition(partition, level, weight);
+		snapPartitionToFamilies(partition);
 
 		if(m_serial)
 		{
@@ -1008,14 +1388,7 @@ public:
 			uint32_t stride = 0;
 			for(int i = 0; i < m_rank; ++i)
 				stride += partition[i];
-			LocalTree::octvector octantsCopy = m_octree.m_octants;
-			LocalTree::octvector::const_iterator first = octantsCopy.begin() + stride;
-			LocalTree::octvector::const_iterator last = first + partition[m_rank];
-			m_octree.m_octants.assign(first, last);
-			octvector(m_octree.m_octants).swap(m_octree.m_octants);
-
-			first = octantsCopy.end();
-			last = octantsCopy.end();
+			m_octree.moveOctants(stride, stride + partition[m_rank], 0, partition[m_rank]);
 
 			userData.assign(stride,partition[m_rank]);
 
@@ -1035,6 +1408,7 @@ public:
 
 			//empty ghosts
 			m_octree.m_ghosts.clear();
+			m_octree.m_ghostsMortons.clear();
 			m_octree.m_sizeGhosts = 0;
 			//compute new partition range globalidx
 			uint64_t* newPartitionRangeGlobalidx = new uint64_t[m_nproc];
@@ -1105,7 +1479,7 @@ public:
 			uint32_t x,y,z;
 			uint8_t l;
 			int8_t m;
-			bool info[17];
+			uint32_t info;
 			int intBuffer = 0;
 			int contatore = 0;
 			//build send buffers from Head
@@ -1144,17 +1518,13 @@ public:
 							z = octant.getZ();
 							l = octant.getLevel();
 							m = octant.getMarker();
-							for(int j = 0; j < 17; ++j)
-								info[j] = octant.m_info[j];
+							info = octant.m_info;
 							m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							for(int j = 0; j < 17; ++j){
-								MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-
-							}
+							m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							userData.gather(sendBuffers[p],i);
 						}
 						if(nofElementsFromSuccessiveToPrevious == headSize)
@@ -1192,16 +1562,13 @@ public:
 							z = octant.getZ();
 							l = octant.getLevel();
 							m = octant.getMarker();
-							for(int j = 0; j < 17; ++j)
-								info[j] = octant.m_info[j];
+							info = octant.m_info;
 							m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							for(int j = 0; j < 17; ++j){
-								MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							}
+							m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							userData.gather(sendBuffers[p],i);
 						}
 						lh -= nofElementsFromSuccessiveToPrevious;
@@ -1249,16 +1616,13 @@ public:
 							z = octant.getZ();
 							l = octant.getLevel();
 							m = octant.getMarker();
-							for(int j = 0; j < 17; ++j)
-								info[j] = octant.m_info[j];
+							info = octant.m_info;
 							m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							for(int j = 0; j < 17; ++j){
-								MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							}
+							m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							userData.gather(sendBuffers[p],i);
 						}
 						if(nofElementsFromPreviousToSuccessive == tailSize)
@@ -1295,16 +1659,13 @@ public:
 							z = octant.getZ();
 							l = octant.getLevel();
 							m = octant.getMarker();
-							for(int j = 0; j < 17; ++j)
-								info[j] = octant.m_info[j];
+							info = octant.m_info;
 							m_errorFlag = MPI_Pack(&x,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&y,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&z,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&l,1,MPI_UINT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							m_errorFlag = MPI_Pack(&m,1,MPI_INT8_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							for(int j = 0; j < 17; ++j){
-								MPI_Pack(&info[j],1,MPI::BOOL,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
-							}
+							m_errorFlag = MPI_Pack(&info,1,MPI_UINT32_T,sendBuffers[p].m_commBuffer,buffSize,&sendBuffers[p].m_pos,m_comm);
 							userData.gather(sendBuffers[p],i);
 						}
 						ft += nofElementsFromPreviousToSuccessive;
@@ -1316,44 +1677,25 @@ public:
 				}
 			}
 
-			//Build receiver sources
-			std::vector<Array> recvs(m_nproc);
-			recvs[m_rank] = Array((uint32_t)sendBuffers.size()+1,-1);
-			recvs[m_rank].m_array[0] = m_rank;
-			int counter = 1;
-			std::map<int,CommBuffer>::iterator sitend = sendBuffers.end();
-			for(std::map<int,CommBuffer>::iterator sit = sendBuffers.begin(); sit != sitend; ++sit){
-				recvs[m_rank].m_array[counter] = sit->first;
-				++counter;
-			}
-			int* nofRecvsPerProc = new int[m_nproc];
-			m_errorFlag = MPI_Allgather(&recvs[m_rank].m_arraySize,1,MPI_INT,nofRecvsPerProc,1,MPI_INT,m_comm);
-			int globalRecvsBuffSize = 0;
-			int* displays = new int[m_nproc];
-			for(int pp = 0; pp < m_nproc; ++pp){
-				displays[pp] = 0;
-				globalRecvsBuffSize += nofRecvsPerProc[pp];
-				for(int ppp = 0; ppp < pp; ++ppp){
-					displays[pp] += nofRecvsPerProc[ppp];
-				}
-			}
-			int* globalRecvsBuff = new int[globalRecvsBuffSize];
-			m_errorFlag = MPI_Allgatherv(recvs[m_rank].m_array,recvs[m_rank].m_arraySize,MPI_INT,globalRecvsBuff,nofRecvsPerProc,displays,MPI_INT,m_comm);
-
-			std::vector<std::set<int> > sendersPerProc(m_nproc);
-			for(int pin = 0; pin < m_nproc; ++pin){
-				for(int k = displays[pin]+1; k < displays[pin] + nofRecvsPerProc[pin]; ++k){
-					sendersPerProc[globalRecvsBuff[k]].insert(globalRecvsBuff[displays[pin]]);
-				}
+			//Find the processes exchanging octants with this one from the old and the new partition
+			//(buffers without octants are not sent)
+			std::set<int> senders, receivers;
+			findMigrationNeighbours(newPartitionRangeGlobalidx, senders, receivers);
+			std::map<int,CommBuffer>::iterator sit = sendBuffers.begin();
+			while(sit != sendBuffers.end()){
+				if(receivers.count(sit->first))
+					++sit;
+				else
+					sendBuffers.erase(sit++);
 			}
 
 			//Communicate Octants (size)
-			MPI_Request* req = new MPI_Request[sendBuffers.size()+sendersPerProc[m_rank].size()];
-			MPI_Status* stats = new MPI_Status[sendBuffers.size()+sendersPerProc[m_rank].size()];
+			MPI_Request* req = new MPI_Request[sendBuffers.size()+senders.size()];
+			MPI_Status* stats = new MPI_Status[sendBuffers.size()+senders.size()];
 			int nReq = 0;
 			std::map<int,int> recvBufferSizePerProc;
-			std::set<int>::iterator senditend = sendersPerProc[m_rank].end();
-			for(std::set<int>::iterator sendit = sendersPerProc[m_rank].begin(); sendit != senditend; ++sendit){
+			std::set<int>::iterator senditend = senders.end();
+			for(std::set<int>::iterator sendit = senders.begin(); sendit != senditend; ++sendit){
 				recvBufferSizePerProc[*sendit] = 0;
 				m_errorFlag = MPI_Irecv(&recvBufferSizePerProc[*sendit],1,MPI_UINT32_T,*sendit,m_rank,m_comm,&req[nReq]);
 				++nReq;
@@ -1378,7 +1720,7 @@ public:
 			}
 
 			nReq = 0;
-			for(std::set<int>::iterator sendit = sendersPerProc[m_rank].begin(); sendit != senditend; ++sendit){
+			for(std::set<int>::iterator sendit = senders.begin(); sendit != senditend; ++sendit){
 				m_errorFlag = MPI_Irecv(recvBuffers[*sendit].m_commBuffer,recvBuffers[*sendit].m_commBufferSize,MPI_PACKED,*sendit,m_rank,m_comm,&req[nReq]);
 				++nReq;
 			}
@@ -1401,25 +1743,24 @@ public:
 					nofNewTail += nofNewPerProc;
 			}
 
-			//MOVE RESIDENT TO BEGIN IN OCTANTS
+			//MOVE RESIDENTS IN RIGHT POSITION (in place, they are not moved if the head does not change size)
 			uint32_t resEnd = m_octree.getNumOctants() - tailOffset;
 			uint32_t nofResidents = resEnd - headOffset;
-			uint32_t octCounter = 0;
-			for(uint32_t i = headOffset; i < resEnd; ++i){
-				m_octree.m_octants[octCounter] = m_octree.m_octants[i];
-				//TODO move data - DONE
-				userData.move(i,octCounter);
-				++octCounter;
-			}
 			uint32_t newCounter = nofNewHead + nofNewTail + nofResidents;
-			m_octree.m_octants.resize(newCounter);
-			userData.resize(newCounter);
-			//MOVE RESIDENTS IN RIGHT POSITION
-			uint32_t resCounter = nofNewHead + nofResidents - 1;
-			for(uint32_t k = 0; k < nofResidents ; ++k){
-				m_octree.m_octants[resCounter - k] = m_octree.m_octants[nofResidents - k - 1];
-				//TODO move data - DON
-				userData.move(nofResidents - k - 1,resCounter - k);
+			m_octree.moveOctants(headOffset, resEnd, nofNewHead, newCounter);
+			if(nofNewHead > headOffset){
+				userData.resize(newCounter);
+				for(uint32_t k = nofResidents; k > 0; --k){
+					userData.move(headOffset + k - 1, nofNewHead + k - 1);
+				}
+			}
+			else{
+				if(nofNewHead < headOffset){
+					for(uint32_t k = 0; k < nofResidents; ++k){
+						userData.move(headOffset + k, nofNewHead + k);
+					}
+				}
+				userData.resize(newCounter);
 			}
 
 			//UNPACK BUFFERS AND BUILD NEW OCTANTS
@@ -1442,25 +1783,20 @@ public:
 					m_octree.m_octants[newCounter] = Octant(m_dim,l,x,y,z);
 					m_errorFlag = MPI_Unpack(rbit->second.m_commBuffer,rbit->second.m_commBufferSize,&rbit->second.m_pos,&m,1,MPI_INT8_T,m_comm);
 					m_octree.m_octants[newCounter].setMarker(m);
-					for(int j = 0; j < 17; ++j){
-						m_errorFlag = MPI_Unpack(rbit->second.m_commBuffer,rbit->second.m_commBufferSize,&rbit->second.m_pos,&info[j],1,MPI::BOOL,m_comm);
-						m_octree.m_octants[newCounter].m_info[j] = info[j];
-					}
+					m_errorFlag = MPI_Unpack(rbit->second.m_commBuffer,rbit->second.m_commBufferSize,&rbit->second.m_pos,&info,1,MPI_UINT32_T,m_comm);
+					m_octree.m_octants[newCounter].m_info = info;
+					m_octree.m_mortons[newCounter] = m_octree.m_octants[newCounter].computeMorton();
 					//TODO Unpack data
 					userData.scatter(rbit->second,newCounter);
 					++newCounter;
 				}
 			}
-			octvector(m_octree.m_octants).swap(m_octree.m_octants);
 
 			userData.shrink();
 
 			delete [] newPartitionRangeGlobalidx; newPartitionRangeGlobalidx = NULL;
-			delete [] nofRecvsPerProc; nofRecvsPerProc = NULL;
-			delete [] displays; displays = NULL;
 			delete [] req; req = NULL;
 			delete [] stats; stats = NULL;
-			delete [] globalRecvsBuff; globalRecvsBuff = NULL;
 
 			//Update and ghosts here
 			updateLoadBalance();
@@ -1472,6 +1808,10 @@ public:
 		delete [] partition;
 		partition = NULL;
 
+		updateNeighbourCache(false);
+		updateGeometryCache();
+		updateIntersections(false);
+
 		//Write info of final partition on m_log
 		m_log.writeLog(" ");
 		m_log.writeLog(" Final Parallel partition : ");
@@ -1487,6 +1827,76 @@ public:
 
 #endif
 
+#if ENABLE_MPI==1
+	/** Write the octree and the user data of the octants in a binary restart file (see dump).
+	 * The user data must have a fixed size: they are gathered as raw bytes in the order of the
+	 * octants and written after the octants at the offset given by the global index of the first local octant.
+	 * \param[in] filename Name of the restart file.
+	 * \param[in] userData User interface to gather the data of the octants.
+	 * \return True if the file has been written (false if the user data have not a fixed size,
+	 * if the gathered data do not match the fixed size or on any MPI-IO error).
+	 */
+	template<class Impl>
+	bool
+	dump(const std::string & filename, DataLBInterface<Impl> & userData){
+		uint32_t dataSize = userData.fixedSize();
+		if (dataSize == 0){
+			m_log.writeLog(" DUMP : user data of variable size are not supported");
+			return false;
+		}
+		MPI_File file;
+		if (!openDump(filename, dataSize, file)){
+			return false;
+		}
+
+		uint64_t first;
+		uint32_t count;
+		getDumpRange(first, count);
+		DumpBuffer buffer(size_t(count)*dataSize);
+		for (uint32_t i = 0; i < count; ++i){
+			userData.gather(buffer,i);
+		}
+		bool done = (buffer.m_pos == size_t(count)*dataSize);
+		done = writeDumpRecords(file, getDumpDataOffset(dataSize), buffer.m_buffer.data(), count, dataSize) && done;
+		return closeDump(done, file);
+	}
+
+	/** Replace the octree and the user data of the octants with the ones stored in a binary
+	 * restart file written by dump (see restore). The user data are resized to the restored
+	 * local and ghost octants and the data of the local octants are scattered from the file.
+	 * \param[in] filename Name of the restart file.
+	 * \param[in] userData User interface to scatter the data of the octants.
+	 * \return True if the octree has been restored (false if the file does not match the
+	 * octree, the user data have not the fixed size of the file or on any MPI-IO error;
+	 * the octree is restored but the user data are not valid if the error occurs reading them).
+	 */
+	template<class Impl>
+	bool
+	restore(const std::string & filename, DataLBInterface<Impl> & userData){
+		uint32_t dataSize = userData.fixedSize();
+		if (dataSize == 0){
+			m_log.writeLog(" RESTORE : user data of variable size are not supported");
+			return false;
+		}
+		MPI_File file;
+		if (!openRestore(filename, dataSize, file)){
+			return false;
+		}
+
+		uint32_t nofOctants = getNumOctants();
+		DumpBuffer buffer(size_t(nofOctants)*dataSize);
+		bool done = readDumpRecords(file, getDumpDataOffset(dataSize), buffer.m_buffer.data(), nofOctants, dataSize);
+
+		userData.resize(nofOctants);
+		for (uint32_t i = 0; i < nofOctants; ++i){
+			userData.scatter(buffer,i);
+		}
+		userData.resizeGhost(getNumGhosts());
+		done = done && (buffer.m_pos == size_t(nofOctants)*dataSize);
+		return closeDump(done, file);
+	}
+#endif
+
 	// =============================================================================== //
 
 
@@ -39,6 +39,39 @@ inline uint64_t mortonEncode_magicbits(unsigned int x, unsigned int y){
 
 
 
+// method to gather the bits of a given integer placed 3 positions apart (inverse of splitBy3)
+inline uint32_t compactBy3(uint64_t a){
+	uint64_t x = a & 0x1249249249249249;
+	x = (x ^ (x >> 2)) & 0x10c30c30c30c30c3;
+	x = (x ^ (x >> 4)) & 0x100f00f00f00f00f;
+	x = (x ^ (x >> 8)) & 0x1f0000ff0000ff;
+	x = (x ^ (x >> 16)) & 0x1f00000000ffff;
+	x = (x ^ (x >> 32)) & 0x1fffff;
+	return (uint32_t)x;
+}
+
+inline void mortonDecode_magicbits(uint64_t morton, uint32_t & x, uint32_t & y, uint32_t & z){
+	x = compactBy3(morton);
+	y = compactBy3(morton >> 1);
+	z = compactBy3(morton >> 2);
+}
+
+// method to gather the bits of a given integer placed 2 positions apart (inverse of splitBy2)
+inline uint32_t compactBy2(uint64_t a){
+	uint64_t x = a & 0x5555555555555555;
+	x = (x ^ (x >> 1)) & 0x3333333333333333;
+	x = (x ^ (x >> 2)) & 0xF0F0F0F0F0F0F0F;
+	x = (x ^ (x >> 4)) & 0xFF00FF00FF00FF;
+	x = (x ^ (x >> 8)) & 0xFFFF0000FFFF;
+	x = (x ^ (x >> 16)) & 0xFFFFFFFF;
+	return (uint32_t)x;
+}
+
+inline void mortonDecode_magicbits(uint64_t morton, uint32_t & x, uint32_t & y){
+	x = compactBy2(morton);
+	y = compactBy2(morton >> 1);
+}
+
 inline uint64_t keyXY(uint64_t x, uint64_t y, int8_t max_level){
 	uint64_t answer = 0;
 	answer |= x | (y << max_level);
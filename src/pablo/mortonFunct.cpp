@@ -0,0 +1,396 @@
+// =================================================================================== //
+// INCLUDES                                                                            //
+// =================================================================================== //
+#include "mortonFunct.hpp"
+
+#if (defined(__x86_64__) || defined(__amd64__)) && defined(__GNUC__)
+#define MORTON_HAVE_BMI2 1
+#include <immintrin.h>
+#else
+#define MORTON_HAVE_BMI2 0
+#endif
+
+// =================================================================================== //
+// LOOKUP TABLES                                                                       //
+// =================================================================================== //
+
+/*! Spread the 8 bits of a byte 3 positions apart (3D encode). */
+static const uint32_t mortonEncodeLUT3D[256] = {
+	0x000000, 0x000001, 0x000008, 0x000009, 0x000040, 0x000041, 0x000048, 0x000049,
+	0x000200, 0x000201, 0x000208, 0x000209, 0x000240, 0x000241, 0x000248, 0x000249,
+	0x001000, 0x001001, 0x001008, 0x001009, 0x001040, 0x001041, 0x001048, 0x001049,
+	0x001200, 0x001201, 0x001208, 0x001209, 0x001240, 0x001241, 0x001248, 0x001249,
+	0x008000, 0x008001, 0x008008, 0x008009, 0x008040, 0x008041, 0x008048, 0x008049,
+	0x008200, 0x008201, 0x008208, 0x008209, 0x008240, 0x008241, 0x008248, 0x008249,
+	0x009000, 0x009001, 0x009008, 0x009009, 0x009040, 0x009041, 0x009048, 0x009049,
+	0x009200, 0x009201, 0x009208, 0x009209, 0x009240, 0x009241, 0x009248, 0x009249,
+	0x040000, 0x040001, 0x040008, 0x040009, 0x040040, 0x040041, 0x040048, 0x040049,
+	0x040200, 0x040201, 0x040208, 0x040209, 0x040240, 0x040241, 0x040248, 0x040249,
+	0x041000, 0x041001, 0x041008, 0x041009, 0x041040, 0x041041, 0x041048, 0x041049,
+	0x041200, 0x041201, 0x041208, 0x041209, 0x041240, 0x041241, 0x041248, 0x041249,
+	0x048000, 0x048001, 0x048008, 0x048009, 0x048040, 0x048041, 0x048048, 0x048049,
+	0x048200, 0x048201, 0x048208, 0x048209, 0x048240, 0x048241, 0x048248, 0x048249,
+	0x049000, 0x049001, 0x049008, 0x049009, 0x049040, 0x049041, 0x049048, 0x049049,
+	0x049200, 0x049201, 0x049208, 0x049209, 0x049240, 0x049241, 0x049248, 0x049249,
+	0x200000, 0x200001, 0x200008, 0x200009, 0x200040, 0x200041, 0x200048, 0x200049,
+	0x200200, 0x200201, 0x200208, 0x200209, 0x200240, 0x200241, 0x200248, 0x200249,
+	0x201000, 0x201001, 0x201008, 0x201009, 0x201040, 0x201041, 0x201048, 0x201049,
+	0x201200, 0x201201, 0x201208, 0x201209, 0x201240, 0x201241, 0x201248, 0x201249,
+	0x208000, 0x208001, 0x208008, 0x208009, 0x208040, 0x208041, 0x208048, 0x208049,
+	0x208200, 0x208201, 0x208208, 0x208209, 0x208240, 0x208241, 0x208248, 0x208249,
+	0x209000, 0x209001, 0x209008, 0x209009, 0x209040, 0x209041, 0x209048, 0x209049,
+	0x209200, 0x209201, 0x209208, 0x209209, 0x209240, 0x209241, 0x209248, 0x209249,
+	0x240000, 0x240001, 0x240008, 0x240009, 0x240040, 0x240041, 0x240048, 0x240049,
+	0x240200, 0x240201, 0x240208, 0x240209, 0x240240, 0x240241, 0x240248, 0x240249,
+	0x241000, 0x241001, 0x241008, 0x241009, 0x241040, 0x241041, 0x241048, 0x241049,
+	0x241200, 0x241201, 0x241208, 0x241209, 0x241240, 0x241241, 0x241248, 0x241249,
+	0x248000, 0x248001, 0x248008, 0x248009, 0x248040, 0x248041, 0x248048, 0x248049,
+	0x248200, 0x248201, 0x248208, 0x248209, 0x248240, 0x248241, 0x248248, 0x248249,
+	0x249000, 0x249001, 0x249008, 0x249009, 0x249040, 0x249041, 0x249048, 0x249049,
+	0x249200, 0x249201, 0x249208, 0x249209, 0x249240, 0x249241, 0x249248, 0x249249
+};
+
+/*! Spread the 8 bits of a byte 2 positions apart (2D encode). */
+static const uint16_t mortonEncodeLUT2D[256] = {
+	0x0000, 0x0001, 0x0004, 0x0005, 0x0010, 0x0011, 0x0014, 0x0015,
+	0x0040, 0x0041, 0x0044, 0x0045, 0x0050, 0x0051, 0x0054, 0x0055,
+	0x0100, 0x0101, 0x0104, 0x0105, 0x0110, 0x0111, 0x0114, 0x0115,
+	0x0140, 0x0141, 0x0144, 0x0145, 0x0150, 0x0151, 0x0154, 0x0155,
+	0x0400, 0x0401, 0x0404, 0x0405, 0x0410, 0x0411, 0x0414, 0x0415,
+	0x0440, 0x0441, 0x0444, 0x0445, 0x0450, 0x0451, 0x0454, 0x0455,
+	0x0500, 0x0501, 0x0504, 0x0505, 0x0510, 0x0511, 0x0514, 0x0515,
+	0x0540, 0x0541, 0x0544, 0x0545, 0x0550, 0x0551, 0x0554, 0x0555,
+	0x1000, 0x1001, 0x1004, 0x1005, 0x1010, 0x1011, 0x1014, 0x1015,
+	0x1040, 0x1041, 0x1044, 0x1045, 0x1050, 0x1051, 0x1054, 0x1055,
+	0x1100, 0x1101, 0x1104, 0x1105, 0x1110, 0x1111, 0x1114, 0x1115,
+	0x1140, 0x1141, 0x1144, 0x1145, 0x1150, 0x1151, 0x1154, 0x1155,
+	0x1400, 0x1401, 0x1404, 0x1405, 0x1410, 0x1411, 0x1414, 0x1415,
+	0x1440, 0x1441, 0x1444, 0x1445, 0x1450, 0x1451, 0x1454, 0x1455,
+	0x1500, 0x1501, 0x1504, 0x1505, 0x1510, 0x1511, 0x1514, 0x1515,
+	0x1540, 0x1541, 0x1544, 0x1545, 0x1550, 0x1551, 0x1554, 0x1555,
+	0x4000, 0x4001, 0x4004, 0x4005, 0x4010, 0x4011, 0x4014, 0x4015,
+	0x4040, 0x4041, 0x4044, 0x4045, 0x4050, 0x4051, 0x4054, 0x4055,
+	0x4100, 0x4101, 0x4104, 0x4105, 0x4110, 0x4111, 0x4114, 0x4115,
+	0x4140, 0x4141, 0x4144, 0x4145, 0x4150, 0x4151, 0x4154, 0x4155,
+	0x4400, 0x4401, 0x4404, 0x4405, 0x4410, 0x4411, 0x4414, 0x4415,
+	0x4440, 0x4441, 0x4444, 0x4445, 0x4450, 0x4451, 0x4454, 0x4455,
+	0x4500, 0x4501, 0x4504, 0x4505, 0x4510, 0x4511, 0x4514, 0x4515,
+	0x4540, 0x4541, 0x4544, 0x4545, 0x4550, 0x4551, 0x4554, 0x4555,
+	0x5000, 0x5001, 0x5004, 0x5005, 0x5010, 0x5011, 0x5014, 0x5015,
+	0x5040, 0x5041, 0x5044, 0x5045, 0x5050, 0x5051, 0x5054, 0x5055,
+	0x5100, 0x5101, 0x5104, 0x5105, 0x5110, 0x5111, 0x5114, 0x5115,
+	0x5140, 0x5141, 0x5144, 0x5145, 0x5150, 0x5151, 0x5154, 0x5155,
+	0x5400, 0x5401, 0x5404, 0x5405, 0x5410, 0x5411, 0x5414, 0x5415,
+	0x5440, 0x5441, 0x5444, 0x5445, 0x5450, 0x5451, 0x5454, 0x5455,
+	0x5500, 0x5501, 0x5504, 0x5505, 0x5510, 0x5511, 0x5514, 0x5515,
+	0x5540, 0x5541, 0x5544, 0x5545, 0x5550, 0x5551, 0x5554, 0x5555
+};
+
+/*! Split 9 interleaved bits into 3+3+3 bits, x in 0-2, y in 3-5, z in 6-8 (3D decode). */
+static const uint16_t mortonDecodeLUT3D[512] = {
+	0x000, 0x001, 0x008, 0x009, 0x040, 0x041, 0x048, 0x049,
+	0x002, 0x003, 0x00a, 0x00b, 0x042, 0x043, 0x04a, 0x04b,
+	0x010, 0x011, 0x018, 0x019, 0x050, 0x051, 0x058, 0x059,
+	0x012, 0x013, 0x01a, 0x01b, 0x052, 0x053, 0x05a, 0x05b,
+	0x080, 0x081, 0x088, 0x089, 0x0c0, 0x0c1, 0x0c8, 0x0c9,
+	0x082, 0x083, 0x08a, 0x08b, 0x0c2, 0x0c3, 0x0ca, 0x0cb,
+	0x090, 0x091, 0x098, 0x099, 0x0d0, 0x0d1, 0x0d8, 0x0d9,
+	0x092, 0x093, 0x09a, 0x09b, 0x0d2, 0x0d3, 0x0da, 0x0db,
+	0x004, 0x005, 0x00c, 0x00d, 0x044, 0x045, 0x04c, 0x04d,
+	0x006, 0x007, 0x00e, 0x00f, 0x046, 0x047, 0x04e, 0x04f,
+	0x014, 0x015, 0x01c, 0x01d, 0x054, 0x055, 0x05c, 0x05d,
+	0x016, 0x017, 0x01e, 0x01f, 0x056, 0x057, 0x05e, 0x05f,
+	0x084, 0x085, 0x08c, 0x08d, 0x0c4, 0x0c5, 0x0cc, 0x0cd,
+	0x086, 0x087, 0x08e, 0x08f, 0x0c6, 0x0c7, 0x0ce, 0x0cf,
+	0x094, 0x095, 0x09c, 0x09d, 0x0d4, 0x0d5, 0x0dc, 0x0dd,
+	0x096, 0x097, 0x09e, 0x09f, 0x0d6, 0x0d7, 0x0de, 0x0df,
+	0x020, 0x021, 0x028, 0x029, 0x060, 0x061, 0x068, 0x069,
+	0x022, 0x023, 0x02a, 0x02b, 0x062, 0x063, 0x06a, 0x06b,
+	0x030, 0x031, 0x038, 0x039, 0x070, 0x071, 0x078, 0x079,
+	0x032, 0x033, 0x03a, 0x03b, 0x072, 0x073, 0x07a, 0x07b,
+	0x0a0, 0x0a1, 0x0a8, 0x0a9, 0x0e0, 0x0e1, 0x0e8, 0x0e9,
+	0x0a2, 0x0a3, 0x0aa, 0x0ab, 0x0e2, 0x0e3, 0x0ea, 0x0eb,
+	0x0b0, 0x0b1, 0x0b8, 0x0b9, 0x0f0, 0x0f1, 0x0f8, 0x0f9,
+	0x0b2, 0x0b3, 0x0ba, 0x0bb, 0x0f2, 0x0f3, 0x0fa, 0x0fb,
+	0x024, 0x025, 0x02c, 0x02d, 0x064, 0x065, 0x06c, 0x06d,
+	0x026, 0x027, 0x02e, 0x02f, 0x066, 0x067, 0x06e, 0x06f,
+	0x034, 0x035, 0x03c, 0x03d, 0x074, 0x075, 0x07c, 0x07d,
+	0x036, 0x037, 0x03e, 0x03f, 0x076, 0x077, 0x07e, 0x07f,
+	0x0a4, 0x0a5, 0x0ac, 0x0ad, 0x0e4, 0x0e5, 0x0ec, 0x0ed,
+	0x0a6, 0x0a7, 0x0ae, 0x0af, 0x0e6, 0x0e7, 0x0ee, 0x0ef,
+	0x0b4, 0x0b5, 0x0bc, 0x0bd, 0x0f4, 0x0f5, 0x0fc, 0x0fd,
+	0x0b6, 0x0b7, 0x0be, 0x0bf, 0x0f6, 0x0f7, 0x0fe, 0x0ff,
+	0x100, 0x101, 0x108, 0x109, 0x140, 0x141, 0x148, 0x149,
+	0x102, 0x103, 0x10a, 0x10b, 0x142, 0x143, 0x14a, 0x14b,
+	0x110, 0x111, 0x118, 0x119, 0x150, 0x151, 0x158, 0x159,
+	0x112, 0x113, 0x11a, 0x11b, 0x152, 0x153, 0x15a, 0x15b,
+	0x180, 0x181, 0x188, 0x189, 0x1c0, 0x1c1, 0x1c8, 0x1c9,
+	0x182, 0x183, 0x18a, 0x18b, 0x1c2, 0x1c3, 0x1ca, 0x1cb,
+	0x190, 0x191, 0x198, 0x199, 0x1d0, 0x1d1, 0x1d8, 0x1d9,
+	0x192, 0x193, 0x19a, 0x19b, 0x1d2, 0x1d3, 0x1da, 0x1db,
+	0x104, 0x105, 0x10c, 0x10d, 0x144, 0x145, 0x14c, 0x14d,
+	0x106, 0x107, 0x10e, 0x10f, 0x146, 0x147, 0x14e, 0x14f,
+	0x114, 0x115, 0x11c, 0x11d, 0x154, 0x155, 0x15c, 0x15d,
+	0x116, 0x117, 0x11e, 0x11f, 0x156, 0x157, 0x15e, 0x15f,
+	0x184, 0x185, 0x18c, 0x18d, 0x1c4, 0x1c5, 0x1cc, 0x1cd,
+	0x186, 0x187, 0x18e, 0x18f, 0x1c6, 0x1c7, 0x1ce, 0x1cf,
+	0x194, 0x195, 0x19c, 0x19d, 0x1d4, 0x1d5, 0x1dc, 0x1dd,
+	0x196, 0x197, 0x19e, 0x19f, 0x1d6, 0x1d7, 0x1de, 0x1df,
+	0x120, 0x121, 0x128, 0x129, 0x160, 0x161, 0x168, 0x169,
+	0x122, 0x123, 0x12a, 0x12b, 0x162, 0x163, 0x16a, 0x16b,
+	0x130, 0x131, 0x138, 0x139, 0x170, 0x171, 0x178, 0x179,
+	0x132, 0x133, 0x13a, 0x13b, 0x172, 0x173, 0x17a, 0x17b,
+	0x1a0, 0x1a1, 0x1a8, 0x1a9, 0x1e0, 0x1e1, 0x1e8, 0x1e9,
+	0x1a2, 0x1a3, 0x1aa, 0x1ab, 0x1e2, 0x1e3, 0x1ea, 0x1eb,
+	0x1b0, 0x1b1, 0x1b8, 0x1b9, 0x1f0, 0x1f1, 0x1f8, 0x1f9,
+	0x1b2, 0x1b3, 0x1ba, 0x1bb, 0x1f2, 0x1f3, 0x1fa, 0x1fb,
+	0x124, 0x125, 0x12c, 0x12d, 0x164, 0x165, 0x16c, 0x16d,
+	0x126, 0x127, 0x12e, 0x12f, 0x166, 0x167, 0x16e, 0x16f,
+	0x134, 0x135, 0x13c, 0x13d, 0x174, 0x175, 0x17c, 0x17d,
+	0x136, 0x137, 0x13e, 0x13f, 0x176, 0x177, 0x17e, 0x17f,
+	0x1a4, 0x1a5, 0x1ac, 0x1ad, 0x1e4, 0x1e5, 0x1ec, 0x1ed,
+	0x1a6, 0x1a7, 0x1ae, 0x1af, 0x1e6, 0x1e7, 0x1ee, 0x1ef,
+	0x1b4, 0x1b5, 0x1bc, 0x1bd, 0x1f4, 0x1f5, 0x1fc, 0x1fd,
+	0x1b6, 0x1b7, 0x1be, 0x1bf, 0x1f6, 0x1f7, 0x1fe, 0x1ff
+};
+
+/*! Split 8 interleaved bits into 4+4 bits, x in 0-3, y in 4-7 (2D decode). */
+static const uint8_t mortonDecodeLUT2D[256] = {
+	0x00, 0x01, 0x10, 0x11, 0x02, 0x03, 0x12, 0x13,
+	0x20, 0x21, 0x30, 0x31, 0x22, 0x23, 0x32, 0x33,
+	0x04, 0x05, 0x14, 0x15, 0x06, 0x07, 0x16, 0x17,
+	0x24, 0x25, 0x34, 0x35, 0x26, 0x27, 0x36, 0x37,
+	0x40, 0x41, 0x50, 0x51, 0x42, 0x43, 0x52, 0x53,
+	0x60, 0x61, 0x70, 0x71, 0x62, 0x63, 0x72, 0x73,
+	0x44, 0x45, 0x54, 0x55, 0x46, 0x47, 0x56, 0x57,
+	0x64, 0x65, 0x74, 0x75, 0x66, 0x67, 0x76, 0x77,
+	0x08, 0x09, 0x18, 0x19, 0x0a, 0x0b, 0x1a, 0x1b,
+	0x28, 0x29, 0x38, 0x39, 0x2a, 0x2b, 0x3a, 0x3b,
+	0x0c, 0x0d, 0x1c, 0x1d, 0x0e, 0x0f, 0x1e, 0x1f,
+	0x2c, 0x2d, 0x3c, 0x3d, 0x2e, 0x2f, 0x3e, 0x3f,
+	0x48, 0x49, 0x58, 0x59, 0x4a, 0x4b, 0x5a, 0x5b,
+	0x68, 0x69, 0x78, 0x79, 0x6a, 0x6b, 0x7a, 0x7b,
+	0x4c, 0x4d, 0x5c, 0x5d, 0x4e, 0x4f, 0x5e, 0x5f,
+	0x6c, 0x6d, 0x7c, 0x7d, 0x6e, 0x6f, 0x7e, 0x7f,
+	0x80, 0x81, 0x90, 0x91, 0x82, 0x83, 0x92, 0x93,
+	0xa0, 0xa1, 0xb0, 0xb1, 0xa2, 0xa3, 0xb2, 0xb3,
+	0x84, 0x85, 0x94, 0x95, 0x86, 0x87, 0x96, 0x97,
+	0xa4, 0xa5, 0xb4, 0xb5, 0xa6, 0xa7, 0xb6, 0xb7,
+	0xc0, 0xc1, 0xd0, 0xd1, 0xc2, 0xc3, 0xd2, 0xd3,
+	0xe0, 0xe1, 0xf0, 0xf1, 0xe2, 0xe3, 0xf2, 0xf3,
+	0xc4, 0xc5, 0xd4, 0xd5, 0xc6, 0xc7, 0xd6, 0xd7,
+	0xe4, 0xe5, 0xf4, 0xf5, 0xe6, 0xe7, 0xf6, 0xf7,
+	0x88, 0x89, 0x98, 0x99, 0x8a, 0x8b, 0x9a, 0x9b,
+	0xa8, 0xa9, 0xb8, 0xb9, 0xaa, 0xab, 0xba, 0xbb,
+	0x8c, 0x8d, 0x9c, 0x9d, 0x8e, 0x8f, 0x9e, 0x9f,
+	0xac, 0xad, 0xbc, 0xbd, 0xae, 0xaf, 0xbe, 0xbf,
+	0xc8, 0xc9, 0xd8, 0xd9, 0xca, 0xcb, 0xda, 0xdb,
+	0xe8, 0xe9, 0xf8, 0xf9, 0xea, 0xeb, 0xfa, 0xfb,
+	0xcc, 0xcd, 0xdc, 0xdd, 0xce, 0xcf, 0xde, 0xdf,
+	0xec, 0xed, 0xfc, 0xfd, 0xee, 0xef, 0xfe, 0xff
+};
+
+// =================================================================================== //
+// GLOBAL VARIABLES                                                                    //
+// =================================================================================== //
+
+/*! The backend is selected during the dynamic initialization of the library.
+ * Any use before that (e.g. from other static initializers) reads the
+ * zero-initialized value, i.e. the always available magic-bits kernels.
+ */
+MortonBackend g_mortonBackend = getDefaultMortonBackend();
+
+// =================================================================================== //
+// LOOKUP TABLE KERNELS                                                                //
+// =================================================================================== //
+
+// ----------------------------------------------------------------------------------- //
+static inline uint64_t lutSplitBy3(uint32_t a){
+	uint64_t x = a & 0x1fffff;
+	return (uint64_t)mortonEncodeLUT3D[(x >> 16) & 0xff] << 48
+			| (uint64_t)mortonEncodeLUT3D[(x >> 8) & 0xff] << 24
+			| (uint64_t)mortonEncodeLUT3D[x & 0xff];
+}
+
+static inline uint64_t lutSplitBy2(uint32_t a){
+	return (uint64_t)mortonEncodeLUT2D[(a >> 24) & 0xff] << 48
+			| (uint64_t)mortonEncodeLUT2D[(a >> 16) & 0xff] << 32
+			| (uint64_t)mortonEncodeLUT2D[(a >> 8) & 0xff] << 16
+			| (uint64_t)mortonEncodeLUT2D[a & 0xff];
+}
+
+// ----------------------------------------------------------------------------------- //
+/*! Compute the 3D Morton number of a set of logical coordinates by lookup tables.
+ * \param[in] x,y,z Logical coordinates (only the first 21 bits are used).
+ * \return Morton number.
+ */
+uint64_t
+mortonEncode_lut(uint32_t x, uint32_t y, uint32_t z){
+	return lutSplitBy3(x) | lutSplitBy3(y) << 1 | lutSplitBy3(z) << 2;
+};
+
+/*! Compute the 2D Morton number of a set of logical coordinates by lookup tables.
+ * \param[in] x,y Logical coordinates.
+ * \return Morton number.
+ */
+uint64_t
+mortonEncode_lut(uint32_t x, uint32_t y){
+	return lutSplitBy2(x) | lutSplitBy2(y) << 1;
+};
+
+/*! Compute the logical coordinates of a 3D Morton number by lookup tables.
+ * \param[in] morton Morton number.
+ * \param[out] x,y,z Logical coordinates.
+ */
+void
+mortonDecode_lut(uint64_t morton, uint32_t & x, uint32_t & y, uint32_t & z){
+	x = y = z = 0;
+	for (int k = 0; k < 7; k++){
+		uint32_t c = mortonDecodeLUT3D[(morton >> (9*k)) & 0x1ff];
+		x |= (c & 0x7) << (3*k);
+		y |= ((c >> 3) & 0x7) << (3*k);
+		z |= (c >> 6) << (3*k);
+	}
+};
+
+/*! Compute the logical coordinates of a 2D Morton number by lookup tables.
+ * \param[in] morton Morton number.
+ * \param[out] x,y Logical coordinates.
+ */
+void
+mortonDecode_lut(uint64_t morton, uint32_t & x, uint32_t & y){
+	x = y = 0;
+	for (int k = 0; k < 8; k++){
+		uint32_t c = mortonDecodeLUT2D[(morton >> (8*k)) & 0xff];
+		x |= (c & 0xf) << (4*k);
+		y |= (c >> 4) << (4*k);
+	}
+};
+
+// =================================================================================== //
+// BMI2 KERNELS                                                                        //
+// =================================================================================== //
+
+#if MORTON_HAVE_BMI2
+#define MORTON_TARGET_BMI2 __attribute__((target("bmi2")))
+#else
+#define MORTON_TARGET_BMI2
+#endif
+
+// ----------------------------------------------------------------------------------- //
+/*! Compute the 3D Morton number of a set of logical coordinates by PDEP.
+ * Falls back to the magic-bits kernel when the library is built for a
+ * non x86-64 target; the caller is responsible for checking that the CPU
+ * supports BMI2 (see isMortonBackendSupported).
+ * \param[in] x,y,z Logical coordinates (only the first 21 bits are used).
+ * \return Morton number.
+ */
+MORTON_TARGET_BMI2 uint64_t
+mortonEncode_bmi2(uint32_t x, uint32_t y, uint32_t z){
+#if MORTON_HAVE_BMI2
+	return _pdep_u64(x, 0x1249249249249249) | _pdep_u64(y, 0x2492492492492492) | _pdep_u64(z, 0x4924924924924924);
+#else
+	return mortonEncode_magicbits(x, y, z);
+#endif
+};
+
+/*! Compute the 2D Morton number of a set of logical coordinates by PDEP.
+ * \param[in] x,y Logical coordinates.
+ * \return Morton number.
+ */
+MORTON_TARGET_BMI2 uint64_t
+mortonEncode_bmi2(uint32_t x, uint32_t y){
+#if MORTON_HAVE_BMI2
+	return _pdep_u64(x, 0x5555555555555555) | _pdep_u64(y, 0xaaaaaaaaaaaaaaaa);
+#else
+	return mortonEncode_magicbits(x, y);
+#endif
+};
+
+/*! Compute the logical coordinates of a 3D Morton number by PEXT.
+ * \param[in] morton Morton number.
+ * \param[out] x,y,z Logical coordinates.
+ */
+MORTON_TARGET_BMI2 void
+mortonDecode_bmi2(uint64_t morton, uint32_t & x, uint32_t & y, uint32_t & z){
+#if MORTON_HAVE_BMI2
+	x = (uint32_t)_pext_u64(morton, 0x1249249249249249);
+	y = (uint32_t)_pext_u64(morton, 0x2492492492492492);
+	z = (uint32_t)_pext_u64(morton, 0x4924924924924924);
+#else
+	mortonDecode_magicbits(morton, x, y, z);
+#endif
+};
+
+/*! Compute the logical coordinates of a 2D Morton number by PEXT.
+ * \param[in] morton Morton number.
+ * \param[out] x,y Logical coordinates.
+ */
+MORTON_TARGET_BMI2 void
+mortonDecode_bmi2(uint64_t morton, uint32_t & x, uint32_t & y){
+#if MORTON_HAVE_BMI2
+	x = (uint32_t)_pext_u64(morton, 0x5555555555555555);
+	y = (uint32_t)_pext_u64(morton, 0xaaaaaaaaaaaaaaaa);
+#else
+	mortonDecode_magicbits(morton, x, y);
+#endif
+};
+
+// =================================================================================== //
+// BACKEND SELECTION                                                                   //
+// =================================================================================== //
+
+// ----------------------------------------------------------------------------------- //
+/*! Check if a Morton backend can be used on the running CPU.
+ * \param[in] backend Morton backend.
+ * \return True if the backend is available.
+ */
+bool
+isMortonBackendSupported(MortonBackend backend){
+	switch (backend){
+	case MORTON_MAGICBITS:
+	case MORTON_LUT:
+		return true;
+	case MORTON_BMI2:
+#if MORTON_HAVE_BMI2
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("bmi2");
+#else
+		return false;
+#endif
+	}
+	return false;
+};
+
+/*! Get the backend selected at start-up: BMI2 when the CPU supports it,
+ * magic bits otherwise.
+ * \return Default Morton backend.
+ */
+MortonBackend
+getDefaultMortonBackend(){
+	if (isMortonBackendSupported(MORTON_BMI2)) return MORTON_BMI2;
+	return MORTON_MAGICBITS;
+};
+
+/*! Set the backend used to compute Morton numbers. The choice is global and
+ * it does not change the value of the keys, so it can be done at any time.
+ * \param[in] backend Morton backend.
+ * \return False if the backend is not supported by the running CPU (the
+ * current backend is kept), true otherwise.
+ */
+bool
+setMortonBackend(MortonBackend backend){
+	if (!isMortonBackendSupported(backend)) return false;
+	g_mortonBackend = backend;
+	return true;
+};
+
+/*! Get the backend used to compute Morton numbers.
+ * \return Current Morton backend.
+ */
+MortonBackend
+getMortonBackend(){
+	return g_mortonBackend;
+};
+
+// ----------------------------------------------------------------------------------- //
@@ -0,0 +1,110 @@
+#ifndef MORTONFUNCT_HPP_
+#define MORTONFUNCT_HPP_
+
+// =================================================================================== //
+// INCLUDES                                                                            //
+// =================================================================================== //
+#include "inlinedFunct.hpp"
+
+// =================================================================================== //
+// TYPEDEFS                                                                            //
+// =================================================================================== //
+/*!
+ *	\ingroup	PABLO
+ *
+ *	Kernels available to interleave (encode) and de-interleave (decode) the bits
+ *	of the logical coordinates of an octant into its Morton number.
+ *	All the backends produce bit-for-bit the same keys for coordinates in the range
+ *	[0, 2^21) in 3D and [0, 2^32) in 2D.
+ */
+enum MortonBackend {
+	MORTON_MAGICBITS = 0,	/**< Shift-and-mask ("magic bits") kernels, always available */
+	MORTON_LUT = 1,			/**< Byte-wise lookup table kernels, always available */
+	MORTON_BMI2 = 2			/**< PDEP/PEXT kernels, available on x86-64 CPUs supporting BMI2 */
+};
+
+/*! Backend currently used by mortonEncode/mortonDecode. Do not write it directly,
+ * use setMortonBackend. */
+extern MortonBackend g_mortonBackend;
+
+// =================================================================================== //
+// PROTOTYPES                                                                          //
+// =================================================================================== //
+
+// ----------------------------------------------------------------------------------- //
+uint64_t		mortonEncode_lut(uint32_t x, uint32_t y, uint32_t z);
+uint64_t		mortonEncode_lut(uint32_t x, uint32_t y);
+void			mortonDecode_lut(uint64_t morton, uint32_t & x, uint32_t & y, uint32_t & z);
+void			mortonDecode_lut(uint64_t morton, uint32_t & x, uint32_t & y);
+
+// ----------------------------------------------------------------------------------- //
+uint64_t		mortonEncode_bmi2(uint32_t x, uint32_t y, uint32_t z);
+uint64_t		mortonEncode_bmi2(uint32_t x, uint32_t y);
+void			mortonDecode_bmi2(uint64_t morton, uint32_t & x, uint32_t & y, uint32_t & z);
+void			mortonDecode_bmi2(uint64_t morton, uint32_t & x, uint32_t & y);
+
+// ----------------------------------------------------------------------------------- //
+bool			isMortonBackendSupported(MortonBackend backend);
+MortonBackend	getDefaultMortonBackend();
+bool			setMortonBackend(MortonBackend backend);
+MortonBackend	getMortonBackend();
+
+// =================================================================================== //
+// DISPATCHERS                                                                         //
+// =================================================================================== //
+
+// ----------------------------------------------------------------------------------- //
+inline uint64_t mortonEncode(uint32_t x, uint32_t y, uint32_t z){
+	switch (g_mortonBackend){
+	case MORTON_BMI2:
+		return mortonEncode_bmi2(x, y, z);
+	case MORTON_LUT:
+		return mortonEncode_lut(x, y, z);
+	default:
+		return mortonEncode_magicbits(x, y, z);
+	}
+}
+
+inline uint64_t mortonEncode(uint32_t x, uint32_t y){
+	switch (g_mortonBackend){
+	case MORTON_BMI2:
+		return mortonEncode_bmi2(x, y);
+	case MORTON_LUT:
+		return mortonEncode_lut(x, y);
+	default:
+		return mortonEncode_magicbits(x, y);
+	}
+}
+
+// ----------------------------------------------------------------------------------- //
+inline void mortonDecode(uint64_t morton, uint32_t & x, uint32_t & y, uint32_t & z){
+	switch (g_mortonBackend){
+	case MORTON_BMI2:
+		mortonDecode_bmi2(morton, x, y, z);
+		break;
+	case MORTON_LUT:
+		mortonDecode_lut(morton, x, y, z);
+		break;
+	default:
+		mortonDecode_magicbits(morton, x, y, z);
+		break;
+	}
+}
+
+inline void mortonDecode(uint64_t morton, uint32_t & x, uint32_t & y){
+	switch (g_mortonBackend){
+	case MORTON_BMI2:
+		mortonDecode_bmi2(morton, x, y);
+		break;
+	case MORTON_LUT:
+		mortonDecode_lut(morton, x, y);
+		break;
+	default:
+		mortonDecode_magicbits(morton, x, y);
+		break;
+	}
+}
+
+// ----------------------------------------------------------------------------------- //
+
+#endif /* MORTONFUNCT_HPP_ */
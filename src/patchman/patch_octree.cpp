@@ -29,14 +29,13 @@ namespace pman {
 */
 PatchOctree::PatchOctree(const int &id, const int &dimension,
 				 std::array<double, 3> origin, double length, double dh )
-	: Patch(id, dimension)
+	: Patch(id, dimension), m_tree(dimension)
 {
 	std::cout << ">> Initializing Octree mesh\n";
 
 	// Inizializzazione dell'octree
 	double initial_level = ceil(log2(std::max(1., length / dh)));
 
-	m_tree = PabloUniform(origin[0], origin[1], origin[2], length, get_dimension());
 	m_tree.setMarker((uint32_t) 0, initial_level);
 
 	// Info sull'octree
@@ -204,15 +203,15 @@ long PatchOctree::get_octant_id(const OctantInfo &octantInfo) const
 	Gets the connectivity of the specified octant.
 
 	\param octantInfo the data of the octant
-	\result A reference to the octant's connectivity
+	\result A pointer to the first vertex of the octant's connectivity
 */
-const std::vector<uint32_t> & PatchOctree::get_octant_connect(const OctantInfo &octantInfo)
+const uint32_t * PatchOctree::get_octant_connect(const OctantInfo &octantInfo)
 {
 	bool isGhost = m_tree.getIsGhost(octantInfo.id);
 	if (!isGhost) {
-		return m_tree.getConnectivity()[octantInfo.id];
+		return m_tree.getConnectivityView()[octantInfo.id];
 	} else {
-		return m_tree.getGhostConnectivity()[octantInfo.id];
+		return m_tree.getGhostConnectivityView()[octantInfo.id];
 	}
 }
 
@@ -719,7 +718,7 @@ std::vector<unsigned long> PatchOctree::import_octants(std::vector<OctantInfo> &
 
 			// Octant data
 			OctantInfo octantInfo = get_cell_octant(vertexSource.id);
-			const std::vector<uint32_t> &octantTreeConnect = get_octant_connect(octantInfo);
+			const uint32_t *octantTreeConnect = get_octant_connect(octantInfo);
 
 			// List of vertices
 			const std::vector<int> &localConnect = cellLocalFaceConnect[vertexSource.face];
@@ -734,7 +733,7 @@ std::vector<unsigned long> PatchOctree::import_octants(std::vector<OctantInfo> &
 
 	// Create the new vertices
 	for (OctantInfo &octantInfo : octantInfoList) {
-		const std::vector<uint32_t> &octantTreeConnect = get_octant_connect(octantInfo);
+		const uint32_t *octantTreeConnect = get_octant_connect(octantInfo);
 		for (int k = 0; k < nCellVertices; ++k) {
 			uint32_t vertexTreeId = octantTreeConnect[k];
 			if (vertexMap.count(vertexTreeId) == 0) {
@@ -797,7 +796,7 @@ std::vector<unsigned long> PatchOctree::import_octants(std::vector<OctantInfo> &
 		interfaceFaces[1] = FaceInfo(neighId, ownerFace + 1 - 2 * (ownerFace % 2));
 
 		// Interface connectivity
-		const std::vector<uint32_t> &octantTreeConnect = get_octant_connect(ownerOctantInfo);
+		const uint32_t *octantTreeConnect = get_octant_connect(ownerOctantInfo);
 		const std::vector<int> &localConnect = cellLocalFaceConnect[ownerFace];
 		std::unique_ptr<long[]> interfaceConnect = std::unique_ptr<long[]>(new long[nInterfaceVertices]);
 		for (int k = 0; k < nInterfaceVertices; ++k) {
@@ -836,7 +835,7 @@ std::vector<unsigned long> PatchOctree::import_octants(std::vector<OctantInfo> &
 	std::vector<std::vector<bool>> interfaceOwnerFlags(nCellFaces, std::vector<bool>());
 	for (OctantInfo &octantInfo : octantInfoList) {
 		// Octant connectivity
-		const std::vector<uint32_t> &octantTreeConnect = get_octant_connect(octantInfo);
+		const uint32_t *octantTreeConnect = get_octant_connect(octantInfo);
 
 		// Cell connectivity
 		std::unique_ptr<long[]> cellConnect = std::unique_ptr<long[]>(new long[nCellVertices]);
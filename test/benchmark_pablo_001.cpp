@@ -0,0 +1,112 @@
+#include "ParaTree.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Search the octant with a given Morton number by a halving search that recomputes
+ * the Morton number of each probed octant (lookup strategy without cached keys).*/
+uint32_t searchRecomputingMorton(ParaTree & pablo, uint64_t morton) {
+
+    uint32_t nocts = pablo.getNumOctants();
+    uint32_t beg = 0;
+    uint32_t end = nocts;
+    while (beg < end){
+        uint32_t mid = beg + (end - beg)/2;
+        if (pablo.getMorton(pablo.getOctant(mid)) < morton){
+            beg = mid + 1;
+        }
+        else{
+            end = mid;
+        }
+    }
+    return beg;
+}
+
+// =================================================================================== //
+
+void benchmark001(uint64_t targetOctants, uint32_t nLookups) {
+
+    /**<Instantation of a 3D para_tree object.*/
+    ParaTree pablo(3);
+
+    /**<Refine globally until the next global refinement overcomes the target size.*/
+    while (uint64_t(pablo.getNumOctants())*8 <= targetOctants){
+        pablo.adaptGlobalRefine();
+    }
+
+    /**<Refine the first octants (in Morton order) to reach the target size.*/
+    uint32_t nocts = pablo.getNumOctants();
+    uint64_t nRefine = (targetOctants - nocts)/7;
+    for (uint32_t i=0; i<nRefine && i<nocts; i++){
+        pablo.setMarker(i, 1);
+    }
+    pablo.adapt();
+    nocts = pablo.getNumOctants();
+
+    cout << " Number of octants : " << nocts << endl;
+
+    /**<Build the lookup queries (pseudo-random octants).*/
+    vector<Octant> queries(nLookups);
+    uint64_t seed = 12345;
+    for (uint32_t i=0; i<nLookups; i++){
+        seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+        queries[i] = *pablo.getOctant(uint32_t((seed >> 33) % nocts));
+    }
+
+    /**<Lookups recomputing the Morton number at every probe.*/
+    uint64_t checksumOld = 0;
+    chrono::high_resolution_clock::time_point t0 = chrono::high_resolution_clock::now();
+    for (uint32_t i=0; i<nLookups; i++){
+        checksumOld += searchRecomputingMorton(pablo, pablo.getMorton(&queries[i]));
+    }
+    chrono::high_resolution_clock::time_point t1 = chrono::high_resolution_clock::now();
+
+    /**<Lookups through the Morton numbers cached in the local tree.*/
+    uint64_t checksumNew = 0;
+    chrono::high_resolution_clock::time_point t2 = chrono::high_resolution_clock::now();
+    for (uint32_t i=0; i<nLookups; i++){
+        checksumNew += pablo.getIdx(queries[i]);
+    }
+    chrono::high_resolution_clock::time_point t3 = chrono::high_resolution_clock::now();
+
+    double timeOld = chrono::duration<double>(t1 - t0).count();
+    double timeNew = chrono::duration<double>(t3 - t2).count();
+
+    cout << " Lookups                          : " << nLookups << endl;
+    cout << " Recomputed Morton  [Mlookup/s]   : " << nLookups/timeOld*1.0e-6 << endl;
+    cout << " Cached Morton      [Mlookup/s]   : " << nLookups/timeNew*1.0e-6 << endl;
+    cout << " Speedup                          : " << timeOld/timeNew << endl;
+    cout << " Checksums                        : " << checksumOld << " " << checksumNew << endl;
+
+    return ;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+
+	{
+#endif
+		/**<Target number of octants and lookups (optionally from command line)*/
+		uint64_t targetOctants = 10000000;
+		uint32_t nLookups = 1000000;
+		if (argc > 1) targetOctants = strtoull(argv[1], NULL, 10);
+		if (argc > 2) nLookups = strtoul(argv[2], NULL, 10);
+
+		/**<Calling Pablo Benchmark routines*/
+
+        benchmark001(targetOctants, nLookups) ;
+
+#if ENABLE_MPI==1
+	}
+
+	MPI::Finalize();
+#endif
+}
@@ -0,0 +1,137 @@
+#include "ParaTree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+#if ENABLE_MPI==1
+// =================================================================================== //
+
+/**<User data communication as in examples/UserDataComm (variable size interface),
+ * or with a fixed size, for a field with stride doubles per octant.*/
+class FieldComm : public DataCommInterface<FieldComm> {
+public:
+    dvector & data;
+    dvector & ghostData;
+    size_t stride;
+    bool fixed;
+
+    FieldComm(dvector & data_, dvector & ghostData_, size_t stride_, bool fixed_) : data(data_), ghostData(ghostData_), stride(stride_), fixed(fixed_){};
+
+    size_t fixedSize() const {return (fixed ? stride*sizeof(double) : 0);};
+    size_t size(const uint32_t) const {return stride*sizeof(double);};
+
+    template<class Buffer>
+    void gather(Buffer & buff, const uint32_t e){
+        for (size_t k=0; k<stride; k++) buff.write(data[e*stride+k]);
+    };
+
+    template<class Buffer>
+    void scatter(Buffer & buff, const uint32_t e){
+        for (size_t k=0; k<stride; k++) buff.read(ghostData[e*stride+k]);
+    };
+};
+#endif
+
+// =================================================================================== //
+
+void benchmark002(int nrefs, size_t stride, int nupdates) {
+
+    /**<Instantation of a 3D para_tree object.*/
+    ParaTree pablo(3);
+
+    /**<Refine globally.*/
+    for (int iter=0; iter<nrefs; iter++){
+        pablo.adaptGlobalRefine();
+    }
+
+#if ENABLE_MPI==1
+    /**<PARALLEL TEST: Call loadBalance, the octree is now distributed over the processes.*/
+    pablo.loadBalance();
+
+    uint32_t nocts = pablo.getNumOctants();
+    uint32_t nghosts = pablo.getNumGhosts();
+    dvector data(nocts*stride);
+    for (uint32_t i=0; i<nocts*stride; i++){
+        data[i] = double(pablo.getGlobalIdx(uint32_t(i/stride)))*stride + i%stride;
+    }
+
+    if (pablo.getRank() == 0){
+        cout << " Number of octants (rank 0) : " << nocts << endl;
+        cout << " Number of ghosts (rank 0)  : " << nghosts << endl;
+        cout << " Values per octant          : " << stride << endl;
+    }
+
+    /**<Ghost updates through the user interface (variable and fixed size), the POD arrays
+     * and the POD arrays in the memory window shared by the processes of the node.*/
+    dvector ghostVariable(nghosts*stride), ghostFixed(nghosts*stride), ghostPod(nghosts*stride), ghostShared(nghosts*stride);
+    double* sharedData = pablo.allocateSharedData<double>(stride);
+    copy(data.begin(), data.end(), sharedData);
+    FieldComm variableComm(data, ghostVariable, stride, false);
+    FieldComm fixedComm(data, ghostFixed, stride, true);
+
+    double times[4];
+    for (int method=0; method<4; method++){
+        MPI_Barrier(pablo.getComm());
+        chrono::high_resolution_clock::time_point t0 = chrono::high_resolution_clock::now();
+        for (int k=0; k<nupdates; k++){
+            if (method == 0) pablo.communicate(variableComm);
+            else if (method == 1) pablo.communicate(fixedComm);
+            else if (method == 2) pablo.communicate(data, ghostPod, stride);
+            else pablo.communicate(sharedData, ghostShared.data(), stride);
+        }
+        MPI_Barrier(pablo.getComm());
+        chrono::high_resolution_clock::time_point t1 = chrono::high_resolution_clock::now();
+        times[method] = chrono::duration<double>(t1 - t0).count()/nupdates;
+    }
+
+    int mismatches = 0;
+    for (uint32_t i=0; i<nghosts*stride; i++){
+        if (ghostVariable[i] != ghostPod[i] || ghostFixed[i] != ghostPod[i] || ghostShared[i] != ghostPod[i]) mismatches++;
+    }
+    int globalMismatches = 0;
+    MPI_Allreduce(&mismatches, &globalMismatches, 1, MPI_INT, MPI_SUM, pablo.getComm());
+
+    if (pablo.getRank() == 0){
+        cout << " Variable size interface [ms/update] : " << times[0]*1.0e3 << endl;
+        cout << " Fixed size interface    [ms/update] : " << times[1]*1.0e3 << endl;
+        cout << " POD arrays              [ms/update] : " << times[2]*1.0e3 << endl;
+        cout << " POD arrays (shared)     [ms/update] : " << times[3]*1.0e3 << endl;
+        cout << " Speedup vs variable / fixed         : " << times[0]/times[2] << " " << times[1]/times[2] << endl;
+        cout << " Mismatches                          : " << globalMismatches << endl;
+    }
+    pablo.freeSharedBuffer();
+#endif
+
+    return ;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+
+	{
+#endif
+		/**<Global refinements, values per octant and ghost updates (optionally from command line)*/
+		int nrefs = 6;
+		size_t stride = 5;
+		int nupdates = 50;
+		if (argc > 1) nrefs = atoi(argv[1]);
+		if (argc > 2) stride = strtoul(argv[2], NULL, 10);
+		if (argc > 3) nupdates = atoi(argv[3]);
+
+		/**<Calling Pablo Benchmark routines*/
+
+        benchmark002(nrefs, stride, nupdates) ;
+
+#if ENABLE_MPI==1
+	}
+
+	MPI::Finalize();
+#endif
+}
@@ -0,0 +1,156 @@
+#include "ParaTree.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Velocity of the transported field.*/
+static const darray3 velocity = {{1.0, 0.5, 0.25}};
+
+/**<Face-flux sweep reading each intersection through the ParaTree getters
+ * (geometry recomputed at every call).*/
+void sweepGetters(ParaTree & pablo, const dvector & phi, const dvector & ghostPhi, dvector & residual) {
+
+    uint32_t nintersections = pablo.getNumIntersections();
+    for (uint32_t i=0; i<nintersections; i++){
+        Intersection* inter = pablo.getIntersection(i);
+        if (pablo.getBound(inter)) continue;
+        uint32_t in = pablo.getIn(inter);
+        uint32_t out = pablo.getOut(inter);
+        bool ghost = pablo.getIsGhost(inter);
+        darray3 normal = pablo.getNormal(inter);
+        double un = normal[0]*velocity[0] + normal[1]*velocity[1] + normal[2]*velocity[2];
+        double phiOut = ghost ? ghostPhi[out] : phi[out];
+        double flux = pablo.getArea(inter)*un*0.5*(phi[in] + phiOut);
+        residual[in] -= flux;
+        if (!ghost) residual[out] += flux;
+    }
+}
+
+/**<Face-flux sweep streaming the structure of arrays of the intersections.*/
+void sweepStore(const IntersectionStore & store, const dvector & phi, const dvector & ghostPhi, dvector & residual) {
+
+    uint32_t nintersections = store.size();
+    const uint8_t* flags = store.getFlags();
+    const double* areas = store.getAreas();
+    const double* nx = store.getNormals(0);
+    const double* ny = store.getNormals(1);
+    const double* nz = store.getNormals(2);
+    for (uint32_t i=0; i<nintersections; i++){
+        if (flags[i] & IntersectionStore::BOUND) continue;
+        uint32_t in = store.getIn(i);
+        uint32_t out = store.getOut(i);
+        bool ghost = (flags[i] & IntersectionStore::GHOST) != 0;
+        double un = nx[i]*velocity[0] + ny[i]*velocity[1] + nz[i]*velocity[2];
+        double phiOut = ghost ? ghostPhi[out] : phi[out];
+        double flux = areas[i]*un*0.5*(phi[in] + phiOut);
+        residual[in] -= flux;
+        if (!ghost) residual[out] += flux;
+    }
+}
+
+// =================================================================================== //
+
+void benchmark003(int nrefs, int nsweeps) {
+
+    /**<Instantation of a 3D para_tree object.*/
+    ParaTree pablo(3);
+
+    /**<Refine globally, then refine the octants near a corner.*/
+    for (int iter=0; iter<nrefs; iter++){
+        pablo.adaptGlobalRefine();
+    }
+    uint32_t nocts = pablo.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = pablo.getCenter(i);
+        if (center[0] + center[1] + center[2] < 0.75) pablo.setMarker(i, 1);
+    }
+    pablo.adapt();
+
+#if ENABLE_MPI==1
+    /**<PARALLEL TEST: Call loadBalance, the octree is now distributed over the processes.*/
+    pablo.loadBalance();
+#endif
+
+    nocts = pablo.getNumOctants();
+    uint32_t nghosts = pablo.getNumGhosts();
+    dvector phi(nocts), ghostPhi(nghosts);
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = pablo.getCenter(i);
+        phi[i] = center[0] + 2.0*center[1] + 3.0*center[2];
+    }
+    for (uint32_t i=0; i<nghosts; i++){
+        Octant ghost = *pablo.getGhostOctant(i);
+        darray3 center = pablo.getCenter(&ghost);
+        ghostPhi[i] = center[0] + 2.0*center[1] + 3.0*center[2];
+    }
+
+    /**<Intersections and their structure of arrays.*/
+    pablo.setIntersectionStore(true);
+    chrono::high_resolution_clock::time_point t0 = chrono::high_resolution_clock::now();
+    pablo.computeIntersections();
+    chrono::high_resolution_clock::time_point t1 = chrono::high_resolution_clock::now();
+    const IntersectionStore & store = pablo.getStoredIntersections();
+
+    /**<Sweeps over both layouts.*/
+    dvector residualGetters(nocts, 0.0), residualStore(nocts, 0.0);
+    chrono::high_resolution_clock::time_point t2 = chrono::high_resolution_clock::now();
+    for (int k=0; k<nsweeps; k++){
+        sweepGetters(pablo, phi, ghostPhi, residualGetters);
+    }
+    chrono::high_resolution_clock::time_point t3 = chrono::high_resolution_clock::now();
+    for (int k=0; k<nsweeps; k++){
+        sweepStore(store, phi, ghostPhi, residualStore);
+    }
+    chrono::high_resolution_clock::time_point t4 = chrono::high_resolution_clock::now();
+
+    double timeBuild = chrono::duration<double>(t1 - t0).count();
+    double timeGetters = chrono::duration<double>(t3 - t2).count()/nsweeps;
+    double timeStore = chrono::duration<double>(t4 - t3).count()/nsweeps;
+
+    uint32_t mismatches = 0;
+    for (uint32_t i=0; i<nocts; i++){
+        if (residualGetters[i] != residualStore[i]) mismatches++;
+    }
+
+    if (pablo.getRank() == 0){
+        cout << " Number of octants (rank 0)       : " << nocts << endl;
+        cout << " Number of intersections (rank 0) : " << store.size() << endl;
+        cout << " Intersections and store    [ms]  : " << timeBuild*1.0e3 << endl;
+        cout << " Getters sweep        [ms/sweep]  : " << timeGetters*1.0e3 << endl;
+        cout << " Store sweep          [ms/sweep]  : " << timeStore*1.0e3 << endl;
+        cout << " Speedup                          : " << timeGetters/timeStore << endl;
+        cout << " Mismatches (rank 0)              : " << mismatches << endl;
+    }
+
+    return ;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+
+	{
+#endif
+		/**<Global refinements and sweeps (optionally from command line)*/
+		int nrefs = 5;
+		int nsweeps = 20;
+		if (argc > 1) nrefs = atoi(argv[1]);
+		if (argc > 2) nsweeps = atoi(argv[2]);
+
+		/**<Calling Pablo Benchmark routines*/
+
+        benchmark003(nrefs, nsweeps) ;
+
+#if ENABLE_MPI==1
+	}
+
+	MPI::Finalize();
+#endif
+}
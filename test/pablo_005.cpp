@@ -0,0 +1,107 @@
+#include "ParaTree.hpp"
+#include <iostream>
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Check that a set of coordinates is encoded and decoded bit-for-bit in the
+ * same way by all the Morton backends. Return the number of mismatches.*/
+int checkMorton(const vector<MortonBackend> & backends, uint32_t x, uint32_t y, uint32_t z) {
+
+    int nerrors = 0;
+
+    uint64_t ref3D = mortonEncode_magicbits(x, y, z);
+    uint64_t ref2D = mortonEncode_magicbits(x, y);
+    for (MortonBackend backend : backends){
+        setMortonBackend(backend);
+
+        uint32_t dx, dy, dz;
+        if (mortonEncode(x, y, z) != ref3D) nerrors++;
+        mortonDecode(ref3D, dx, dy, dz);
+        if (dx != x || dy != y || dz != z) nerrors++;
+
+        if (mortonEncode(x, y) != ref2D) nerrors++;
+        mortonDecode(ref2D, dx, dy);
+        if (dx != x || dy != y) nerrors++;
+    }
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int test005() {
+
+    /**<Backends supported by the running CPU.*/
+    MortonBackend defaultBackend = getMortonBackend();
+    vector<MortonBackend> backends;
+    backends.push_back(MORTON_MAGICBITS);
+    backends.push_back(MORTON_LUT);
+    if (isMortonBackendSupported(MORTON_BMI2)){
+        backends.push_back(MORTON_BMI2);
+    }
+    cout << " Number of Morton backends tested : " << backends.size() << endl;
+
+    /**<Logical coordinates go from 0 to 2^maxlevel (nodes included).*/
+    ParaTree pablo105(3);
+    uint32_t maxLength = pablo105.getMaxLength();
+
+    int nerrors = 0;
+
+    /**<Sweep the whole range along each direction.*/
+    uint64_t seed = 12345;
+    for (uint32_t i=0; i<=maxLength; i++){
+        seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+        uint32_t r = uint32_t(seed >> 33) % (maxLength + 1);
+        nerrors += checkMorton(backends, i, r, maxLength - i);
+        nerrors += checkMorton(backends, r, maxLength - i, i);
+        nerrors += checkMorton(backends, maxLength - i, i, r);
+    }
+
+    /**<Edge values, all the bits used by the 3D keys set.*/
+    nerrors += checkMorton(backends, 0x1fffff, 0x1fffff, 0x1fffff);
+    nerrors += checkMorton(backends, 0x155555, 0x0aaaaa, 0x1fffff);
+
+    /**<The Morton numbers of the octants do not depend on the backend.*/
+    for (int iter=0; iter<5; iter++){
+        pablo105.adaptGlobalRefine();
+    }
+    uint32_t nocts = pablo105.getNumOctants();
+    setMortonBackend(MORTON_MAGICBITS);
+    vector<uint64_t> mortons(nocts);
+    for (uint32_t i=0; i<nocts; i++){
+        mortons[i] = pablo105.getMorton(i);
+    }
+    for (MortonBackend backend : backends){
+        setMortonBackend(backend);
+        for (uint32_t i=0; i<nocts; i++){
+            Octant octant = *pablo105.getOctant(i);
+            if (pablo105.getMorton(&octant) != mortons[i]) nerrors++;
+        }
+    }
+
+    setMortonBackend(defaultBackend);
+
+    cout << " Number of mismatches : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = test005();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
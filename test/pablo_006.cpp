@@ -0,0 +1,155 @@
+#include "ParaTree.hpp"
+#include "PabloUniform.hpp"
+#include <iostream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Collect the intersections of a tree as (in, out, face, flags) tuples
+ * (computed from scratch if recompute is true).*/
+vector<array<uint32_t, 4> > collectIntersections(ParaTree & pablo, bool recompute = true) {
+
+    if (recompute) pablo.clearIntersections();
+    pablo.computeIntersections();
+
+    uint32_t nintersections = pablo.getNumIntersections();
+    vector<array<uint32_t, 4> > intersections(nintersections);
+    for (uint32_t i=0; i<nintersections; i++){
+        Intersection* inter = pablo.getIntersection(i);
+        uint32_t flags = pablo.getFiner(inter) + 2*pablo.getBound(inter) + 4*pablo.getIsGhost(inter) + 8*pablo.getPbound(inter);
+        intersections[i] = {{pablo.getIn(inter), pablo.getOut(inter), pablo.getFace(inter), flags}};
+    }
+
+    return intersections;
+}
+
+/**<Compare the structure of arrays of the intersections of a tree (a para_tree
+ * or a pablo uniform object) with the getters of each intersection.
+ * Return the number of mismatches.*/
+template<class Tree>
+int checkStore(Tree & pablo) {
+
+    const IntersectionStore & store = pablo.getStoredIntersections();
+    uint32_t nintersections = pablo.getNumIntersections();
+    int nmismatches = (store.size() == nintersections) ? 0 : 1;
+    for (uint32_t i=0; i<nintersections && i<store.size(); i++){
+        Intersection* inter = pablo.getIntersection(i);
+        darray3 center = pablo.getCenter(inter);
+        darray3 normal = pablo.getNormal(inter);
+        uint32_t flags = pablo.getFiner(inter)*IntersectionStore::FINER + pablo.getBound(inter)*IntersectionStore::BOUND
+                + pablo.getIsGhost(inter)*IntersectionStore::GHOST + pablo.getPbound(inter)*IntersectionStore::PBOUND;
+        if (store.getIn(i) != pablo.getIn(inter) || store.getOut(i) != pablo.getOut(inter)) nmismatches++;
+        if (store.getFaces()[i] != pablo.getFace(inter) || store.getFlags()[i] != flags) nmismatches++;
+        if (store.getAreas()[i] != pablo.getArea(inter)) nmismatches++;
+        for (int k=0; k<3; k++){
+            if (store.getCenters(k)[i] != center[k] || store.getNormals(k)[i] != normal[k]) nmismatches++;
+        }
+
+        /**<The area of a face of a 3D tree is the square of its size.*/
+        double size = pablo.getSize(inter);
+        if (pablo.getArea(inter) != size*size) nmismatches++;
+    }
+
+    return nmismatches;
+}
+
+// =================================================================================== //
+
+int test006() {
+
+    /**<Instantation of a 3D para_tree object and non-uniform refinement.*/
+    ParaTree pablo106(3);
+    for (int iter=0; iter<4; iter++){
+        pablo106.adaptGlobalRefine();
+    }
+
+    uint64_t seed = 12345;
+    for (int iter=0; iter<2; iter++){
+        uint32_t nocts = pablo106.getNumOctants();
+        for (uint32_t i=0; i<nocts; i++){
+            seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+            if ((seed >> 33) % 4 == 0) pablo106.setMarker(i, 1);
+        }
+        pablo106.adapt();
+    }
+    cout << " Number of octants : " << pablo106.getNumOctants() << endl;
+
+    /**<The intersections computed by one and several threads are the same, in the same order.*/
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = max(4, omp_get_max_threads());
+    omp_set_num_threads(1);
+#endif
+    vector<array<uint32_t, 4> > serial = collectIntersections(pablo106);
+
+#ifdef _OPENMP
+    omp_set_num_threads(nthreads);
+#endif
+    vector<array<uint32_t, 4> > threaded = collectIntersections(pablo106);
+
+    cout << " Number of threads : " << nthreads << endl;
+    cout << " Number of intersections : " << serial.size() << " " << threaded.size() << endl;
+
+    /**<The structure of arrays of the intersections stores the values of the getters.*/
+    pablo106.setIntersectionStore(true);
+    pablo106.computeIntersections();
+    int nmismatches = checkStore(pablo106);
+
+    /**<The store of a pablo uniform object with a custom domain holds the physical
+     * geometry, also after a change of the domain.*/
+    PabloUniform uniform106(-1.0, 2.0, 0.5, 3.0, 3);
+    for (int iter=0; iter<3; iter++){
+        uniform106.adaptGlobalRefine();
+    }
+    uint32_t nocts = uniform106.getNumOctants();
+    for (uint32_t i=0; i<nocts; i+=5){
+        uniform106.setMarker(i, 1);
+    }
+    uniform106.adapt();
+    uniform106.setIntersectionStore(true);
+    uniform106.computeIntersections();
+    nmismatches += checkStore(uniform106);
+    uniform106.setL(2.0);
+    nmismatches += checkStore(uniform106);
+    cout << " Intersection store mismatches : " << nmismatches << endl;
+
+    /**<The intersections updated by adapt with mapper are the same of the ones computed
+     * from scratch, also with few changed octants.*/
+    int nupdates = 0;
+    for (int iter=0; iter<3; iter++){
+        uint32_t nocts = pablo106.getNumOctants();
+        for (uint32_t i=0; i<nocts; i++){
+            seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+            if ((seed >> 33) % (iter == 2 ? 500 : 8) == 0) pablo106.setMarker(i, (iter == 1) ? -1 : 1);
+        }
+        pablo106.adapt(true);
+        vector<array<uint32_t, 4> > updated = collectIntersections(pablo106, false);
+        vector<array<uint32_t, 4> > computed = collectIntersections(pablo106);
+        if (updated != computed || pablo106.getStoredIntersections().size() != computed.size()) nupdates++;
+    }
+    cout << " Intersection update mismatches : " << nupdates << endl;
+
+    return (serial == threaded && nmismatches == 0 && nupdates == 0) ? 0 : 1;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = test006();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return status;
+}
@@ -0,0 +1,129 @@
+#include "ParaTree.hpp"
+#include "PabloUniform.hpp"
+#include <iostream>
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Compare the bulk geometry of the octants with the geometry of each octant
+ * (of a para_tree or of a pablo uniform object). Return the number of mismatches.*/
+template<class Tree>
+int checkGeometry(Tree & pablo) {
+
+    int nerrors = 0;
+
+    uint32_t nocts = pablo.getNumOctants();
+    dvector x(nocts), y(nocts), z(nocts), sizes(nocts), volumes(nocts);
+    pablo.getCenters(0, nocts, x.data(), y.data(), z.data());
+    pablo.getSizes(0, nocts, sizes.data());
+    pablo.getVolumes(0, nocts, volumes.data());
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = pablo.getCenter(i);
+        if (x[i] != center[0] || y[i] != center[1]) nerrors++;
+        if (pablo.getDim() == 3 && z[i] != center[2]) nerrors++;
+        if (sizes[i] != pablo.getSize(i) || volumes[i] != pablo.getVolume(i)) nerrors++;
+    }
+
+    /**<A range in the middle of the octants.*/
+    uint32_t begin = nocts/3, end = 2*nocts/3;
+    dvector xr(end - begin), yr(end - begin), zr(end - begin);
+    pablo.getCenters(begin, end, xr.data(), yr.data(), zr.data());
+    for (uint32_t i=begin; i<end; i++){
+        if (xr[i-begin] != x[i] || yr[i-begin] != y[i] || zr[i-begin] != z[i]) nerrors++;
+    }
+
+    /**<The cache stores the same values.*/
+    if (pablo.getGeometryCache()){
+        if (pablo.getCachedCenters(0) != x || pablo.getCachedCenters(1) != y || pablo.getCachedCenters(2) != z) nerrors++;
+        if (pablo.getCachedSizes() != sizes || pablo.getCachedVolumes() != volumes) nerrors++;
+    }
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int test007() {
+
+    int nerrors = 0;
+
+    for (uint8_t dim=2; dim<=3; dim++){
+
+        /**<Instantation of a para_tree object and non-uniform refinement.*/
+        ParaTree pablo107(dim);
+        for (int iter=0; iter<4; iter++){
+            pablo107.adaptGlobalRefine();
+        }
+        nerrors += checkGeometry(pablo107);
+
+        /**<Enable the geometry cache, then adapt: the cache is recomputed.*/
+        pablo107.setGeometryCache(true);
+        nerrors += checkGeometry(pablo107);
+        uint64_t seed = 12345;
+        for (int iter=0; iter<2; iter++){
+            uint32_t nocts = pablo107.getNumOctants();
+            for (uint32_t i=0; i<nocts; i++){
+                seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+                if ((seed >> 33) % 4 == 0) pablo107.setMarker(i, 1);
+            }
+            pablo107.adapt();
+            if (pablo107.getCachedSizes().size() != pablo107.getNumOctants()) nerrors++;
+            nerrors += checkGeometry(pablo107);
+        }
+
+        /**<Disable the cache, its memory is freed.*/
+        pablo107.setGeometryCache(false);
+        if (!pablo107.getCachedVolumes().empty()) nerrors++;
+        nerrors += checkGeometry(pablo107);
+
+        /**<Instantation of a pablo uniform object with a custom domain: the bulk
+         * geometry and its cache are in the physical domain.*/
+        darray3 origin = {{-1.0, 2.0, 0.5}};
+        double L = 3.0;
+        PabloUniform uniform107(origin[0], origin[1], origin[2], L, dim);
+        for (int iter=0; iter<4; iter++){
+            uniform107.adaptGlobalRefine();
+        }
+        uniform107.setGeometryCache(true);
+        nerrors += checkGeometry(uniform107);
+        uint32_t nocts = uniform107.getNumOctants();
+        for (uint32_t i=0; i<nocts; i++){
+            if (uniform107.getCachedSizes()[i] != L*uniform107.ParaTree::getSize(i)) nerrors++;
+            if (uniform107.getCachedCenters(0)[i] != origin[0] + L*uniform107.ParaTree::getCenter(i)[0]) nerrors++;
+            if (uniform107.getCachedVolumes()[i] != L*L*(dim == 3 ? L : 1.0)*uniform107.ParaTree::getVolume(i)) nerrors++;
+            if (i % 3 == 0) uniform107.setMarker(i, 1);
+        }
+        uniform107.adapt();
+        nerrors += checkGeometry(uniform107);
+
+        /**<A new domain updates the cache.*/
+        uniform107.setL(2.0);
+        uniform107.setOrigin({{1.0, 1.0, 1.0}});
+        nerrors += checkGeometry(uniform107);
+        uniform107.setGeometryCache(false);
+        nerrors += checkGeometry(uniform107);
+    }
+
+    cout << " Number of mismatches : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = test007();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
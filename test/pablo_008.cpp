@@ -0,0 +1,103 @@
+#include "ParaTree.hpp"
+#include <iostream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Count the face neighbours whose levels differ by more than one.*/
+int checkBalance21(ParaTree & pablo) {
+
+    int nerrors = 0;
+
+    u32vector neigh;
+    vector<bool> isghost;
+    uint32_t nocts = pablo.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        for (uint8_t iface=0; iface<2*pablo.getDim(); iface++){
+            pablo.findNeighbours(i, iface, 1, neigh, isghost);
+            for (size_t k=0; k<neigh.size(); k++){
+                int level = isghost[k] ? pablo.getLevel(pablo.getGhostOctant(neigh[k])) : pablo.getLevel(neigh[k]);
+                if (abs(level - int(pablo.getLevel(i))) > 1) nerrors++;
+            }
+        }
+    }
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+/**<Refine scattered octants several times and adapt with the 2:1 balance
+ * using nthreads threads. Return the Morton indices and the levels of the octants.*/
+vector<pair<uint64_t, uint8_t> > balancedOctants(uint8_t dim, int nthreads, int & nerrors) {
+
+#ifdef _OPENMP
+    omp_set_num_threads(nthreads);
+#endif
+
+    /**<Instantation of a para_tree object.*/
+    ParaTree pablo108(dim);
+    for (int iter=0; iter<((dim == 2) ? 7 : 5); iter++){
+        pablo108.adaptGlobalRefine();
+    }
+
+    /**<Refinement of scattered octants, the balance refines the fronts around them.*/
+    uint64_t seed = 12345;
+    for (int iter=0; iter<3; iter++){
+        uint32_t nocts = pablo108.getNumOctants();
+        for (uint32_t i=0; i<nocts; i++){
+            seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+            if ((seed >> 33) % 50 == 0) pablo108.setMarker(i, 1);
+        }
+        pablo108.adapt();
+        nerrors += checkBalance21(pablo108);
+    }
+
+    uint32_t nocts = pablo108.getNumOctants();
+    vector<pair<uint64_t, uint8_t> > octants(nocts);
+    for (uint32_t i=0; i<nocts; i++){
+        octants[i] = make_pair(pablo108.getMorton(i), pablo108.getLevel(i));
+    }
+
+    return octants;
+}
+
+// =================================================================================== //
+
+int test008() {
+
+    int nerrors = 0;
+
+    /**<The balanced tree is the same with one and with several threads.*/
+    for (uint8_t dim=2; dim<=3; dim++){
+        vector<pair<uint64_t, uint8_t> > serial = balancedOctants(dim, 1, nerrors);
+        vector<pair<uint64_t, uint8_t> > threaded = balancedOctants(dim, 4, nerrors);
+        if (serial != threaded) nerrors++;
+    }
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = test008();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
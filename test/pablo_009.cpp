@@ -0,0 +1,61 @@
+#include "ParaTree.hpp"
+#include <iostream>
+
+using namespace std;
+
+// =================================================================================== //
+
+int test009() {
+
+    int nerrors = 0;
+
+    /**<An octant stores coordinates, info flags, level and marker in 16 bytes.*/
+    if (sizeof(Octant) != 16) nerrors++;
+
+    for (uint8_t dim=2; dim<=3; dim++){
+
+        /**<Instantation of a para_tree object.*/
+        ParaTree pablo109(dim);
+
+        for (int iter=0; iter<((dim == 2) ? 6 : 4); iter++){
+            pablo109.adaptGlobalRefine();
+        }
+
+        /**<The footprint counts at least the octants and their Morton numbers.*/
+        uint64_t nocts = pablo109.getNumOctants();
+        uint64_t bytes = pablo109.getMemoryFootprint();
+        if (bytes < nocts*(sizeof(Octant) + sizeof(uint64_t))) nerrors++;
+
+        /**<The connectivity is counted when it is built and released when it is cleared.*/
+        pablo109.computeConnectivity();
+        uint64_t nnodes = pablo109.getNumNodes();
+        uint64_t connectivityBytes = pablo109.getMemoryFootprint();
+        if (connectivityBytes < bytes + nocts*pablo109.getNnodes()*sizeof(uint32_t) + nnodes*sizeof(u32array3)) nerrors++;
+        pablo109.clearConnectivity();
+        if (pablo109.getMemoryFootprint() >= connectivityBytes) nerrors++;
+
+        pablo109.writeMemoryFootprint();
+    }
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = test009();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include "ParaTree.hpp"
+#include <iostream>
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Compare the neighbours of every face, edge and node of the local octants of a tree
+ * with the neighbour cache with the ones of a tree without the cache.*/
+int compareNeighbours(ParaTree & cached, ParaTree & uncached) {
+
+    int nerrors = 0;
+    if (!cached.getNeighbourCache() || uncached.getNeighbourCache()) nerrors++;
+    if (cached.getNumOctants() != uncached.getNumOctants()) return nerrors + 1;
+
+    uint8_t dim = cached.getDim();
+    uint32_t nocts = cached.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        for (uint8_t codim=1; codim<=dim; codim++){
+            uint8_t nentities = (codim == 1) ? cached.getNfaces() : ((codim == dim) ? cached.getNnodes() : cached.getNedges());
+            for (uint8_t ientity=0; ientity<nentities; ientity++){
+                u32vector neighbours, uncachedNeighbours;
+                bvector isghost, uncachedIsghost;
+                cached.findNeighbours(i, ientity, codim, neighbours, isghost);
+                uncached.findNeighbours(i, ientity, codim, uncachedNeighbours, uncachedIsghost);
+                if (neighbours != uncachedNeighbours || isghost != uncachedIsghost) nerrors++;
+            }
+        }
+    }
+
+    return nerrors;
+}
+
+/**<Set the same markers on two trees: refine the octants of a corner and coarsen the
+ * octants of the opposite one.*/
+void setMarkers(ParaTree & cached, ParaTree & uncached, bool refine) {
+
+    uint32_t nocts = cached.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = cached.getCenter(i);
+        int8_t marker = 0;
+        if (refine && center[0] < 0.4 && center[1] < 0.3) marker = 1;
+        if (!refine && center[0] > 0.6 && center[1] > 0.5) marker = -1;
+        cached.setMarker(i, marker);
+        uncached.setMarker(i, marker);
+    }
+}
+
+// =================================================================================== //
+
+int test010() {
+
+    int nerrors = 0;
+
+    for (uint8_t dim=2; dim<=3; dim++){
+
+        /**<Instantation of two para_tree objects, the first one caches the neighbours
+         * of faces, edges and nodes.*/
+        ParaTree cached(dim), uncached(dim);
+        cached.setNeighbourCache(true, dim);
+
+        for (int iter=0; iter<((dim == 2) ? 5 : 3); iter++){
+            cached.adaptGlobalRefine();
+            uncached.adaptGlobalRefine();
+        }
+        nerrors += compareNeighbours(cached, uncached);
+
+        /**<The cache is patched through the mapper by adapt(true) and rebuilt by adapt(false).*/
+        for (int iter=0; iter<4; iter++){
+            bool mapper = (iter%2 == 0);
+            setMarkers(cached, uncached, iter < 2);
+            cached.adapt(mapper);
+            uncached.adapt(mapper);
+            nerrors += compareNeighbours(cached, uncached);
+        }
+    }
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = test010();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
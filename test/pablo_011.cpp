@@ -0,0 +1,107 @@
+#include "ParaTree.hpp"
+#include <iostream>
+#include <set>
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Compare the flat connectivity of a tree, through its view, with the nested
+ * compatibility accessors, the node numbering and the coordinates of the nodes.*/
+int checkConnectivity(ParaTree & pablo) {
+
+    int nerrors = 0;
+
+    uint32_t nocts = pablo.getNumOctants();
+    uint32_t nnodes = pablo.getNumNodes();
+    uint8_t stride = pablo.getNnodes();
+    ConnectivityView view = pablo.getConnectivityView();
+    const u32vector2D & nested = pablo.getConnectivity();
+    const u32arr3vector & nodes = pablo.getNodes();
+    if (view.size() != nocts || view.getStride() != stride || nested.size() != nocts || nodes.size() != nnodes) return nerrors + 1;
+
+    vector<bool> used(nnodes, false);
+    for (uint32_t i=0; i<nocts; i++){
+        u32vector row = pablo.getConnectivity(i);
+        if (row != nested[i] || row != pablo.getConnectivity(pablo.getOctant(i))) nerrors++;
+        if (!equal(view.begin(i), view.end(i), nested[i].begin())) nerrors++;
+
+        /**<The j-th node of the connectivity is the j-th node of the octant.*/
+        darr3vector octantNodes = pablo.getNodes(i);
+        for (uint8_t j=0; j<stride; j++){
+            uint32_t inode = view[i][j];
+            if (inode >= nnodes) {nerrors++; continue;}
+            used[inode] = true;
+            if (pablo.getNodeCoordinates(inode) != octantNodes[j]) nerrors++;
+            if (pablo.getNodeLogicalCoordinates(inode) != nodes[inode]) nerrors++;
+        }
+    }
+
+    /**<The nodes are numbered without gaps and without duplicates.*/
+    set<u32array3> distinct(nodes.begin(), nodes.end());
+    if (distinct.size() != nnodes) nerrors++;
+    for (uint32_t inode=0; inode<nnodes; inode++){
+        if (!used[inode]) nerrors++;
+    }
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int test011() {
+
+    int nerrors = 0;
+
+    for (uint8_t dim=2; dim<=3; dim++){
+
+        /**<Instantation of a para_tree object.*/
+        ParaTree pablo111(dim);
+
+        for (int iter=0; iter<((dim == 2) ? 4 : 3); iter++){
+            pablo111.adaptGlobalRefine();
+        }
+        pablo111.computeConnectivity();
+        nerrors += checkConnectivity(pablo111);
+
+        /**<Refine the octants of a corner and coarsen the ones of the opposite corner,
+         * then update the connectivity.*/
+        for (int iter=0; iter<2; iter++){
+            uint32_t nocts = pablo111.getNumOctants();
+            for (uint32_t i=0; i<nocts; i++){
+                darray3 center = pablo111.getCenter(i);
+                if (center[0] < 0.3 && center[1] < 0.4) pablo111.setMarker(i, 1);
+                if (center[0] > 0.6 && center[1] > 0.6) pablo111.setMarker(i, -1);
+            }
+            pablo111.adapt();
+            pablo111.updateConnectivity();
+            nerrors += checkConnectivity(pablo111);
+        }
+
+        /**<No connectivity after it is cleared.*/
+        pablo111.clearConnectivity();
+        if (!pablo111.getConnectivityView().empty() || !pablo111.getConnectivity(uint32_t(0)).empty()) nerrors++;
+    }
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = test011();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#include "ParaTree.hpp"
+#include <iostream>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Append the octants (Morton index and level), the max depth, the connectivity
+ * and the nodes of a tree to a state vector.*/
+void appendState(ParaTree & pablo, u64vector & state) {
+
+    uint32_t nocts = pablo.getNumOctants();
+    state.push_back(nocts);
+    state.push_back(pablo.getMaxDepth());
+    for (uint32_t i=0; i<nocts; i++){
+        state.push_back(pablo.getMorton(i));
+        state.push_back(pablo.getLevel(i));
+    }
+
+    pablo.updateConnectivity();
+    ConnectivityView connectivity = pablo.getConnectivityView();
+    state.insert(state.end(), connectivity.data(), connectivity.data() + size_t(connectivity.size())*connectivity.getStride());
+    const u32arr3vector & nodes = pablo.getNodes();
+    for (size_t inode=0; inode<nodes.size(); inode++){
+        state.insert(state.end(), nodes[inode].begin(), nodes[inode].end());
+    }
+}
+
+/**<Check the Morton indices stored by the tree through the search of the owners
+ * of the centers of the octants.*/
+int checkMortons(ParaTree & pablo) {
+
+    int nerrors = 0;
+    uint32_t nocts = pablo.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = pablo.getCenter(i);
+        if (pablo.getPointOwnerIdx(center) != i) nerrors++;
+    }
+
+    return nerrors;
+}
+
+/**<Refine and coarsen a tree globally and locally using nthreads threads.
+ * Return the state of the tree after each step.*/
+u64vector adaptedState(uint8_t dim, int nthreads, int & nerrors) {
+
+#ifdef _OPENMP
+    omp_set_num_threads(nthreads);
+#endif
+
+    /**<Instantation of a para_tree object, the global refinements go beyond the
+     * size thresholds of the multi-threaded loops.*/
+    ParaTree pablo112(dim);
+    for (int iter=0; iter<((dim == 2) ? 7 : 5); iter++){
+        pablo112.adaptGlobalRefine();
+    }
+    u64vector state;
+    appendState(pablo112, state);
+    nerrors += checkMortons(pablo112);
+
+    /**<Refinement of the octants of a corner, the max depth grows.*/
+    uint32_t nocts = pablo112.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = pablo112.getCenter(i);
+        if (center[0] < 0.2 && center[1] < 0.3) pablo112.setMarker(i, 1);
+    }
+    pablo112.adapt();
+    appendState(pablo112, state);
+    nerrors += checkMortons(pablo112);
+
+    /**<Global coarsening, the octants of the corner are coarsened too.*/
+    pablo112.adaptGlobalCoarse();
+    appendState(pablo112, state);
+    nerrors += checkMortons(pablo112);
+
+    pablo112.adaptGlobalRefine();
+    appendState(pablo112, state);
+    nerrors += checkMortons(pablo112);
+
+    return state;
+}
+
+// =================================================================================== //
+
+int test012() {
+
+    int nerrors = 0;
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = max(4, omp_get_max_threads());
+#endif
+    cout << " Number of threads : " << nthreads << endl;
+
+    /**<The refined and coarsened trees, their max depth, Morton indices and connectivity
+     * are the same with one and with several threads.*/
+    for (uint8_t dim=2; dim<=3; dim++){
+        u64vector serial = adaptedState(dim, 1, nerrors);
+        u64vector threaded = adaptedState(dim, nthreads, nerrors);
+        if (serial != threaded) nerrors++;
+    }
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = test012();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
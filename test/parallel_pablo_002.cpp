@@ -0,0 +1,138 @@
+#include "ParaTree.hpp"
+#include <iostream>
+
+using namespace std;
+
+#if ENABLE_MPI==1
+// =================================================================================== //
+
+/**<User data communication of a field of doubles (fixed or variable size).*/
+class FieldComm : public DataCommInterface<FieldComm> {
+public:
+    dvector & data;
+    dvector & ghostData;
+    bool fixed;
+
+    FieldComm(dvector & data_, dvector & ghostData_, bool fixed_) : data(data_), ghostData(ghostData_), fixed(fixed_){};
+
+    size_t fixedSize() const {return (fixed ? sizeof(double) : 0);};
+    size_t size(const uint32_t) const {return sizeof(double);};
+
+    template<class Buffer>
+    void gather(Buffer & buff, const uint32_t e){buff.write(data[e]);};
+
+    template<class Buffer>
+    void scatter(Buffer & buff, const uint32_t e){buff.read(ghostData[e]);};
+};
+
+// =================================================================================== //
+
+/**<Value of the field in an octant.*/
+double field(const darray3 & center, int step) {
+    return center[0] + 10.0*center[1] + 100.0*step;
+}
+#endif
+
+// =================================================================================== //
+
+int testParallel002() {
+
+    int nerrors = 0;
+
+    /**<Instantation of a 2D para_tree object.*/
+    ParaTree pablo22;
+
+    for (int iter=0; iter<5; iter++){
+        pablo22.adaptGlobalRefine();
+    }
+
+#if ENABLE_MPI==1
+    /**<PARALLEL TEST: Call loadBalance, the octree is now distributed over the processes.*/
+    pablo22.loadBalance();
+
+    /**<Refine the octants inside a circle and balance again.*/
+    uint32_t nocts = pablo22.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = pablo22.getCenter(i);
+        if (pow((center[0]-0.5),2.0)+pow((center[1]-0.5),2.0) <= pow(0.25,2.0)){
+            pablo22.setMarker(i, 1);
+        }
+    }
+    pablo22.adapt();
+    pablo22.loadBalance();
+
+    nocts = pablo22.getNumOctants();
+    uint32_t nghosts = pablo22.getNumGhosts();
+
+    /**<Internal and border of process octants are a partition of the local octants.*/
+    uint32_t ninternals = pablo22.getInternalOctantsEnd() - pablo22.getInternalOctantsBegin();
+    uint32_t npborders = pablo22.getPboundOctantsEnd() - pablo22.getPboundOctantsBegin();
+    if (ninternals + npborders != nocts) nerrors++;
+
+    /**<Update the ghosts several times (persistent communications for fixed size data,
+     * POD arrays) overlapping the communication with work on the internal octants.*/
+    dvector data(nocts), ghostData(nghosts);
+    for (int step=0; step<4; step++){
+        bool fixed = (step != 2);
+        for (uint32_t i=0; i<nocts; i++){
+            data[i] = field(pablo22.getCenter(i), step);
+        }
+        ghostData.assign(nghosts, -1.0);
+
+        /**<The last update uses the POD arrays path.*/
+        FieldComm comm(data, ghostData, fixed);
+        if (step < 3) pablo22.communicateBegin(comm);
+        else pablo22.communicateBegin(data.data(), ghostData.data());
+        double volume = 0.0;
+        for (octantIterator it = pablo22.getInternalOctantsBegin(); it != pablo22.getInternalOctantsEnd(); ++it){
+            volume += pablo22.getVolume(*it);
+        }
+        if (step < 3) pablo22.communicateEnd(comm);
+        else pablo22.communicateEnd(data.data(), ghostData.data());
+
+        for (uint32_t i=0; i<nghosts; i++){
+            Octant ghost = *pablo22.getGhostOctant(i);
+            if (ghostData[i] != field(pablo22.getCenter(&ghost), step)) nerrors++;
+        }
+    }
+
+    /**<Update the ghosts of data stored in the memory window shared by the processes of
+     * the node (the ghosts of the same node are read without messages).*/
+    double* sharedData = pablo22.allocateSharedData<double>();
+    for (uint32_t i=0; i<nocts; i++){
+        sharedData[i] = field(pablo22.getCenter(i), 4);
+    }
+    ghostData.assign(nghosts, -1.0);
+    pablo22.communicate(sharedData, ghostData.data());
+    for (uint32_t i=0; i<nghosts; i++){
+        Octant ghost = *pablo22.getGhostOctant(i);
+        if (ghostData[i] != field(pablo22.getCenter(&ghost), 4)) nerrors++;
+    }
+    pablo22.freeSharedBuffer();
+
+    int localErrors = nerrors;
+    MPI_Allreduce(&localErrors, &nerrors, 1, MPI_INT, MPI_SUM, pablo22.getComm());
+#endif
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = testParallel002();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
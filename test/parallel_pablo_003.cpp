@@ -0,0 +1,132 @@
+#include "ParaTree.hpp"
+#include <iostream>
+
+using namespace std;
+
+#if ENABLE_MPI==1
+// =================================================================================== //
+
+/**<Check that the first local octant starts a family of siblings (i.e. it is a first child),
+ * so that no family is split between this process and the previous one.*/
+int checkFirstOctant(ParaTree & pablo) {
+
+    if (pablo.getRank() == 0 || pablo.getNumOctants() == 0) return 0;
+
+    uint8_t level = pablo.getLevel(uint32_t(0));
+    if (level == 0) return 0;
+    /**<Morton indices interleave three coordinates also in 2D.*/
+    uint64_t familyMask = (uint64_t(1) << (3*(pablo.getMaxLevel() - level + 1))) - 1;
+    return ((pablo.getMorton(uint32_t(0)) & familyMask) == 0) ? 0 : 1;
+}
+
+/**<Check that no family of siblings that can be coarsened straddles the boundary
+ * between this process and the previous one: the last octant of the previous
+ * process and the first local octant are not siblings.*/
+int checkStraddlingFamily(ParaTree & pablo) {
+
+    /**<Morton index and level of the last octant of each process (level -1 if empty),
+     * sent to the next process.*/
+    int rank = pablo.getRank(), nproc = pablo.getNproc();
+    uint32_t nocts = pablo.getNumOctants();
+    uint64_t last[2] = {0, uint64_t(-1)}, prevLast[2] = {0, uint64_t(-1)};
+    if (nocts > 0){
+        last[0] = pablo.getMorton(nocts - 1);
+        last[1] = pablo.getLevel(nocts - 1);
+    }
+    int prev = (rank > 0) ? rank - 1 : MPI_PROC_NULL;
+    int next = (rank < nproc - 1) ? rank + 1 : MPI_PROC_NULL;
+    MPI_Sendrecv(last, 2, MPI_UINT64_T, next, 0, prevLast, 2, MPI_UINT64_T, prev, 0, pablo.getComm(), MPI_STATUS_IGNORE);
+
+    if (rank == 0 || nocts == 0 || prevLast[1] == uint64_t(-1)) return 0;
+    uint8_t level = pablo.getLevel(uint32_t(0));
+    if (level == 0 || prevLast[1] != level) return 0;
+    int shift = 3*(pablo.getMaxLevel() - level + 1);
+    return ((pablo.getMorton(uint32_t(0)) >> shift) == (prevLast[0] >> shift)) ? 1 : 0;
+}
+#endif
+
+// =================================================================================== //
+
+int testParallel003() {
+
+    int nerrors = 0;
+
+    /**<Instantation of a 2D para_tree object.*/
+    ParaTree pablo23;
+
+    for (int iter=0; iter<4; iter++){
+        pablo23.adaptGlobalRefine();
+    }
+
+    /**<Refine twice the octants near a corner, families of different levels.*/
+    for (int iter=0; iter<2; iter++){
+        uint32_t nocts = pablo23.getNumOctants();
+        for (uint32_t i=0; i<nocts; i++){
+            darray3 center = pablo23.getCenter(i);
+            if (center[0] + center[1] < 0.6){
+                pablo23.setMarker(i, 1);
+            }
+        }
+        pablo23.adapt();
+    }
+    uint64_t globalNumOctants = pablo23.getGlobalNumOctants();
+
+#if ENABLE_MPI==1
+    /**<PARALLEL TEST: Call loadBalance keeping the families of siblings on the same process.*/
+    pablo23.setPartitionFamilyDepth(1);
+    pablo23.loadBalance();
+    nerrors += checkFirstOctant(pablo23);
+    nerrors += checkStraddlingFamily(pablo23);
+
+    /**<Weighted load balance, the octants near the corner are heavier.*/
+    uint32_t nocts = pablo23.getNumOctants();
+    dvector weight(nocts, 1.0);
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = pablo23.getCenter(i);
+        if (center[0] + center[1] < 0.3) weight[i] = 4.0;
+    }
+    pablo23.setLoadBalanceTolerance(0.02);
+    pablo23.loadBalance(&weight);
+    nerrors += checkFirstOctant(pablo23);
+    nerrors += checkStraddlingFamily(pablo23);
+    if (pablo23.getGlobalNumOctants() != globalNumOctants) nerrors++;
+
+    /**<Load balance keeping compact the families one and two levels over the max depth.*/
+    for (uint8_t level=1; level<=2; level++){
+        nocts = pablo23.getNumOctants();
+        weight.assign(nocts, 1.0);
+        for (uint32_t i=0; i<nocts; i++){
+            darray3 center = pablo23.getCenter(i);
+            if (center[0] + center[1] > 1.2) weight[i] = 3.0;
+        }
+        pablo23.loadBalance(level, &weight);
+        nerrors += checkStraddlingFamily(pablo23);
+        if (pablo23.getGlobalNumOctants() != globalNumOctants) nerrors++;
+    }
+
+    int localErrors = nerrors;
+    MPI_Allreduce(&localErrors, &nerrors, 1, MPI_INT, MPI_SUM, pablo23.getComm());
+#endif
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = testParallel003();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
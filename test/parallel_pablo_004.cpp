@@ -0,0 +1,202 @@
+#include "ParaTree.hpp"
+#include <iostream>
+#include <fstream>
+#include <iterator>
+
+using namespace std;
+
+#if ENABLE_MPI==1
+// =================================================================================== //
+
+/**<User data of a field of doubles (one value per octant) stored in a restart file.*/
+class FieldLB : public DataLBInterface<FieldLB> {
+public:
+    dvector & data;
+    dvector & ghostData;
+
+    FieldLB(dvector & data_, dvector & ghostData_) : data(data_), ghostData(ghostData_){};
+
+    size_t fixedSize() const {return sizeof(double);};
+    size_t size(const uint32_t) const {return sizeof(double);};
+    void move(const uint32_t from, const uint32_t to){data[to] = data[from];};
+
+    template<class Buffer>
+    void gather(Buffer & buff, const uint32_t e){buff.write(data[e]);};
+
+    template<class Buffer>
+    void scatter(Buffer & buff, const uint32_t e){buff.read(data[e]);};
+
+    void assign(uint32_t stride, uint32_t length){data.assign(data.begin() + stride, data.begin() + stride + length);};
+    void resize(uint32_t newSize){data.resize(newSize);};
+    void resizeGhost(uint32_t newSize){ghostData.resize(newSize);};
+    void shrink(){data.shrink_to_fit();};
+};
+
+/**<User data that declare a fixed size different from the size of the gathered data.*/
+class WrongSizeLB : public DataLBInterface<WrongSizeLB> {
+public:
+    dvector & data;
+
+    WrongSizeLB(dvector & data_) : data(data_){};
+
+    size_t fixedSize() const {return sizeof(double);};
+    size_t size(const uint32_t) const {return sizeof(double);};
+    void move(const uint32_t from, const uint32_t to){data[to] = data[from];};
+
+    template<class Buffer>
+    void gather(Buffer & buff, const uint32_t e){float value = float(data[e]); buff.write(value);};
+
+    template<class Buffer>
+    void scatter(Buffer & buff, const uint32_t e){float value; buff.read(value); data[e] = value;};
+
+    void assign(uint32_t stride, uint32_t length){data.assign(data.begin() + stride, data.begin() + stride + length);};
+    void resize(uint32_t newSize){data.resize(newSize);};
+    void resizeGhost(uint32_t){};
+    void shrink(){data.shrink_to_fit();};
+};
+
+// =================================================================================== //
+
+/**<Value of the field in an octant.*/
+double field(const darray3 & center) {
+    return center[0] + 10.0*center[1];
+}
+
+/**<Refinement and marker rules of the octree, function of the center of the octants.*/
+bool inCorner(const darray3 & center) {
+    return (center[0] < 0.5 && center[1] < 0.5);
+}
+
+// =================================================================================== //
+
+/**<Check a restored octree against the octree that has been dumped, through the
+ * rules used to build it (the octants are distributed in a different way).*/
+int checkRestore(ParaTree & pablo, ParaTree & restored, bool checkMarkers) {
+
+    int nerrors = 0;
+    if (restored.getGlobalNumOctants() != pablo.getGlobalNumOctants()) nerrors++;
+    if (restored.getMaxDepth() != pablo.getMaxDepth()) nerrors++;
+
+    uint32_t nocts = restored.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = restored.getCenter(i);
+        uint8_t level = inCorner(center) ? 6 : 5;
+        if (restored.getLevel(i) != level) nerrors++;
+        if (checkMarkers && restored.getMarker(i) != (center[1] > 0.5 ? 1 : 0)) nerrors++;
+        double h = 0.5*restored.getSize(i);
+        bool bound = (center[0] - h <= 0.0 || center[0] + h >= 1.0 || center[1] - h <= 0.0 || center[1] + h >= 1.0);
+        if (restored.getBound(i) != bound) nerrors++;
+    }
+
+    /**<The ghosts are rebuilt on the new partition.*/
+    uint32_t nghosts = restored.getNumGhosts();
+    if (restored.getNproc() > 1 && nghosts == 0) nerrors++;
+    for (uint32_t i=0; i<nghosts; i++){
+        Octant ghost = *restored.getGhostOctant(i);
+        if (restored.getLevel(&ghost) != (inCorner(restored.getCenter(&ghost)) ? 6 : 5)) nerrors++;
+    }
+
+    return nerrors;
+}
+#endif
+
+// =================================================================================== //
+
+int testParallel004() {
+
+    int nerrors = 0;
+
+    /**<Instantation of a 2D para_tree object.*/
+    ParaTree pablo24;
+
+    for (int iter=0; iter<5; iter++){
+        pablo24.adaptGlobalRefine();
+    }
+
+    /**<Refine the octants of a corner of the domain.*/
+    uint32_t nocts = pablo24.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        if (inCorner(pablo24.getCenter(i))){
+            pablo24.setMarker(i, 1);
+        }
+    }
+    pablo24.adapt();
+
+#if ENABLE_MPI==1
+    /**<Dump the serial octree and restore it, the octants are now distributed over the processes.*/
+    if (!pablo24.dump("parallel_pablo_004_serial.dump")) nerrors++;
+    ParaTree restored24;
+    if (!restored24.restore("parallel_pablo_004_serial.dump")) nerrors++;
+    nerrors += checkRestore(pablo24, restored24, false);
+
+    /**<PARALLEL TEST: Call loadBalance, set the markers and dump the octree with a field.*/
+    pablo24.loadBalance();
+    nocts = pablo24.getNumOctants();
+    dvector data(nocts), ghostData;
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = pablo24.getCenter(i);
+        pablo24.setMarker(i, (center[1] > 0.5) ? 1 : 0);
+        data[i] = field(center);
+    }
+    FieldLB dumpLB(data, ghostData);
+    if (!pablo24.dump("parallel_pablo_004.dump", dumpLB)) nerrors++;
+
+    /**<Restore the octree and the field, the octree of a different dimension is not restored.*/
+    dvector restoredData, restoredGhostData;
+    FieldLB restoreLB(restoredData, restoredGhostData);
+    ParaTree restored34(3);
+    if (restored34.restore("parallel_pablo_004.dump", restoreLB)) nerrors++;
+    if (!restored24.restore("parallel_pablo_004.dump", restoreLB)) nerrors++;
+    nerrors += checkRestore(pablo24, restored24, true);
+
+    uint32_t nrestored = restored24.getNumOctants();
+    if (restoredData.size() != nrestored || restoredGhostData.size() != restored24.getNumGhosts()) nerrors++;
+    for (uint32_t i=0; i<nrestored && i<restoredData.size(); i++){
+        if (restoredData[i] != field(restored24.getCenter(i))) nerrors++;
+    }
+
+    /**<Missing and truncated files are not restored, data of the wrong size are not dumped.*/
+    ParaTree failed24;
+    if (failed24.restore("parallel_pablo_004_missing.dump")) nerrors++;
+    if (pablo24.getRank() == 0){
+        ifstream in("parallel_pablo_004.dump", ios::binary);
+        string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        ofstream out("parallel_pablo_004_truncated.dump", ios::binary | ios::trunc);
+        out.write(content.data(), content.size()/2);
+    }
+    MPI_Barrier(pablo24.getComm());
+    if (failed24.restore("parallel_pablo_004_truncated.dump", restoreLB)) nerrors++;
+    if (failed24.getGlobalNumOctants() != 1) nerrors++;
+    WrongSizeLB wrongLB(data);
+    if (pablo24.dump("parallel_pablo_004_wrong.dump", wrongLB)) nerrors++;
+
+    /**<The restored octree can be adapted.*/
+    restored24.adapt();
+    if (restored24.getGlobalNumOctants() <= pablo24.getGlobalNumOctants()) nerrors++;
+
+    int localErrors = nerrors;
+    MPI_Allreduce(&localErrors, &nerrors, 1, MPI_INT, MPI_SUM, pablo24.getComm());
+#endif
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = testParallel004();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
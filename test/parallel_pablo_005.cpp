@@ -0,0 +1,261 @@
+#include "ParaTree.hpp"
+#include "PabloUniform.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Locate a set of points, given in the unit cube, in an octree with a custom
+ * origin and length: the points are first mapped in the physical domain.*/
+int checkUniformOwners(const vector<darray3> & unitPoints) {
+
+    int nerrors = 0;
+
+    /**<Instantation of a 3D pablo uniform object with a custom domain.*/
+    darray3 origin = {{-1.0, 2.0, 0.5}};
+    double L = 3.0;
+    PabloUniform uniform35(origin[0], origin[1], origin[2], L, 3);
+
+    for (int iter=0; iter<4; iter++){
+        uniform35.adaptGlobalRefine();
+    }
+
+#if ENABLE_MPI==1
+    uniform35.loadBalance();
+#endif
+
+    uint32_t npoints = unitPoints.size();
+    vector<darray3> points(npoints);
+    for (uint32_t i=0; i<npoints; i++){
+        for (int k=0; k<3; k++){
+            points[i][k] = origin[k] + L*unitPoints[i][k];
+        }
+    }
+
+    /**<The batched owners are the ones found point by point (on a copy of the
+     * point, that is mapped in place).*/
+    u32vector idx;
+    vector<int> ranks;
+    uniform35.getPointOwners(points, idx, ranks);
+    if (idx.size() != npoints || ranks.size() != npoints) nerrors++;
+
+    for (uint32_t i=0; i<npoints && i<idx.size(); i++){
+        darray3 point = points[i];
+        if (idx[i] != uniform35.getPointOwnerIdx(point)) nerrors++;
+        if (idx[i] == uint32_t(-1)) continue;
+
+        darray3 center = uniform35.getCenter(idx[i]);
+        double h = 0.5*uniform35.getSize(idx[i]);
+        for (int k=0; k<3; k++){
+            if (points[i][k] < center[k] - h || points[i][k] > center[k] + h) nerrors++;
+        }
+    }
+
+#if ENABLE_MPI==1
+    /**<Route different points from each process to their owners: the routed points
+     * are inside the physical owner octants and none of them is lost.*/
+    uint32_t nsend = 5000;
+    uint32_t first = (uniform35.getRank() % 4)*nsend;
+    vector<darray3> sendPoints(points.begin() + first, points.begin() + first + nsend);
+    vector<uint64_t> sendData(nsend);
+    for (uint32_t i=0; i<nsend; i++){
+        sendData[i] = first + i;
+    }
+    uniform35.getPointOwners(sendPoints, idx, ranks);
+    uint64_t nsendInsides = nsend - count(ranks.begin(), ranks.end(), -1);
+
+    vector<darray3> routedPoints;
+    vector<uint64_t> routedData;
+    u32vector routedIdx;
+    uniform35.routePoints(sendPoints, sendData, routedPoints, routedData, routedIdx);
+    if (routedData.size() != routedPoints.size() || routedIdx.size() != routedPoints.size()) nerrors++;
+    for (uint32_t i=0; i<routedPoints.size() && i<routedIdx.size(); i++){
+        if (routedIdx[i] >= uniform35.getNumOctants()) {nerrors++; continue;}
+        darray3 center = uniform35.getCenter(routedIdx[i]);
+        double h = 0.5*uniform35.getSize(routedIdx[i]);
+        for (int k=0; k<3; k++){
+            if (routedPoints[i][k] < center[k] - h || routedPoints[i][k] > center[k] + h) nerrors++;
+        }
+        if (routedData[i] >= npoints || points[routedData[i]] != routedPoints[i]) nerrors++;
+    }
+
+    uint64_t nrouted = routedPoints.size(), globalRouted = 0, globalSendInsides = 0;
+    MPI_Allreduce(&nrouted, &globalRouted, 1, MPI_UINT64_T, MPI_SUM, uniform35.getComm());
+    MPI_Allreduce(&nsendInsides, &globalSendInsides, 1, MPI_UINT64_T, MPI_SUM, uniform35.getComm());
+    if (globalRouted != globalSendInsides) nerrors++;
+#endif
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int testParallel005() {
+
+    int nerrors = 0;
+
+    /**<Instantation of a 3D para_tree object.*/
+    ParaTree pablo35(3);
+
+    for (int iter=0; iter<4; iter++){
+        pablo35.adaptGlobalRefine();
+    }
+
+    /**<Refine the octants near a corner.*/
+    uint32_t nocts = pablo35.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        darray3 center = pablo35.getCenter(i);
+        if (center[0] + center[1] + center[2] < 0.8){
+            pablo35.setMarker(i, 1);
+        }
+    }
+    pablo35.adapt();
+
+#if ENABLE_MPI==1
+    /**<PARALLEL TEST: Call loadBalance, the octree is now distributed over the processes.*/
+    pablo35.loadBalance();
+#endif
+
+    /**<The same random points on all the processes, some of them outside of the domain.*/
+    uint32_t npoints = 20000;
+    vector<darray3> points(npoints);
+    uint64_t seed = 12345;
+    for (uint32_t i=0; i<npoints; i++){
+        for (int k=0; k<3; k++){
+            seed = seed*6364136223846793005ULL + 1442695040888963407ULL;
+            points[i][k] = -0.1 + 1.2*double(seed >> 11)/double(uint64_t(1) << 53);
+        }
+    }
+    points[0] = {{1.0, 1.0, 1.0}};
+    points[1] = {{0.0, 0.0, 0.0}};
+
+    /**<Locate the points at once and one by one.*/
+    u32vector idx;
+    vector<int> ranks;
+    pablo35.getPointOwners(points, idx, ranks);
+    if (idx.size() != npoints || ranks.size() != npoints) nerrors++;
+
+    int nlocals = 0, ninsides = 0;
+    for (uint32_t i=0; i<npoints && i<idx.size(); i++){
+        if (idx[i] != pablo35.getPointOwnerIdx(points[i])) nerrors++;
+        if (ranks[i] < 0){
+            if (idx[i] != uint32_t(-1)) nerrors++;
+            continue;
+        }
+        ninsides++;
+        if (idx[i] == uint32_t(-1)){
+            if (ranks[i] == pablo35.getRank()) nerrors++;
+            continue;
+        }
+        nlocals++;
+        if (ranks[i] != pablo35.getRank()) nerrors++;
+
+        /**<The point is inside the owner octant.*/
+        darray3 center = pablo35.getCenter(idx[i]);
+        double h = 0.5*pablo35.getSize(idx[i]);
+        for (int k=0; k<3; k++){
+            if (points[i][k] < center[k] - h || points[i][k] > center[k] + h) nerrors++;
+        }
+    }
+
+    /**<The same points in an octree with a custom domain.*/
+    nerrors += checkUniformOwners(points);
+
+#if ENABLE_MPI==1
+    /**<Each point inside the domain is located by exactly one process.*/
+    int globalLocals = 0;
+    MPI_Allreduce(&nlocals, &globalLocals, 1, MPI_INT, MPI_SUM, pablo35.getComm());
+    if (pablo35.getNproc() > 1 && globalLocals != ninsides) nerrors++;
+
+    /**<Route different points from each process to their owners, with the index of
+     * the point and the source rank attached.*/
+    uint32_t nsend = 5000;
+    uint32_t first = (pablo35.getRank() % 4)*nsend;
+    vector<darray3> sendPoints(points.begin() + first, points.begin() + first + nsend);
+    vector<uint64_t> sendData(2*nsend);
+    for (uint32_t i=0; i<nsend; i++){
+        sendData[2*i] = first + i;
+        sendData[2*i+1] = pablo35.getRank();
+    }
+    pablo35.getPointOwners(sendPoints, idx, ranks);
+    uint64_t nsendInsides = nsend - count(ranks.begin(), ranks.end(), -1);
+
+    vector<darray3> routedPoints;
+    vector<uint64_t> routedData;
+    u32vector routedIdx;
+    pablo35.routePoints(sendPoints, sendData, routedPoints, routedData, routedIdx, 2);
+    if (routedData.size() != 2*routedPoints.size() || routedIdx.size() != routedPoints.size()) nerrors++;
+    for (uint32_t i=0; i<routedPoints.size() && i<routedIdx.size(); i++){
+        if (routedIdx[i] >= pablo35.getNumOctants()) {nerrors++; continue;}
+        darray3 center = pablo35.getCenter(routedIdx[i]);
+        double h = 0.5*pablo35.getSize(routedIdx[i]);
+        for (int k=0; k<3; k++){
+            if (routedPoints[i][k] < center[k] - h || routedPoints[i][k] > center[k] + h) nerrors++;
+        }
+        if (routedData[2*i] >= npoints || points[routedData[2*i]] != routedPoints[i]) nerrors++;
+        if (routedData[2*i+1] >= uint64_t(pablo35.getNproc())) nerrors++;
+    }
+
+    /**<No point inside the domain is lost or duplicated.*/
+    uint64_t nrouted = routedPoints.size(), globalRouted = 0, globalSendInsides = 0;
+    MPI_Allreduce(&nrouted, &globalRouted, 1, MPI_UINT64_T, MPI_SUM, pablo35.getComm());
+    MPI_Allreduce(&nsendInsides, &globalSendInsides, 1, MPI_UINT64_T, MPI_SUM, pablo35.getComm());
+    if (pablo35.getNproc() > 1 && globalRouted != globalSendInsides) nerrors++;
+
+    /**<Back-to-back routes of different points, with the round attached: the points
+     * of a route are never received by the previous one.*/
+    int nrounds = 4;
+    vector<vector<darray3> > roundPoints(nrounds);
+    vector<vector<uint64_t> > roundData(nrounds);
+    vector<u32vector> roundIdx(nrounds);
+    vector<uint64_t> roundSendInsides(nrounds);
+    for (int round=0; round<nrounds; round++){
+        uint32_t first = ((pablo35.getRank() + round) % 4)*nsend;
+        vector<darray3> sendPoints(points.begin() + first, points.begin() + first + nsend);
+        vector<uint64_t> sendData(nsend);
+        for (uint32_t i=0; i<nsend; i++){
+            sendData[i] = uint64_t(round)*npoints + first + i;
+        }
+        pablo35.routePoints(sendPoints, sendData, roundPoints[round], roundData[round], roundIdx[round]);
+        pablo35.getPointOwners(sendPoints, idx, ranks);
+        roundSendInsides[round] = nsend - count(ranks.begin(), ranks.end(), -1);
+    }
+    for (int round=0; round<nrounds; round++){
+        for (uint32_t i=0; i<roundPoints[round].size(); i++){
+            uint64_t ipoint = roundData[round][i] - uint64_t(round)*npoints;
+            if (roundData[round][i] < uint64_t(round)*npoints || ipoint >= npoints || points[ipoint] != roundPoints[round][i]) nerrors++;
+        }
+        uint64_t nrouted = roundPoints[round].size(), globalRouted = 0, globalSendInsides = 0;
+        MPI_Allreduce(&nrouted, &globalRouted, 1, MPI_UINT64_T, MPI_SUM, pablo35.getComm());
+        MPI_Allreduce(&roundSendInsides[round], &globalSendInsides, 1, MPI_UINT64_T, MPI_SUM, pablo35.getComm());
+        if (globalRouted != globalSendInsides) nerrors++;
+    }
+
+    int localErrors = nerrors;
+    MPI_Allreduce(&localErrors, &nerrors, 1, MPI_INT, MPI_SUM, pablo35.getComm());
+#endif
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = testParallel005();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include "ParaTree.hpp"
+#include <iostream>
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Count the face neighbours (local or ghost) whose levels differ by more than one.*/
+int checkBalance21(ParaTree & pablo) {
+
+    int nerrors = 0;
+
+    u32vector neigh;
+    vector<bool> isghost;
+    uint32_t nocts = pablo.getNumOctants();
+    for (uint32_t i=0; i<nocts; i++){
+        for (uint8_t iface=0; iface<2*pablo.getDim(); iface++){
+            pablo.findNeighbours(i, iface, 1, neigh, isghost);
+            for (size_t k=0; k<neigh.size(); k++){
+                int level = isghost[k] ? pablo.getLevel(pablo.getGhostOctant(neigh[k])) : pablo.getLevel(neigh[k]);
+                if (abs(level - int(pablo.getLevel(i))) > 1) nerrors++;
+            }
+        }
+    }
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int testParallel006() {
+
+    int nerrors = 0;
+
+    for (uint8_t dim=2; dim<=3; dim++){
+
+        /**<Instantation of a para_tree object.*/
+        ParaTree pablo36(dim);
+
+        for (int iter=0; iter<((dim == 2) ? 5 : 3); iter++){
+            pablo36.adaptGlobalRefine();
+        }
+
+#if ENABLE_MPI==1
+        /**<PARALLEL TEST: Call loadBalance, the octree is now distributed over the processes.*/
+        pablo36.loadBalance();
+#endif
+
+        /**<Refine repeatedly the octants around the center of the domain, shared by the
+         * processes: the 2:1 balance ripples across the process boundaries.*/
+        for (int iter=0; iter<4; iter++){
+            uint32_t nocts = pablo36.getNumOctants();
+            for (uint32_t i=0; i<nocts; i++){
+                darray3 center = pablo36.getCenter(i);
+                double size = pablo36.getSize(i);
+                if (abs(center[0] - 0.5) < size && abs(center[1] - 0.5) < size && (dim == 2 || abs(center[2] - 0.5) < size)){
+                    pablo36.setMarker(i, 1);
+                }
+            }
+            pablo36.adapt();
+            nerrors += checkBalance21(pablo36);
+
+            /**<One time for each iteration of the balance, the first sweep included.*/
+            const dvector & times = pablo36.getBalanceTimes();
+            if (pablo36.getBalanceIterations() < 1 || times.size() != pablo36.getBalanceIterations()) nerrors++;
+            for (size_t k=0; k<times.size(); k++){
+                if (times[k] < 0.0) nerrors++;
+            }
+        }
+    }
+
+#if ENABLE_MPI==1
+    int localErrors = nerrors;
+    MPI_Allreduce(&localErrors, &nerrors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = testParallel006();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
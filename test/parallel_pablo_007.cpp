@@ -0,0 +1,132 @@
+#include "ParaTree.hpp"
+#include <iostream>
+
+using namespace std;
+
+#if ENABLE_MPI==1
+// =================================================================================== //
+
+/**<User data of a field of doubles (one value per octant) migrated by the load
+ * balance, with a fixed or a variable size.*/
+class FieldLB : public DataLBInterface<FieldLB> {
+public:
+    dvector & data;
+    dvector & ghostData;
+    bool fixed;
+
+    FieldLB(dvector & data_, dvector & ghostData_, bool fixed_) : data(data_), ghostData(ghostData_), fixed(fixed_){};
+
+    size_t fixedSize() const {return (fixed ? sizeof(double) : 0);};
+    size_t size(const uint32_t) const {return sizeof(double);};
+    void move(const uint32_t from, const uint32_t to){data[to] = data[from];};
+
+    template<class Buffer>
+    void gather(Buffer & buff, const uint32_t e){buff.write(data[e]);};
+
+    template<class Buffer>
+    void scatter(Buffer & buff, const uint32_t e){buff.read(data[e]);};
+
+    void assign(uint32_t stride, uint32_t length){data.assign(data.begin() + stride, data.begin() + stride + length);};
+    void resize(uint32_t newSize){data.resize(newSize);};
+    void resizeGhost(uint32_t newSize){ghostData.resize(newSize);};
+    void shrink(){data.shrink_to_fit();};
+};
+
+// =================================================================================== //
+
+/**<Value of the field in an octant.*/
+double field(const darray3 & center) {
+    return center[0] + 10.0*center[1];
+}
+
+/**<Count the local octants whose data does not follow the octant.*/
+int checkField(ParaTree & pablo, const dvector & data) {
+
+    int nerrors = 0;
+    uint32_t nocts = pablo.getNumOctants();
+    if (data.size() != nocts) return 1;
+    for (uint32_t i=0; i<nocts; i++){
+        if (data[i] != field(pablo.getCenter(i))) nerrors++;
+    }
+
+    return nerrors;
+}
+#endif
+
+// =================================================================================== //
+
+int testParallel007() {
+
+    int nerrors = 0;
+
+#if ENABLE_MPI==1
+    for (int ifixed=0; ifixed<2; ifixed++){
+
+        /**<Instantation of a 2D para_tree object.*/
+        ParaTree pablo27;
+
+        for (int iter=0; iter<5; iter++){
+            pablo27.adaptGlobalRefine();
+        }
+
+        uint32_t nocts = pablo27.getNumOctants();
+        dvector data(nocts), ghostData;
+        for (uint32_t i=0; i<nocts; i++){
+            data[i] = field(pablo27.getCenter(i));
+        }
+        FieldLB userData(data, ghostData, (ifixed == 1));
+
+        /**<PARALLEL TEST: Call loadBalance with the user data, the octree is now distributed over the processes.*/
+        pablo27.loadBalance(userData);
+        nerrors += checkField(pablo27, data);
+
+        /**<Weights heavier on the first octants, then on the last ones: the octants and
+         * their data are shifted towards the last processes and back towards the first ones.*/
+        for (int step=0; step<4; step++){
+            nocts = pablo27.getNumOctants();
+            dvector weight(nocts);
+            for (uint32_t i=0; i<nocts; i++){
+                double y = pablo27.getCenter(i)[1];
+                weight[i] = (step % 2 == 0) ? 1.0 + 4.0*(1.0 - y) : 1.0 + 4.0*y;
+            }
+            if (step < 2){
+                pablo27.loadBalance(userData, &weight);
+            }
+            else{
+                uint8_t level = 2;
+                pablo27.loadBalance(userData, level, &weight);
+            }
+            nerrors += checkField(pablo27, data);
+        }
+
+        /**<Uniform distribution again.*/
+        pablo27.loadBalance(userData);
+        nerrors += checkField(pablo27, data);
+    }
+
+    int localErrors = nerrors;
+    MPI_Allreduce(&localErrors, &nerrors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = testParallel007();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+#include "ParaTree.hpp"
+#include <iostream>
+
+using namespace std;
+
+// =================================================================================== //
+
+/**<Weight of an octant, function of its global index: the first quarter of the
+ * octants is heavier.*/
+double weightOf(uint64_t globalIdx) {
+    return (globalIdx < 64) ? 5.0 : 1.0;
+}
+
+/**<Number of octants of each process of the weighted partition of 256 octants: an
+ * octant is assigned to the process floor(P*c/W), with c the weight preceding its center.*/
+u32vector expectedPartition(int nproc) {
+
+    double globalWeight = 0.0;
+    for (uint64_t g=0; g<256; g++){
+        globalWeight += weightOf(g);
+    }
+
+    u32vector partition(nproc, 0);
+    double partialWeight = 0.0;
+    for (uint64_t g=0; g<256; g++){
+        double center = partialWeight + 0.5*weightOf(g);
+        partition[min(int(double(nproc)*center/globalWeight), nproc - 1)]++;
+        partialWeight += weightOf(g);
+    }
+
+    return partition;
+}
+
+#if ENABLE_MPI==1
+/**<Weighted load balance of a tree: check the number of local octants.*/
+int checkWeightedPartition(ParaTree & pablo) {
+
+    uint32_t nocts = pablo.getNumOctants();
+    dvector weight(nocts);
+    for (uint32_t i=0; i<nocts; i++){
+        weight[i] = weightOf(pablo.getSerial() ? i : pablo.getGlobalIdx(i));
+    }
+    pablo.loadBalance(&weight);
+
+    int nerrors = 0;
+    u32vector expected = expectedPartition(pablo.getNproc());
+    if (pablo.getNumOctants() != expected[pablo.getRank()]) nerrors++;
+
+    /**<Explicit partition on three processes (the cuts fall at the weights 512/3 and 1024/3).*/
+    if (pablo.getNproc() == 3){
+        uint32_t explicitPartition[3] = {34, 51, 171};
+        if (pablo.getNumOctants() != explicitPartition[pablo.getRank()]) nerrors++;
+    }
+    if (pablo.getGlobalNumOctants() != 256) nerrors++;
+
+    return nerrors;
+}
+#endif
+
+// =================================================================================== //
+
+int testParallel008() {
+
+    int nerrors = 0;
+
+    /**<Instantation of a 2D para_tree object with 256 octants.*/
+    ParaTree pablo28;
+    for (int iter=0; iter<4; iter++){
+        pablo28.adaptGlobalRefine();
+    }
+
+#if ENABLE_MPI==1
+    /**<PARALLEL TEST: weighted load balance of the serial tree, then of the distributed tree.*/
+    nerrors += checkWeightedPartition(pablo28);
+    pablo28.loadBalance();
+    nerrors += checkWeightedPartition(pablo28);
+
+    int localErrors = nerrors;
+    MPI_Allreduce(&localErrors, &nerrors, 1, MPI_INT, MPI_SUM, pablo28.getComm());
+#endif
+
+    cout << " Number of errors : " << nerrors << endl;
+
+    return nerrors;
+}
+
+// =================================================================================== //
+
+int main( int argc, char *argv[] ) {
+
+#if ENABLE_MPI==1
+	MPI::Init(argc, argv);
+#endif
+
+	/**<Calling Pablo Test routines*/
+	int status = testParallel008();
+
+#if ENABLE_MPI==1
+	MPI::Finalize();
+#endif
+
+	return (status == 0) ? 0 : 1;
+}